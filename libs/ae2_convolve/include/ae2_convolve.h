@@ -7,6 +7,7 @@
 struct AE2ConvolveConfig {
     uint32_t max_num_coefficients; /* 最大係数数 */
     uint32_t max_num_input_samples; /* 最大入力サンプル数 */
+    uint32_t partition_size; /* 係数の分割サイズ（分割畳み込みのみ使用。0の場合はmax_num_input_samplesから決定） */
 };
 
 /* 畳み込みインターフェース */
@@ -0,0 +1,60 @@
+#ifndef AE2CROSSFADECONVOLVE_H_INCLUDED
+#define AE2CROSSFADECONVOLVE_H_INCLUDED
+
+#include <stdint.h>
+#include "ae2_convolve.h"
+
+/* 初期化コンフィグ */
+struct AE2CrossfadeConvolveConfig {
+    const struct AE2ConvolveInterface *conv_if; /* 内部で使用する畳み込みインターフェース */
+    struct AE2ConvolveConfig conv_config; /* 内部で使用する畳み込みのコンフィグ */
+};
+
+/* クロスフェード付き係数差し替え畳み込み */
+/* 内部に同じ畳み込みを2つ持ち、待機側に新しい係数を変換してから、入力を現用側から待機側へクロスフェードして切り替える */
+/* 現用側はフェード後も係数長だけ処理を続けるため、差し替え前の入力の残響は途切れずに鳴り終わる */
+struct AE2CrossfadeConvolve;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ワークサイズ計算 */
+int32_t AE2CrossfadeConvolve_CalculateWorkSize(const struct AE2CrossfadeConvolveConfig *config);
+
+/* インスタンス生成 */
+struct AE2CrossfadeConvolve *AE2CrossfadeConvolve_Create(const struct AE2CrossfadeConvolveConfig *config, void *work, int32_t work_size);
+
+/* インスタンス破棄 */
+void AE2CrossfadeConvolve_Destroy(struct AE2CrossfadeConvolve *conv);
+
+/* 内部状態リセット */
+/* 進行中のクロスフェードは完了させる */
+void AE2CrossfadeConvolve_Reset(struct AE2CrossfadeConvolve *conv);
+
+/* 係数の即時セット（内部状態はリセットされる） */
+/* Convolve, SwapCoefficientsと同時に呼び出さないこと */
+void AE2CrossfadeConvolve_SetCoefficients(struct AE2CrossfadeConvolve *conv, const float *coefficients, uint32_t num_coefficients);
+
+/* 係数の差し替え */
+/* 待機側に係数を変換してセットし、次のConvolveからnum_crossfade_samplesかけて入力をクロスフェードする */
+/* 差し替えの完了は、フェード後に古い係数の残響（係数長+レイテンシ）が鳴り終わった時点 */
+/* Convolveとは別スレッドから同時に呼び出してよい（係数の変換はこの関数内で行い、Convolveでは行わない） */
+/* 前回の差し替えが完了していない（待機側が使用中の）場合は何もせず負の値を返す。成功時は0 */
+int32_t AE2CrossfadeConvolve_SwapCoefficients(struct AE2CrossfadeConvolve *conv,
+        const float *coefficients, uint32_t num_coefficients, uint32_t num_crossfade_samples);
+
+/* 差し替えが完了したか？（1: 完了し、古い係数の領域は次の差し替えで再利用できる 0: 待機中、クロスフェード中、または古い係数の残響の処理中） */
+int32_t AE2CrossfadeConvolve_IsSwapCompleted(const struct AE2CrossfadeConvolve *conv);
+
+/* 畳み込み */
+void AE2CrossfadeConvolve_Convolve(struct AE2CrossfadeConvolve *conv, const float *input, float *output, uint32_t num_samples);
+
+/* レイテンシーの取得 */
+int32_t AE2CrossfadeConvolve_GetLatencyNumSamples(const struct AE2CrossfadeConvolve *conv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AE2CROSSFADECONVOLVE_H_INCLUDED */
@@ -3,12 +3,60 @@
 
 #include "ae2_convolve.h"
 
+/* 複数インスタンスで共有するフーリエ変換済み係数 */
+struct AE2FFTConvolveSharedCoefficients;
+
+/* FFTプラン（ae2_fft.h） */
+struct AE2FFTPlan;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 const struct AE2ConvolveInterface *AE2FFTConvolve_GetInterface(void);
 
+/* 分割サイズの計算 */
+/* partition_size（0の場合はmax_num_input_samples）をFFTプランが扱える2, 3, 5の積で表せる値に切り上げる */
+/* 同じ分割方針を使う他の分割畳み込みからも使用する */
+uint32_t AE2FFTConvolve_CalculatePartitionSize(const struct AE2ConvolveConfig *config);
+
+/* 係数の分割毎のフーリエ変換 */
+/* 分割毎に2 * partition_size点へ0埋めして正規化込みでFFTし、分割kの実部/虚部をir_freq[2 * k * partition_size]から格納する */
+/* fft_planはfft_size = 2 * partition_size, work_bufferは2 * partition_size必須。同じ係数形式を使う他の分割畳み込みからも使用する */
+void AE2FFTConvolve_TransformCoefficients(struct AE2FFTPlan *fft_plan, float *work_buffer,
+        uint32_t partition_size, const float *coefficients, uint32_t num_coefficients, float *ir_freq);
+
+/* 分割サイズ単位の畳み込み */
+/* inputとoutputは分割サイズ（GetLatencyNumSamplesの値）必須。出力の遅延はなく、inputに対応する結果がoutputに入る */
+/* 常に分割境界で呼び出すこと。同一インスタンスでConvolveと混在させないこと */
+void AE2FFTConvolve_ConvolveBlock(void *obj, const float *input, float *output);
+
+/* 共有係数作成に必要なワークサイズ計算 */
+int32_t AE2FFTConvolve_CalculateSharedCoefficientsWorkSize(const struct AE2ConvolveConfig *config);
+
+/* 共有係数作成 */
+/* 係数のフーリエ変換はここで1回だけ行う。作成後の係数は読み取り専用 */
+struct AE2FFTConvolveSharedCoefficients *AE2FFTConvolve_CreateSharedCoefficients(
+        const struct AE2ConvolveConfig *config, const float *coefficients, uint32_t num_coefficients,
+        void *work, int32_t work_size);
+
+/* 共有係数破棄 */
+/* 参照しているインスタンスを全て破棄してから呼ぶこと */
+void AE2FFTConvolve_DestroySharedCoefficients(struct AE2FFTConvolveSharedCoefficients *shared);
+
+/* 共有係数を参照しているインスタンス数の取得 */
+uint32_t AE2FFTConvolve_GetSharedCoefficientsNumReferences(const struct AE2FFTConvolveSharedCoefficients *shared);
+
+/* 共有係数を参照するインスタンスのワークサイズ計算 */
+/* 係数を保持しない分だけCalculateWorkSizeより小さい */
+int32_t AE2FFTConvolve_CalculateSharedWorkSize(const struct AE2ConvolveConfig *config);
+
+/* 共有係数を参照するインスタンス生成 */
+/* 生成時に参照数を増やし、インターフェースのDestroyで減らす。参照数の操作はスレッドセーフではない */
+/* 生成したインスタンスには係数セット（SetCoefficients）を行わないこと */
+void *AE2FFTConvolve_CreateShared(const struct AE2ConvolveConfig *config,
+        struct AE2FFTConvolveSharedCoefficients *shared, void *work, int32_t work_size);
+
 #ifdef __cplusplus
 }
 #endif
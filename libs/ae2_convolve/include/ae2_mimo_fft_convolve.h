@@ -0,0 +1,54 @@
+#ifndef AE2MIMOFFTCONVOLVE_H_INCLUDED
+#define AE2MIMOFFTCONVOLVE_H_INCLUDED
+
+#include <stdint.h>
+
+/* 初期化コンフィグ */
+struct AE2MIMOFFTConvolveConfig {
+    uint32_t num_inputs; /* 入力チャンネル数 */
+    uint32_t num_outputs; /* 出力チャンネル数 */
+    uint32_t max_num_coefficients; /* 最大係数数（入出力の組毎） */
+    uint32_t max_num_input_samples; /* 最大入力サンプル数 */
+    uint32_t partition_size; /* 係数の分割サイズ（0の場合はmax_num_input_samplesから決定） */
+};
+
+/* 多入力多出力の分割FFT畳み込み */
+/* 出力チャンネルoには各入力チャンネルiと係数(i, o)の畳み込みの総和が出力される */
+/* 入力は1周期（分割サイズ分のサンプル）毎にチャンネルあたり1回だけFFTし、出力チャンネルあたり1回だけIFFTする */
+struct AE2MIMOFFTConvolve;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* ワークサイズ計算 */
+int32_t AE2MIMOFFTConvolve_CalculateWorkSize(const struct AE2MIMOFFTConvolveConfig *config);
+
+/* インスタンス生成 */
+/* 生成直後は全ての係数が0（無音を出力する） */
+struct AE2MIMOFFTConvolve *AE2MIMOFFTConvolve_Create(const struct AE2MIMOFFTConvolveConfig *config, void *work, int32_t work_size);
+
+/* インスタンス破棄 */
+void AE2MIMOFFTConvolve_Destroy(struct AE2MIMOFFTConvolve *conv);
+
+/* 内部状態リセット */
+void AE2MIMOFFTConvolve_Reset(struct AE2MIMOFFTConvolve *conv);
+
+/* 入力チャンネルinputから出力チャンネルoutputへの係数セット */
+/* num_coefficientsが0の場合はその組の寄与をなくす。内部状態はリセットされる */
+void AE2MIMOFFTConvolve_SetCoefficients(struct AE2MIMOFFTConvolve *conv,
+        uint32_t input, uint32_t output, const float *coefficients, uint32_t num_coefficients);
+
+/* 畳み込み */
+/* input[num_inputs][num_samples]を入力し、output[num_outputs][num_samples]に結果を書き出す */
+void AE2MIMOFFTConvolve_Convolve(struct AE2MIMOFFTConvolve *conv,
+        const float *const *input, float *const *output, uint32_t num_samples);
+
+/* レイテンシーの取得 */
+int32_t AE2MIMOFFTConvolve_GetLatencyNumSamples(const struct AE2MIMOFFTConvolve *conv);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AE2MIMOFFTCONVOLVE_H_INCLUDED */
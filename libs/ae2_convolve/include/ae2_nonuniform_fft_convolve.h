@@ -0,0 +1,34 @@
+#ifndef AE2NONUNIFORMFFTCONVOLVE_H_INCLUDED
+#define AE2NONUNIFORMFFTCONVOLVE_H_INCLUDED
+
+#include "ae2_convolve.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* インターフェース取得 */
+/* 先頭をカラツバ法で、以降を分割サイズが4倍ずつ増える分割FFT畳み込みで計算するレイテンシ0の畳み込み */
+/* AE2ConvolveConfigのpartition_sizeは最小の分割サイズ（カラツバ法で計算する先頭の係数長）として使用する */
+const struct AE2ConvolveInterface *AE2NonUniformFFTConvolve_GetInterface(void);
+
+/* インターフェース取得（バックグラウンド処理あり） */
+/* 分割サイズ4096以上の段をConvolveの外（AE2NonUniformFFTConvolve_ProcessBackground）で計算する */
+/* Convolveは先頭の小さな段の計算と、受け渡しバッファへの入力・結果の加算のみ行う */
+/* 各段は1周期（分割サイズ分のサンプル）の処理猶予を持ち、間に合わなかった周期の寄与は0になる */
+const struct AE2ConvolveInterface *AE2NonUniformFFTConvolve_GetAsyncInterface(void);
+
+/* バックグラウンド処理 */
+/* ワーカースレッドから繰り返し呼び出す。Convolveとは別スレッドから同時に呼び出してよい */
+/* 最小の非同期分割サイズ分のサンプルが入力される間に少なくとも1回は呼び出すこと */
+/* Reset・SetCoefficientsの実行中は呼び出さないこと。戻り値は処理した周期数 */
+int32_t AE2NonUniformFFTConvolve_ProcessBackground(void *obj);
+
+/* 処理が間に合わなかった周期数の取得（Reset・SetCoefficientsで0に戻る） */
+uint32_t AE2NonUniformFFTConvolve_GetNumMissedDeadlines(const void *obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AE2NONUNIFORMFFTCONVOLVE_H_INCLUDED */
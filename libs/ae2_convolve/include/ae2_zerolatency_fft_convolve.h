@@ -3,12 +3,42 @@
 
 #include "ae2_convolve.h"
 
+/* 複数インスタンスで共有する係数 */
+struct AE2ZeroLatencyFFTConvolveSharedCoefficients;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/* インターフェース取得 */
+/* partition_sizeが0の場合、後半の周波数領域畳み込みは入力サンプル数によらず先頭の時間領域畳み込みの係数長で分割する */
 const struct AE2ConvolveInterface* AE2ZeroLatencyFFTConvolve_GetInterface(void);
 
+/* 共有係数作成に必要なワークサイズ計算 */
+int32_t AE2ZeroLatencyFFTConvolve_CalculateSharedCoefficientsWorkSize(const struct AE2ConvolveConfig *config);
+
+/* 共有係数作成 */
+/* 後半の係数のフーリエ変換はここで1回だけ行う。インスタンスと同じコンフィグを指定すること */
+struct AE2ZeroLatencyFFTConvolveSharedCoefficients *AE2ZeroLatencyFFTConvolve_CreateSharedCoefficients(
+        const struct AE2ConvolveConfig *config, const float *coefficients, uint32_t num_coefficients,
+        void *work, int32_t work_size);
+
+/* 共有係数破棄 */
+/* 参照しているインスタンスを全て破棄してから呼ぶこと */
+void AE2ZeroLatencyFFTConvolve_DestroySharedCoefficients(struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared);
+
+/* 共有係数を参照しているインスタンス数の取得 */
+uint32_t AE2ZeroLatencyFFTConvolve_GetSharedCoefficientsNumReferences(const struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared);
+
+/* 共有係数を参照するインスタンスのワークサイズ計算 */
+int32_t AE2ZeroLatencyFFTConvolve_CalculateSharedWorkSize(const struct AE2ConvolveConfig *config);
+
+/* 共有係数を参照するインスタンス生成 */
+/* 生成時に参照数を増やし、インターフェースのDestroyで減らす。参照数の操作はスレッドセーフではない */
+/* 生成したインスタンスには係数セット（SetCoefficients）を行わないこと */
+void *AE2ZeroLatencyFFTConvolve_CreateShared(const struct AE2ConvolveConfig *config,
+        struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared, void *work, int32_t work_size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,281 @@
+#include "ae2_crossfade_convolve.h"
+
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+/* メモリバリア（差し替え要求/完了の通知に使用） */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_M_ARM) || defined(_M_ARM64)
+#define AE2CROSSFADECONVOLVE_MEMORY_BARRIER() __dmb(0xB)
+#else
+#define AE2CROSSFADECONVOLVE_MEMORY_BARRIER() _mm_mfence()
+#endif
+#elif defined(__GNUC__)
+#define AE2CROSSFADECONVOLVE_MEMORY_BARRIER() __sync_synchronize()
+#else
+/* バリアが使えない処理系ではスレッドをまたいだ差し替えは保証しない */
+#define AE2CROSSFADECONVOLVE_MEMORY_BARRIER()
+#endif
+
+/* メモリアラインメント */
+#define AE2CROSSFADECONVOLVE_ALIGNMENT 16
+/* 最小値の取得 */
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+/* nの倍数切り上げ */
+#define ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
+
+/* クロスフェード付き係数差し替え畳み込み構造体 */
+struct AE2CrossfadeConvolve {
+    const struct AE2ConvolveInterface *conv_if; /* 畳み込みインターフェース */
+    void *conv_objs[2]; /* 畳み込みオブジェクト */
+    uint32_t active; /* 現用側のインデックス */
+    volatile uint32_t requested; /* 差し替え要求数（SwapCoefficientsのみが書き込む） */
+    volatile uint32_t completed; /* 差し替え完了数（Convolveのみが書き込む） */
+    uint32_t requested_crossfade_num_samples; /* 要求されたクロスフェードサンプル数 */
+    uint32_t num_coefficients[2]; /* 各畳み込みオブジェクトにセットした係数長 */
+    uint8_t crossfading; /* クロスフェード中（古い側の残響の鳴り終わりを待つ間を含む）か？ */
+    uint32_t crossfade_pos; /* クロスフェード開始からの進行サンプル数 */
+    uint32_t crossfade_num_samples; /* 進行中のクロスフェードサンプル数 */
+    uint32_t swap_num_samples; /* クロスフェード開始から古い側の残響が鳴り終わるまでのサンプル数 */
+    float *fade_buffer; /* 待機側の出力バッファ */
+    float *input_buffer; /* 新旧に振り分けた入力のバッファ */
+    uint32_t max_num_input_samples; /* 最大入力サンプル数 */
+};
+
+/* 差し替えの完了 */
+static void AE2CrossfadeConvolve_CompleteSwap(struct AE2CrossfadeConvolve *conv);
+
+/* ワークサイズ計算 */
+int32_t AE2CrossfadeConvolve_CalculateWorkSize(const struct AE2CrossfadeConvolveConfig *config)
+{
+    int32_t work_size, conv_work_size;
+
+    /* 引数チェック */
+    if ((config == NULL) || (config->conv_if == NULL)) {
+        return -1;
+    }
+
+    if ((conv_work_size = config->conv_if->CalculateWorkSize(&config->conv_config)) < 0) {
+        return -1;
+    }
+
+    work_size = sizeof(struct AE2CrossfadeConvolve) + AE2CROSSFADECONVOLVE_ALIGNMENT;
+    work_size += 2 * conv_work_size;
+    work_size += 2 * (sizeof(float) * config->conv_config.max_num_input_samples + AE2CROSSFADECONVOLVE_ALIGNMENT);
+
+    return work_size;
+}
+
+/* インスタンス生成 */
+struct AE2CrossfadeConvolve *AE2CrossfadeConvolve_Create(const struct AE2CrossfadeConvolveConfig *config, void *work, int32_t work_size)
+{
+    struct AE2CrossfadeConvolve *conv;
+    uint8_t *work_ptr = (uint8_t *)work;
+    int32_t conv_work_size;
+    uint32_t i;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL)
+            || (work_size < AE2CrossfadeConvolve_CalculateWorkSize(config))) {
+        return NULL;
+    }
+
+    /* 構造体配置 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2CROSSFADECONVOLVE_ALIGNMENT);
+    conv = (struct AE2CrossfadeConvolve *)work_ptr;
+    conv->conv_if = config->conv_if;
+    conv->max_num_input_samples = config->conv_config.max_num_input_samples;
+    work_ptr += sizeof(struct AE2CrossfadeConvolve);
+
+    /* 現用・待機の畳み込みオブジェクト */
+    if ((conv_work_size = conv->conv_if->CalculateWorkSize(&config->conv_config)) < 0) {
+        return NULL;
+    }
+    for (i = 0; i < 2; i++) {
+        if ((conv->conv_objs[i] = conv->conv_if->Create(&config->conv_config, work_ptr, conv_work_size)) == NULL) {
+            return NULL;
+        }
+        work_ptr += conv_work_size;
+    }
+
+    /* 待機側の出力バッファ */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2CROSSFADECONVOLVE_ALIGNMENT);
+    conv->fade_buffer = (float *)work_ptr;
+    work_ptr += sizeof(float) * conv->max_num_input_samples;
+
+    /* 入力の振り分けバッファ */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2CROSSFADECONVOLVE_ALIGNMENT);
+    conv->input_buffer = (float *)work_ptr;
+    work_ptr += sizeof(float) * conv->max_num_input_samples;
+
+    conv->active = 0;
+    conv->requested = conv->completed = 0;
+    conv->requested_crossfade_num_samples = 0;
+    conv->num_coefficients[0] = conv->num_coefficients[1] = 0;
+    conv->crossfading = 0;
+    conv->crossfade_pos = conv->crossfade_num_samples = conv->swap_num_samples = 0;
+
+    return conv;
+}
+
+/* インスタンス破棄 */
+void AE2CrossfadeConvolve_Destroy(struct AE2CrossfadeConvolve *conv)
+{
+    if (conv != NULL) {
+        conv->conv_if->Destroy(conv->conv_objs[0]);
+        conv->conv_if->Destroy(conv->conv_objs[1]);
+    }
+}
+
+/* 内部状態リセット */
+void AE2CrossfadeConvolve_Reset(struct AE2CrossfadeConvolve *conv)
+{
+    assert(conv != NULL);
+
+    /* 進行中のクロスフェードは完了させる */
+    if (conv->crossfading) {
+        AE2CrossfadeConvolve_CompleteSwap(conv);
+    }
+
+    conv->conv_if->Reset(conv->conv_objs[0]);
+    conv->conv_if->Reset(conv->conv_objs[1]);
+}
+
+/* 係数の即時セット */
+void AE2CrossfadeConvolve_SetCoefficients(struct AE2CrossfadeConvolve *conv, const float *coefficients, uint32_t num_coefficients)
+{
+    assert(conv != NULL);
+
+    /* 差し替え途中であれば完了させてから現用側にセット */
+    if (conv->crossfading) {
+        AE2CrossfadeConvolve_CompleteSwap(conv);
+    }
+    conv->conv_if->SetCoefficients(conv->conv_objs[conv->active], coefficients, num_coefficients);
+    conv->num_coefficients[conv->active] = num_coefficients;
+}
+
+/* 係数の差し替え */
+int32_t AE2CrossfadeConvolve_SwapCoefficients(struct AE2CrossfadeConvolve *conv,
+        const float *coefficients, uint32_t num_coefficients, uint32_t num_crossfade_samples)
+{
+    uint32_t standby;
+
+    assert(conv != NULL);
+
+    /* 前回の差し替えが完了するまで待機側は使用中 */
+    if (conv->requested != conv->completed) {
+        return -1;
+    }
+    /* completedの読み出しを待機側の書き換えより先に行う */
+    AE2CROSSFADECONVOLVE_MEMORY_BARRIER();
+
+    /* 待機側に係数を変換してセット（内部状態もリセットされる） */
+    standby = conv->active ^ 1;
+    conv->conv_if->SetCoefficients(conv->conv_objs[standby], coefficients, num_coefficients);
+    conv->num_coefficients[standby] = num_coefficients;
+    conv->requested_crossfade_num_samples = num_crossfade_samples;
+
+    /* 待機側の書き換えを要求の公開より先に行う */
+    AE2CROSSFADECONVOLVE_MEMORY_BARRIER();
+    conv->requested = conv->completed + 1;
+
+    return 0;
+}
+
+/* 差し替えが完了したか？ */
+int32_t AE2CrossfadeConvolve_IsSwapCompleted(const struct AE2CrossfadeConvolve *conv)
+{
+    assert(conv != NULL);
+    return (conv->requested == conv->completed) ? 1 : 0;
+}
+
+/* 畳み込み */
+void AE2CrossfadeConvolve_Convolve(struct AE2CrossfadeConvolve *conv, const float *input, float *output, uint32_t num_samples)
+{
+    uint32_t smpl, num_fade;
+    void *active_obj, *standby_obj;
+    float gain, delta;
+
+    assert((conv != NULL) && (input != NULL) && (output != NULL));
+    assert(num_samples <= conv->max_num_input_samples);
+
+    /* 差し替え要求があればクロスフェード開始 */
+    if (!conv->crossfading && (conv->requested != conv->completed)) {
+        /* requestedの読み出しを待機側の使用より先に行う */
+        AE2CROSSFADECONVOLVE_MEMORY_BARRIER();
+        conv->crossfading = 1;
+        conv->crossfade_pos = 0;
+        conv->crossfade_num_samples = conv->requested_crossfade_num_samples;
+        /* フェードを終えた後も、古い側はそれまでの入力の残響が鳴り終わるまで（係数長+レイテンシ）処理を続ける */
+        conv->swap_num_samples = conv->crossfade_num_samples + conv->num_coefficients[conv->active]
+            + (uint32_t)conv->conv_if->GetLatencyNumSamples(conv->conv_objs[conv->active]);
+    }
+
+    active_obj = conv->conv_objs[conv->active];
+
+    if (!conv->crossfading) {
+        conv->conv_if->Convolve(active_obj, input, output, num_samples);
+        return;
+    }
+
+    /* 出力ではなく入力をクロスフェードして新旧に振り分ける（新旧のゲインの和は常に1） */
+    /* 畳み込みは線形なので、それぞれの入力の残響は途切れずに出力の和に残る */
+    num_fade = 0;
+    if (conv->crossfade_pos < conv->crossfade_num_samples) {
+        num_fade = MIN(num_samples, conv->crossfade_num_samples - conv->crossfade_pos);
+        delta = 1.0f / (float)conv->crossfade_num_samples;
+        gain = (float)conv->crossfade_pos * delta;
+        for (smpl = 0; smpl < num_fade; smpl++) {
+            gain += delta;
+            conv->input_buffer[smpl] = gain * input[smpl];
+        }
+    }
+    /* クロスフェードを終えた分は新しい係数側のみに入力 */
+    memcpy(&conv->input_buffer[num_fade], &input[num_fade], sizeof(float) * (num_samples - num_fade));
+
+    /* 新しい係数側 */
+    standby_obj = conv->conv_objs[conv->active ^ 1];
+    conv->conv_if->Convolve(standby_obj, conv->input_buffer, conv->fade_buffer, num_samples);
+
+    /* 古い係数側は残りの入力（フェード後は無音）を与えて残響を鳴らし切る */
+    for (smpl = 0; smpl < num_fade; smpl++) {
+        conv->input_buffer[smpl] = input[smpl] - conv->input_buffer[smpl];
+    }
+    memset(&conv->input_buffer[num_fade], 0, sizeof(float) * (num_samples - num_fade));
+    conv->conv_if->Convolve(active_obj, conv->input_buffer, output, num_samples);
+
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        output[smpl] += conv->fade_buffer[smpl];
+    }
+    conv->crossfade_pos += num_samples;
+
+    /* 古い側の残響が鳴り終わったら切り替え */
+    if (conv->crossfade_pos >= conv->swap_num_samples) {
+        AE2CrossfadeConvolve_CompleteSwap(conv);
+    }
+}
+
+/* 差し替えの完了 */
+static void AE2CrossfadeConvolve_CompleteSwap(struct AE2CrossfadeConvolve *conv)
+{
+    assert(conv != NULL);
+
+    /* 待機側を現用に切り替え */
+    conv->active ^= 1;
+    conv->crossfading = 0;
+
+    /* 古い側の使用を終えてから完了を通知 */
+    AE2CROSSFADECONVOLVE_MEMORY_BARRIER();
+    conv->completed = conv->requested;
+}
+
+/* レイテンシーの取得 */
+int32_t AE2CrossfadeConvolve_GetLatencyNumSamples(const struct AE2CrossfadeConvolve *conv)
+{
+    assert(conv != NULL);
+
+    /* 現用と待機は同じコンフィグなのでレイテンシも同じ */
+    return conv->conv_if->GetLatencyNumSamples(conv->conv_objs[conv->active]);
+}
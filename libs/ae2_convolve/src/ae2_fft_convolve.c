@@ -8,12 +8,12 @@
 #include "ae2_fft.h"
 #include "ae2_ring_buffer.h"
 
-/* FFT点数 */
-#define AE2FFTCONVOLVE_FFT_SIZE 2048
+/* 最小の分割サイズ */
+#define AE2FFTCONVOLVE_MIN_PARTITION_SIZE 16
 /* メモリアラインメント */
 #define AE2FFTCONVOLVE_ALIGNMENT 16
-/* ある整数が2の冪乗か判定. 0:2の冪乗ではない, それ以外:2の冪乗 */
-#define IS_POWER_OF_2(x) (!((x) & ((x) - 1)))
+/* 1回の複素乗算/加算でまとめて処理する最大分割数 */
+#define AE2FFTCONVOLVE_MAX_NUM_MULADD_PARTITIONS 4
 /* 最大値を取得 */
 #define MAX(a,b) (((a) > (b)) ? (a) : (b))
 /* 最小値を取得 */
@@ -21,6 +21,16 @@
 /* nの倍数切り上げ */
 #define ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
 
+/* 複数インスタンスで共有するフーリエ変換済み係数 */
+struct AE2FFTConvolveSharedCoefficients {
+    uint32_t fft_size; /* FFT点数 */
+    uint32_t partition_size; /* 係数の分割サイズ */
+    uint32_t num_coefficients; /* 係数長（分割サイズ単位に切り上げ済み） */
+    uint32_t num_partitions; /* 係数の分割数 */
+    uint32_t num_references; /* 参照しているインスタンス数 */
+    float *ir_freq; /* フーリエ変換済みのインパルス応答 配置はAE2FFTConvolveと同一 */
+};
+
 /* FFT畳み込み構造体 */
 struct AE2FFTConvolve {
     uint32_t fft_size; /* FFT点数 */
@@ -31,13 +41,15 @@ struct AE2FFTConvolve {
     uint32_t buffer_count; /* 入力バッファサンプル数カウント */
     uint32_t current_part; /* 現在処理中の分割 */
     uint32_t max_num_input_samples;	/* 最大入力サンプル数 */
-    float *ir_freq; /* フーリエ変換済みのインパルス応答 */
+    float *ir_freq; /* フーリエ変換済みのインパルス応答 分割毎に実部(partition_size)、虚部(partition_size)の順に並ぶ */
+    struct AE2FFTConvolveSharedCoefficients *shared; /* 参照している共有係数（NULLの場合はir_freqを自身で保持） */
     struct AE2RingBuffer *input_buffer; /* 入力データリングバッファ */
     struct AE2RingBuffer *output_buffer; /* 出力データリングバッファ */
-    struct AE2RingBuffer *freq_buffer; /* 周波数領域に変換したデータバッファ */
-    void *freq_buffer_work; /* データバッファのワーク領域先頭ポインタ */
-    float *work_buffer[2]; /* 複素数演算バッファ */
-    float *comp_muladd_buffer; /* 複素数乗算/加算計算結果バッファ */
+    float *freq_spectra; /* 周波数領域に変換した入力の遅延線 分割数分のスペクトルを巡回して使う。配置はir_freqと同一 */
+    uint32_t freq_write_pos; /* 次に新しいスペクトルを書き込む遅延線の位置 */
+    struct AE2FFTPlan *fft_plan; /* FFTプラン */
+    float *work_buffer; /* 複素数演算バッファ */
+    float *comp_muladd_buffer; /* 複素数乗算/加算計算結果バッファ 実部、虚部の順に並ぶ */
 };
 
 /* ワークサイズ計算 */
@@ -57,9 +69,17 @@ static int32_t AE2FFTConvolve_GetLatencyNumSamples(void *obj);
 
 /* 引数を2の冪乗に切り上げる */
 static uint32_t AE2FFTConvolve_Roundup2PoweredValue(uint32_t val);
-/* srcとcoefを複素乗算し、dstに足し込む */
-static void AE2FFTConvolve_MulAddSpectrum(
-        float *dst, const float *src, const float *coef, uint32_t num_complex);
+/* ワークサイズ計算（共通処理） */
+static int32_t AE2FFTConvolve_CalculateWorkSizeCore(const struct AE2ConvolveConfig *config, uint8_t has_coefficients);
+/* インスタンス生成（共通処理） */
+static struct AE2FFTConvolve *AE2FFTConvolve_CreateCore(
+        const struct AE2ConvolveConfig *config, struct AE2FFTConvolveSharedCoefficients *shared, void *work, int32_t work_size);
+/* 1分割分のFFT畳み込み */
+static void AE2FFTConvolve_ProcessPartition(struct AE2FFTConvolve *conv);
+/* 遅延線上のスペクトルと係数の分割partから降順にnum_spectra個を複素乗算し、複素乗算/加算結果バッファに足し込む */
+static void AE2FFTConvolve_MulAddSpectra(struct AE2FFTConvolve *conv, uint32_t part, uint32_t num_spectra);
+/* 現在処理中の分割からnum_partitions分の複素乗算/加算を行う */
+static void AE2FFTConvolve_MulAddPartitions(struct AE2FFTConvolve *conv, uint32_t num_partitions);
 
 /* インターフェース */
 static const struct AE2ConvolveInterface st_fft_convolve_if = {
@@ -72,9 +92,6 @@ static const struct AE2ConvolveInterface st_fft_convolve_if = {
     AE2FFTConvolve_GetLatencyNumSamples,
 };
 
-/* FFTのサイズチェック */
-extern char fft_size_check[IS_POWER_OF_2(AE2FFTCONVOLVE_FFT_SIZE) ? 1 : -1];
-
 /* インターフェース取得 */
 const struct AE2ConvolveInterface *AE2FFTConvolve_GetInterface(void)
 {
@@ -83,25 +100,36 @@ const struct AE2ConvolveInterface *AE2FFTConvolve_GetInterface(void)
 
 /* ワークサイズ計算 */
 static int32_t AE2FFTConvolve_CalculateWorkSize(const struct AE2ConvolveConfig *config)
+{
+    return AE2FFTConvolve_CalculateWorkSizeCore(config, 1);
+}
+
+/* 共有係数を参照するインスタンスのワークサイズ計算 */
+int32_t AE2FFTConvolve_CalculateSharedWorkSize(const struct AE2ConvolveConfig *config)
+{
+    return AE2FFTConvolve_CalculateWorkSizeCore(config, 0);
+}
+
+/* ワークサイズ計算（共通処理） */
+static int32_t AE2FFTConvolve_CalculateWorkSizeCore(const struct AE2ConvolveConfig *config, uint8_t has_coefficients)
 {
     int32_t work_size;
-    uint32_t fft_size, max_fft_size, max_num_partitions;
-    int32_t time_buffer_work_size, freq_buffer_work_size;
+    uint32_t partition_size, fft_size, max_num_partitions;
+    int32_t time_buffer_work_size, fft_plan_work_size;
     struct AE2RingBufferConfig buffer_config;
+    struct AE2FFTPlanConfig fft_plan_config;
 
     if (config == NULL) {
         return -1;
     }
 
     /* FFTサイズ */
-    fft_size = AE2FFTCONVOLVE_FFT_SIZE;
-
-    /* 最大のFFTサイズを取得 */
     /* 補足）2倍するのは巡回畳み込み対策。FFT畳み込み結果の半分は折り返している。 */
-    max_fft_size = MAX(fft_size, 2 * AE2FFTConvolve_Roundup2PoweredValue(config->max_num_coefficients));
+    partition_size = AE2FFTConvolve_CalculatePartitionSize(config);
+    fft_size = 2 * partition_size;
 
     /* 最大分割数の計算 */
-    max_num_partitions = max_fft_size / fft_size;
+    max_num_partitions = MAX(1, (AE2FFTConvolve_Roundup2PoweredValue(config->max_num_coefficients) + partition_size - 1) / partition_size);
 
     /* 入出力リングバッファの領域計算 */
     buffer_config.max_ndata = fft_size + config->max_num_input_samples;
@@ -113,79 +141,112 @@ static int32_t AE2FFTConvolve_CalculateWorkSize(const struct AE2ConvolveConfig *
         return -1;
     }
 
-    /* 周波数領域に変換したデータのバッファの領域計算 */
-    /* 係数設定時に係数長に合わせたサイズのリングバッファを再構築する */
-    buffer_config.max_ndata = max_num_partitions * fft_size;
-    buffer_config.max_required_ndata = fft_size;
-    buffer_config.data_unit_size = sizeof(float);
-    freq_buffer_work_size = AE2RingBuffer_CalculateWorkSize(&buffer_config);
-    if (freq_buffer_work_size < 0) {
+    /* FFTプランの領域計算 */
+    fft_plan_config.fft_size = (int32_t)fft_size;
+    fft_plan_config.type = AE2FFTPLAN_TYPE_REAL;
+    fft_plan_config.in_place = 0;
+    fft_plan_config.double_precision = 0;
+    fft_plan_work_size = AE2FFTPlan_CalculateWorkSize(&fft_plan_config);
+    if (fft_plan_work_size < 0) {
         return -1;
     }
 
     /* ハンドル領域分 */
     work_size = sizeof(struct AE2FFTConvolve) + AE2FFTCONVOLVE_ALIGNMENT;
-    /* フーリエ変換済みの係数領域分 */
-    work_size += sizeof(float) * max_num_partitions * fft_size + AE2FFTCONVOLVE_ALIGNMENT;
+    /* フーリエ変換済みの係数領域分（共有係数を参照する場合は不要） */
+    if (has_coefficients) {
+        work_size += sizeof(float) * max_num_partitions * fft_size + AE2FFTCONVOLVE_ALIGNMENT;
+    }
     /* 複素作業領域分 FFT点数分確保 */
-    work_size += 2 * (sizeof(float) * fft_size + AE2FFTCONVOLVE_ALIGNMENT);
+    work_size += (sizeof(float) * fft_size + AE2FFTCONVOLVE_ALIGNMENT);
     /* 複素乗算/加算作業領域分 FFT点数分確保 */
     work_size += (sizeof(float) * fft_size + AE2FFTCONVOLVE_ALIGNMENT);
     /* 入出力データバッファ分 */
     work_size += 2 * time_buffer_work_size;
-    /* 周波数領域に変換したデータのバッファ分 */
-    work_size += freq_buffer_work_size;
+    /* 周波数領域に変換した入力の遅延線分 */
+    work_size += sizeof(float) * max_num_partitions * fft_size + AE2FFTCONVOLVE_ALIGNMENT;
+    /* FFTプラン分 */
+    work_size += fft_plan_work_size;
 
     return work_size;
 }
 
 /* インスタンス生成 */
 static void* AE2FFTConvolve_Create(const struct AE2ConvolveConfig *config, void *work, int32_t work_size)
+{
+    return AE2FFTConvolve_CreateCore(config, NULL, work, work_size);
+}
+
+/* 共有係数を参照するインスタンス生成 */
+void *AE2FFTConvolve_CreateShared(const struct AE2ConvolveConfig *config,
+        struct AE2FFTConvolveSharedCoefficients *shared, void *work, int32_t work_size)
+{
+    if (shared == NULL) {
+        return NULL;
+    }
+
+    return AE2FFTConvolve_CreateCore(config, shared, work, work_size);
+}
+
+/* インスタンス生成（共通処理） */
+static struct AE2FFTConvolve *AE2FFTConvolve_CreateCore(
+        const struct AE2ConvolveConfig *config, struct AE2FFTConvolveSharedCoefficients *shared, void *work, int32_t work_size)
 {
     uint8_t *work_ptr = (uint8_t *)work;
     struct AE2FFTConvolve* conv;
-    uint32_t fft_size, max_fft_size, max_num_partitions;
-    int32_t buffer_work_size;
+    uint32_t partition_size, fft_size, max_num_partitions;
+    int32_t buffer_work_size, fft_plan_work_size;
     struct AE2RingBufferConfig buffer_config;
+    struct AE2FFTPlanConfig fft_plan_config;
 
     /* 引数チェック */
     if ((config == NULL) || (work == NULL)
-            || (work_size < AE2FFTConvolve_CalculateWorkSize(config))) {
+            || (work_size < AE2FFTConvolve_CalculateWorkSizeCore(config, (shared == NULL) ? 1 : 0))) {
         return NULL;
     }
 
     /* FFTサイズ */
-    fft_size = AE2FFTCONVOLVE_FFT_SIZE;
-
-    /* 最大のFFTサイズを取得 */
     /* 補足）2倍するのは巡回畳み込み対策。FFT畳み込み結果の半分は折り返している。 */
-    max_fft_size = MAX(fft_size, 2 * AE2FFTConvolve_Roundup2PoweredValue(config->max_num_coefficients));
+    partition_size = AE2FFTConvolve_CalculatePartitionSize(config);
+    fft_size = 2 * partition_size;
 
     /* 最大分割数の計算 */
-    max_num_partitions = max_fft_size / fft_size;
+    max_num_partitions = MAX(1, (AE2FFTConvolve_Roundup2PoweredValue(config->max_num_coefficients) + partition_size - 1) / partition_size);
+
+    /* 共有係数の分割が遅延線に収まるか確認 */
+    if ((shared != NULL)
+            && ((shared->partition_size != partition_size) || (shared->num_partitions > max_num_partitions))) {
+        return NULL;
+    }
 
     /* 構造体を配置 */
     work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
     conv = (struct AE2FFTConvolve *)work_ptr;
     conv->fft_size = fft_size;
-    conv->partition_size = fft_size / 2;
+    conv->partition_size = partition_size;
     conv->max_num_coefficients = AE2FFTConvolve_Roundup2PoweredValue(config->max_num_coefficients);
     conv->max_num_input_samples = config->max_num_input_samples;
-    conv->num_coefficients = fft_size / 2;
+    conv->num_coefficients = partition_size;
     conv->num_partitions = 1;
+    conv->shared = shared;
     work_ptr += sizeof(struct AE2FFTConvolve);
 
     /* 変換済み係数の割り当て */
-    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
-    conv->ir_freq = (float *)work_ptr;
-    work_ptr += sizeof(float) * max_num_partitions * fft_size;
+    if (shared == NULL) {
+        work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
+        conv->ir_freq = (float *)work_ptr;
+        work_ptr += sizeof(float) * max_num_partitions * fft_size;
+    } else {
+        /* 共有係数を参照 */
+        conv->ir_freq = shared->ir_freq;
+        conv->num_coefficients = shared->num_coefficients;
+        conv->num_partitions = shared->num_partitions;
+        shared->num_references++;
+    }
 
     /* 作業領域の割り当て */
     work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
-    conv->work_buffer[0] = (float *)work_ptr;
-    work_ptr += sizeof(float) * fft_size;
-    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
-    conv->work_buffer[1] = (float *)work_ptr;
+    conv->work_buffer = (float *)work_ptr;
     work_ptr += sizeof(float) * fft_size;
     work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
     conv->comp_muladd_buffer = (float *)work_ptr;
@@ -205,18 +266,24 @@ static void* AE2FFTConvolve_Create(const struct AE2ConvolveConfig *config, void
     conv->output_buffer = AE2RingBuffer_Create(&buffer_config, work_ptr, buffer_work_size);
     work_ptr += buffer_work_size;
 
-    /* 周波数領域に変換したデータバッファ */
-    /* 係数設定時に係数長に合わせたサイズのリングバッファを再構築する */
-    buffer_config.max_ndata = max_num_partitions * fft_size;
-    buffer_config.max_required_ndata = fft_size;
-    buffer_config.data_unit_size = sizeof(float);
-    buffer_work_size = AE2RingBuffer_CalculateWorkSize(&buffer_config);
-    if (buffer_work_size < 0) {
+    /* 周波数領域に変換した入力の遅延線 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
+    conv->freq_spectra = (float *)work_ptr;
+    work_ptr += sizeof(float) * max_num_partitions * fft_size;
+
+    /* FFTプラン */
+    fft_plan_config.fft_size = (int32_t)fft_size;
+    fft_plan_config.type = AE2FFTPLAN_TYPE_REAL;
+    fft_plan_config.in_place = 0;
+    fft_plan_config.double_precision = 0;
+    fft_plan_work_size = AE2FFTPlan_CalculateWorkSize(&fft_plan_config);
+    if (fft_plan_work_size < 0) {
         return NULL;
     }
-    conv->freq_buffer_work = work_ptr;
-    conv->freq_buffer = AE2RingBuffer_Create(&buffer_config, work_ptr, buffer_work_size);
-    work_ptr += buffer_work_size;
+    if ((conv->fft_plan = AE2FFTPlan_Create(&fft_plan_config, work_ptr, fft_plan_work_size)) == NULL) {
+        return NULL;
+    }
+    work_ptr += fft_plan_work_size;
 
     /* バッファをリセット */
     AE2FFTConvolve_Reset(conv);
@@ -233,22 +300,28 @@ static void AE2FFTConvolve_Destroy(void *obj)
         /* リングバッファを破棄 */
         AE2RingBuffer_Destroy(conv->input_buffer);
         AE2RingBuffer_Destroy(conv->output_buffer);
-        AE2RingBuffer_Destroy(conv->freq_buffer);
+        /* FFTプランを破棄 */
+        AE2FFTPlan_Destroy(conv->fft_plan);
+        /* 共有係数の参照を解放 */
+        if (conv->shared != NULL) {
+            assert(conv->shared->num_references > 0);
+            conv->shared->num_references--;
+            conv->shared = NULL;
+        }
     }
 }
 
 /* 係数セット */
 static void AE2FFTConvolve_SetCoefficients(void *obj, const float *coefficients, uint32_t num_coefficients)
 {
-    uint32_t smpl, i;
     struct AE2FFTConvolve *conv = (struct AE2FFTConvolve *)obj;
-    float norm_factor_inverse;
-    struct AE2RingBufferConfig buffer_config;
-    int32_t buffer_work_size;
 
     /* 引数チェック */
     assert((obj != NULL) && (coefficients != NULL));
 
+    /* 共有係数は読み取り専用 */
+    assert(conv->shared == NULL);
+
     /* 係数サイズチェック */
     assert(num_coefficients <= conv->max_num_coefficients);
 
@@ -257,36 +330,166 @@ static void AE2FFTConvolve_SetCoefficients(void *obj, const float *coefficients,
     /* 分割数の再計算 */
     conv->num_partitions = conv->num_coefficients / conv->partition_size;
 
+    /* 分割毎にFFT */
+    AE2FFTConvolve_TransformCoefficients(conv->fft_plan, conv->work_buffer,
+            conv->partition_size, coefficients, num_coefficients, conv->ir_freq);
+
+    /* 内部バッファリセット（遅延線は分割数分を巡回して使う） */
+    AE2FFTConvolve_Reset(conv);
+}
+
+/* 係数を分割毎にフーリエ変換してir_freqに格納
+* work_bufferは2 * partition_size必須 */
+void AE2FFTConvolve_TransformCoefficients(struct AE2FFTPlan *fft_plan, float *work_buffer,
+        uint32_t partition_size, const float *coefficients, uint32_t num_coefficients, float *ir_freq)
+{
+    uint32_t smpl, i;
+    const uint32_t fft_size = 2 * partition_size;
+    const float norm_factor_inverse = 2.0f / (float)fft_size;
+
     /* 後半0埋めを行いつつFFT */
-    norm_factor_inverse = 2.0f / conv->fft_size;
-    for (smpl = 0; smpl < conv->num_coefficients; smpl += conv->partition_size) {
-        const uint32_t copy_samples = MIN(conv->partition_size, num_coefficients - smpl);
+    for (smpl = 0; smpl < num_coefficients; smpl += partition_size) {
+        const uint32_t copy_samples = MIN(partition_size, num_coefficients - smpl);
         /* 一旦0埋め（後半部分の0埋めを兼ねる） */
-        memset(conv->work_buffer[0], 0, sizeof(float) * conv->fft_size);
+        memset(work_buffer, 0, sizeof(float) * fft_size);
         /* 係数コピー */
-        memcpy(conv->work_buffer[0], &coefficients[smpl], sizeof(float) * copy_samples);
+        memcpy(work_buffer, &coefficients[smpl], sizeof(float) * copy_samples);
         /* 変換前に正規化 */
         for (i = 0; i < copy_samples; i++) {
-            conv->work_buffer[0][i] *= norm_factor_inverse;
+            work_buffer[i] *= norm_factor_inverse;
         }
-        /* 係数をFFT */
-        AE2FFT_RealFFT((int)conv->fft_size, -1, conv->work_buffer[0], conv->work_buffer[1]);
-        /* 結果をコピー */
-        memcpy(&conv->ir_freq[2 * smpl], conv->work_buffer[0], sizeof(float) * conv->fft_size);
+        /* 係数をFFTし、結果を実部と虚部に分けて格納 */
+        AE2FFTPlan_SplitRealFFT(fft_plan, work_buffer,
+                &ir_freq[2 * smpl], &ir_freq[2 * smpl + partition_size]);
     }
+}
 
-    /* 周波数領域に変換したデータバッファを再構築 */
-    AE2RingBuffer_Destroy(conv->freq_buffer);
-    buffer_config.max_ndata = conv->num_partitions * conv->fft_size;
-    buffer_config.max_required_ndata = conv->fft_size;
-    buffer_config.data_unit_size = sizeof(float);
-    buffer_work_size = AE2RingBuffer_CalculateWorkSize(&buffer_config);
-    assert(buffer_work_size > 0);
-    conv->freq_buffer = AE2RingBuffer_Create(&buffer_config, conv->freq_buffer_work, buffer_work_size);
-    assert(conv->freq_buffer != NULL);
+/* 共有係数作成に必要なワークサイズ計算 */
+int32_t AE2FFTConvolve_CalculateSharedCoefficientsWorkSize(const struct AE2ConvolveConfig *config)
+{
+    int32_t work_size, fft_plan_work_size;
+    uint32_t partition_size, fft_size, max_num_partitions;
+    struct AE2FFTPlanConfig fft_plan_config;
 
-    /* 内部バッファリセット */
-    AE2FFTConvolve_Reset(conv);
+    if (config == NULL) {
+        return -1;
+    }
+
+    partition_size = AE2FFTConvolve_CalculatePartitionSize(config);
+    fft_size = 2 * partition_size;
+    max_num_partitions = MAX(1, (AE2FFTConvolve_Roundup2PoweredValue(config->max_num_coefficients) + partition_size - 1) / partition_size);
+
+    /* 変換に使うFFTプランの領域計算 */
+    fft_plan_config.fft_size = (int32_t)fft_size;
+    fft_plan_config.type = AE2FFTPLAN_TYPE_REAL;
+    fft_plan_config.in_place = 0;
+    fft_plan_config.double_precision = 0;
+    fft_plan_work_size = AE2FFTPlan_CalculateWorkSize(&fft_plan_config);
+    if (fft_plan_work_size < 0) {
+        return -1;
+    }
+
+    /* ハンドル領域分 */
+    work_size = sizeof(struct AE2FFTConvolveSharedCoefficients) + AE2FFTCONVOLVE_ALIGNMENT;
+    /* フーリエ変換済みの係数領域分 */
+    work_size += sizeof(float) * max_num_partitions * fft_size + AE2FFTCONVOLVE_ALIGNMENT;
+    /* 変換用の作業領域分 */
+    work_size += sizeof(float) * fft_size + AE2FFTCONVOLVE_ALIGNMENT;
+    /* FFTプラン分 */
+    work_size += fft_plan_work_size;
+
+    return work_size;
+}
+
+/* 共有係数作成 */
+struct AE2FFTConvolveSharedCoefficients *AE2FFTConvolve_CreateSharedCoefficients(
+        const struct AE2ConvolveConfig *config, const float *coefficients, uint32_t num_coefficients,
+        void *work, int32_t work_size)
+{
+    uint8_t *work_ptr = (uint8_t *)work;
+    struct AE2FFTConvolveSharedCoefficients *shared;
+    struct AE2FFTPlan *fft_plan;
+    struct AE2FFTPlanConfig fft_plan_config;
+    uint32_t partition_size, fft_size, max_num_partitions;
+    int32_t fft_plan_work_size;
+    float *work_buffer;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL) || ((coefficients == NULL) && (num_coefficients > 0))
+            || (work_size < AE2FFTConvolve_CalculateSharedCoefficientsWorkSize(config))) {
+        return NULL;
+    }
+
+    partition_size = AE2FFTConvolve_CalculatePartitionSize(config);
+    fft_size = 2 * partition_size;
+    max_num_partitions = MAX(1, (AE2FFTConvolve_Roundup2PoweredValue(config->max_num_coefficients) + partition_size - 1) / partition_size);
+
+    /* 係数サイズチェック */
+    if (num_coefficients > AE2FFTConvolve_Roundup2PoweredValue(config->max_num_coefficients)) {
+        return NULL;
+    }
+
+    /* 構造体を配置 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
+    shared = (struct AE2FFTConvolveSharedCoefficients *)work_ptr;
+    shared->fft_size = fft_size;
+    shared->partition_size = partition_size;
+    /* 係数がない場合も0の分割を1つ持たせる */
+    shared->num_coefficients = MAX(partition_size, ROUNDUP(num_coefficients, partition_size));
+    shared->num_partitions = shared->num_coefficients / partition_size;
+    shared->num_references = 0;
+    work_ptr += sizeof(struct AE2FFTConvolveSharedCoefficients);
+
+    /* 変換済み係数の割り当て */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
+    shared->ir_freq = (float *)work_ptr;
+    work_ptr += sizeof(float) * max_num_partitions * fft_size;
+
+    /* 作業領域の割り当て */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2FFTCONVOLVE_ALIGNMENT);
+    work_buffer = (float *)work_ptr;
+    work_ptr += sizeof(float) * fft_size;
+
+    /* FFTプラン（変換時のみ使用） */
+    fft_plan_config.fft_size = (int32_t)fft_size;
+    fft_plan_config.type = AE2FFTPLAN_TYPE_REAL;
+    fft_plan_config.in_place = 0;
+    fft_plan_config.double_precision = 0;
+    fft_plan_work_size = AE2FFTPlan_CalculateWorkSize(&fft_plan_config);
+    if (fft_plan_work_size < 0) {
+        return NULL;
+    }
+    if ((fft_plan = AE2FFTPlan_Create(&fft_plan_config, work_ptr, fft_plan_work_size)) == NULL) {
+        return NULL;
+    }
+    work_ptr += fft_plan_work_size;
+
+    /* 分割毎にFFT（係数がない分割は0） */
+    memset(shared->ir_freq, 0, sizeof(float) * shared->num_partitions * fft_size);
+    if (num_coefficients > 0) {
+        AE2FFTConvolve_TransformCoefficients(fft_plan, work_buffer,
+                partition_size, coefficients, num_coefficients, shared->ir_freq);
+    }
+
+    AE2FFTPlan_Destroy(fft_plan);
+
+    return shared;
+}
+
+/* 共有係数破棄 */
+void AE2FFTConvolve_DestroySharedCoefficients(struct AE2FFTConvolveSharedCoefficients *shared)
+{
+    if (shared != NULL) {
+        /* 参照しているインスタンスを先に破棄すること */
+        assert(shared->num_references == 0);
+    }
+}
+
+/* 共有係数を参照しているインスタンス数の取得 */
+uint32_t AE2FFTConvolve_GetSharedCoefficientsNumReferences(const struct AE2FFTConvolveSharedCoefficients *shared)
+{
+    assert(shared != NULL);
+    return shared->num_references;
 }
 
 /* 畳み込み計算 */
@@ -314,119 +517,150 @@ static void AE2FFTConvolve_Convolve(void *obj, const float *input, float *output
         goal_part = MIN(goal_part, conv->num_partitions);
 
         /* 周波数領域で複素乗算/加算 */
-        for (; conv->current_part < goal_part; conv->current_part++) {
-            /* バッファ先頭からは最も古い結果が取れるので、係数末尾から畳み込みを行う */
-            const uint32_t part_offset = (conv->num_partitions - conv->current_part) * conv->fft_size;
-            /* 周波数バッファを取り出す */
-            AE2RingBuffer_Get(conv->freq_buffer, &buffer_ptr, conv->fft_size);
-            AE2FFTConvolve_MulAddSpectrum(conv->comp_muladd_buffer,
-                    (const float *)buffer_ptr, &conv->ir_freq[part_offset], conv->partition_size);
-            /* バッファ末尾に再挿入 */
-            AE2RingBuffer_Put(conv->freq_buffer, buffer_ptr, conv->fft_size);
+        if (conv->current_part < goal_part) {
+            AE2FFTConvolve_MulAddPartitions(conv, goal_part - conv->current_part);
         }
     }
 
     /* FFT点数/2毎にFFT畳み込み処理を実行し、出力バッファに結果を書き出す */
     /* FFT点数/2が入力サンプル数よりも小さい場合があるので、入力サンプル分を消費するまでwhileで回す */
     while (conv->buffer_count >= conv->fft_size) {
-        /* 残った分の複素乗算/加算を実行 */
-        for (; conv->current_part < conv->num_partitions; conv->current_part++) {
-            const uint32_t part_offset = (conv->num_partitions - conv->current_part) * conv->fft_size;
-            AE2RingBuffer_Get(conv->freq_buffer, &buffer_ptr, conv->fft_size);
-            AE2FFTConvolve_MulAddSpectrum(conv->comp_muladd_buffer,
-                    (const float *)buffer_ptr, &conv->ir_freq[part_offset], conv->partition_size);
-            AE2RingBuffer_Put(conv->freq_buffer, buffer_ptr, conv->fft_size);
-        }
+        /* 1分割分のFFT畳み込み */
+        AE2FFTConvolve_ProcessPartition(conv);
+
+        /* 結果を出力バッファに書き出す */
+        /* FFT畳み込みで有効なのは結果後半のみ（直線畳み込み）。後半のみ出力バッファに書き出す */
+        AE2RingBuffer_Put(conv->output_buffer, &conv->work_buffer[conv->fft_size / 2], conv->fft_size / 2);
+    }
+
+    /* 出力バッファから取り出し */
+    AE2RingBuffer_Get(conv->output_buffer, &buffer_ptr, num_samples);
+    memcpy(output, buffer_ptr, num_samples * sizeof(float));
+}
 
-        /* 入力バッファからFFTサイズ分データを取り出し */
-        /* FFT点数/2だけバッファを進めるため、取り出しサイズは conv->fft_size / 2 */
-        AE2RingBuffer_Get(conv->input_buffer, &buffer_ptr, conv->fft_size / 2);
-        memcpy(conv->work_buffer[0], buffer_ptr, sizeof(float) * conv->fft_size); /* 注: 取得するのはfreqbuffer_unit_size */
+/* 1分割分のFFT畳み込み
+* 入力バッファにFFT点数分のデータが溜まっていること。結果はwork_bufferの後半に入る */
+static void AE2FFTConvolve_ProcessPartition(struct AE2FFTConvolve *conv)
+{
+    void *buffer_ptr;
+    float *spectrum;
 
-        /* FFT */
-        AE2FFT_RealFFT((int)conv->fft_size, -1, conv->work_buffer[0], conv->work_buffer[1]);
+    assert(conv != NULL);
+    assert(conv->buffer_count >= conv->fft_size);
 
-        /* 結果を周波数バッファに入力（一番古いデータは消去） */
-        AE2RingBuffer_Get(conv->freq_buffer, &buffer_ptr, conv->fft_size);
-        AE2RingBuffer_Put(conv->freq_buffer, conv->work_buffer[0], conv->fft_size);
+    /* 残った分の複素乗算/加算を実行 */
+    if (conv->current_part < conv->num_partitions) {
+        AE2FFTConvolve_MulAddPartitions(conv, conv->num_partitions - conv->current_part);
+    }
 
-        /* 係数先頭分を複素乗算/加算 */
-        AE2FFTConvolve_MulAddSpectrum(conv->comp_muladd_buffer, conv->work_buffer[0], &conv->ir_freq[0], conv->partition_size);
+    /* 入力バッファからFFTサイズ分データを取り出し */
+    /* FFT点数/2だけバッファを進めるため、取り出しサイズは conv->fft_size / 2 */
+    AE2RingBuffer_Get(conv->input_buffer, &buffer_ptr, conv->fft_size / 2);
 
-        /* IFFT */
-        AE2FFT_RealFFT((int)conv->fft_size, 1, conv->comp_muladd_buffer, conv->work_buffer[1]);
+    /* FFTし、結果を遅延線に直接書き込む（一番古いスペクトルを上書き） */
+    spectrum = &conv->freq_spectra[conv->freq_write_pos * conv->fft_size];
+    AE2FFTPlan_SplitRealFFT(conv->fft_plan, (const float *)buffer_ptr,
+            &spectrum[0], &spectrum[conv->partition_size]);
 
-        /* 結果を出力バッファに書き出す */
-        /* FFT畳み込みで有効なのは結果後半のみ（直線畳み込み）。後半のみ出力バッファに書き出す */
-        AE2RingBuffer_Put(conv->output_buffer, &conv->comp_muladd_buffer[conv->fft_size / 2], conv->fft_size / 2);
+    /* 係数先頭分を複素乗算/加算 */
+    AE2FFTConvolve_MulAddSpectra(conv, 0, 1);
+
+    /* 遅延線の書き込み位置を進める */
+    conv->freq_write_pos = (conv->freq_write_pos + 1) % conv->num_partitions;
+
+    /* IFFT（周波数バッファへの挿入が済んだ作業バッファに書き出す） */
+    AE2FFTPlan_SplitRealIFFT(conv->fft_plan,
+            &conv->comp_muladd_buffer[0], &conv->comp_muladd_buffer[conv->partition_size], conv->work_buffer);
+
+    /* 複素数乗算/加算結果バッファをクリア */
+    memset(conv->comp_muladd_buffer, 0, sizeof(float) * conv->fft_size);
+
+    /* バッファデータ数を削減 */
+    conv->buffer_count -= conv->fft_size / 2;
+
+    /* 現在処理中の分割をリセット */
+    conv->current_part = 1;
+}
+
+/* 分割サイズ単位の畳み込み */
+void AE2FFTConvolve_ConvolveBlock(void *obj, const float *input, float *output)
+{
+    struct AE2FFTConvolve *conv = (struct AE2FFTConvolve *)obj;
+
+    /* 引数チェック */
+    assert((obj != NULL) && (input != NULL) && (output != NULL));
 
-        /* 複素数乗算/加算結果バッファをクリア */
-        memset(conv->comp_muladd_buffer, 0, sizeof(float) * conv->fft_size);
+    /* 入力のバッファリング */
+    AE2RingBuffer_Put(conv->input_buffer, input, conv->partition_size);
+    conv->buffer_count += conv->partition_size;
+
+    /* 分割境界で呼ばれているので、ちょうどFFT点数分溜まっている */
+    assert(conv->buffer_count == conv->fft_size);
+    AE2FFTConvolve_ProcessPartition(conv);
 
-        /* バッファデータ数を削減 */
-        conv->buffer_count -= conv->fft_size / 2;
+    /* 出力バッファを経由せず直接書き出す */
+    memcpy(output, &conv->work_buffer[conv->fft_size / 2], sizeof(float) * (conv->fft_size / 2));
+}
 
-        /* 現在処理中の分割をリセット */
-        conv->current_part = 1;
+/* 遅延線上のスペクトルと係数の分割partから降順にnum_spectra個を複素乗算し、複素乗算/加算結果バッファに足し込む
+* 係数の分割qには、書き込み位置からq個遡ったスペクトルを掛ける（分割0は書き込み位置のスペクトル） */
+static void AE2FFTConvolve_MulAddSpectra(struct AE2FFTConvolve *conv, uint32_t part, uint32_t num_spectra)
+{
+    uint32_t k;
+    const float *spectra[AE2FFTCONVOLVE_MAX_NUM_MULADD_PARTITIONS];
+    const float *coefs[AE2FFTCONVOLVE_MAX_NUM_MULADD_PARTITIONS];
+
+    assert(num_spectra <= AE2FFTCONVOLVE_MAX_NUM_MULADD_PARTITIONS);
+    assert(part + 1 >= num_spectra);
+    assert(part < conv->num_partitions);
+
+    for (k = 0; k < num_spectra; k++) {
+        const uint32_t pos = (conv->freq_write_pos + conv->num_partitions - (part - k)) % conv->num_partitions;
+        spectra[k] = &conv->freq_spectra[pos * conv->fft_size];
+        coefs[k] = &conv->ir_freq[(part - k) * conv->fft_size];
     }
 
-    /* 出力バッファから取り出し */
-    AE2RingBuffer_Get(conv->output_buffer, &buffer_ptr, num_samples);
-    memcpy(output, buffer_ptr, num_samples * sizeof(float));
+    /* 複数分割の積をまとめて加算 */
+    AE2FFTPlan_SplitRealSpectrumMulAddMultiple(conv->fft_plan,
+            (int32_t)num_spectra, spectra, coefs, conv->comp_muladd_buffer);
 }
 
-/* srcとcoefを複素乗算し、dstに足し込む */
-static void AE2FFTConvolve_MulAddSpectrum(
-        float *dst, const float *src, const float *coef, uint32_t num_complex)
+/* 現在処理中の分割からnum_partitions分の複素乗算/加算を行う */
+static void AE2FFTConvolve_MulAddPartitions(struct AE2FFTConvolve *conv, uint32_t num_partitions)
 {
-    uint32_t cmplx;
-    float src_re, src_im, coef_re, coef_im;
-    float re, im;
-
-    /* 先頭の1複素数(float配列2要素)は直流成分と最高周波数成分の実部 */
-    dst[0] += src[0] * coef[0];
-    dst[1] += src[1] * coef[1];
-
-    /* それ以降の要素は複素数が入っている */
-    for (cmplx = 1; cmplx < num_complex; cmplx++) {
-        src_re = AE2FFTCOMPLEX_REAL(src, cmplx); src_im = AE2FFTCOMPLEX_IMAG(src, cmplx);
-        coef_re = AE2FFTCOMPLEX_REAL(coef, cmplx); coef_im = AE2FFTCOMPLEX_IMAG(coef, cmplx);
-        /* 複素乗算 */
-        re = src_re * coef_re - src_im * coef_im;
-        im = src_im * coef_re + src_re * coef_im;
-        /* バッファに加算 */
-        AE2FFTCOMPLEX_REAL(dst, cmplx) += re;
-        AE2FFTCOMPLEX_IMAG(dst, cmplx) += im;
+    assert(conv->current_part + num_partitions <= conv->num_partitions);
+
+    while (num_partitions > 0) {
+        const uint32_t num_process = MIN(num_partitions, AE2FFTCONVOLVE_MAX_NUM_MULADD_PARTITIONS);
+        /* 係数末尾（最も古いスペクトル）から畳み込みを行う */
+        AE2FFTConvolve_MulAddSpectra(conv, conv->num_partitions - conv->current_part, num_process);
+        conv->current_part += num_process;
+        num_partitions -= num_process;
     }
 }
 
 /* 内部状態リセット */
 static void AE2FFTConvolve_Reset(void *obj)
 {
-    uint32_t part;
     struct AE2FFTConvolve *conv = (struct AE2FFTConvolve *)obj;
     const uint32_t fft_buffer_size = sizeof(float) * conv->fft_size;
 
     /* 作業領域をクリア */
-    memset(conv->work_buffer[0], 0, fft_buffer_size);
-    memset(conv->work_buffer[1], 0, fft_buffer_size);
+    memset(conv->work_buffer, 0, fft_buffer_size);
     memset(conv->comp_muladd_buffer, 0, fft_buffer_size);
 
     /* リングバッファをリセット */
     AE2RingBuffer_Clear(conv->input_buffer);
     AE2RingBuffer_Clear(conv->output_buffer);
-    AE2RingBuffer_Clear(conv->freq_buffer);
 
     /* リングバッファに無音を挿入 */
     /* 補足）最初のFFT点数/2の分はFFTを行うまで出力できないため、無音を入れておく */
-    AE2RingBuffer_Put(conv->input_buffer,  conv->work_buffer[0], conv->fft_size / 2);
-    AE2RingBuffer_Put(conv->output_buffer, conv->work_buffer[0], conv->fft_size / 2);
+    AE2RingBuffer_Put(conv->input_buffer,  conv->work_buffer, conv->fft_size / 2);
+    AE2RingBuffer_Put(conv->output_buffer, conv->work_buffer, conv->fft_size / 2);
 
-    /* 周波数領域に変換したデータに0を詰める */
-    /* 補足）初回の分割での入力がバッファ末尾に入る様に、分割数-1までを全て0で埋める */
-    for (part = 0; part < conv->num_partitions - 1; part++) {
-        AE2RingBuffer_Put(conv->freq_buffer, conv->work_buffer[0], conv->fft_size);
-    }
+    /* 周波数領域に変換した入力の遅延線を0で埋める */
+    memset(conv->freq_spectra, 0, fft_buffer_size * conv->num_partitions);
+    conv->freq_write_pos = 0;
 
     /* 入力カウントをリセット */
     conv->buffer_count = conv->fft_size / 2;
@@ -444,6 +678,37 @@ static int32_t AE2FFTConvolve_GetLatencyNumSamples(void *obj)
     return (int32_t)conv->partition_size;
 }
 
+/* 分割サイズの計算 */
+uint32_t AE2FFTConvolve_CalculatePartitionSize(const struct AE2ConvolveConfig *config)
+{
+    uint32_t size, tmp;
+
+    assert(config != NULL);
+
+    /* 指定がなければ最大入力サンプル数に合わせる（1回の入力でちょうど1回FFTが走る） */
+    size = (config->partition_size > 0) ? config->partition_size : config->max_num_input_samples;
+    size = MAX(size, AE2FFTCONVOLVE_MIN_PARTITION_SIZE);
+
+    /* FFTプランが扱える2, 3, 5の積で表せる値に切り上げる */
+    for (;; size++) {
+        tmp = size;
+        while ((tmp % 2) == 0) {
+            tmp /= 2;
+        }
+        while ((tmp % 3) == 0) {
+            tmp /= 3;
+        }
+        while ((tmp % 5) == 0) {
+            tmp /= 5;
+        }
+        if (tmp == 1) {
+            break;
+        }
+    }
+
+    return size;
+}
+
 /* 2の冪乗に切り上げ */
 static uint32_t AE2FFTConvolve_Roundup2PoweredValue(uint32_t val)
 {
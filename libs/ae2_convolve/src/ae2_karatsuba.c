@@ -3,7 +3,15 @@
 #include <assert.h>
 #include <string.h>
 
+#include "ae2_karatsuba_kernel.h"
+
+#if defined(AE2KARATSUBA_USE_X86_SIMD) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 #define AE2KARATSUBA_ALIGNMENT 16
+/* 分割の最大段数（2の冪乗のサイズを基底サイズまで半分にしていく回数の上限） */
+#define AE2KARATSUBA_MAX_NUM_STAGES 32
 
 /* 2値のうちの最大を取る */
 #define MAX(x,y) (((x) > (y)) ? (x) : (y))
@@ -18,6 +26,16 @@ struct AE2Karatsuba {
     float *work_buffer; /* 計算用ワークバッファ */
     int32_t output_buffer_pos; /* 出力バッファ参照位置 */
     uint32_t max_num_coefficients; /* 最大の畳み込み係数サイズ */
+    const struct AE2KaratsubaKernel *kernel; /* 直接畳み込みカーネル */
+};
+
+/* 分割途中の畳み込み（再帰を使わずに走査するためのスタック要素） */
+struct AE2KaratsubaStage {
+    const float *a; /* 被乗数 */
+    const float *b; /* 乗数 */
+    float *z; /* 結果および計算領域（サイズ6n） */
+    uint32_t n; /* サイズ */
+    uint32_t step; /* 次に計算する部分積（0: a0 * b0, 1: a1 * b1, 2: (a1 + a0) * (b1 + b0), 3: 合成） */
 };
 
 /* ワークサイズ計算 */
@@ -34,12 +52,12 @@ static void AE2Karatsuba_SetCoefficients(void *obj, const float *coefficients, u
 static void AE2Karatsuba_Convolve(void *obj, const float *input, float *output, uint32_t num_samples);
 /* レイテンシーの取得 */
 static int32_t AE2Karatsuba_GetLatencyNumSamples(void *obj);
-/* ナイーブな畳込み */
-/* z = a * b zはサイズ2n */
-static void AE2Karatsuba_ConvolveNaive(const float *a, const float *b, float *z, uint32_t n);
 /* カラツバ法による畳込み */
 /* zはサイズ6n 先頭2nに結果が入る */
-static void AE2Karatsuba_ConvolveKaratsuba(const float *a, const float *b, float *z, uint32_t n);
+static void AE2Karatsuba_ConvolveKaratsuba(
+        const struct AE2KaratsubaKernel *kernel, const float *a, const float *b, float *z, uint32_t n);
+/* 実行環境で使用可能な最速のカーネルを選択 */
+static const struct AE2KaratsubaKernel *AE2Karatsuba_SelectKernel(void);
 /* 2の冪乗に切り上げ */
 static uint32_t AE2Karatsuba_Roundup2PoweredValue(uint32_t val);
 
@@ -103,6 +121,7 @@ static void* AE2Karatsuba_Create(const struct AE2ConvolveConfig *config, void *w
     conv->num_coefficients = 0;
     conv->output_buffer_pos = 0;
     conv->max_num_coefficients = max_num_block_samples;
+    conv->kernel = AE2Karatsuba_SelectKernel();
     work_ptr += sizeof(struct AE2Karatsuba);
 
     /* 係数領域の割り当て */
@@ -187,8 +206,8 @@ static void AE2Karatsuba_Convolve(void *obj, const float *input, float *output,
     }
 
     /* 畳み込み計算 */
-    AE2Karatsuba_ConvolveKaratsuba(conv->input_buffer,
-            conv->coefficients, conv->work_buffer, conv_size);
+    AE2Karatsuba_ConvolveKaratsuba(conv->kernel,
+            conv->input_buffer, conv->coefficients, conv->work_buffer, conv_size);
 
     /* 先頭のnum_samplesは前回の余りを加算してそのまま出力 */
     for (smpl = 0; smpl < num_samples; smpl++) {
@@ -242,7 +261,7 @@ static int32_t AE2Karatsuba_GetLatencyNumSamples(void *obj)
 
 /* 素朴な直線畳込み */
 /* z = a * b zはサイズ2n */
-static void AE2Karatsuba_ConvolveNaive(const float *a, const float *b, float *z, uint32_t n)
+void AE2Karatsuba_DirectConvolveScalar(const float *a, const float *b, float *z, uint32_t n)
 {
     uint32_t i, j;
 
@@ -259,55 +278,161 @@ static void AE2Karatsuba_ConvolveNaive(const float *a, const float *b, float *z,
     }
 }
 
-/* カラツバ法による畳込み */
-/* zはサイズ6n 先頭2nに結果が入る */
-static void AE2Karatsuba_ConvolveKaratsuba(const float *a, const float *b, float *z, uint32_t n)
+/* スカラーカーネル */
+/* 基底サイズ8はae2_karatsuba_bench（BUILD_AE2_BENCHMARKS）の計測で、n = 64〜1024の全サイズで最速 */
+static const struct AE2KaratsubaKernel st_scalar_kernel = {
+    "scalar",
+    8,
+    AE2Karatsuba_DirectConvolveScalar,
+};
+
+/* スカラーカーネルの取得 */
+const struct AE2KaratsubaKernel *AE2KaratsubaKernel_GetScalar(void)
 {
-    uint32_t i;
-    const uint32_t  n2 = n >> 1;
-    const float     *a0 = &a[0];        /* 被乗数/右側配列ポインタ        */
-    const float     *a1 = &a[n2];       /* 被乗数/左側配列ポインタ        */
-    const float     *b0 = &b[0];        /* 乗数  /右側配列ポインタ        */
-    const float     *b1 = &b[n2];       /* 乗数  /左側配列ポインタ        */
-    float     *x1 = &z[n * 0];          /* x1 (= a0 * b0) 用配列ポインタ  */
-    float     *x2 = &z[n * 1];          /* x2 (= a1 * b1) 用配列ポインタ  */
-    float     *x3 = &z[n * 2];          /* x3 (= v * w)   用配列ポインタ  */
-    float     *v  = &z[n * 5];          /* v  (= a1 + a0) 用配列ポインタ  */
-    float     *w  = &z[n * 5 + n2];     /* w  (= b1 + b0) 用配列ポインタ  */
-
-    /* サイズが8以下の場合は通常の畳込みを行う */
-    if (n <= 8) {
-        assert(n == 8);
-        AE2Karatsuba_ConvolveNaive(a, b, z, 8);
-        return;
-    }
+    return &st_scalar_kernel;
+}
 
-    /* v = a1 + a0, w = b1 + b0 */
-    for(i = 0; i < n2; i++) {
-        v[i] = a1[i] + a0[i];
-        w[i] = b1[i] + b0[i];
+/* CPUがAVX2とFMAをサポートしているか（OSによるYMMレジスタの退避も確認） */
+static int AE2Karatsuba_CPUSupportsAVX2FMA(void)
+{
+#if defined(AE2KARATSUBA_USE_X86_SIMD) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return 0;
+    }
+    /* OSXSAVE, AVX, FMA */
+    __cpuid(info, 1);
+    if (((info[2] >> 27) & 1) == 0 || ((info[2] >> 28) & 1) == 0 || ((info[2] >> 12) & 1) == 0) {
+        return 0;
+    }
+    /* OSがXMM/YMMの状態を保存するか */
+    if ((_xgetbv(0) & 0x6) != 0x6) {
+        return 0;
     }
+    /* AVX2 */
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+#elif defined(AE2KARATSUBA_USE_X86_SIMD) && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return 0;
+#endif
+}
 
-    /* x1 = a0 * b0 */
-    AE2Karatsuba_ConvolveKaratsuba(a0, b0, x1, n2);
+/* CPUがSSE2をサポートしているか */
+static int AE2Karatsuba_CPUSupportsSSE2(void)
+{
+#if defined(AE2KARATSUBA_USE_X86_SIMD) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] >> 26) & 1;
+#elif defined(AE2KARATSUBA_USE_X86_SIMD) && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#else
+    return 0;
+#endif
+}
 
-    /* x2 = a1 * b1 */
-    AE2Karatsuba_ConvolveKaratsuba(a1, b1, x2, n2);
+/* 実行環境で使用可能な最速のカーネルを選択 */
+static const struct AE2KaratsubaKernel *AE2Karatsuba_SelectKernel(void)
+{
+    const struct AE2KaratsubaKernel *kernel;
 
-    /* x3 = (a1 + a0) * (b1 + b0) */
-    AE2Karatsuba_ConvolveKaratsuba(v,  w,  x3, n2);
+    if (AE2Karatsuba_CPUSupportsAVX2FMA() && ((kernel = AE2KaratsubaKernel_GetAVX2()) != NULL)) {
+        return kernel;
+    }
 
-    /* x3 -= x1 + x2 */
-    for(i = 0; i < n; i++) {
-        x3[i] -= (x1[i] + x2[i]);
+    if (AE2Karatsuba_CPUSupportsSSE2() && ((kernel = AE2KaratsubaKernel_GetSSE2()) != NULL)) {
+        return kernel;
     }
 
-    /* z = x2 * R^2 + (x3 - x1 - x2) * R + x1 */
-    /*      ( x1, x2 は既に所定の位置にセットされているので、x3 のみ加算 ) */
-    for(i = 0; i < n; i++) {
-        z[i + n2] += x3[i];
+    return AE2KaratsubaKernel_GetScalar();
+}
+
+/* カラツバ法による畳込み */
+/* zはサイズ6n 先頭2nに結果が入る */
+/* 再帰と同じ順序・同じ領域配置で部分積を計算するが、関数呼び出しの代わりに段のスタックを使う */
+static void AE2Karatsuba_ConvolveKaratsuba(
+        const struct AE2KaratsubaKernel *kernel, const float *a, const float *b, float *z, uint32_t n)
+{
+    uint32_t i, n2, depth;
+    const float *ca, *cb;
+    float *cz;
+    struct AE2KaratsubaStage stack[AE2KARATSUBA_MAX_NUM_STAGES];
+    struct AE2KaratsubaStage *stage;
+
+    assert(kernel != NULL);
+    assert(kernel->base_size <= AE2KARATSUBA_MAX_BASE_SIZE);
+
+    /* 基底サイズ以下の場合は直接畳み込む */
+    if (n <= kernel->base_size) {
+        kernel->DirectConvolve(a, b, z, n);
+        return;
     }
 
+    depth = 0;
+    stack[0].a = a; stack[0].b = b; stack[0].z = z; stack[0].n = n; stack[0].step = 0;
+    depth++;
+
+    while (depth > 0) {
+        stage = &stack[depth - 1];
+        n2 = stage->n >> 1;
+
+        switch (stage->step) {
+        case 0:
+            /* v = a1 + a0, w = b1 + b0 （x3の計算まで z[5n, 6n) に保持） */
+            {
+                float *v = &stage->z[stage->n * 5];
+                float *w = &stage->z[stage->n * 5 + n2];
+                for (i = 0; i < n2; i++) {
+                    v[i] = stage->a[n2 + i] + stage->a[i];
+                    w[i] = stage->b[n2 + i] + stage->b[i];
+                }
+            }
+            /* x1 = a0 * b0 */
+            ca = &stage->a[0]; cb = &stage->b[0]; cz = &stage->z[0];
+            break;
+        case 1:
+            /* x2 = a1 * b1 */
+            ca = &stage->a[n2]; cb = &stage->b[n2]; cz = &stage->z[stage->n];
+            break;
+        case 2:
+            /* x3 = (a1 + a0) * (b1 + b0) */
+            ca = &stage->z[stage->n * 5]; cb = &stage->z[stage->n * 5 + n2]; cz = &stage->z[stage->n * 2];
+            break;
+        default:
+            /* z = x2 * R^2 + (x3 - x1 - x2) * R + x1 */
+            /* x1, x2 は既に所定の位置にあるので (x3 - x1 - x2) のみ加算する */
+            /* 前半と後半を同じループで処理すると、書き込み先のx1後半とx2前半は読み出し済みになる */
+            {
+                float *x1 = &stage->z[0];
+                float *x2 = &stage->z[stage->n];
+                const float *x3 = &stage->z[stage->n * 2];
+                for (i = 0; i < n2; i++) {
+                    const float t0 = x3[i] - (x1[i] + x2[i]);
+                    const float t1 = x3[n2 + i] - (x1[n2 + i] + x2[n2 + i]);
+                    x1[n2 + i] += t0;
+                    x2[i] += t1;
+                }
+            }
+            depth--;
+            continue;
+        }
+        stage->step++;
+
+        /* 部分積が基底サイズ以下なら直接畳み込み、そうでなければ段を積む */
+        if (n2 <= kernel->base_size) {
+            kernel->DirectConvolve(ca, cb, cz, n2);
+        } else {
+            assert(depth < AE2KARATSUBA_MAX_NUM_STAGES);
+            stage = &stack[depth];
+            stage->a = ca; stage->b = cb; stage->z = cz; stage->n = n2; stage->step = 0;
+            depth++;
+        }
+    }
 }
 
 /* 2の冪乗に切り上げ */
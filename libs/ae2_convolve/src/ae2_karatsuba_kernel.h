@@ -0,0 +1,52 @@
+/*!
+* @file ae2_karatsuba_kernel.h
+* @brief カラツバ法の基底（直接畳み込み）カーネル（ライブラリ内部用）
+*/
+#ifndef AE2KARATSUBAKERNEL_H_INCLUDED
+#define AE2KARATSUBAKERNEL_H_INCLUDED
+
+#include <stdint.h>
+
+/* x86/x64向けのSIMDカーネルを使用するか */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AE2KARATSUBA_USE_X86_SIMD
+#endif
+
+/* 直接畳み込みする最大サイズ（カーネルの基底サイズの上限） */
+#define AE2KARATSUBA_MAX_BASE_SIZE 128
+
+/* 直接畳み込み z = a * b
+* a, b サイズnの系列
+* z 結果（サイズ2n 末尾の1要素は0）
+* nは2の冪乗でAE2KARATSUBA_MAX_BASE_SIZE以下
+*/
+typedef void (*AE2KaratsubaDirectConvolveFunction)(const float *a, const float *b, float *z, uint32_t n);
+
+/* カラツバ法の基底カーネル */
+struct AE2KaratsubaKernel {
+    const char *name; /* カーネル名 */
+    uint32_t base_size; /* 分割をやめて直接畳み込みするサイズ（ベンチマークで決定した分岐点） */
+    AE2KaratsubaDirectConvolveFunction DirectConvolve; /* 直接畳み込み */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* スカラー実装の直接畳み込み SIMDカーネルの小サイズ処理でも使用 */
+void AE2Karatsuba_DirectConvolveScalar(const float *a, const float *b, float *z, uint32_t n);
+
+/* スカラーカーネルの取得 */
+const struct AE2KaratsubaKernel *AE2KaratsubaKernel_GetScalar(void);
+
+/* SSE2カーネルの取得 ビルド対象外の環境ではNULLを返す */
+const struct AE2KaratsubaKernel *AE2KaratsubaKernel_GetSSE2(void);
+
+/* AVX2/FMAカーネルの取得 ビルド対象外の環境ではNULLを返す */
+const struct AE2KaratsubaKernel *AE2KaratsubaKernel_GetAVX2(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AE2KARATSUBAKERNEL_H_INCLUDED */
@@ -0,0 +1,77 @@
+#include "ae2_karatsuba_kernel.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* AVX2/FMAを有効にしてコンパイルされた場合のみカーネルを提供 */
+#if defined(AE2KARATSUBA_USE_X86_SIMD) && defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+#include <immintrin.h>
+
+/* 1ベクトルの要素数 */
+#define AE2KARATSUBAAVX2_NUM_LANES 8
+/* 1回のループで計算する出力数（4ベクトル分をレジスタに保持） */
+#define AE2KARATSUBAAVX2_BLOCK_SIZE (4 * AE2KARATSUBAAVX2_NUM_LANES)
+
+/* AVX2実装の直接畳み込み */
+/* 出力4ベクトル分をレジスタに保持したまま係数を走査し、出力は1回だけ書き出す */
+static void AE2Karatsuba_DirectConvolveAVX2(const float *a, const float *b, float *z, uint32_t n)
+{
+    uint32_t o, j, jmin, jmax;
+    /* 範囲外の参照が0になるよう前後をパディングした被乗数 */
+    float apad[AE2KARATSUBAAVX2_BLOCK_SIZE + AE2KARATSUBA_MAX_BASE_SIZE + AE2KARATSUBAAVX2_BLOCK_SIZE];
+    const float *ap = &apad[AE2KARATSUBAAVX2_BLOCK_SIZE];
+
+    /* 出力ブロックに満たないサイズはスカラーで処理 */
+    if (n < (AE2KARATSUBAAVX2_BLOCK_SIZE / 2)) {
+        AE2Karatsuba_DirectConvolveScalar(a, b, z, n);
+        return;
+    }
+
+    memset(apad, 0, sizeof(float) * AE2KARATSUBAAVX2_BLOCK_SIZE);
+    memcpy(&apad[AE2KARATSUBAAVX2_BLOCK_SIZE], a, sizeof(float) * n);
+    memset(&apad[AE2KARATSUBAAVX2_BLOCK_SIZE + n], 0, sizeof(float) * AE2KARATSUBAAVX2_BLOCK_SIZE);
+
+    for (o = 0; o < (n << 1); o += AE2KARATSUBAAVX2_BLOCK_SIZE) {
+        __m256 z0 = _mm256_setzero_ps(), z1 = _mm256_setzero_ps(), z2 = _mm256_setzero_ps(), z3 = _mm256_setzero_ps();
+        /* 出力ブロックに寄与する係数の範囲 */
+        jmin = (o + 1 > n) ? (o + 1 - n) : 0;
+        jmax = (o + AE2KARATSUBAAVX2_BLOCK_SIZE - 1 < n - 1) ? (o + AE2KARATSUBAAVX2_BLOCK_SIZE - 1) : (n - 1);
+        for (j = jmin; j <= jmax; j++) {
+            const __m256 bj = _mm256_set1_ps(b[j]);
+            const float *p = &ap[(int32_t)o - (int32_t)j];
+            z0 = _mm256_fmadd_ps(_mm256_loadu_ps(&p[0]), bj, z0);
+            z1 = _mm256_fmadd_ps(_mm256_loadu_ps(&p[8]), bj, z1);
+            z2 = _mm256_fmadd_ps(_mm256_loadu_ps(&p[16]), bj, z2);
+            z3 = _mm256_fmadd_ps(_mm256_loadu_ps(&p[24]), bj, z3);
+        }
+        _mm256_storeu_ps(&z[o + 0], z0);
+        _mm256_storeu_ps(&z[o + 8], z1);
+        _mm256_storeu_ps(&z[o + 16], z2);
+        _mm256_storeu_ps(&z[o + 24], z3);
+    }
+}
+
+/* AVX2/FMAカーネル */
+/* 基底サイズ128はae2_karatsuba_benchの計測で、n >= 128では64より速い */
+static const struct AE2KaratsubaKernel st_avx2_kernel = {
+    "avx2",
+    128,
+    AE2Karatsuba_DirectConvolveAVX2,
+};
+
+/* AVX2/FMAカーネルの取得 */
+const struct AE2KaratsubaKernel *AE2KaratsubaKernel_GetAVX2(void)
+{
+    return &st_avx2_kernel;
+}
+
+#else
+
+/* AVX2/FMAカーネルの取得 */
+const struct AE2KaratsubaKernel *AE2KaratsubaKernel_GetAVX2(void)
+{
+    return NULL;
+}
+
+#endif /* AE2KARATSUBA_USE_X86_SIMD && __AVX2__ && __FMA__ */
@@ -0,0 +1,78 @@
+#include "ae2_karatsuba_kernel.h"
+
+#include <stddef.h>
+#include <string.h>
+
+/* SSE2を有効にしてコンパイルされた場合のみカーネルを提供 */
+#if defined(AE2KARATSUBA_USE_X86_SIMD) \
+    && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+
+#include <emmintrin.h>
+
+/* 1ベクトルの要素数 */
+#define AE2KARATSUBASSE2_NUM_LANES 4
+/* 1回のループで計算する出力数（4ベクトル分をレジスタに保持） */
+#define AE2KARATSUBASSE2_BLOCK_SIZE (4 * AE2KARATSUBASSE2_NUM_LANES)
+
+/* SSE2実装の直接畳み込み */
+/* 出力4ベクトル分をレジスタに保持したまま係数を走査し、出力は1回だけ書き出す */
+static void AE2Karatsuba_DirectConvolveSSE2(const float *a, const float *b, float *z, uint32_t n)
+{
+    uint32_t o, j, jmin, jmax;
+    /* 範囲外の参照が0になるよう前後をパディングした被乗数 */
+    float apad[AE2KARATSUBASSE2_BLOCK_SIZE + AE2KARATSUBA_MAX_BASE_SIZE + AE2KARATSUBASSE2_BLOCK_SIZE];
+    const float *ap = &apad[AE2KARATSUBASSE2_BLOCK_SIZE];
+
+    /* 出力ブロックに満たないサイズはスカラーで処理 */
+    if (n < (AE2KARATSUBASSE2_BLOCK_SIZE / 2)) {
+        AE2Karatsuba_DirectConvolveScalar(a, b, z, n);
+        return;
+    }
+
+    memset(apad, 0, sizeof(float) * AE2KARATSUBASSE2_BLOCK_SIZE);
+    memcpy(&apad[AE2KARATSUBASSE2_BLOCK_SIZE], a, sizeof(float) * n);
+    memset(&apad[AE2KARATSUBASSE2_BLOCK_SIZE + n], 0, sizeof(float) * AE2KARATSUBASSE2_BLOCK_SIZE);
+
+    for (o = 0; o < (n << 1); o += AE2KARATSUBASSE2_BLOCK_SIZE) {
+        __m128 z0 = _mm_setzero_ps(), z1 = _mm_setzero_ps(), z2 = _mm_setzero_ps(), z3 = _mm_setzero_ps();
+        /* 出力ブロックに寄与する係数の範囲 */
+        jmin = (o + 1 > n) ? (o + 1 - n) : 0;
+        jmax = (o + AE2KARATSUBASSE2_BLOCK_SIZE - 1 < n - 1) ? (o + AE2KARATSUBASSE2_BLOCK_SIZE - 1) : (n - 1);
+        for (j = jmin; j <= jmax; j++) {
+            const __m128 bj = _mm_set1_ps(b[j]);
+            const float *p = &ap[(int32_t)o - (int32_t)j];
+            z0 = _mm_add_ps(z0, _mm_mul_ps(_mm_loadu_ps(&p[0]), bj));
+            z1 = _mm_add_ps(z1, _mm_mul_ps(_mm_loadu_ps(&p[4]), bj));
+            z2 = _mm_add_ps(z2, _mm_mul_ps(_mm_loadu_ps(&p[8]), bj));
+            z3 = _mm_add_ps(z3, _mm_mul_ps(_mm_loadu_ps(&p[12]), bj));
+        }
+        _mm_storeu_ps(&z[o + 0], z0);
+        _mm_storeu_ps(&z[o + 4], z1);
+        _mm_storeu_ps(&z[o + 8], z2);
+        _mm_storeu_ps(&z[o + 12], z3);
+    }
+}
+
+/* SSE2カーネル */
+/* 基底サイズ64はae2_karatsuba_benchの計測で、n >= 128では32, 128より速い */
+static const struct AE2KaratsubaKernel st_sse2_kernel = {
+    "sse2",
+    64,
+    AE2Karatsuba_DirectConvolveSSE2,
+};
+
+/* SSE2カーネルの取得 */
+const struct AE2KaratsubaKernel *AE2KaratsubaKernel_GetSSE2(void)
+{
+    return &st_sse2_kernel;
+}
+
+#else
+
+/* SSE2カーネルの取得 */
+const struct AE2KaratsubaKernel *AE2KaratsubaKernel_GetSSE2(void)
+{
+    return NULL;
+}
+
+#endif /* AE2KARATSUBA_USE_X86_SIMD && __SSE2__ */
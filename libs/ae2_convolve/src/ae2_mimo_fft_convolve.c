@@ -0,0 +1,352 @@
+#include "ae2_mimo_fft_convolve.h"
+
+#include <string.h>
+#include <assert.h>
+
+#include "ae2_fft.h"
+#include "ae2_fft_convolve.h"
+
+/* メモリアラインメント */
+#define AE2MIMOFFTCONVOLVE_ALIGNMENT 16
+/* 1回の複素乗算/加算でまとめて処理する最大スペクトル数 */
+#define AE2MIMOFFTCONVOLVE_MAX_NUM_MULADD_SPECTRA 4
+/* 最大値を取得 */
+#define MAX(a,b) (((a) > (b)) ? (a) : (b))
+/* 最小値を取得 */
+#define MIN(a,b) (((a) < (b)) ? (a) : (b))
+/* nの倍数切り上げ */
+#define ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
+
+/* 多入力多出力FFT畳み込み構造体 */
+struct AE2MIMOFFTConvolve {
+    uint32_t num_inputs; /* 入力チャンネル数 */
+    uint32_t num_outputs; /* 出力チャンネル数 */
+    uint32_t fft_size; /* FFT点数 */
+    uint32_t partition_size; /* 係数の分割サイズ: fft_size / 2 が成立 */
+    uint32_t max_num_coefficients; /* 最大係数長 */
+    uint32_t max_num_partitions; /* 最大分割数（遅延線の長さ） */
+    uint32_t *num_partitions; /* 入出力の組毎の分割数 output * num_inputs + input の順に並ぶ */
+    float *ir_freq; /* フーリエ変換済みのインパルス応答 組毎にmax_num_partitions個のスペクトルが並ぶ */
+    float *input_blocks; /* 入力チャンネル毎のFFT入力 前半は前周期、後半は現周期の入力 */
+    float *freq_spectra; /* 入力チャンネル毎の周波数領域に変換した入力の遅延線 max_num_partitions個のスペクトルを巡回して使う */
+    uint32_t freq_write_pos; /* 次に新しいスペクトルを書き込む遅延線の位置 */
+    float *output_blocks; /* 出力チャンネル毎の前周期の畳み込み結果 */
+    uint32_t block_pos; /* 周期内のサンプル位置 */
+    struct AE2FFTPlan *fft_plan; /* FFTプラン */
+    float *work_buffer; /* 変換作業バッファ */
+    float *comp_muladd_buffer; /* 複素数乗算/加算計算結果バッファ 実部、虚部の順に並ぶ */
+};
+
+/* 分割サイズの計算 */
+static uint32_t AE2MIMOFFTConvolve_CalculatePartitionSize(const struct AE2MIMOFFTConvolveConfig *config);
+/* 1周期分の畳み込み */
+static void AE2MIMOFFTConvolve_ProcessBlock(struct AE2MIMOFFTConvolve *conv);
+
+/* ワークサイズ計算 */
+int32_t AE2MIMOFFTConvolve_CalculateWorkSize(const struct AE2MIMOFFTConvolveConfig *config)
+{
+    int32_t work_size, fft_plan_work_size;
+    uint32_t partition_size, fft_size, max_num_partitions, num_pairs;
+    struct AE2FFTPlanConfig fft_plan_config;
+
+    /* 引数チェック */
+    if ((config == NULL) || (config->num_inputs == 0) || (config->num_outputs == 0)
+            || (config->max_num_input_samples == 0)) {
+        return -1;
+    }
+
+    partition_size = AE2MIMOFFTConvolve_CalculatePartitionSize(config);
+    fft_size = 2 * partition_size;
+    max_num_partitions = MAX(1, (config->max_num_coefficients + partition_size - 1) / partition_size);
+    num_pairs = config->num_inputs * config->num_outputs;
+
+    /* FFTプランの領域計算 */
+    fft_plan_config.fft_size = (int32_t)fft_size;
+    fft_plan_config.type = AE2FFTPLAN_TYPE_REAL;
+    fft_plan_config.in_place = 0;
+    fft_plan_config.double_precision = 0;
+    fft_plan_work_size = AE2FFTPlan_CalculateWorkSize(&fft_plan_config);
+    if (fft_plan_work_size < 0) {
+        return -1;
+    }
+
+    /* ハンドル領域分 */
+    work_size = sizeof(struct AE2MIMOFFTConvolve) + AE2MIMOFFTCONVOLVE_ALIGNMENT;
+    /* 組毎の分割数 */
+    work_size += sizeof(uint32_t) * num_pairs + AE2MIMOFFTCONVOLVE_ALIGNMENT;
+    /* フーリエ変換済みの係数領域分 */
+    work_size += sizeof(float) * num_pairs * max_num_partitions * fft_size + AE2MIMOFFTCONVOLVE_ALIGNMENT;
+    /* 入力ブロック分 */
+    work_size += sizeof(float) * config->num_inputs * fft_size + AE2MIMOFFTCONVOLVE_ALIGNMENT;
+    /* 入力スペクトルの遅延線分 */
+    work_size += sizeof(float) * config->num_inputs * max_num_partitions * fft_size + AE2MIMOFFTCONVOLVE_ALIGNMENT;
+    /* 出力ブロック分 */
+    work_size += sizeof(float) * config->num_outputs * partition_size + AE2MIMOFFTCONVOLVE_ALIGNMENT;
+    /* 変換作業領域、複素乗算/加算作業領域分 */
+    work_size += 2 * (sizeof(float) * fft_size + AE2MIMOFFTCONVOLVE_ALIGNMENT);
+    /* FFTプラン分 */
+    work_size += fft_plan_work_size;
+
+    return work_size;
+}
+
+/* インスタンス生成 */
+struct AE2MIMOFFTConvolve *AE2MIMOFFTConvolve_Create(const struct AE2MIMOFFTConvolveConfig *config, void *work, int32_t work_size)
+{
+    uint8_t *work_ptr = (uint8_t *)work;
+    struct AE2MIMOFFTConvolve *conv;
+    uint32_t partition_size, fft_size, max_num_partitions, num_pairs;
+    int32_t fft_plan_work_size;
+    struct AE2FFTPlanConfig fft_plan_config;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL)
+            || (work_size < AE2MIMOFFTConvolve_CalculateWorkSize(config))) {
+        return NULL;
+    }
+
+    partition_size = AE2MIMOFFTConvolve_CalculatePartitionSize(config);
+    fft_size = 2 * partition_size;
+    max_num_partitions = MAX(1, (config->max_num_coefficients + partition_size - 1) / partition_size);
+    num_pairs = config->num_inputs * config->num_outputs;
+
+    /* 構造体を配置 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2MIMOFFTCONVOLVE_ALIGNMENT);
+    conv = (struct AE2MIMOFFTConvolve *)work_ptr;
+    conv->num_inputs = config->num_inputs;
+    conv->num_outputs = config->num_outputs;
+    conv->fft_size = fft_size;
+    conv->partition_size = partition_size;
+    conv->max_num_coefficients = config->max_num_coefficients;
+    conv->max_num_partitions = max_num_partitions;
+    work_ptr += sizeof(struct AE2MIMOFFTConvolve);
+
+    /* 組毎の分割数 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2MIMOFFTCONVOLVE_ALIGNMENT);
+    conv->num_partitions = (uint32_t *)work_ptr;
+    work_ptr += sizeof(uint32_t) * num_pairs;
+
+    /* 変換済み係数 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2MIMOFFTCONVOLVE_ALIGNMENT);
+    conv->ir_freq = (float *)work_ptr;
+    work_ptr += sizeof(float) * num_pairs * max_num_partitions * fft_size;
+
+    /* 入力ブロック */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2MIMOFFTCONVOLVE_ALIGNMENT);
+    conv->input_blocks = (float *)work_ptr;
+    work_ptr += sizeof(float) * config->num_inputs * fft_size;
+
+    /* 入力スペクトルの遅延線 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2MIMOFFTCONVOLVE_ALIGNMENT);
+    conv->freq_spectra = (float *)work_ptr;
+    work_ptr += sizeof(float) * config->num_inputs * max_num_partitions * fft_size;
+
+    /* 出力ブロック */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2MIMOFFTCONVOLVE_ALIGNMENT);
+    conv->output_blocks = (float *)work_ptr;
+    work_ptr += sizeof(float) * config->num_outputs * partition_size;
+
+    /* 作業領域 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2MIMOFFTCONVOLVE_ALIGNMENT);
+    conv->work_buffer = (float *)work_ptr;
+    work_ptr += sizeof(float) * fft_size;
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2MIMOFFTCONVOLVE_ALIGNMENT);
+    conv->comp_muladd_buffer = (float *)work_ptr;
+    work_ptr += sizeof(float) * fft_size;
+
+    /* FFTプラン */
+    fft_plan_config.fft_size = (int32_t)fft_size;
+    fft_plan_config.type = AE2FFTPLAN_TYPE_REAL;
+    fft_plan_config.in_place = 0;
+    fft_plan_config.double_precision = 0;
+    fft_plan_work_size = AE2FFTPlan_CalculateWorkSize(&fft_plan_config);
+    if (fft_plan_work_size < 0) {
+        return NULL;
+    }
+    if ((conv->fft_plan = AE2FFTPlan_Create(&fft_plan_config, work_ptr, fft_plan_work_size)) == NULL) {
+        return NULL;
+    }
+    work_ptr += fft_plan_work_size;
+
+    /* 係数は全て0（どの組も寄与しない） */
+    memset(conv->num_partitions, 0, sizeof(uint32_t) * num_pairs);
+
+    AE2MIMOFFTConvolve_Reset(conv);
+
+    return conv;
+}
+
+/* インスタンス破棄 */
+void AE2MIMOFFTConvolve_Destroy(struct AE2MIMOFFTConvolve *conv)
+{
+    if (conv != NULL) {
+        AE2FFTPlan_Destroy(conv->fft_plan);
+    }
+}
+
+/* 内部状態リセット */
+void AE2MIMOFFTConvolve_Reset(struct AE2MIMOFFTConvolve *conv)
+{
+    assert(conv != NULL);
+
+    memset(conv->input_blocks, 0, sizeof(float) * conv->num_inputs * conv->fft_size);
+    memset(conv->freq_spectra, 0, sizeof(float) * conv->num_inputs * conv->max_num_partitions * conv->fft_size);
+    memset(conv->output_blocks, 0, sizeof(float) * conv->num_outputs * conv->partition_size);
+    memset(conv->comp_muladd_buffer, 0, sizeof(float) * conv->fft_size);
+    conv->freq_write_pos = 0;
+    conv->block_pos = 0;
+}
+
+/* 入力チャンネルinputから出力チャンネルoutputへの係数セット */
+void AE2MIMOFFTConvolve_SetCoefficients(struct AE2MIMOFFTConvolve *conv,
+        uint32_t input, uint32_t output, const float *coefficients, uint32_t num_coefficients)
+{
+    uint32_t pair;
+    float *ir_freq;
+
+    /* 引数チェック */
+    assert(conv != NULL);
+    assert((coefficients != NULL) || (num_coefficients == 0));
+    assert((input < conv->num_inputs) && (output < conv->num_outputs));
+    assert(num_coefficients <= conv->max_num_coefficients);
+
+    pair = output * conv->num_inputs + input;
+    ir_freq = &conv->ir_freq[pair * conv->max_num_partitions * conv->fft_size];
+
+    /* 分割数の再計算 */
+    conv->num_partitions[pair] = (num_coefficients + conv->partition_size - 1) / conv->partition_size;
+
+    /* 分割毎にFFT（単入出力のFFT畳み込みと同じ係数形式） */
+    AE2FFTConvolve_TransformCoefficients(conv->fft_plan, conv->work_buffer,
+            conv->partition_size, coefficients, num_coefficients, ir_freq);
+
+    /* 内部バッファリセット（前の係数の影響をクリア） */
+    AE2MIMOFFTConvolve_Reset(conv);
+}
+
+/* 畳み込み */
+void AE2MIMOFFTConvolve_Convolve(struct AE2MIMOFFTConvolve *conv,
+        const float *const *input, float *const *output, uint32_t num_samples)
+{
+    uint32_t ch, smpl;
+
+    /* 引数チェック */
+    assert((conv != NULL) && (input != NULL) && (output != NULL));
+
+    smpl = 0;
+    while (smpl < num_samples) {
+        const uint32_t num_process = MIN(conv->partition_size - conv->block_pos, num_samples - smpl);
+
+        /* 入力ブロック後半に追記（出力と同じ領域を指す場合があるので先に読み出す） */
+        for (ch = 0; ch < conv->num_inputs; ch++) {
+            memcpy(&conv->input_blocks[ch * conv->fft_size + conv->partition_size + conv->block_pos],
+                    &input[ch][smpl], sizeof(float) * num_process);
+        }
+
+        /* 前周期の結果を出力 */
+        for (ch = 0; ch < conv->num_outputs; ch++) {
+            memcpy(&output[ch][smpl],
+                    &conv->output_blocks[ch * conv->partition_size + conv->block_pos], sizeof(float) * num_process);
+        }
+
+        conv->block_pos += num_process;
+        smpl += num_process;
+
+        /* 1周期分溜まったら畳み込み */
+        if (conv->block_pos == conv->partition_size) {
+            AE2MIMOFFTConvolve_ProcessBlock(conv);
+            conv->block_pos = 0;
+        }
+    }
+}
+
+/* 1周期分の畳み込み */
+static void AE2MIMOFFTConvolve_ProcessBlock(struct AE2MIMOFFTConvolve *conv)
+{
+    uint32_t in, out, q, num_spectra;
+    const uint32_t spectra_stride = conv->max_num_partitions * conv->fft_size;
+    const float *spectra[AE2MIMOFFTCONVOLVE_MAX_NUM_MULADD_SPECTRA];
+    const float *coefs[AE2MIMOFFTCONVOLVE_MAX_NUM_MULADD_SPECTRA];
+
+    assert(conv != NULL);
+
+    /* 各入力チャンネルを1回だけFFTし、遅延線に書き込む */
+    for (in = 0; in < conv->num_inputs; in++) {
+        float *block = &conv->input_blocks[in * conv->fft_size];
+        float *spectrum = &conv->freq_spectra[in * spectra_stride + conv->freq_write_pos * conv->fft_size];
+        AE2FFTPlan_SplitRealFFT(conv->fft_plan, block, &spectrum[0], &spectrum[conv->partition_size]);
+        /* 現周期の入力を次周期の前半に移す */
+        memcpy(&block[0], &block[conv->partition_size], sizeof(float) * conv->partition_size);
+    }
+
+    /* 出力チャンネル毎に全入力との積を足し合わせてからIFFT */
+    for (out = 0; out < conv->num_outputs; out++) {
+        float *output_block = &conv->output_blocks[out * conv->partition_size];
+        uint32_t num_products = 0;
+
+        num_spectra = 0;
+        for (in = 0; in < conv->num_inputs; in++) {
+            const uint32_t pair = out * conv->num_inputs + in;
+            for (q = 0; q < conv->num_partitions[pair]; q++) {
+                /* 係数の分割qには、書き込み位置からq個遡ったスペクトルを掛ける */
+                const uint32_t pos = (conv->freq_write_pos + conv->max_num_partitions - q) % conv->max_num_partitions;
+                spectra[num_spectra] = &conv->freq_spectra[in * spectra_stride + pos * conv->fft_size];
+                coefs[num_spectra] = &conv->ir_freq[pair * spectra_stride + q * conv->fft_size];
+                num_spectra++;
+                /* 入力チャンネルをまたいでまとめて加算 */
+                if (num_spectra == AE2MIMOFFTCONVOLVE_MAX_NUM_MULADD_SPECTRA) {
+                    AE2FFTPlan_SplitRealSpectrumMulAddMultiple(conv->fft_plan,
+                            (int32_t)num_spectra, spectra, coefs, conv->comp_muladd_buffer);
+                    num_products += num_spectra;
+                    num_spectra = 0;
+                }
+            }
+        }
+        if (num_spectra > 0) {
+            AE2FFTPlan_SplitRealSpectrumMulAddMultiple(conv->fft_plan,
+                    (int32_t)num_spectra, spectra, coefs, conv->comp_muladd_buffer);
+            num_products += num_spectra;
+        }
+
+        /* 寄与する組がなければ無音 */
+        if (num_products == 0) {
+            memset(output_block, 0, sizeof(float) * conv->partition_size);
+            continue;
+        }
+
+        /* IFFTし、有効な後半のみを出力ブロックに書き出す */
+        AE2FFTPlan_SplitRealIFFT(conv->fft_plan,
+                &conv->comp_muladd_buffer[0], &conv->comp_muladd_buffer[conv->partition_size], conv->work_buffer);
+        memcpy(output_block, &conv->work_buffer[conv->partition_size], sizeof(float) * conv->partition_size);
+
+        /* 複素数乗算/加算結果バッファをクリア */
+        memset(conv->comp_muladd_buffer, 0, sizeof(float) * conv->fft_size);
+    }
+
+    /* 遅延線の書き込み位置を進める */
+    conv->freq_write_pos = (conv->freq_write_pos + 1) % conv->max_num_partitions;
+}
+
+/* レイテンシーの取得 */
+int32_t AE2MIMOFFTConvolve_GetLatencyNumSamples(const struct AE2MIMOFFTConvolve *conv)
+{
+    assert(conv != NULL);
+
+    /* 分割サイズ(=FFT点数/2)分遅れる */
+    return (int32_t)conv->partition_size;
+}
+
+/* 分割サイズの計算 */
+/* 単一入出力のFFT畳み込みと同じ方針で決める */
+static uint32_t AE2MIMOFFTConvolve_CalculatePartitionSize(const struct AE2MIMOFFTConvolveConfig *config)
+{
+    struct AE2ConvolveConfig conv_config;
+
+    assert(config != NULL);
+
+    conv_config.max_num_coefficients = config->max_num_coefficients;
+    conv_config.max_num_input_samples = config->max_num_input_samples;
+    conv_config.partition_size = config->partition_size;
+
+    return AE2FFTConvolve_CalculatePartitionSize(&conv_config);
+}
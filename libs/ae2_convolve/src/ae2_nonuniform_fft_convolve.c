@@ -0,0 +1,602 @@
+#include "ae2_nonuniform_fft_convolve.h"
+
+#include <assert.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "ae2_convolve.h"
+#include "ae2_karatsuba.h"
+#include "ae2_fft_convolve.h"
+
+/* メモリバリア */
+#if defined(_MSC_VER)
+#include <intrin.h>
+#if defined(_M_ARM) || defined(_M_ARM64)
+#define AE2NONUNIFORMFFTCONVOLVE_MEMORY_BARRIER() __dmb(0xB)
+#else
+#define AE2NONUNIFORMFFTCONVOLVE_MEMORY_BARRIER() _mm_mfence()
+#endif
+#elif defined(__GNUC__)
+#define AE2NONUNIFORMFFTCONVOLVE_MEMORY_BARRIER() __sync_synchronize()
+#else
+/* バリアが使えない環境ではバックグラウンド処理を別スレッドから呼ばないこと */
+#define AE2NONUNIFORMFFTCONVOLVE_MEMORY_BARRIER()
+#endif
+
+/* メモリアラインメント */
+#define AE2NONUNIFORMFFTCONVOLVE_ALIGNMENT 16
+/* 最小の分割サイズ */
+#define AE2NONUNIFORMFFTCONVOLVE_MIN_PARTITION_SIZE 16
+/* 最大の分割サイズ */
+#define AE2NONUNIFORMFFTCONVOLVE_MAX_PARTITION_SIZE 16384
+/* 段ごとの分割サイズの倍率 */
+#define AE2NONUNIFORMFFTCONVOLVE_PARTITION_GROWTH 4
+/* 最大段数 */
+#define AE2NONUNIFORMFFTCONVOLVE_MAX_NUM_STAGES 12
+/* バックグラウンドで処理する最小の分割サイズ */
+#define AE2NONUNIFORMFFTCONVOLVE_MIN_ASYNC_PARTITION_SIZE 4096
+/* 受け渡しバッファのスロット数（2の冪） */
+#define AE2NONUNIFORMFFTCONVOLVE_NUM_HANDOFF_SLOTS 4
+/* 最小値の取得 */
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+/* 最大値の取得 */
+#define MAX(a, b) (((a) > (b)) ? (a) : (b))
+/* nの倍数切り上げ */
+#define ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
+
+/* 段の構成 */
+struct AE2NonUniformFFTConvolveLayout {
+    uint32_t head_size; /* カラツバ法で計算する先頭の係数長 */
+    uint32_t num_stages; /* 分割FFT畳み込みの段数 */
+    uint32_t stage_offsets[AE2NONUNIFORMFFTCONVOLVE_MAX_NUM_STAGES]; /* 各段が担当する係数の先頭位置 */
+    uint32_t stage_num_coefficients[AE2NONUNIFORMFFTCONVOLVE_MAX_NUM_STAGES]; /* 各段が担当する最大係数長 */
+    uint32_t stage_partition_sizes[AE2NONUNIFORMFFTCONVOLVE_MAX_NUM_STAGES]; /* 各段の分割サイズ */
+    uint8_t stage_is_async[AE2NONUNIFORMFFTCONVOLVE_MAX_NUM_STAGES]; /* 各段をバックグラウンドで処理するか */
+};
+
+/* バックグラウンド処理する段との受け渡しバッファ */
+/* publishedはオーディオスレッドのみ、doneはバックグラウンドスレッドのみが書き込む */
+struct AE2NonUniformFFTConvolveHandoff {
+    float *input_slots; /* 入力スロット（分割サイズ * スロット数） */
+    float *output_slots; /* 出力スロット（分割サイズ * スロット数） */
+    float *work_input; /* バックグラウンドスレッド側の入力作業領域（分割サイズ） */
+    uint32_t input_pos; /* 現在の周期の入力済みサンプル数 */
+    volatile uint32_t published; /* 入力を書き終えた周期数 */
+    volatile uint32_t done; /* 処理を終えた周期数 */
+    uint8_t output_valid; /* 現在の周期の出力が間に合ったか */
+    uint32_t num_missed_deadlines; /* 処理が間に合わなかった周期数 */
+};
+
+/* 非一様分割FFT畳み込み構造体 */
+struct AE2NonUniformFFTConvolve {
+    const struct AE2ConvolveInterface *time_conv_if; /* 時間領域畳み込みモジュールインターフェース */
+    const struct AE2ConvolveInterface *freq_conv_if; /* 周波数領域畳み込みモジュールインターフェース */
+    void *time_conv_obj; /* 時間領域畳み込みモジュールオブジェクト本体 */
+    void *freq_conv_objs[AE2NONUNIFORMFFTCONVOLVE_MAX_NUM_STAGES]; /* 各段の周波数領域畳み込みモジュールオブジェクト本体 */
+    struct AE2NonUniformFFTConvolveLayout layout; /* 段の構成 */
+    uint32_t num_active_stages; /* 係数が割り当てられている段数 */
+    struct AE2NonUniformFFTConvolveHandoff handoffs[AE2NONUNIFORMFFTCONVOLVE_MAX_NUM_STAGES]; /* 各段の受け渡しバッファ */
+    uint8_t async; /* 大きな分割をバックグラウンドで処理するか */
+    float *output_buffer; /* 出力データバッファ */
+    uint32_t max_num_input_samples; /* 最大入力サンプル数 */
+};
+
+/* ワークサイズ取得 */
+static int32_t AE2NonUniformFFTConvolve_CalculateWorkSize(const struct AE2ConvolveConfig *config);
+/* インスタンス生成 */
+static void* AE2NonUniformFFTConvolve_Create(const struct AE2ConvolveConfig *config, void *work, int32_t work_size);
+/* ワークサイズ取得（バックグラウンド処理あり） */
+static int32_t AE2NonUniformFFTConvolve_CalculateWorkSizeAsync(const struct AE2ConvolveConfig *config);
+/* インスタンス生成（バックグラウンド処理あり） */
+static void* AE2NonUniformFFTConvolve_CreateAsync(const struct AE2ConvolveConfig *config, void *work, int32_t work_size);
+/* ワークサイズ取得（共通処理） */
+static int32_t AE2NonUniformFFTConvolve_CalculateWorkSizeCore(const struct AE2ConvolveConfig *config, uint8_t async);
+/* インスタンス生成（共通処理） */
+static void* AE2NonUniformFFTConvolve_CreateCore(const struct AE2ConvolveConfig *config, void *work, int32_t work_size, uint8_t async);
+/* インスタンス破棄 */
+static void AE2NonUniformFFTConvolve_Destroy(void *obj);
+/* 内部状態リセット */
+static void AE2NonUniformFFTConvolve_Reset(void *obj);
+/* 係数セット */
+static void AE2NonUniformFFTConvolve_SetCoefficients(void *obj, const float *coefficients, uint32_t num_coefficients);
+/* 畳み込み */
+static void AE2NonUniformFFTConvolve_Convolve(void *obj, const float *input, float *output, uint32_t num_samples);
+/* レイテンシ取得 */
+static int32_t AE2NonUniformFFTConvolve_GetLatencyNumSamples(void *obj);
+/* 段の構成を計算 */
+static void AE2NonUniformFFTConvolve_CalculateLayout(
+    const struct AE2ConvolveConfig *config, uint8_t async, struct AE2NonUniformFFTConvolveLayout *layout);
+/* 段の担当範囲の先頭位置を計算 */
+static uint32_t AE2NonUniformFFTConvolve_CalculateStageOffset(uint32_t stage, uint32_t partition_size, uint8_t async);
+/* バックグラウンド処理する段との入出力の受け渡し */
+static void AE2NonUniformFFTConvolve_ExchangeHandoff(
+    struct AE2NonUniformFFTConvolveHandoff *handoff, uint32_t partition_size,
+    const float *input, float *output, uint32_t num_samples);
+/* 2の冪乗に切り上げ */
+static uint32_t AE2NonUniformFFTConvolve_Roundup2PoweredValue(uint32_t val);
+
+/* インターフェース */
+static const struct AE2ConvolveInterface st_nonuniform_convolve_if = {
+    AE2NonUniformFFTConvolve_CalculateWorkSize,
+    AE2NonUniformFFTConvolve_Create,
+    AE2NonUniformFFTConvolve_Destroy,
+    AE2NonUniformFFTConvolve_Reset,
+    AE2NonUniformFFTConvolve_SetCoefficients,
+    AE2NonUniformFFTConvolve_Convolve,
+    AE2NonUniformFFTConvolve_GetLatencyNumSamples,
+};
+
+/* インターフェース（バックグラウンド処理あり） */
+static const struct AE2ConvolveInterface st_nonuniform_async_convolve_if = {
+    AE2NonUniformFFTConvolve_CalculateWorkSizeAsync,
+    AE2NonUniformFFTConvolve_CreateAsync,
+    AE2NonUniformFFTConvolve_Destroy,
+    AE2NonUniformFFTConvolve_Reset,
+    AE2NonUniformFFTConvolve_SetCoefficients,
+    AE2NonUniformFFTConvolve_Convolve,
+    AE2NonUniformFFTConvolve_GetLatencyNumSamples,
+};
+
+/* インターフェース取得 */
+const struct AE2ConvolveInterface *AE2NonUniformFFTConvolve_GetInterface(void)
+{
+    return &st_nonuniform_convolve_if;
+}
+
+/* インターフェース取得（バックグラウンド処理あり） */
+const struct AE2ConvolveInterface *AE2NonUniformFFTConvolve_GetAsyncInterface(void)
+{
+    return &st_nonuniform_async_convolve_if;
+}
+
+/* 段の担当範囲の先頭位置を計算 */
+/* バックグラウンド処理する段は1周期分の処理猶予を確保するため、分割サイズの2倍の位置から担当する */
+static uint32_t AE2NonUniformFFTConvolve_CalculateStageOffset(uint32_t stage, uint32_t partition_size, uint8_t async)
+{
+    if (async && (stage > 0) && (partition_size >= AE2NONUNIFORMFFTCONVOLVE_MIN_ASYNC_PARTITION_SIZE)) {
+        return 2 * partition_size;
+    }
+    return partition_size;
+}
+
+/* 段の構成を計算 */
+/* 分割サイズPの段は係数[P, 4P)を担当する。分割FFT畳み込みのレイテンシはPなので、入力を遅延させずにそのまま加算できる */
+/* バックグラウンド処理する段は係数[2P, 8P)を担当し、その手前の段が担当範囲を広げて隙間を埋める */
+static void AE2NonUniformFFTConvolve_CalculateLayout(
+    const struct AE2ConvolveConfig *config, uint8_t async, struct AE2NonUniformFFTConvolveLayout *layout)
+{
+    uint32_t partition_size, offset;
+
+    assert(config != NULL);
+    assert(layout != NULL);
+
+    /* 最小の分割サイズ。指定がなければ最大入力サンプル数に合わせる */
+    partition_size = (config->partition_size > 0) ? config->partition_size : config->max_num_input_samples;
+    partition_size = MAX(partition_size, AE2NONUNIFORMFFTCONVOLVE_MIN_PARTITION_SIZE);
+    partition_size = MIN(partition_size, AE2NONUNIFORMFFTCONVOLVE_MAX_PARTITION_SIZE);
+    partition_size = AE2NonUniformFFTConvolve_Roundup2PoweredValue(partition_size);
+
+    layout->head_size = partition_size;
+    layout->num_stages = 0;
+    offset = partition_size;
+    while (offset < config->max_num_coefficients) {
+        const uint32_t stage = layout->num_stages;
+        uint32_t end;
+        assert(stage < AE2NONUNIFORMFFTCONVOLVE_MAX_NUM_STAGES);
+        /* 最大の分割サイズに達したら残りは全てその段で担当 */
+        if ((partition_size >= AE2NONUNIFORMFFTCONVOLVE_MAX_PARTITION_SIZE)
+                || (stage == (AE2NONUNIFORMFFTCONVOLVE_MAX_NUM_STAGES - 1))) {
+            end = config->max_num_coefficients;
+        } else {
+            /* 次の段の先頭位置まで担当 */
+            end = AE2NonUniformFFTConvolve_CalculateStageOffset(stage + 1,
+                    AE2NONUNIFORMFFTCONVOLVE_PARTITION_GROWTH * partition_size, async);
+            end = MIN(end, config->max_num_coefficients);
+        }
+        layout->stage_offsets[stage] = offset;
+        layout->stage_num_coefficients[stage] = end - offset;
+        layout->stage_partition_sizes[stage] = partition_size;
+        layout->stage_is_async[stage]
+            = (AE2NonUniformFFTConvolve_CalculateStageOffset(stage, partition_size, async) != partition_size) ? 1 : 0;
+        layout->num_stages++;
+        offset = end;
+        partition_size *= AE2NONUNIFORMFFTCONVOLVE_PARTITION_GROWTH;
+    }
+}
+
+/* ワークサイズ計算 */
+static int32_t AE2NonUniformFFTConvolve_CalculateWorkSize(const struct AE2ConvolveConfig *config)
+{
+    return AE2NonUniformFFTConvolve_CalculateWorkSizeCore(config, 0);
+}
+
+/* ワークサイズ計算（バックグラウンド処理あり） */
+static int32_t AE2NonUniformFFTConvolve_CalculateWorkSizeAsync(const struct AE2ConvolveConfig *config)
+{
+    return AE2NonUniformFFTConvolve_CalculateWorkSizeCore(config, 1);
+}
+
+/* ワークサイズ計算（共通処理） */
+static int32_t AE2NonUniformFFTConvolve_CalculateWorkSizeCore(const struct AE2ConvolveConfig *config, uint8_t async)
+{
+    int32_t tmp_work_size, work_size;
+    uint32_t stage;
+    struct AE2ConvolveConfig conv_config;
+    struct AE2NonUniformFFTConvolveLayout layout;
+    const struct AE2ConvolveInterface *time_conv_if = AE2Karatsuba_GetInterface();
+    const struct AE2ConvolveInterface *freq_conv_if = AE2FFTConvolve_GetInterface();
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* 段の構成を計算 */
+    AE2NonUniformFFTConvolve_CalculateLayout(config, async, &layout);
+
+    work_size = sizeof(struct AE2NonUniformFFTConvolve) + AE2NONUNIFORMFFTCONVOLVE_ALIGNMENT;
+
+    /* 最大入力サンプル数は共通 */
+    conv_config.max_num_input_samples = config->max_num_input_samples;
+
+    /* 時間領域畳み込みモジュール分 */
+    conv_config.max_num_coefficients = layout.head_size;
+    conv_config.partition_size = 0;
+    if ((tmp_work_size = time_conv_if->CalculateWorkSize(&conv_config)) < 0) {
+        return -1;
+    }
+    work_size += tmp_work_size;
+
+    /* 各段の周波数領域畳み込みモジュール分 */
+    for (stage = 0; stage < layout.num_stages; stage++) {
+        const uint32_t partition_size = layout.stage_partition_sizes[stage];
+        conv_config.max_num_coefficients = layout.stage_num_coefficients[stage];
+        conv_config.partition_size = partition_size;
+        /* バックグラウンド処理する段は分割サイズ単位でのみ入力する */
+        conv_config.max_num_input_samples = layout.stage_is_async[stage] ? partition_size : config->max_num_input_samples;
+        if ((tmp_work_size = freq_conv_if->CalculateWorkSize(&conv_config)) < 0) {
+            return -1;
+        }
+        work_size += tmp_work_size;
+        /* 受け渡しバッファ分 */
+        if (layout.stage_is_async[stage]) {
+            work_size += sizeof(float) * partition_size * (2 * AE2NONUNIFORMFFTCONVOLVE_NUM_HANDOFF_SLOTS + 1) + AE2NONUNIFORMFFTCONVOLVE_ALIGNMENT;
+        }
+    }
+
+    /* 出力データバッファ分 */
+    work_size += sizeof(float) * config->max_num_input_samples + AE2NONUNIFORMFFTCONVOLVE_ALIGNMENT;
+
+    return work_size;
+}
+
+/* インスタンス生成 */
+static void* AE2NonUniformFFTConvolve_Create(const struct AE2ConvolveConfig *config, void *work, int32_t work_size)
+{
+    return AE2NonUniformFFTConvolve_CreateCore(config, work, work_size, 0);
+}
+
+/* インスタンス生成（バックグラウンド処理あり） */
+static void* AE2NonUniformFFTConvolve_CreateAsync(const struct AE2ConvolveConfig *config, void *work, int32_t work_size)
+{
+    return AE2NonUniformFFTConvolve_CreateCore(config, work, work_size, 1);
+}
+
+/* インスタンス生成（共通処理） */
+static void* AE2NonUniformFFTConvolve_CreateCore(const struct AE2ConvolveConfig *config, void *work, int32_t work_size, uint8_t async)
+{
+    struct AE2NonUniformFFTConvolve *conv;
+    uint8_t *work_ptr = (uint8_t *)work;
+    struct AE2ConvolveConfig conv_config;
+    int32_t tmp_work_size;
+    uint32_t stage;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL)
+            || (work_size < AE2NonUniformFFTConvolve_CalculateWorkSizeCore(config, async))) {
+        return NULL;
+    }
+
+    /* 構造体配置 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2NONUNIFORMFFTCONVOLVE_ALIGNMENT);
+    conv = (struct AE2NonUniformFFTConvolve *)work_ptr;
+    conv->time_conv_if = AE2Karatsuba_GetInterface();
+    conv->freq_conv_if = AE2FFTConvolve_GetInterface();
+    conv->max_num_input_samples = config->max_num_input_samples;
+    conv->num_active_stages = 0;
+    conv->async = async;
+    AE2NonUniformFFTConvolve_CalculateLayout(config, async, &conv->layout);
+    work_ptr += sizeof(struct AE2NonUniformFFTConvolve);
+
+    /* 共通のパラメータ設定項目 */
+    conv_config.max_num_input_samples = config->max_num_input_samples;
+
+    /* 時間領域畳み込みモジュール */
+    conv_config.max_num_coefficients = conv->layout.head_size;
+    conv_config.partition_size = 0;
+    if ((tmp_work_size = conv->time_conv_if->CalculateWorkSize(&conv_config)) < 0) {
+        return NULL;
+    }
+    if ((conv->time_conv_obj = conv->time_conv_if->Create(&conv_config, work_ptr, tmp_work_size)) == NULL) {
+        return NULL;
+    }
+    work_ptr += tmp_work_size;
+
+    /* 各段の周波数領域畳み込みモジュール */
+    for (stage = 0; stage < conv->layout.num_stages; stage++) {
+        const uint32_t partition_size = conv->layout.stage_partition_sizes[stage];
+        struct AE2NonUniformFFTConvolveHandoff *handoff = &conv->handoffs[stage];
+        conv_config.max_num_coefficients = conv->layout.stage_num_coefficients[stage];
+        conv_config.partition_size = partition_size;
+        conv_config.max_num_input_samples = conv->layout.stage_is_async[stage] ? partition_size : config->max_num_input_samples;
+        if ((tmp_work_size = conv->freq_conv_if->CalculateWorkSize(&conv_config)) < 0) {
+            return NULL;
+        }
+        if ((conv->freq_conv_objs[stage] = conv->freq_conv_if->Create(&conv_config, work_ptr, tmp_work_size)) == NULL) {
+            return NULL;
+        }
+        work_ptr += tmp_work_size;
+        if (!conv->layout.stage_is_async[stage]) {
+            /* 各段のレイテンシは担当する係数の先頭位置と一致する */
+            assert(conv->freq_conv_if->GetLatencyNumSamples(conv->freq_conv_objs[stage]) == (int32_t)conv->layout.stage_offsets[stage]);
+            handoff->input_slots = handoff->output_slots = handoff->work_input = NULL;
+        } else {
+            /* バックグラウンド処理では分割サイズ単位の畳み込みを使うため、2周期目で結果を取り出せる */
+            assert(conv->layout.stage_offsets[stage] == (2 * partition_size));
+            /* 受け渡しバッファ */
+            work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2NONUNIFORMFFTCONVOLVE_ALIGNMENT);
+            handoff->input_slots = (float *)work_ptr;
+            work_ptr += sizeof(float) * partition_size * AE2NONUNIFORMFFTCONVOLVE_NUM_HANDOFF_SLOTS;
+            handoff->output_slots = (float *)work_ptr;
+            work_ptr += sizeof(float) * partition_size * AE2NONUNIFORMFFTCONVOLVE_NUM_HANDOFF_SLOTS;
+            handoff->work_input = (float *)work_ptr;
+            work_ptr += sizeof(float) * partition_size;
+        }
+    }
+
+    /* 出力データバッファ */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2NONUNIFORMFFTCONVOLVE_ALIGNMENT);
+    conv->output_buffer = (float *)work_ptr;
+    work_ptr += sizeof(float) * config->max_num_input_samples;
+
+    /* 内部状態リセット */
+    AE2NonUniformFFTConvolve_Reset(conv);
+
+    return conv;
+}
+
+/* インスタンス破棄 */
+static void AE2NonUniformFFTConvolve_Destroy(void *obj)
+{
+    uint32_t stage;
+    struct AE2NonUniformFFTConvolve *conv = (struct AE2NonUniformFFTConvolve *)obj;
+
+    if (conv != NULL) {
+        /* 各畳み込みモジュールの破棄 */
+        conv->time_conv_if->Destroy(conv->time_conv_obj);
+        for (stage = 0; stage < conv->layout.num_stages; stage++) {
+            conv->freq_conv_if->Destroy(conv->freq_conv_objs[stage]);
+        }
+    }
+}
+
+/* 係数セット */
+static void AE2NonUniformFFTConvolve_SetCoefficients(void *obj, const float *coefficients, uint32_t num_coefficients)
+{
+    uint32_t stage;
+    struct AE2NonUniformFFTConvolve *conv = (struct AE2NonUniformFFTConvolve *)obj;
+    const struct AE2NonUniformFFTConvolveLayout *layout = &conv->layout;
+
+    assert((obj != NULL) && (coefficients != NULL));
+
+    /* 先頭分を時間領域畳み込みモジュールにセット */
+    conv->time_conv_if->SetCoefficients(conv->time_conv_obj, coefficients, MIN(num_coefficients, layout->head_size));
+
+    /* 後ろは担当範囲に応じて各段にセット */
+    conv->num_active_stages = 0;
+    for (stage = 0; stage < layout->num_stages; stage++) {
+        const uint32_t offset = layout->stage_offsets[stage];
+        if (num_coefficients <= offset) {
+            break;
+        }
+        conv->freq_conv_if->SetCoefficients(conv->freq_conv_objs[stage],
+                &coefficients[offset], MIN(num_coefficients - offset, layout->stage_num_coefficients[stage]));
+        conv->num_active_stages++;
+    }
+
+    /* 内部状態をリセット（前の係数の影響をクリア） */
+    AE2NonUniformFFTConvolve_Reset(conv);
+}
+
+/* 畳み込み計算 */
+static void AE2NonUniformFFTConvolve_Convolve(void *obj, const float *input, float *output, uint32_t num_samples)
+{
+    uint32_t stage, smpl;
+    struct AE2NonUniformFFTConvolve *conv = (struct AE2NonUniformFFTConvolve *)obj;
+
+    assert((obj != NULL) && (input != NULL) && (output != NULL));
+    assert(num_samples <= conv->max_num_input_samples);
+
+    /* 先頭分を時間領域で畳み込み */
+    conv->time_conv_if->Convolve(conv->time_conv_obj, input, output, num_samples);
+
+    /* 各段の結果をミックス */
+    /* 段のレイテンシと担当範囲の先頭位置が一致するため、入力を遅延させる必要はない */
+    for (stage = 0; stage < conv->num_active_stages; stage++) {
+        /* バックグラウンド処理する段は受け渡しバッファとの入出力のみ行う */
+        if (conv->layout.stage_is_async[stage]) {
+            AE2NonUniformFFTConvolve_ExchangeHandoff(&conv->handoffs[stage],
+                    conv->layout.stage_partition_sizes[stage], input, output, num_samples);
+            continue;
+        }
+        conv->freq_conv_if->Convolve(conv->freq_conv_objs[stage], input, conv->output_buffer, num_samples);
+        for (smpl = 0; smpl < num_samples; smpl++) {
+            output[smpl] += conv->output_buffer[smpl];
+        }
+    }
+}
+
+/* バックグラウンド処理する段との入出力の受け渡し */
+/* 周期pの入力はスロットp、周期pで加算する出力はスロットp-2（周期p-2の入力に対する結果）を使う */
+static void AE2NonUniformFFTConvolve_ExchangeHandoff(
+    struct AE2NonUniformFFTConvolveHandoff *handoff, uint32_t partition_size,
+    const float *input, float *output, uint32_t num_samples)
+{
+    uint32_t progress, smpl;
+    const uint32_t slot_mask = AE2NONUNIFORMFFTCONVOLVE_NUM_HANDOFF_SLOTS - 1;
+
+    assert((handoff != NULL) && (input != NULL) && (output != NULL));
+
+    progress = 0;
+    while (progress < num_samples) {
+        const uint32_t period = handoff->published;
+        const uint32_t num_process = MIN(num_samples - progress, partition_size - handoff->input_pos);
+        float *input_slot = &handoff->input_slots[(period & slot_mask) * partition_size + handoff->input_pos];
+        const float *output_slot = &handoff->output_slots[((period - 2) & slot_mask) * partition_size + handoff->input_pos];
+
+        /* 周期の先頭で出力が間に合ったか判定 */
+        /* 周期p-2の処理が済んでいれば done >= p-1 */
+        if (handoff->input_pos == 0) {
+            if ((uint32_t)(period - handoff->done) <= 1) {
+                handoff->output_valid = 1;
+            } else {
+                /* 間に合わなかった周期は寄与を0とする */
+                handoff->output_valid = 0;
+                handoff->num_missed_deadlines++;
+            }
+            /* doneの読み出しを出力スロットの読み出しより先に行う */
+            AE2NONUNIFORMFFTCONVOLVE_MEMORY_BARRIER();
+        }
+
+        /* 入力を書き込み */
+        memcpy(input_slot, &input[progress], sizeof(float) * num_process);
+
+        /* 結果を加算 */
+        if (handoff->output_valid) {
+            for (smpl = 0; smpl < num_process; smpl++) {
+                output[progress + smpl] += output_slot[smpl];
+            }
+        }
+
+        handoff->input_pos += num_process;
+        progress += num_process;
+
+        /* 周期の入力が揃ったら公開 */
+        if (handoff->input_pos == partition_size) {
+            /* スロットへの書き込みを公開より先に行う */
+            AE2NONUNIFORMFFTCONVOLVE_MEMORY_BARRIER();
+            handoff->published = period + 1;
+            handoff->input_pos = 0;
+        }
+    }
+}
+
+/* バックグラウンド処理 */
+int32_t AE2NonUniformFFTConvolve_ProcessBackground(void *obj)
+{
+    uint32_t stage;
+    int32_t num_processed = 0;
+    struct AE2NonUniformFFTConvolve *conv = (struct AE2NonUniformFFTConvolve *)obj;
+    const uint32_t slot_mask = AE2NONUNIFORMFFTCONVOLVE_NUM_HANDOFF_SLOTS - 1;
+
+    assert(obj != NULL);
+
+    /* 締め切りの短い（分割サイズの小さい）段から処理 */
+    for (stage = 0; stage < conv->num_active_stages; stage++) {
+        struct AE2NonUniformFFTConvolveHandoff *handoff = &conv->handoffs[stage];
+        const uint32_t partition_size = conv->layout.stage_partition_sizes[stage];
+
+        if (!conv->layout.stage_is_async[stage]) {
+            continue;
+        }
+
+        /* 公開済みの周期を全て処理 */
+        while (handoff->done != handoff->published) {
+            const uint32_t job = handoff->done;
+            /* publishedの読み出しをスロットの読み出しより先に行う */
+            AE2NONUNIFORMFFTCONVOLVE_MEMORY_BARRIER();
+            memcpy(handoff->work_input,
+                    &handoff->input_slots[(job & slot_mask) * partition_size], sizeof(float) * partition_size);
+            AE2NONUNIFORMFFTCONVOLVE_MEMORY_BARRIER();
+            /* コピー中にスロットが再利用された（スロット数以上遅れた）場合は入力を0とする */
+            /* 時間位置を保つため、畳み込み自体は省略しない */
+            if ((uint32_t)(handoff->published - job) >= AE2NONUNIFORMFFTCONVOLVE_NUM_HANDOFF_SLOTS) {
+                memset(handoff->work_input, 0, sizeof(float) * partition_size);
+            }
+            AE2FFTConvolve_ConvolveBlock(conv->freq_conv_objs[stage],
+                    handoff->work_input, &handoff->output_slots[(job & slot_mask) * partition_size]);
+            /* 結果の書き込みを完了通知より先に行う */
+            AE2NONUNIFORMFFTCONVOLVE_MEMORY_BARRIER();
+            handoff->done = job + 1;
+            num_processed++;
+        }
+    }
+
+    return num_processed;
+}
+
+/* 処理が間に合わなかった周期数の取得 */
+uint32_t AE2NonUniformFFTConvolve_GetNumMissedDeadlines(const void *obj)
+{
+    uint32_t stage, num_missed = 0;
+    const struct AE2NonUniformFFTConvolve *conv = (const struct AE2NonUniformFFTConvolve *)obj;
+
+    assert(obj != NULL);
+
+    for (stage = 0; stage < conv->layout.num_stages; stage++) {
+        num_missed += conv->handoffs[stage].num_missed_deadlines;
+    }
+
+    return num_missed;
+}
+
+/* 内部状態リセット */
+static void AE2NonUniformFFTConvolve_Reset(void *obj)
+{
+    uint32_t stage;
+    struct AE2NonUniformFFTConvolve *conv = (struct AE2NonUniformFFTConvolve *)obj;
+
+    assert(obj != NULL);
+
+    /* 各畳み込みモジュールのリセット */
+    conv->time_conv_if->Reset(conv->time_conv_obj);
+    for (stage = 0; stage < conv->layout.num_stages; stage++) {
+        conv->freq_conv_if->Reset(conv->freq_conv_objs[stage]);
+    }
+
+    /* 受け渡しバッファのリセット */
+    for (stage = 0; stage < conv->layout.num_stages; stage++) {
+        struct AE2NonUniformFFTConvolveHandoff *handoff = &conv->handoffs[stage];
+        if (conv->layout.stage_is_async[stage]) {
+            const uint32_t partition_size = conv->layout.stage_partition_sizes[stage];
+            memset(handoff->input_slots, 0, sizeof(float) * partition_size * AE2NONUNIFORMFFTCONVOLVE_NUM_HANDOFF_SLOTS);
+            memset(handoff->output_slots, 0, sizeof(float) * partition_size * AE2NONUNIFORMFFTCONVOLVE_NUM_HANDOFF_SLOTS);
+        }
+        handoff->input_pos = 0;
+        handoff->published = 0;
+        handoff->done = 0;
+        handoff->output_valid = 0;
+        handoff->num_missed_deadlines = 0;
+    }
+}
+
+/* レイテンシーの取得 */
+static int32_t AE2NonUniformFFTConvolve_GetLatencyNumSamples(void *obj)
+{
+    (void)obj;
+    return 0;
+}
+
+/* 2の冪乗に切り上げ */
+static uint32_t AE2NonUniformFFTConvolve_Roundup2PoweredValue(uint32_t val)
+{
+    val--;
+    val |= val >> 1;
+    val |= val >> 2;
+    val |= val >> 4;
+    val |= val >> 8;
+    val |= val >> 16;
+    val++;
+
+    return val;
+}
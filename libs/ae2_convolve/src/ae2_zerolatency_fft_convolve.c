@@ -21,6 +21,15 @@
 /* nの倍数切り上げ */
 #define ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
 
+/* 複数インスタンスで共有する係数 */
+struct AE2ZeroLatencyFFTConvolveSharedCoefficients {
+    float *head_coefficients; /* 時間領域畳み込みで扱う先頭の係数 */
+    uint32_t num_head_coefficients; /* 先頭の係数長 */
+    uint8_t use_freq_conv; /* 周波数畳み込みを行うか？ */
+    struct AE2FFTConvolveSharedCoefficients *tail; /* 周波数領域畳み込みで扱う後半のフーリエ変換済み係数 */
+    uint32_t num_references; /* 参照しているインスタンス数 */
+};
+
 struct AE2ZeroLatencyFFTConvolve {
     const struct AE2ConvolveInterface *time_conv_if; /* 時間領域畳み込みモジュールインターフェース	*/
     const struct AE2ConvolveInterface *freq_conv_if; /* 周波数領域畳み込みモジュールインターフェース */
@@ -30,6 +39,7 @@ struct AE2ZeroLatencyFFTConvolve {
     struct AE2RingBuffer *input_buffer; /* 入力遅延バッファ */
     float *output_buffer; /* 出力データバッファ */
     uint32_t max_num_input_samples; /* 最大入力サンプル数 */
+    struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared; /* 参照している共有係数（NULLの場合は係数を自身で保持） */
 };
 
 /* ワークサイズ取得 */
@@ -46,6 +56,13 @@ static void	AE2ZeroLatencyFFTConvolve_SetCoefficients(void *obj, const float *co
 static void	AE2ZeroLatencyFFTConvolve_Convolve(void *obj, const float *input, float *output, uint32_t num_samples);
 /* レイテンシ取得 */
 static int32_t AE2ZeroLatencyFFTConvolve_GetLatencyNumSamples(void *obj);
+/* 周波数領域畳み込みモジュールの分割サイズ計算 */
+static uint32_t AE2ZeroLatencyFFTConvolve_CalculatePartitionSize(const struct AE2ConvolveConfig *config);
+/* ワークサイズ計算（共通処理） */
+static int32_t AE2ZeroLatencyFFTConvolve_CalculateWorkSizeCore(const struct AE2ConvolveConfig *config, uint8_t has_coefficients);
+/* インスタンス生成（共通処理） */
+static struct AE2ZeroLatencyFFTConvolve *AE2ZeroLatencyFFTConvolve_CreateCore(
+        const struct AE2ConvolveConfig *config, struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared, void *work, int32_t work_size);
 
 /* インターフェース */
 static const struct AE2ConvolveInterface st_ribara_convolve_if = {
@@ -66,6 +83,18 @@ const struct AE2ConvolveInterface* AE2ZeroLatencyFFTConvolve_GetInterface(void)
 
 /* ワークサイズ計算 */
 static int32_t AE2ZeroLatencyFFTConvolve_CalculateWorkSize(const struct AE2ConvolveConfig *config)
+{
+    return AE2ZeroLatencyFFTConvolve_CalculateWorkSizeCore(config, 1);
+}
+
+/* 共有係数を参照するインスタンスのワークサイズ計算 */
+int32_t AE2ZeroLatencyFFTConvolve_CalculateSharedWorkSize(const struct AE2ConvolveConfig *config)
+{
+    return AE2ZeroLatencyFFTConvolve_CalculateWorkSizeCore(config, 0);
+}
+
+/* ワークサイズ計算（共通処理） */
+static int32_t AE2ZeroLatencyFFTConvolve_CalculateWorkSizeCore(const struct AE2ConvolveConfig *config, uint8_t has_coefficients)
 {
     int32_t	time_conv_size, freq_conv_size, delay_buffer_size, work_size;
     struct AE2RingBufferConfig buffer_config;
@@ -80,6 +109,7 @@ static int32_t AE2ZeroLatencyFFTConvolve_CalculateWorkSize(const struct AE2Convo
 
     /* 最大入力サンプル数は共通 */
     conv_config.max_num_input_samples = config->max_num_input_samples;
+    conv_config.partition_size = AE2ZeroLatencyFFTConvolve_CalculatePartitionSize(config);
 
     /* 時間領域畳み込みモジュール分 */
     conv_config.max_num_coefficients = AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS;
@@ -87,9 +117,10 @@ static int32_t AE2ZeroLatencyFFTConvolve_CalculateWorkSize(const struct AE2Convo
         return -1;
     }
 
-    /* 周波数領域畳み込みモジュール分 */
+    /* 周波数領域畳み込みモジュール分（共有係数を参照する場合は係数領域を持たない） */
     conv_config.max_num_coefficients = config->max_num_coefficients;
-    if ((freq_conv_size = freq_conv_if->CalculateWorkSize(&conv_config)) < 0) {
+    freq_conv_size = has_coefficients ? freq_conv_if->CalculateWorkSize(&conv_config) : AE2FFTConvolve_CalculateSharedWorkSize(&conv_config);
+    if (freq_conv_size < 0) {
         return -1;
     }
 
@@ -110,6 +141,37 @@ static int32_t AE2ZeroLatencyFFTConvolve_CalculateWorkSize(const struct AE2Convo
 
 /* インスタンス生成 */
 static void* AE2ZeroLatencyFFTConvolve_Create(const struct AE2ConvolveConfig *config, void *work, int32_t work_size)
+{
+    return AE2ZeroLatencyFFTConvolve_CreateCore(config, NULL, work, work_size);
+}
+
+/* 共有係数を参照するインスタンス生成 */
+void *AE2ZeroLatencyFFTConvolve_CreateShared(const struct AE2ConvolveConfig *config,
+        struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared, void *work, int32_t work_size)
+{
+    struct AE2ZeroLatencyFFTConvolve *conv;
+
+    if (shared == NULL) {
+        return NULL;
+    }
+
+    if ((conv = AE2ZeroLatencyFFTConvolve_CreateCore(config, shared, work, work_size)) == NULL) {
+        return NULL;
+    }
+
+    /* 先頭の係数は時間領域畳み込みモジュールにコピー（係数長が短いため共有しない） */
+    conv->use_freq_conv = shared->use_freq_conv;
+    conv->time_conv_if->SetCoefficients(conv->time_conv_obj, shared->head_coefficients, shared->num_head_coefficients);
+    shared->num_references++;
+
+    AE2ZeroLatencyFFTConvolve_Reset(conv);
+
+    return conv;
+}
+
+/* インスタンス生成（共通処理） */
+static struct AE2ZeroLatencyFFTConvolve *AE2ZeroLatencyFFTConvolve_CreateCore(
+        const struct AE2ConvolveConfig *config, struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared, void *work, int32_t work_size)
 {
     struct AE2ZeroLatencyFFTConvolve *conv;
     uint8_t *work_ptr = (uint8_t *)work;
@@ -119,7 +181,7 @@ static void* AE2ZeroLatencyFFTConvolve_Create(const struct AE2ConvolveConfig *co
 
     /* 引数チェック */
     if ((config == NULL) || (work == NULL)
-            || (work_size < AE2ZeroLatencyFFTConvolve_CalculateWorkSize(config))) {
+            || (work_size < AE2ZeroLatencyFFTConvolve_CalculateWorkSizeCore(config, (shared == NULL) ? 1 : 0))) {
         return NULL;
     }
 
@@ -131,10 +193,12 @@ static void* AE2ZeroLatencyFFTConvolve_Create(const struct AE2ConvolveConfig *co
     conv->time_conv_if = AE2Karatsuba_GetInterface();
     conv->freq_conv_if = AE2FFTConvolve_GetInterface();
     conv->max_num_input_samples = config->max_num_input_samples;
+    conv->shared = NULL;
     work_ptr += sizeof(struct AE2ZeroLatencyFFTConvolve);
 
     /* 共通のパラメータ設定項目 */
     conv_config.max_num_input_samples = config->max_num_input_samples;
+    conv_config.partition_size = AE2ZeroLatencyFFTConvolve_CalculatePartitionSize(config);
 
     /* 時間領域畳み込みモジュール */
     conv_config.max_num_coefficients = AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS;
@@ -146,10 +210,21 @@ static void* AE2ZeroLatencyFFTConvolve_Create(const struct AE2ConvolveConfig *co
 
     /* 周波数領域畳み込みモジュール */
     conv_config.max_num_coefficients = config->max_num_coefficients;
-    if ((tmp_work_size = conv->freq_conv_if->CalculateWorkSize(&conv_config)) < 0) {
-        return NULL;
+    if (shared == NULL) {
+        if ((tmp_work_size = conv->freq_conv_if->CalculateWorkSize(&conv_config)) < 0) {
+            return NULL;
+        }
+        conv->freq_conv_obj = conv->freq_conv_if->Create(&conv_config, work_ptr, tmp_work_size);
+    } else {
+        /* 後半の係数は共有係数を参照 */
+        if ((tmp_work_size = AE2FFTConvolve_CalculateSharedWorkSize(&conv_config)) < 0) {
+            return NULL;
+        }
+        if ((conv->freq_conv_obj = AE2FFTConvolve_CreateShared(&conv_config, shared->tail, work_ptr, tmp_work_size)) == NULL) {
+            return NULL;
+        }
+        conv->shared = shared;
     }
-    conv->freq_conv_obj = conv->freq_conv_if->Create(&conv_config, work_ptr, tmp_work_size);
     work_ptr += tmp_work_size;
 
     /* ディレイバッファ */
@@ -180,6 +255,12 @@ static void AE2ZeroLatencyFFTConvolve_Destroy(void *obj)
         /* 各畳み込みモジュールの破棄 */
         conv->time_conv_if->Destroy(conv->time_conv_obj);
         conv->freq_conv_if->Destroy(conv->freq_conv_obj);
+        /* 共有係数の参照を解放 */
+        if (conv->shared != NULL) {
+            assert(conv->shared->num_references > 0);
+            conv->shared->num_references--;
+            conv->shared = NULL;
+        }
     }
 }
 
@@ -188,6 +269,9 @@ static void AE2ZeroLatencyFFTConvolve_SetCoefficients(void *obj, const float *co
 {
     struct AE2ZeroLatencyFFTConvolve *conv = (struct AE2ZeroLatencyFFTConvolve *)obj;
 
+    /* 共有係数は読み取り専用 */
+    assert(conv->shared == NULL);
+
     if (num_coefficients > AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS) {
         conv->use_freq_conv = 1;
         /* 先頭分を時間領域畳み込みモジュールにセット */
@@ -206,6 +290,97 @@ static void AE2ZeroLatencyFFTConvolve_SetCoefficients(void *obj, const float *co
     AE2ZeroLatencyFFTConvolve_Reset(conv);
 }
 
+/* 共有係数作成に必要なワークサイズ計算 */
+int32_t AE2ZeroLatencyFFTConvolve_CalculateSharedCoefficientsWorkSize(const struct AE2ConvolveConfig *config)
+{
+    int32_t work_size, tail_work_size;
+    struct AE2ConvolveConfig conv_config;
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* 後半の係数はインスタンスの周波数領域畳み込みモジュールと同じ設定で変換する */
+    conv_config.max_num_input_samples = config->max_num_input_samples;
+    conv_config.max_num_coefficients = config->max_num_coefficients;
+    conv_config.partition_size = AE2ZeroLatencyFFTConvolve_CalculatePartitionSize(config);
+    if ((tail_work_size = AE2FFTConvolve_CalculateSharedCoefficientsWorkSize(&conv_config)) < 0) {
+        return -1;
+    }
+
+    work_size = sizeof(struct AE2ZeroLatencyFFTConvolveSharedCoefficients) + AE2BARACONVOLVE_ALIGNMENT;
+    work_size += sizeof(float) * AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS + AE2BARACONVOLVE_ALIGNMENT;
+    work_size += tail_work_size;
+
+    return work_size;
+}
+
+/* 共有係数作成 */
+struct AE2ZeroLatencyFFTConvolveSharedCoefficients *AE2ZeroLatencyFFTConvolve_CreateSharedCoefficients(
+        const struct AE2ConvolveConfig *config, const float *coefficients, uint32_t num_coefficients,
+        void *work, int32_t work_size)
+{
+    struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared;
+    uint8_t *work_ptr = (uint8_t *)work;
+    struct AE2ConvolveConfig conv_config;
+    int32_t tail_work_size;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL) || (coefficients == NULL)
+            || (num_coefficients > config->max_num_coefficients)
+            || (work_size < AE2ZeroLatencyFFTConvolve_CalculateSharedCoefficientsWorkSize(config))) {
+        return NULL;
+    }
+
+    /* 構造体配置 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2BARACONVOLVE_ALIGNMENT);
+    shared = (struct AE2ZeroLatencyFFTConvolveSharedCoefficients *)work_ptr;
+    shared->num_head_coefficients = MIN(num_coefficients, AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS);
+    shared->use_freq_conv = (num_coefficients > AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS) ? 1 : 0;
+    shared->num_references = 0;
+    work_ptr += sizeof(struct AE2ZeroLatencyFFTConvolveSharedCoefficients);
+
+    /* 先頭の係数 */
+    work_ptr = (uint8_t *)ROUNDUP((uintptr_t)work_ptr, AE2BARACONVOLVE_ALIGNMENT);
+    shared->head_coefficients = (float *)work_ptr;
+    memcpy(shared->head_coefficients, coefficients, sizeof(float) * shared->num_head_coefficients);
+    work_ptr += sizeof(float) * AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS;
+
+    /* 後半の係数（なければ0の係数） */
+    conv_config.max_num_input_samples = config->max_num_input_samples;
+    conv_config.max_num_coefficients = config->max_num_coefficients;
+    conv_config.partition_size = AE2ZeroLatencyFFTConvolve_CalculatePartitionSize(config);
+    if ((tail_work_size = AE2FFTConvolve_CalculateSharedCoefficientsWorkSize(&conv_config)) < 0) {
+        return NULL;
+    }
+    if ((shared->tail = AE2FFTConvolve_CreateSharedCoefficients(&conv_config,
+                    &coefficients[shared->num_head_coefficients], num_coefficients - shared->num_head_coefficients,
+                    work_ptr, tail_work_size)) == NULL) {
+        return NULL;
+    }
+    work_ptr += tail_work_size;
+
+    return shared;
+}
+
+/* 共有係数破棄 */
+void AE2ZeroLatencyFFTConvolve_DestroySharedCoefficients(struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared)
+{
+    if (shared != NULL) {
+        /* 参照しているインスタンスを先に破棄すること */
+        assert(shared->num_references == 0);
+        AE2FFTConvolve_DestroySharedCoefficients(shared->tail);
+    }
+}
+
+/* 共有係数を参照しているインスタンス数の取得 */
+uint32_t AE2ZeroLatencyFFTConvolve_GetSharedCoefficientsNumReferences(const struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared)
+{
+    assert(shared != NULL);
+    return shared->num_references;
+}
+
 /* 畳み込み計算 */
 static void AE2ZeroLatencyFFTConvolve_Convolve(void *obj, const float *input, float *output, uint32_t num_samples)
 {
@@ -262,3 +437,21 @@ static int32_t AE2ZeroLatencyFFTConvolve_GetLatencyNumSamples(void *obj)
     (void)obj;
     return 0;
 }
+
+/* 周波数領域畳み込みモジュールの分割サイズ計算 */
+static uint32_t AE2ZeroLatencyFFTConvolve_CalculatePartitionSize(const struct AE2ConvolveConfig *config)
+{
+    uint32_t partition_size;
+
+    assert(config != NULL);
+
+    /* 指定がなければ時間領域畳み込みの係数長に合わせる */
+    /* レイテンシは時間領域畳み込みで隠れるため、これより小さくしてもFFTと複素乗算の回数が増えるだけ */
+    if (config->partition_size == 0) {
+        return AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS;
+    }
+
+    /* 周波数領域畳み込みのレイテンシ（=分割サイズ）は時間領域畳み込みの係数長で隠せる範囲に収める */
+    partition_size = config->partition_size;
+    return MIN(partition_size, AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS);
+}
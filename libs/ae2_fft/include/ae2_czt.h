@@ -0,0 +1,81 @@
+/*!
+* @file ae2_czt.h
+* @brief CZT(Chirp Z-Transform, チャープZ変換)ライブラリ
+*/
+#ifndef AE2CZT_H_INCLUDED
+#define AE2CZT_H_INCLUDED
+
+#include <stdint.h>
+
+/*!
+* @brief CZT生成コンフィグ
+* @note 周波数はサンプリング周波数で正規化した値（サイクル/サンプル）で指定します
+* @note start_frequency = 0.0, frequency_step = 1.0 / num_input_samples, num_output_bins = num_input_samples の場合は任意長のDFTと一致します
+*/
+struct AE2CZTConfig {
+    int32_t num_input_samples; /*!< 入力サンプル数（任意の正の値） */
+    int32_t num_output_bins; /*!< 出力周波数ビン数（任意の正の値） */
+    double start_frequency; /*!< 先頭ビンの正規化周波数 */
+    double frequency_step; /*!< ビン間隔の正規化周波数 */
+};
+
+/*!
+* @brief CZT
+* @note 作業領域を保持します。同一インスタンスを複数スレッドから同時に使用しないでください
+*/
+struct AE2CZT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+* @brief CZT作成に必要なワークサイズ計算
+* @param[in] config CZT生成コンフィグ
+* @return int32_t 計算に成功した場合は0以上の値を、失敗した場合は負の値を返します
+* @sa AE2CZT_Create
+*/
+int32_t AE2CZT_CalculateWorkSize(const struct AE2CZTConfig *config);
+
+/*!
+* @brief CZT作成
+* @param[in] config CZT生成コンフィグ
+* @param[in,out] work CZT生成に使用するワーク領域
+* @param[in] work_size CZT生成に使用するワーク領域サイズ
+* @return AE2CZT 生成に成功した場合は構造体のポインタを、失敗した場合はNULLを返します
+* @note チャープ系列とそのスペクトルはここで全て計算します。変換実行時に三角関数は呼び出しません
+* @sa AE2CZT_CalculateWorkSize
+*/
+struct AE2CZT *AE2CZT_Create(const struct AE2CZTConfig *config, void *work, int32_t work_size);
+
+/*!
+* @brief CZT破棄
+* @param[in,out] czt CZT
+* @sa AE2CZT_Create
+* @attention 本関数実行後、CZTは不定になります
+*/
+void AE2CZT_Destroy(struct AE2CZT *czt);
+
+/*!
+* @brief 内部で使用するFFT点数の取得
+* @param[in] czt CZT
+* @return int32_t FFT点数（入力サンプル数 + 出力ビン数 - 1 以上の値）
+*/
+int32_t AE2CZT_GetFFTSize(const struct AE2CZT *czt);
+
+/*!
+* @brief CZT（Bluestein法）
+* @param[in,out] czt CZT
+* @param[in] flag -1:順方向変換, 1:逆方向変換（回転方向を反転）
+* @param[in] input 変換する系列(num_input_samples * 2サイズ必須, 偶数番目に実数部, 奇数番目に虚数部)
+* @param[out] output 変換結果(num_output_bins * 2サイズ必須, 配置はinputと同一)
+* @note output[k] = sum_n input[n] * exp(flag * 2πi * (start_frequency + k * frequency_step) * n) を計算します
+* @note 正規化は行いません
+*/
+void AE2CZT_Transform(struct AE2CZT *czt, int flag, const float *input, float *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AE2CZT_H_INCLUDED */
@@ -0,0 +1,169 @@
+/*!
+* @file ae2_dct.h
+* @brief DCT(Discrete Cosine Transform, 離散コサイン変換)・MDCTライブラリ
+*/
+#ifndef AE2DCT_H_INCLUDED
+#define AE2DCT_H_INCLUDED
+
+#include <stdint.h>
+
+/*!
+* @brief DCTの種類
+*/
+typedef enum {
+    AE2DCT_TYPE_II = 0, /*!< DCT-II（逆変換はDCT-III） */
+    AE2DCT_TYPE_IV /*!< DCT-IV（逆変換もDCT-IV） */
+} AE2DCTType;
+
+/*!
+* @brief DCT生成コンフィグ
+*/
+struct AE2DCTConfig {
+    int32_t size; /*!< 変換点数（4以上の偶数で、その半分が2, 3, 5の積で表せる値） */
+    AE2DCTType type; /*!< DCTの種類 */
+};
+
+/*!
+* @brief MDCT生成コンフィグ
+*/
+struct AE2MDCTConfig {
+    int32_t num_coefficients; /*!< 係数の数N（ホップサイズ。4以上の偶数で、その半分が2, 3, 5の積で表せる値） */
+    const float *window; /*!< 2Nサイズの窓関数（w[n]^2 + w[n + N]^2 = 1 かつ左右対称であること）。NULLの場合はサイン窓を使用 */
+};
+
+/*!
+* @brief DCT
+* @note 作業領域を保持します。同一インスタンスを複数スレッドから同時に使用しないでください
+*/
+struct AE2DCT;
+
+/*!
+* @brief MDCT
+* @note 分析・合成それぞれの直前のフレームを保持します。同一インスタンスを複数スレッドから同時に使用しないでください
+*/
+struct AE2MDCT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+* @brief DCT作成に必要なワークサイズ計算
+* @param[in] config DCT生成コンフィグ
+* @return int32_t 計算に成功した場合は0以上の値を、失敗した場合は負の値を返します
+* @sa AE2DCT_Create
+*/
+int32_t AE2DCT_CalculateWorkSize(const struct AE2DCTConfig *config);
+
+/*!
+* @brief DCT作成
+* @param[in] config DCT生成コンフィグ
+* @param[in,out] work DCT生成に使用するワーク領域
+* @param[in] work_size DCT生成に使用するワーク領域サイズ
+* @return AE2DCT 生成に成功した場合は構造体のポインタを、失敗した場合はNULLを返します
+* @note DCT-IIは点数nの実数FFT、DCT-IVは点数n/2の複素FFTで計算します。前後処理の回転因子はここで全て計算します
+* @sa AE2DCT_CalculateWorkSize
+*/
+struct AE2DCT *AE2DCT_Create(const struct AE2DCTConfig *config, void *work, int32_t work_size);
+
+/*!
+* @brief DCT破棄
+* @param[in,out] dct DCT
+* @sa AE2DCT_Create
+* @attention 本関数実行後、DCTは不定になります
+*/
+void AE2DCT_Destroy(struct AE2DCT *dct);
+
+/*!
+* @brief 変換点数の取得
+* @param[in] dct DCT
+* @return int32_t 変換点数
+*/
+int32_t AE2DCT_GetSize(const struct AE2DCT *dct);
+
+/*!
+* @brief DCT（順変換）
+* @param[in,out] dct DCT
+* @param[in] input 変換する系列(nサイズ必須)
+* @param[out] output 変換結果(nサイズ必須, inputと同一の領域を指定可能)
+* @note DCT-II: output[k] = sum_i input[i] * cos(π/n * (i + 1/2) * k)
+* @note DCT-IV: output[k] = sum_i input[i] * cos(π/n * (i + 1/2) * (k + 1/2))
+* @note 正規化は行いません
+*/
+void AE2DCT_Forward(struct AE2DCT *dct, const float *input, float *output);
+
+/*!
+* @brief DCT（逆変換）
+* @param[in,out] dct DCT
+* @param[in] input 変換する系列(nサイズ必須)
+* @param[out] output 変換結果(nサイズ必須, inputと同一の領域を指定可能)
+* @note DCT-IIの場合はDCT-III（input[0]は1/2倍）、DCT-IVの場合はDCT-IVを計算します
+* @note 正規化は行いません。正規化定数は2/nです
+*/
+void AE2DCT_Inverse(struct AE2DCT *dct, const float *input, float *output);
+
+/*!
+* @brief MDCT作成に必要なワークサイズ計算
+* @param[in] config MDCT生成コンフィグ
+* @return int32_t 計算に成功した場合は0以上の値を、失敗した場合は負の値を返します
+* @sa AE2MDCT_Create
+*/
+int32_t AE2MDCT_CalculateWorkSize(const struct AE2MDCTConfig *config);
+
+/*!
+* @brief MDCT作成
+* @param[in] config MDCT生成コンフィグ
+* @param[in,out] work MDCT生成に使用するワーク領域
+* @param[in] work_size MDCT生成に使用するワーク領域サイズ
+* @return AE2MDCT 生成に成功した場合は構造体のポインタを、失敗した場合はNULLを返します
+* @note 窓関数はここでコピーします
+* @sa AE2MDCT_CalculateWorkSize
+*/
+struct AE2MDCT *AE2MDCT_Create(const struct AE2MDCTConfig *config, void *work, int32_t work_size);
+
+/*!
+* @brief MDCT破棄
+* @param[in,out] mdct MDCT
+* @sa AE2MDCT_Create
+* @attention 本関数実行後、MDCTは不定になります
+*/
+void AE2MDCT_Destroy(struct AE2MDCT *mdct);
+
+/*!
+* @brief 内部状態のリセット
+* @param[in,out] mdct MDCT
+* @note 分析側の直前の入力と、合成側の重畳加算バッファを0クリアします
+*/
+void AE2MDCT_Reset(struct AE2MDCT *mdct);
+
+/*!
+* @brief 係数の数の取得
+* @param[in] mdct MDCT
+* @return int32_t 係数の数（ホップサイズ）
+*/
+int32_t AE2MDCT_GetNumCoefficients(const struct AE2MDCT *mdct);
+
+/*!
+* @brief MDCT分析
+* @param[in,out] mdct MDCT
+* @param[in] input 新しい入力サンプル(Nサイズ必須)
+* @param[out] coefficients MDCT係数(Nサイズ必須)
+* @note 直前の入力N点とinputを連結した2N点に窓をかけて変換します
+*/
+void AE2MDCT_Analyze(struct AE2MDCT *mdct, const float *input, float *coefficients);
+
+/*!
+* @brief MDCT合成（IMDCTと重畳加算）
+* @param[in,out] mdct MDCT
+* @param[in] coefficients MDCT係数(Nサイズ必須)
+* @param[out] output 出力サンプル(Nサイズ必須)
+* @note 逆変換結果に窓をかけて直前のフレームと重畳加算し、時間領域エイリアシングを打ち消します（TDAC）
+* @note AE2MDCT_Analyzeの結果をそのまま与えると、Nサンプル遅れて入力を完全再構成します
+*/
+void AE2MDCT_Synthesize(struct AE2MDCT *mdct, const float *coefficients, float *output);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AE2DCT_H_INCLUDED */
@@ -5,11 +5,37 @@
 #ifndef AE2FFT_H_INCLUDED
 #define AE2FFT_H_INCLUDED
 
+#include <stdint.h>
+
 /*! @brief i番目の複素数の実数部にアクセス */
 #define AE2FFTCOMPLEX_REAL(flt_array, i) ((flt_array)[((i) << 1)])
 /*! @brief i番目の複素数の虚数部にアクセス */
 #define AE2FFTCOMPLEX_IMAG(flt_array, i) ((flt_array)[((i) << 1) + 1])
 
+/*!
+* @brief FFTプランの変換タイプ
+*/
+typedef enum {
+    AE2FFTPLAN_TYPE_COMPLEX = 0, /*!< 複素数列のFFT（AE2FFT_FloatFFT相当） */
+    AE2FFTPLAN_TYPE_REAL /*!< 実数列のFFT（AE2FFT_RealFFT相当） */
+} AE2FFTPlanType;
+
+/*!
+* @brief FFTプラン生成コンフィグ
+*/
+struct AE2FFTPlanConfig {
+    int32_t fft_size; /*!< FFT点数（2, 3, 5の積で表せる2以上の値。実数FFTの場合は偶数で、その半分も2, 3, 5の積で表せること） */
+    AE2FFTPlanType type; /*!< 変換タイプ */
+    int32_t in_place; /*!< 0以外の場合、作業領域を持たないインプレース変換のプランを作成（複素FFTの点数が2の冪乗の場合のみ） */
+    int32_t double_precision; /*!< 0以外の場合、倍精度の変換（AE2FFTPlan_DoubleFFT, AE2FFTPlan_DoubleRealFFT）用の回転因子テーブルも作成 */
+};
+
+/*!
+* @brief FFTプラン
+* @note 回転因子テーブルと作業領域を保持します。同一プランを複数スレッドから同時に使用しないでください
+*/
+struct AE2FFTPlan;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -34,6 +60,225 @@ void AE2FFT_FloatFFT(int n, int flag, float *x, float *y);
 */
 void AE2FFT_RealFFT(int n, int flag, float *x, float *y);
 
+/*!
+* @brief FFTプラン作成に必要なワークサイズ計算
+* @param[in] config FFTプラン生成コンフィグ
+* @return int32_t 計算に成功した場合は0以上の値を、失敗した場合は負の値を返します
+* @sa AE2FFTPlan_Create
+*/
+int32_t AE2FFTPlan_CalculateWorkSize(const struct AE2FFTPlanConfig *config);
+
+/*!
+* @brief FFTプラン作成
+* @param[in] config FFTプラン生成コンフィグ
+* @param[in,out] work FFTプラン生成に使用するワーク領域
+* @param[in] work_size FFTプラン生成に使用するワーク領域サイズ
+* @return AE2FFTPlan 生成に成功した場合は構造体のポインタを、失敗した場合はNULLを返します
+* @note 回転因子はここで全て計算します。変換実行時に三角関数は呼び出しません
+* @note 回転因子は倍精度で計算してから丸めるため、単精度の変換でもテーブルの誤差は丸め誤差のみで点数に依存しません
+* @note 点数を4, 3, 5, 2基底の段に分解した混合基底FFTを構成します（例: 480, 960, 1440, 1920点）
+* @note in_placeを指定した場合は点数分の作業領域を確保せず、4基底の周波数間引きFFTとビット反転による並べ替えで変換します
+* @sa AE2FFTPlan_CalculateWorkSize
+*/
+struct AE2FFTPlan *AE2FFTPlan_Create(const struct AE2FFTPlanConfig *config, void *work, int32_t work_size);
+
+/*!
+* @brief FFTプラン破棄
+* @param[in,out] plan FFTプラン
+* @sa AE2FFTPlan_Create
+* @attention 本関数実行後、FFTプランは不定になります
+*/
+void AE2FFTPlan_Destroy(struct AE2FFTPlan *plan);
+
+/*!
+* @brief FFT点数の取得
+* @param[in] plan FFTプラン
+* @return int32_t FFT点数
+*/
+int32_t AE2FFTPlan_GetFFTSize(const struct AE2FFTPlan *plan);
+
+/*!
+* @brief プランを使用したFFT（高速フーリエ変換）
+* @param[in,out] plan FFTプラン（AE2FFTPLAN_TYPE_COMPLEXで作成したもの）
+* @param[in] flag -1:FFT, 1:IFFT
+* @param[in,out] x フーリエ変換する系列(入出力 2nサイズ必須, 偶数番目に実数部, 奇数番目に虚数部)
+* @note 正規化は行いません
+* @sa AE2FFT_FloatFFT
+*/
+void AE2FFTPlan_FloatFFT(struct AE2FFTPlan *plan, int flag, float *x);
+
+/*!
+* @brief プランを使用した複数系列のFFT（高速フーリエ変換）
+* @param[in] plan FFTプラン（AE2FFTPLAN_TYPE_COMPLEXで作成したもの）
+* @param[in] flag -1:FFT, 1:IFFT
+* @param[in] num_batch 系列数
+* @param[in,out] x フーリエ変換する系列(入出力 2 * num_batch * nサイズ必須, i番目の系列のk番目の複素数はnum_batch * k + i番目に配置)
+* @param[in,out] y 作業用配列(xと同一サイズ)
+* @note 正規化は行いません
+* @note プランの作業領域は使用しないため、作業用配列を分ければ同一プランを複数スレッドから同時に使用できます
+* @sa AE2FFTPlan_FloatFFT
+*/
+void AE2FFTPlan_FloatFFTBatch(const struct AE2FFTPlan *plan, int flag, int32_t num_batch, float *x, float *y);
+
+/*!
+* @brief プランを使用した実数配列のFFT（高速フーリエ変換）
+* @param[in,out] plan FFTプラン（AE2FFTPLAN_TYPE_REALで作成したもの）
+* @param[in] flag -1:FFT, 1:IFFT
+* @param[in,out] x フーリエ変換する系列(入出力 nサイズ必須, FFTの場合, x[0]に直流成分の実部, x[1]に最高周波数成分の虚数部が入る)
+* @note 正規化は行いません。正規化定数は2/nです
+* @sa AE2FFT_RealFFT
+*/
+void AE2FFTPlan_RealFFT(struct AE2FFTPlan *plan, int flag, float *x);
+
+/*!
+* @brief プランを使用した複数チャンネルの実数配列のFFT（高速フーリエ変換）
+* @param[in,out] plan FFTプラン（AE2FFTPLAN_TYPE_REALで作成したもの）
+* @param[in] flag -1:FFT, 1:IFFT
+* @param[in] num_channels チャンネル数
+* @param[in,out] x フーリエ変換する系列の配列(各チャンネル入出力 nサイズ必須, 配置はAE2FFTPlan_RealFFTと同一)
+* @param[in,out] work 作業用配列(2 * num_channels * nサイズ必須)
+* @note 全チャンネルをインターリーブして一度に変換するため、小さい点数でもSIMDカーネルが有効に働きます
+* @note 正規化は行いません。正規化定数は2/nです
+* @sa AE2FFTPlan_RealFFT
+*/
+void AE2FFTPlan_RealFFTBatch(struct AE2FFTPlan *plan, int flag, int32_t num_channels, float **x, float *work);
+
+/*!
+* @brief プランを使用した実数配列のFFT（n/2+1点の半スペクトルを出力）
+* @param[in,out] plan FFTプラン（AE2FFTPLAN_TYPE_REALで作成したもの）
+* @param[in] x フーリエ変換する系列(nサイズ必須)
+* @param[out] spectrum スペクトル(n+2サイズ必須, 0番目からn/2番目までの複素数を偶数番目に実数部, 奇数番目に虚数部で格納)
+* @note 直流成分と最高周波数成分も通常の複素数として格納するため（虚部は0）、先頭要素の特別扱いは不要です
+* @note spectrumにxと同一の領域（n+2サイズ）を指定すると、入力をコピーせずに変換します
+* @note 正規化は行いません
+* @sa AE2FFTPlan_RealIFFTHalfSpectrum
+*/
+void AE2FFTPlan_RealFFTHalfSpectrum(struct AE2FFTPlan *plan, const float *x, float *spectrum);
+
+/*!
+* @brief プランを使用した半スペクトルの実数配列IFFT
+* @param[in,out] plan FFTプラン（AE2FFTPLAN_TYPE_REALで作成したもの）
+* @param[in] spectrum スペクトル(n+2サイズ必須, 配置はAE2FFTPlan_RealFFTHalfSpectrumと同一)
+* @param[out] x 変換結果(nサイズ必須, spectrumと同一の領域を指定可能)
+* @note 正規化定数1/nを乗じるため、AE2FFTPlan_RealFFTHalfSpectrumの逆変換になります
+* @note 直流成分と最高周波数成分の虚部は無視します
+* @sa AE2FFTPlan_RealFFTHalfSpectrum
+*/
+void AE2FFTPlan_RealIFFTHalfSpectrum(struct AE2FFTPlan *plan, const float *spectrum, float *x);
+
+/*!
+* @brief プランを使用した倍精度のFFT（高速フーリエ変換）
+* @param[in] plan FFTプラン（AE2FFTPLAN_TYPE_COMPLEXかつdouble_precisionを指定して作成したもの）
+* @param[in] flag -1:FFT, 1:IFFT
+* @param[in,out] x フーリエ変換する系列(入出力 2nサイズ必須, 偶数番目に実数部, 奇数番目に虚数部)
+* @param[in,out] y 作業用配列(xと同一サイズ)
+* @note 正規化は行いません
+* @note プランの作業領域は使用しないため、作業用配列を分ければ同一プランを複数スレッドから同時に使用できます
+*/
+void AE2FFTPlan_DoubleFFT(const struct AE2FFTPlan *plan, int flag, double *x, double *y);
+
+/*!
+* @brief プランを使用した倍精度の実数配列のFFT（高速フーリエ変換）
+* @param[in] plan FFTプラン（AE2FFTPLAN_TYPE_REALかつdouble_precisionを指定して作成したもの）
+* @param[in] flag -1:FFT, 1:IFFT
+* @param[in,out] x フーリエ変換する系列(入出力 nサイズ必須, 配置はAE2FFTPlan_RealFFTと同一)
+* @param[in,out] y 作業用配列(xと同一サイズ)
+* @note 正規化は行いません。正規化定数は2/nです
+* @sa AE2FFTPlan_RealFFT
+*/
+void AE2FFTPlan_DoubleRealFFT(const struct AE2FFTPlan *plan, int flag, double *x, double *y);
+
+/*!
+* @brief プランを使用した分離形式（実部と虚部を別配列に持つ形式）のFFT
+* @param[in,out] plan FFTプラン（AE2FFTPLAN_TYPE_COMPLEXで作成したもの）
+* @param[in] flag -1:FFT, 1:IFFT
+* @param[in,out] real フーリエ変換する系列の実部(入出力 nサイズ必須)
+* @param[in,out] imag フーリエ変換する系列の虚部(入出力 nサイズ必須)
+* @note 正規化は行いません
+* @sa AE2FFTPlan_FloatFFT
+*/
+void AE2FFTPlan_SplitFFT(struct AE2FFTPlan *plan, int flag, float *real, float *imag);
+
+/*!
+* @brief プランを使用した実数配列のFFT（結果を分離形式で出力）
+* @param[in,out] plan FFTプラン（AE2FFTPLAN_TYPE_REALで作成したもの）
+* @param[in] x フーリエ変換する系列(nサイズ必須)
+* @param[out] real スペクトルの実部(n/2サイズ必須, real[0]に直流成分の実部が入る)
+* @param[out] imag スペクトルの虚部(n/2サイズ必須, imag[0]に最高周波数成分の実部が入る)
+* @note 正規化は行いません。正規化定数は2/nです
+* @sa AE2FFTPlan_SplitRealIFFT
+*/
+void AE2FFTPlan_SplitRealFFT(struct AE2FFTPlan *plan, const float *x, float *real, float *imag);
+
+/*!
+* @brief プランを使用した分離形式スペクトルの実数配列IFFT
+* @param[in,out] plan FFTプラン（AE2FFTPLAN_TYPE_REALで作成したもの）
+* @param[in] real スペクトルの実部(n/2サイズ必須, 配置はAE2FFTPlan_SplitRealFFTと同一)
+* @param[in] imag スペクトルの虚部(n/2サイズ必須, 配置はAE2FFTPlan_SplitRealFFTと同一)
+* @param[out] x 変換結果(nサイズ必須)
+* @note 正規化は行いません。正規化定数は2/nです
+* @sa AE2FFTPlan_SplitRealFFT
+*/
+void AE2FFTPlan_SplitRealIFFT(struct AE2FFTPlan *plan, const float *real, const float *imag, float *x);
+
+/*!
+* @brief 分離形式スペクトルの複素乗算 y = a * b
+* @param[in] num_bins 周波数ビン数
+* @param[in] a_real, a_imag 乗算するスペクトルの実部と虚部
+* @param[in] b_real, b_imag 乗算するスペクトルの実部と虚部
+* @param[out] y_real, y_imag 乗算結果の実部と虚部（a, bと同一の領域を指定可能）
+*/
+void AE2FFT_SplitSpectrumMul(int32_t num_bins,
+        const float *a_real, const float *a_imag, const float *b_real, const float *b_imag,
+        float *y_real, float *y_imag);
+
+/*!
+* @brief 分離形式スペクトルの複素乗算結果の加算 y += a * b
+* @param[in] num_bins 周波数ビン数
+* @param[in] a_real, a_imag 乗算するスペクトルの実部と虚部
+* @param[in] b_real, b_imag 乗算するスペクトルの実部と虚部
+* @param[in,out] y_real, y_imag 加算先の実部と虚部
+*/
+void AE2FFT_SplitSpectrumMulAdd(int32_t num_bins,
+        const float *a_real, const float *a_imag, const float *b_real, const float *b_imag,
+        float *y_real, float *y_imag);
+
+/*!
+* @brief AE2FFTPlan_SplitRealFFTで得た分離形式スペクトルの複素乗算 y = a * b
+* @param[in] num_bins 周波数ビン数(FFT点数/2)
+* @param[in] a_real, a_imag 乗算するスペクトルの実部と虚部
+* @param[in] b_real, b_imag 乗算するスペクトルの実部と虚部
+* @param[out] y_real, y_imag 乗算結果の実部と虚部（a, bと同一の領域を指定可能）
+* @note 先頭要素は直流成分と最高周波数成分の実数として扱います
+*/
+void AE2FFT_SplitRealSpectrumMul(int32_t num_bins,
+        const float *a_real, const float *a_imag, const float *b_real, const float *b_imag,
+        float *y_real, float *y_imag);
+
+/*!
+* @brief AE2FFTPlan_SplitRealFFTで得た分離形式スペクトルの複素乗算結果の加算 y += a * b
+* @param[in] num_bins 周波数ビン数(FFT点数/2)
+* @param[in] a_real, a_imag 乗算するスペクトルの実部と虚部
+* @param[in] b_real, b_imag 乗算するスペクトルの実部と虚部
+* @param[in,out] y_real, y_imag 加算先の実部と虚部
+* @note 先頭要素は直流成分と最高周波数成分の実数として扱います
+*/
+void AE2FFT_SplitRealSpectrumMulAdd(int32_t num_bins,
+        const float *a_real, const float *a_imag, const float *b_real, const float *b_imag,
+        float *y_real, float *y_imag);
+
+/*!
+* @brief プランを使用した実数列の分離形式スペクトルの複素乗算結果の一括加算 y += sum_k a[k] * b[k]
+* @param[in] plan FFTプラン（AE2FFTPLAN_TYPE_REALで作成したもの）
+* @param[in] num_spectra 乗算するスペクトルの組数
+* @param[in] a, b 乗算するスペクトルのポインタ配列（各スペクトルはAE2FFTPlan_SplitRealFFTの実部n/2個、虚部n/2個の順に並ぶ）
+* @param[in,out] y 加算先（実部n/2個、虚部n/2個の順に並ぶ）
+* @note 全ての組の積をレジスタ上で累積し、yの読み書きは1回で済ませます。プランが使用するSIMDカーネルで計算します
+* @note 先頭要素は直流成分と最高周波数成分の実数として扱います
+*/
+void AE2FFTPlan_SplitRealSpectrumMulAddMultiple(const struct AE2FFTPlan *plan,
+        int32_t num_spectra, const float *const *a, const float *const *b, float *y);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,345 @@
+/*!
+* @file ae2_fft.hpp
+* @brief 点数をコンパイル時に固定したFFT（C++ヘッダオンリー）
+* @note 入出力の配置・変換方向(flag)・正規化の扱いはAE2FFTPlan_FloatFFT, AE2FFTPlan_RealFFTと同一です
+* @note AE2FFTPlanは呼び出さない独立した実装です（プランは回転因子を実行時に確保した領域に持ち、段の構成も実行時に決まるため）
+* @note 回転因子テーブルはconstexprでコンパイル時に生成し、段のループもテンプレートで全て展開します
+* @note C++11以降で使用できます
+*/
+#ifndef AE2FFT_HPP_INCLUDED
+#define AE2FFT_HPP_INCLUDED
+
+#include <cstring>
+
+namespace ae2 {
+
+namespace detail {
+
+/*! @brief 円周率 */
+static constexpr double pi = 3.14159265358979323846;
+
+/*! @brief sinのテイラー級数（termから始めてdepth項を加算） */
+constexpr double sinSeries(double x2, double term, int n, int depth)
+{
+    return (depth == 0) ? 0.0
+        : (term + sinSeries(x2, -term * x2 / static_cast<double>((n + 1) * (n + 2)), n + 2, depth - 1));
+}
+
+/*! @brief |x| <= π/2 でのsin */
+constexpr double sinSmall(double x) { return sinSeries(x * x, x, 1, 16); }
+
+/*! @brief |x| <= π/2 でのcos */
+constexpr double cosSmall(double x) { return sinSeries(x * x, 1.0, 0, 16); }
+
+/*! @brief 象限qと象限内の角度rからcos(qπ/2 + r)を計算 */
+constexpr double cosQuadrant(int q, double r)
+{
+    return (q == 0) ? cosSmall(r) : ((q == 1) ? -sinSmall(r) : ((q == 2) ? -cosSmall(r) : sinSmall(r)));
+}
+
+/*! @brief 象限qと象限内の角度rからsin(qπ/2 + r)を計算 */
+constexpr double sinQuadrant(int q, double r)
+{
+    return (q == 0) ? sinSmall(r) : ((q == 1) ? cosSmall(r) : ((q == 2) ? -sinSmall(r) : -cosSmall(r)));
+}
+
+/*! @brief 2π * m / n の象限内の角度 */
+constexpr double quadrantResidual(long m4, long n)
+{
+    return (2.0 * pi * static_cast<double>(m4 - (m4 / n) * n)) / (4.0 * static_cast<double>(n));
+}
+
+/*! @brief cos(2π * m / n) 整数演算で象限に分けてから級数で計算する */
+constexpr double cosTurn(long m, long n)
+{
+    return cosQuadrant(static_cast<int>((4 * (m % n)) / n), quadrantResidual(4 * (m % n), n));
+}
+
+/*! @brief sin(2π * m / n) */
+constexpr double sinTurn(long m, long n)
+{
+    return sinQuadrant(static_cast<int>((4 * (m % n)) / n), quadrantResidual(4 * (m % n), n));
+}
+
+/*! @brief コンパイル時の整数列 */
+template <int... Is> struct IndexSequence {};
+
+/*! @brief 整数列の連結（後半はオフセットを加える） */
+template <class A, class B> struct ConcatSequence;
+template <int... A, int... B>
+struct ConcatSequence<IndexSequence<A...>, IndexSequence<B...> > {
+    typedef IndexSequence<A..., (static_cast<int>(sizeof...(A)) + B)...> type;
+};
+
+/*! @brief 0, 1, ..., N-1の整数列の生成（テンプレートの再帰深さはlog2(N)） */
+template <int N> struct MakeIndexSequence {
+    typedef typename ConcatSequence<
+        typename MakeIndexSequence<N / 2>::type, typename MakeIndexSequence<N - N / 2>::type>::type type;
+};
+template <> struct MakeIndexSequence<0> { typedef IndexSequence<> type; };
+template <> struct MakeIndexSequence<1> { typedef IndexSequence<0> type; };
+
+/*! @brief 回転因子テーブル cos(2πm/N), sin(2πm/N) (0 <= m < N) */
+template <int N, class Sequence = typename MakeIndexSequence<N>::type> struct TwiddleTable;
+template <int N, int... Is>
+struct TwiddleTable<N, IndexSequence<Is...> > {
+    static constexpr float cosTable[N] = { static_cast<float>(cosTurn(Is, N))... };
+    static constexpr float sinTable[N] = { static_cast<float>(sinTurn(Is, N))... };
+};
+template <int N, int... Is> constexpr float TwiddleTable<N, IndexSequence<Is...> >::cosTable[N];
+template <int N, int... Is> constexpr float TwiddleTable<N, IndexSequence<Is...> >::sinTable[N];
+
+/*! @brief 2の冪乗か判定 */
+constexpr bool isPowerOf2(int n) { return (n > 0) && ((n & (n - 1)) == 0); }
+
+/*!
+* @brief Stockham FFTの1段
+* @tparam N 全体の点数
+* @tparam Flag -1:FFT, 1:IFFT
+* @tparam Len 現在の系列長
+* @tparam S ストライド
+* @tparam Parity ここまでに実行した段数の偶奇
+* @tparam Radix 段の基底（系列長から決定、1は終端）
+*/
+template <int N, int Flag, int Len, int S, int Parity,
+         int Radix = ((Len == 1) ? 1 : ((Len == 2) ? 2 : 4))>
+struct FFTStage;
+
+/*! @brief 終端 奇数段の場合は結果が作業領域側にあるので書き戻す */
+template <int N, int Flag, int Len, int S>
+struct FFTStage<N, Flag, Len, S, 1, 1> {
+    static inline void run(const float *x, float *y) { std::memcpy(y, x, sizeof(float) * 2 * N); }
+};
+template <int N, int Flag, int Len, int S>
+struct FFTStage<N, Flag, Len, S, 0, 1> {
+    static inline void run(const float *, float *) { }
+};
+
+/*! @brief 2基底の段（最終段） */
+template <int N, int Flag, int Len, int S, int Parity>
+struct FFTStage<N, Flag, Len, S, Parity, 2> {
+    static inline void run(float *x, float *y)
+    {
+        for (int q = 0; q < S; q++) {
+            const float ar = x[2 * q], ai = x[2 * q + 1];
+            const float br = x[2 * (q + S)], bi = x[2 * (q + S) + 1];
+            y[2 * q] = ar + br; y[2 * q + 1] = ai + bi;
+            y[2 * (q + S)] = ar - br; y[2 * (q + S) + 1] = ai - bi;
+        }
+        FFTStage<N, Flag, 1, 2 * S, 1 - Parity>::run(y, x);
+    }
+};
+
+/*! @brief 4基底の段 */
+template <int N, int Flag, int Len, int S, int Parity>
+struct FFTStage<N, Flag, Len, S, Parity, 4> {
+    static inline void run(float *x, float *y)
+    {
+        typedef TwiddleTable<N> Table;
+        const int n1 = Len / 4;
+        const int step = N / Len; /* 系列長Lenの回転因子のテーブル上の間隔 */
+        const float fflag = static_cast<float>(Flag);
+
+        for (int p = 0; p < n1; p++) {
+            const float w1r = Table::cosTable[1 * p * step], w1i = fflag * Table::sinTable[1 * p * step];
+            const float w2r = Table::cosTable[2 * p * step], w2i = fflag * Table::sinTable[2 * p * step];
+            const float w3r = Table::cosTable[3 * p * step], w3i = fflag * Table::sinTable[3 * p * step];
+            for (int q = 0; q < S; q++) {
+                const float *a = &x[2 * (q + S * (p + 0 * n1))];
+                const float *b = &x[2 * (q + S * (p + 1 * n1))];
+                const float *c = &x[2 * (q + S * (p + 2 * n1))];
+                const float *d = &x[2 * (q + S * (p + 3 * n1))];
+                float *y0 = &y[2 * (q + S * (4 * p + 0))];
+                float *y1 = &y[2 * (q + S * (4 * p + 1))];
+                float *y2 = &y[2 * (q + S * (4 * p + 2))];
+                float *y3 = &y[2 * (q + S * (4 * p + 3))];
+                const float apcr = a[0] + c[0], apci = a[1] + c[1];
+                const float amcr = a[0] - c[0], amci = a[1] - c[1];
+                const float bpdr = b[0] + d[0], bpdi = b[1] + d[1];
+                /* j = -flag * i との乗算 */
+                const float jbmdr =  fflag * (b[1] - d[1]);
+                const float jbmdi = -fflag * (b[0] - d[0]);
+                const float t1r = amcr - jbmdr, t1i = amci - jbmdi;
+                const float t2r = apcr - bpdr, t2i = apci - bpdi;
+                const float t3r = amcr + jbmdr, t3i = amci + jbmdi;
+                y0[0] = apcr + bpdr; y0[1] = apci + bpdi;
+                y1[0] = w1r * t1r - w1i * t1i; y1[1] = w1r * t1i + w1i * t1r;
+                y2[0] = w2r * t2r - w2i * t2i; y2[1] = w2r * t2i + w2i * t2r;
+                y3[0] = w3r * t3r - w3i * t3i; y3[1] = w3r * t3i + w3i * t3r;
+            }
+        }
+        FFTStage<N, Flag, n1, 4 * S, 1 - Parity>::run(y, x);
+    }
+};
+
+} /* namespace detail */
+
+/*!
+* @brief 点数固定の複素FFT
+* @tparam N FFT点数（2以上の2の冪乗）
+* @note 作業領域（workSize要素）は呼び出し側で用意してください。同じ作業領域を複数スレッドから同時に使用しないでください
+* @sa AE2FFTPlan_FloatFFT
+*/
+template <int N>
+class FFT {
+    static_assert(detail::isPowerOf2(N) && (N >= 2), "FFT size must be a power of 2 (>= 2)");
+public:
+    /*! @brief FFT点数 */
+    static constexpr int size = N;
+    /*! @brief 作業領域の要素数(float) */
+    static constexpr int workSize = 2 * N;
+
+    /*!
+    * @brief コンストラクタ
+    * @param[in] work 作業領域（workSize要素以上。インスタンスより長く保持すること）
+    */
+    explicit FFT(float *work) : work(work) { }
+
+    /*!
+    * @brief 変換方向を指定したFFT（正規化は行いません）
+    * @tparam Flag -1:FFT, 1:IFFT
+    * @param[in,out] x フーリエ変換する系列(入出力 2Nサイズ必須, 偶数番目に実数部, 奇数番目に虚数部)
+    */
+    template <int Flag>
+    void transform(float *x)
+    {
+        static_assert((Flag == -1) || (Flag == 1), "Flag must be -1 or 1");
+        detail::FFTStage<N, Flag, N, 1, 0>::run(x, work);
+    }
+
+    /*!
+    * @brief FFT（正規化は行いません）
+    * @param[in] flag -1:FFT, 1:IFFT
+    * @param[in,out] x フーリエ変換する系列(入出力 2Nサイズ必須, 偶数番目に実数部, 奇数番目に虚数部)
+    */
+    void transform(int flag, float *x)
+    {
+        if (flag == -1) {
+            transform<-1>(x);
+        } else {
+            transform<1>(x);
+        }
+    }
+
+    /*! @brief 順方向FFT */
+    void forward(float *x) { transform<-1>(x); }
+
+    /*! @brief 逆方向FFT（正規化は行いません） */
+    void inverse(float *x) { transform<1>(x); }
+
+private:
+    float *work; /*!< 作業領域 */
+};
+
+template <int N> constexpr int FFT<N>::size;
+template <int N> constexpr int FFT<N>::workSize;
+
+/*!
+* @brief 点数固定の実数FFT
+* @tparam N FFT点数（4以上の2の冪乗）
+* @note 入出力の配置はAE2FFTPlan_RealFFTと同一です（x[0]に直流成分, x[1]に最高周波数成分）
+* @note 作業領域（workSize要素）は呼び出し側で用意してください。同じ作業領域を複数スレッドから同時に使用しないでください
+* @sa AE2FFTPlan_RealFFT
+*/
+template <int N>
+class RealFFT {
+    static_assert(detail::isPowerOf2(N) && (N >= 4), "Real FFT size must be a power of 2 (>= 4)");
+public:
+    /*! @brief FFT点数 */
+    static constexpr int size = N;
+    /*! @brief 作業領域の要素数(float) */
+    static constexpr int workSize = FFT<N / 2>::workSize;
+
+    /*!
+    * @brief コンストラクタ
+    * @param[in] work 作業領域（workSize要素以上。インスタンスより長く保持すること）
+    */
+    explicit RealFFT(float *work) : complexFFT(work) { }
+
+    /*!
+    * @brief 変換方向を指定した実数FFT（正規化は行いません。正規化定数は2/Nです）
+    * @tparam Flag -1:FFT, 1:IFFT
+    * @param[in,out] x フーリエ変換する系列(入出力 Nサイズ必須)
+    */
+    template <int Flag>
+    void transform(float *x)
+    {
+        static_assert((Flag == -1) || (Flag == 1), "Flag must be -1 or 1");
+        /* FFTの場合は先に変換 */
+        if (Flag == -1) {
+            complexFFT.template transform<-1>(x);
+        }
+        postProcess<Flag>(x);
+        /* IFFTの場合は後で変換 */
+        if (Flag == 1) {
+            complexFFT.template transform<1>(x);
+        }
+    }
+
+    /*!
+    * @brief 実数FFT（正規化は行いません。正規化定数は2/Nです）
+    * @param[in] flag -1:FFT, 1:IFFT
+    * @param[in,out] x フーリエ変換する系列(入出力 Nサイズ必須)
+    */
+    void transform(int flag, float *x)
+    {
+        if (flag == -1) {
+            transform<-1>(x);
+        } else {
+            transform<1>(x);
+        }
+    }
+
+    /*! @brief 順方向FFT */
+    void forward(float *x) { transform<-1>(x); }
+
+    /*! @brief 逆方向FFT（正規化は行いません） */
+    void inverse(float *x) { transform<1>(x); }
+
+private:
+    /*! @brief 実数列FFTの後処理（IFFTの場合は前処理） AE2FFTPlan_RealFFTと同一の計算 */
+    template <int Flag>
+    static void postProcess(float *x)
+    {
+        typedef detail::TwiddleTable<N> Table;
+        const float c2 = 0.5f * static_cast<float>(Flag);
+
+        for (int i = 1; i <= (N >> 2); i++) {
+            const int i1 = (i << 1);
+            const int i2 = i1 + 1;
+            const int i3 = N - i1;
+            const int i4 = i3 + 1;
+            const float wr = Table::cosTable[i];
+            const float wi = static_cast<float>(Flag) * Table::sinTable[i];
+            const float h1r = 0.5f * (x[i1] + x[i3]);
+            const float h1i = 0.5f * (x[i2] - x[i4]);
+            const float h2r = -c2 * (x[i2] + x[i4]);
+            const float h2i =  c2 * (x[i1] - x[i3]);
+            x[i1] =  h1r + (wr * h2r) - (wi * h2i);
+            x[i2] =  h1i + (wr * h2i) + (wi * h2r);
+            x[i3] =  h1r - (wr * h2r) + (wi * h2i);
+            x[i4] = -h1i + (wr * h2i) + (wi * h2r);
+        }
+
+        /* 直流成分/最高周波数成分 */
+        {
+            const float h1r = x[0];
+            if (Flag == -1) {
+                x[0] = h1r + x[1];
+                x[1] = h1r - x[1];
+            } else {
+                x[0] = 0.5f * (h1r + x[1]);
+                x[1] = 0.5f * (h1r - x[1]);
+            }
+        }
+    }
+
+    FFT<N / 2> complexFFT; /*!< 半分の点数の複素FFT */
+};
+
+template <int N> constexpr int RealFFT<N>::size;
+template <int N> constexpr int RealFFT<N>::workSize;
+
+} /* namespace ae2 */
+
+#endif /* AE2FFT_HPP_INCLUDED */
@@ -0,0 +1,96 @@
+/*!
+* @file ae2_large_fft.h
+* @brief 大規模FFT(4ステップFFT)ライブラリ
+*/
+#ifndef AE2LARGEFFT_H_INCLUDED
+#define AE2LARGEFFT_H_INCLUDED
+
+#include <stdint.h>
+
+/*!
+* @brief 並列実行されるタスク関数
+* @param[in,out] task_arg タスク引数
+* @param[in] task_index タスクインデックス(0からnum_tasks-1)
+*/
+typedef void (*AE2LargeFFTTaskFunction)(void *task_arg, int32_t task_index);
+
+/*!
+* @brief タスクの並列実行関数
+* @param[in,out] runner_arg AE2LargeFFTConfig::runner_argで指定した値
+* @param[in] num_tasks タスク数
+* @param[in] task タスク関数
+* @param[in,out] task_arg タスク関数に渡す引数
+* @note task(task_arg, 0), ..., task(task_arg, num_tasks - 1)を任意のスレッドで実行し、全て完了してから戻ってください
+*/
+typedef void (*AE2LargeFFTRunnerFunction)(void *runner_arg, int32_t num_tasks, AE2LargeFFTTaskFunction task, void *task_arg);
+
+/*!
+* @brief 大規模FFT生成コンフィグ
+*/
+struct AE2LargeFFTConfig {
+    int32_t fft_size; /*!< FFT点数（2, 3, 5の積で表せる4以上の値） */
+    int32_t num_workers; /*!< 並列に処理するタスク数（ワーカースレッド数） */
+    AE2LargeFFTRunnerFunction runner; /*!< タスクの並列実行関数（NULLの場合は呼び出しスレッドで順に実行） */
+    void *runner_arg; /*!< タスクの並列実行関数に渡す引数 */
+};
+
+/*!
+* @brief 大規模FFT
+* @note 同一インスタンスを複数スレッドから同時に使用しないでください
+*/
+struct AE2LargeFFT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+* @brief 大規模FFT作成に必要なワークサイズ計算
+* @param[in] config 大規模FFT生成コンフィグ
+* @return int32_t 計算に成功した場合は0以上の値を、失敗した場合は負の値を返します
+* @sa AE2LargeFFT_Create
+*/
+int32_t AE2LargeFFT_CalculateWorkSize(const struct AE2LargeFFTConfig *config);
+
+/*!
+* @brief 大規模FFT作成
+* @param[in] config 大規模FFT生成コンフィグ
+* @param[in,out] work 大規模FFT生成に使用するワーク領域
+* @param[in] work_size 大規模FFT生成に使用するワーク領域サイズ
+* @return AE2LargeFFT 生成に成功した場合は構造体のポインタを、失敗した場合はNULLを返します
+* @note 点数をn1 * n2に分解し、列方向FFT・回転因子乗算・行方向FFT・転置の4ステップで変換します
+* @sa AE2LargeFFT_CalculateWorkSize
+*/
+struct AE2LargeFFT *AE2LargeFFT_Create(const struct AE2LargeFFTConfig *config, void *work, int32_t work_size);
+
+/*!
+* @brief 大規模FFT破棄
+* @param[in,out] fft 大規模FFT
+* @sa AE2LargeFFT_Create
+* @attention 本関数実行後、大規模FFTは不定になります
+*/
+void AE2LargeFFT_Destroy(struct AE2LargeFFT *fft);
+
+/*!
+* @brief FFT点数の取得
+* @param[in] fft 大規模FFT
+* @return int32_t FFT点数
+*/
+int32_t AE2LargeFFT_GetFFTSize(const struct AE2LargeFFT *fft);
+
+/*!
+* @brief 大規模FFT
+* @param[in,out] fft 大規模FFT
+* @param[in] flag -1:FFT, 1:IFFT
+* @param[in,out] x フーリエ変換する系列(入出力 2nサイズ必須, 偶数番目に実数部, 奇数番目に虚数部)
+* @param[in,out] y 作業用配列(xと同一サイズ)
+* @note 正規化は行いません
+* @sa AE2FFT_FloatFFT
+*/
+void AE2LargeFFT_FloatFFT(struct AE2LargeFFT *fft, int flag, float *x, float *y);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AE2LARGEFFT_H_INCLUDED */
@@ -0,0 +1,284 @@
+#include "ae2_czt.h"
+
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include "ae2_fft.h"
+
+/* 円周率 */
+#define AE2_PI 3.14159265358979323846
+/* メモリアラインメント */
+#define AE2CZT_ALIGNMENT 16
+/* nの倍数への切り上げ */
+#define AE2CZT_ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
+/* 変換方向(flag)からテーブルのインデックスを取得 -1:0, 1:1 */
+#define AE2CZT_DIRECTION_INDEX(flag) (((flag) + 1) >> 1)
+/* 最大値を取得 */
+#define AE2CZT_MAX(a, b) (((a) > (b)) ? (a) : (b))
+
+/* CZT */
+struct AE2CZT {
+    int32_t num_input_samples; /* 入力サンプル数 */
+    int32_t num_output_bins; /* 出力周波数ビン数 */
+    int32_t fft_size; /* 畳み込みに使用するFFT点数 */
+    struct AE2FFTPlan *fft_plan; /* FFTプラン */
+    float *input_chirps[2]; /* 入力に乗じるチャープ系列 [0]:順方向, [1]:逆方向 */
+    float *output_chirps[2]; /* 出力に乗じるチャープ系列 [0]:順方向, [1]:逆方向 */
+    float *chirp_spectra[2]; /* 畳み込むチャープ系列のスペクトル(1/fft_sizeで正規化済み) [0]:順方向, [1]:逆方向 */
+    float *buffer; /* 畳み込み用バッファ */
+};
+
+/* target以上で最小の2, 3, 5の積で表せる値を計算
+* 3と5の冪の積それぞれについてtarget以上になるまで2倍し、最小のものを選ぶ
+* targetは2以上INT32_MAX / 2以下 */
+static int32_t AE2CZT_CalculateNextSmoothSize(int32_t target)
+{
+    int32_t best, p5, p35, size;
+
+    assert((target >= 2) && (target <= INT32_MAX / 2));
+
+    /* 2の冪乗を初期値とする（target <= INT32_MAX / 2なので2^30以下に収まる） */
+    best = 1;
+    while (best < target) {
+        best <<= 1;
+    }
+
+    /* 以降の積はbest以下に限るため、オーバーフローしない */
+    for (p5 = 1; p5 < best; p5 *= 5) {
+        for (p35 = p5; p35 < best; p35 *= 3) {
+            size = p35;
+            while (size < target) {
+                size <<= 1;
+            }
+            if (size < best) {
+                best = size;
+            }
+            if (p35 > best / 3) {
+                break;
+            }
+        }
+        if (p5 > best / 5) {
+            break;
+        }
+    }
+
+    return best;
+}
+
+/* 畳み込みに使用するFFT点数を計算
+* 巡回畳み込みが線形畳み込みに一致する最小の点数を、FFTプランが扱える点数（2, 3, 5の積）から選ぶ */
+static int32_t AE2CZT_CalculateFFTSize(int32_t num_input_samples, int32_t num_output_bins)
+{
+    /* 和と点数の切り上げがオーバーフローしないよう上限を設ける */
+    if ((num_input_samples > INT32_MAX / 2) || (num_output_bins > INT32_MAX / 2 - num_input_samples)) {
+        return -1;
+    }
+
+    return AE2CZT_CalculateNextSmoothSize(AE2CZT_MAX(num_input_samples + num_output_bins - 1, 2));
+}
+
+/* チャープ exp(flag * 2πi * phase) を計算
+* 位相は倍精度で小数部のみ取り出してから三角関数を呼ぶ */
+static void AE2CZT_SetChirp(float *chirp, int32_t i, double phase, int flag)
+{
+    const double theta = 2.0 * AE2_PI * (phase - floor(phase));
+    AE2FFTCOMPLEX_REAL(chirp, i) = (float)cos(theta);
+    AE2FFTCOMPLEX_IMAG(chirp, i) = (float)(flag * sin(theta));
+}
+
+/* CZT作成に必要なワークサイズ計算 */
+int32_t AE2CZT_CalculateWorkSize(const struct AE2CZTConfig *config)
+{
+    int32_t work_size, fft_size, fft_plan_size;
+    struct AE2FFTPlanConfig fft_config;
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* コンフィグチェック */
+    if ((config->num_input_samples <= 0) || (config->num_output_bins <= 0)) {
+        return -1;
+    }
+    if ((fft_size = AE2CZT_CalculateFFTSize(config->num_input_samples, config->num_output_bins)) < 0) {
+        return -1;
+    }
+
+    /* 構造体サイズ */
+    work_size = sizeof(struct AE2CZT) + AE2CZT_ALIGNMENT;
+
+    /* FFTプラン */
+    fft_config.fft_size = fft_size;
+    fft_config.type = AE2FFTPLAN_TYPE_COMPLEX;
+    fft_config.in_place = 0;
+    fft_config.double_precision = 0;
+    if ((fft_plan_size = AE2FFTPlan_CalculateWorkSize(&fft_config)) < 0) {
+        return -1;
+    }
+    work_size += fft_plan_size;
+
+    /* チャープ系列とスペクトル（順方向/逆方向） */
+    work_size += 2 * (int32_t)(2 * sizeof(float) * (size_t)config->num_input_samples + AE2CZT_ALIGNMENT);
+    work_size += 2 * (int32_t)(2 * sizeof(float) * (size_t)config->num_output_bins + AE2CZT_ALIGNMENT);
+    work_size += 2 * (int32_t)(2 * sizeof(float) * (size_t)fft_size + AE2CZT_ALIGNMENT);
+
+    /* 畳み込み用バッファ */
+    work_size += (int32_t)(2 * sizeof(float) * (size_t)fft_size + AE2CZT_ALIGNMENT);
+
+    return work_size;
+}
+
+/* CZT作成 */
+struct AE2CZT *AE2CZT_Create(const struct AE2CZTConfig *config, void *work, int32_t work_size)
+{
+    struct AE2CZT *czt;
+    uint8_t *work_ptr;
+    int32_t i, n, k, fft_plan_size;
+    struct AE2FFTPlanConfig fft_config;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL) || (work_size < 0)) {
+        return NULL;
+    }
+
+    if (work_size < AE2CZT_CalculateWorkSize(config)) {
+        return NULL;
+    }
+
+    /* ハンドル領域割当 */
+    work_ptr = (uint8_t *)AE2CZT_ROUNDUP((uintptr_t)work, AE2CZT_ALIGNMENT);
+    czt = (struct AE2CZT *)work_ptr;
+    czt->num_input_samples = config->num_input_samples;
+    czt->num_output_bins = config->num_output_bins;
+    czt->fft_size = AE2CZT_CalculateFFTSize(config->num_input_samples, config->num_output_bins);
+    work_ptr += sizeof(struct AE2CZT);
+
+    /* FFTプラン */
+    fft_config.fft_size = czt->fft_size;
+    fft_config.type = AE2FFTPLAN_TYPE_COMPLEX;
+    fft_config.in_place = 0;
+    fft_config.double_precision = 0;
+    fft_plan_size = AE2FFTPlan_CalculateWorkSize(&fft_config);
+    czt->fft_plan = AE2FFTPlan_Create(&fft_config, work_ptr, fft_plan_size);
+    if (czt->fft_plan == NULL) {
+        return NULL;
+    }
+    work_ptr += fft_plan_size;
+
+    /* チャープ系列とスペクトルの領域割当 */
+    for (i = 0; i < 2; i++) {
+        work_ptr = (uint8_t *)AE2CZT_ROUNDUP((uintptr_t)work_ptr, AE2CZT_ALIGNMENT);
+        czt->input_chirps[i] = (float *)work_ptr;
+        work_ptr += 2 * sizeof(float) * (size_t)czt->num_input_samples;
+        work_ptr = (uint8_t *)AE2CZT_ROUNDUP((uintptr_t)work_ptr, AE2CZT_ALIGNMENT);
+        czt->output_chirps[i] = (float *)work_ptr;
+        work_ptr += 2 * sizeof(float) * (size_t)czt->num_output_bins;
+        work_ptr = (uint8_t *)AE2CZT_ROUNDUP((uintptr_t)work_ptr, AE2CZT_ALIGNMENT);
+        czt->chirp_spectra[i] = (float *)work_ptr;
+        work_ptr += 2 * sizeof(float) * (size_t)czt->fft_size;
+    }
+
+    /* 畳み込み用バッファ */
+    work_ptr = (uint8_t *)AE2CZT_ROUNDUP((uintptr_t)work_ptr, AE2CZT_ALIGNMENT);
+    czt->buffer = (float *)work_ptr;
+    work_ptr += 2 * sizeof(float) * (size_t)czt->fft_size;
+
+    /* nk = (n^2 + k^2 - (k - n)^2) / 2 を使い、
+    * X[k] = C[k] * sum_n (x[n] * A[n]) * B[k - n] の畳み込みに書き換える
+    * A[n] = exp(flag * 2πi * (f0 * n + df * n^2 / 2))
+    * B[m] = exp(-flag * 2πi * df * m^2 / 2)
+    * C[k] = exp(flag * 2πi * df * k^2 / 2) */
+    for (i = 0; i < 2; i++) {
+        const int flag = (i == 0) ? -1 : 1;
+        const double f0 = config->start_frequency;
+        const double df = config->frequency_step;
+        const float inv_fft_size = 1.0f / (float)czt->fft_size;
+        float *spectrum = czt->chirp_spectra[i];
+
+        for (n = 0; n < czt->num_input_samples; n++) {
+            AE2CZT_SetChirp(czt->input_chirps[i], n, f0 * n + 0.5 * df * ((double)n * n), flag);
+        }
+        for (k = 0; k < czt->num_output_bins; k++) {
+            AE2CZT_SetChirp(czt->output_chirps[i], k, 0.5 * df * ((double)k * k), flag);
+        }
+
+        /* B[m]を -(num_input_samples - 1) <= m < num_output_bins の範囲で巡回配置 */
+        memset(spectrum, 0, 2 * sizeof(float) * (size_t)czt->fft_size);
+        for (k = 0; k < czt->num_output_bins; k++) {
+            AE2CZT_SetChirp(spectrum, k, 0.5 * df * ((double)k * k), -flag);
+        }
+        for (n = 1; n < czt->num_input_samples; n++) {
+            AE2CZT_SetChirp(spectrum, czt->fft_size - n, 0.5 * df * ((double)n * n), -flag);
+        }
+
+        /* 変換実行時の正規化を省くため、スペクトルに1/fft_sizeを含めておく */
+        AE2FFTPlan_FloatFFT(czt->fft_plan, -1, spectrum);
+        for (k = 0; k < 2 * czt->fft_size; k++) {
+            spectrum[k] *= inv_fft_size;
+        }
+    }
+
+    return czt;
+}
+
+/* CZT破棄 */
+void AE2CZT_Destroy(struct AE2CZT *czt)
+{
+    if (czt != NULL) {
+        AE2FFTPlan_Destroy(czt->fft_plan);
+    }
+}
+
+/* 内部で使用するFFT点数の取得 */
+int32_t AE2CZT_GetFFTSize(const struct AE2CZT *czt)
+{
+    assert(czt != NULL);
+    return czt->fft_size;
+}
+
+/* CZT（Bluestein法） */
+void AE2CZT_Transform(struct AE2CZT *czt, int flag, const float *input, float *output)
+{
+    int32_t i;
+    const float *input_chirp, *output_chirp, *spectrum;
+    float *buffer;
+
+    assert(czt != NULL);
+    assert((input != NULL) && (output != NULL));
+    assert((flag == -1) || (flag == 1));
+
+    input_chirp = czt->input_chirps[AE2CZT_DIRECTION_INDEX(flag)];
+    output_chirp = czt->output_chirps[AE2CZT_DIRECTION_INDEX(flag)];
+    spectrum = czt->chirp_spectra[AE2CZT_DIRECTION_INDEX(flag)];
+    buffer = czt->buffer;
+
+    /* 入力にチャープを乗じ、残りは0埋め */
+    for (i = 0; i < czt->num_input_samples; i++) {
+        const float xr = AE2FFTCOMPLEX_REAL(input, i), xi = AE2FFTCOMPLEX_IMAG(input, i);
+        const float ar = AE2FFTCOMPLEX_REAL(input_chirp, i), ai = AE2FFTCOMPLEX_IMAG(input_chirp, i);
+        AE2FFTCOMPLEX_REAL(buffer, i) = xr * ar - xi * ai;
+        AE2FFTCOMPLEX_IMAG(buffer, i) = xr * ai + xi * ar;
+    }
+    memset(&buffer[2 * czt->num_input_samples], 0,
+            2 * sizeof(float) * (size_t)(czt->fft_size - czt->num_input_samples));
+
+    /* チャープ系列との巡回畳み込み */
+    AE2FFTPlan_FloatFFT(czt->fft_plan, -1, buffer);
+    for (i = 0; i < czt->fft_size; i++) {
+        const float xr = AE2FFTCOMPLEX_REAL(buffer, i), xi = AE2FFTCOMPLEX_IMAG(buffer, i);
+        const float br = AE2FFTCOMPLEX_REAL(spectrum, i), bi = AE2FFTCOMPLEX_IMAG(spectrum, i);
+        AE2FFTCOMPLEX_REAL(buffer, i) = xr * br - xi * bi;
+        AE2FFTCOMPLEX_IMAG(buffer, i) = xr * bi + xi * br;
+    }
+    AE2FFTPlan_FloatFFT(czt->fft_plan, 1, buffer);
+
+    /* 出力にチャープを乗じる */
+    for (i = 0; i < czt->num_output_bins; i++) {
+        const float yr = AE2FFTCOMPLEX_REAL(buffer, i), yi = AE2FFTCOMPLEX_IMAG(buffer, i);
+        const float cr = AE2FFTCOMPLEX_REAL(output_chirp, i), ci = AE2FFTCOMPLEX_IMAG(output_chirp, i);
+        AE2FFTCOMPLEX_REAL(output, i) = yr * cr - yi * ci;
+        AE2FFTCOMPLEX_IMAG(output, i) = yr * ci + yi * cr;
+    }
+}
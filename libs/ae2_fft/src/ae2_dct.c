@@ -0,0 +1,465 @@
+#include "ae2_dct.h"
+
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include "ae2_fft.h"
+
+/* 円周率 */
+#define AE2_PI 3.14159265358979323846
+/* メモリアラインメント */
+#define AE2DCT_ALIGNMENT 16
+/* nの倍数への切り上げ */
+#define AE2DCT_ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
+
+/* DCT */
+struct AE2DCT {
+    int32_t size; /* 変換点数 */
+    AE2DCTType type; /* DCTの種類 */
+    struct AE2FFTPlan *fft_plan; /* FFTプラン DCT-II:n点の実数FFT, DCT-IV:n/2点の複素FFT */
+    float *pre_twiddles; /* 前処理の回転因子（DCT-IVのみ） exp(-πi(k + 1/4)/n) (0 <= k < n/2) */
+    float *post_twiddles; /* 後処理の回転因子 DCT-II: exp(-πik/(2n)) (0 <= k <= n/2), DCT-IV: exp(-πik/n) (0 <= k < n/2) */
+    float *buffer; /* 変換用バッファ(n+2サイズ) */
+};
+
+/* MDCT */
+struct AE2MDCT {
+    int32_t num_coefficients; /* 係数の数N */
+    struct AE2DCT *dct; /* N点のDCT-IV */
+    float *analysis_window; /* 分析窓(2Nサイズ) */
+    float *synthesis_window; /* 合成窓(2Nサイズ, IMDCTの正規化定数を含む) */
+    float *history; /* 直前の入力(Nサイズ) */
+    float *overlap; /* 重畳加算バッファ(Nサイズ) */
+    float *buffer; /* 折り返し用バッファ(Nサイズ) */
+};
+
+/* exp(-πi * numer / denom) を計算 */
+static void AE2DCT_SetTwiddle(float *table, int32_t i, double numer, double denom)
+{
+    const double theta = AE2_PI * numer / denom;
+    AE2FFTCOMPLEX_REAL(table, i) = (float)cos(theta);
+    AE2FFTCOMPLEX_IMAG(table, i) = (float)(-sin(theta));
+}
+
+/* FFTプランのコンフィグを設定 */
+static void AE2DCT_SetFFTPlanConfig(const struct AE2DCTConfig *config, struct AE2FFTPlanConfig *fft_config)
+{
+    if (config->type == AE2DCT_TYPE_II) {
+        fft_config->fft_size = config->size;
+        fft_config->type = AE2FFTPLAN_TYPE_REAL;
+    } else {
+        fft_config->fft_size = config->size / 2;
+        fft_config->type = AE2FFTPLAN_TYPE_COMPLEX;
+    }
+    fft_config->in_place = 0;
+    fft_config->double_precision = 0;
+}
+
+/* DCT作成に必要なワークサイズ計算 */
+int32_t AE2DCT_CalculateWorkSize(const struct AE2DCTConfig *config)
+{
+    int32_t work_size, fft_plan_size;
+    struct AE2FFTPlanConfig fft_config;
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* コンフィグチェック */
+    if ((config->size < 4) || ((config->size % 2) != 0)) {
+        return -1;
+    }
+    if ((config->type != AE2DCT_TYPE_II) && (config->type != AE2DCT_TYPE_IV)) {
+        return -1;
+    }
+
+    /* 構造体サイズ */
+    work_size = sizeof(struct AE2DCT) + AE2DCT_ALIGNMENT;
+
+    /* FFTプラン */
+    AE2DCT_SetFFTPlanConfig(config, &fft_config);
+    if ((fft_plan_size = AE2FFTPlan_CalculateWorkSize(&fft_config)) < 0) {
+        return -1;
+    }
+    work_size += fft_plan_size;
+
+    /* 前後処理の回転因子 */
+    work_size += 2 * (int32_t)(2 * sizeof(float) * (size_t)(config->size / 2 + 1) + AE2DCT_ALIGNMENT);
+
+    /* 変換用バッファ */
+    work_size += (int32_t)(sizeof(float) * (size_t)(config->size + 2) + AE2DCT_ALIGNMENT);
+
+    return work_size;
+}
+
+/* DCT作成 */
+struct AE2DCT *AE2DCT_Create(const struct AE2DCTConfig *config, void *work, int32_t work_size)
+{
+    struct AE2DCT *dct;
+    uint8_t *work_ptr;
+    int32_t k, fft_plan_size;
+    struct AE2FFTPlanConfig fft_config;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL) || (work_size < 0)) {
+        return NULL;
+    }
+
+    if (work_size < AE2DCT_CalculateWorkSize(config)) {
+        return NULL;
+    }
+
+    /* ハンドル領域割当 */
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work, AE2DCT_ALIGNMENT);
+    dct = (struct AE2DCT *)work_ptr;
+    dct->size = config->size;
+    dct->type = config->type;
+    work_ptr += sizeof(struct AE2DCT);
+
+    /* FFTプラン */
+    AE2DCT_SetFFTPlanConfig(config, &fft_config);
+    fft_plan_size = AE2FFTPlan_CalculateWorkSize(&fft_config);
+    dct->fft_plan = AE2FFTPlan_Create(&fft_config, work_ptr, fft_plan_size);
+    if (dct->fft_plan == NULL) {
+        return NULL;
+    }
+    work_ptr += fft_plan_size;
+
+    /* 前後処理の回転因子 */
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work_ptr, AE2DCT_ALIGNMENT);
+    dct->pre_twiddles = (float *)work_ptr;
+    work_ptr += 2 * sizeof(float) * (size_t)(dct->size / 2 + 1);
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work_ptr, AE2DCT_ALIGNMENT);
+    dct->post_twiddles = (float *)work_ptr;
+    work_ptr += 2 * sizeof(float) * (size_t)(dct->size / 2 + 1);
+    if (dct->type == AE2DCT_TYPE_II) {
+        for (k = 0; k <= dct->size / 2; k++) {
+            AE2DCT_SetTwiddle(dct->post_twiddles, k, k, 2.0 * dct->size);
+        }
+    } else {
+        for (k = 0; k < dct->size / 2; k++) {
+            AE2DCT_SetTwiddle(dct->pre_twiddles, k, k + 0.25, dct->size);
+            AE2DCT_SetTwiddle(dct->post_twiddles, k, k, dct->size);
+        }
+    }
+
+    /* 変換用バッファ */
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work_ptr, AE2DCT_ALIGNMENT);
+    dct->buffer = (float *)work_ptr;
+    work_ptr += sizeof(float) * (size_t)(dct->size + 2);
+
+    return dct;
+}
+
+/* DCT破棄 */
+void AE2DCT_Destroy(struct AE2DCT *dct)
+{
+    if (dct != NULL) {
+        AE2FFTPlan_Destroy(dct->fft_plan);
+    }
+}
+
+/* 変換点数の取得 */
+int32_t AE2DCT_GetSize(const struct AE2DCT *dct)
+{
+    assert(dct != NULL);
+    return dct->size;
+}
+
+/* DCT-IV（n/2点の複素FFTを使用）
+* v[k] = (x[2k] + i * x[n-1-2k]) * exp(-πi(k + 1/4)/n) をFFTし、
+* u[k] = V[k] * exp(-πik/n) とすると y[2k] = Re(u[k]), y[n-1-2k] = -Im(u[k]) */
+static void AE2DCT_DCT4(struct AE2DCT *dct, const float *input, float *output)
+{
+    int32_t k;
+    const int32_t n = dct->size;
+    const float *pre = dct->pre_twiddles;
+    const float *post = dct->post_twiddles;
+    float *buffer = dct->buffer;
+
+    for (k = 0; k < n / 2; k++) {
+        const float xr = input[2 * k], xi = input[n - 1 - 2 * k];
+        const float wr = AE2FFTCOMPLEX_REAL(pre, k), wi = AE2FFTCOMPLEX_IMAG(pre, k);
+        AE2FFTCOMPLEX_REAL(buffer, k) = xr * wr - xi * wi;
+        AE2FFTCOMPLEX_IMAG(buffer, k) = xr * wi + xi * wr;
+    }
+
+    AE2FFTPlan_FloatFFT(dct->fft_plan, -1, buffer);
+
+    for (k = 0; k < n / 2; k++) {
+        const float vr = AE2FFTCOMPLEX_REAL(buffer, k), vi = AE2FFTCOMPLEX_IMAG(buffer, k);
+        const float wr = AE2FFTCOMPLEX_REAL(post, k), wi = AE2FFTCOMPLEX_IMAG(post, k);
+        output[2 * k] = vr * wr - vi * wi;
+        output[n - 1 - 2 * k] = -(vr * wi + vi * wr);
+    }
+}
+
+/* DCT-II（n点の実数FFTを使用）
+* v[k] = x[2k], v[n-1-k] = x[2k+1] と並べ替えてFFTし、u[k] = V[k] * exp(-πik/(2n)) とすると
+* y[k] = Re(u[k]), y[n-k] = -Im(u[k]) */
+static void AE2DCT_DCT2(struct AE2DCT *dct, const float *input, float *output)
+{
+    int32_t k;
+    const int32_t n = dct->size;
+    const float *post = dct->post_twiddles;
+    float *buffer = dct->buffer;
+
+    for (k = 0; k < n / 2; k++) {
+        buffer[k] = input[2 * k];
+        buffer[n - 1 - k] = input[2 * k + 1];
+    }
+
+    AE2FFTPlan_RealFFT(dct->fft_plan, -1, buffer);
+
+    /* 直流成分と最高周波数成分 */
+    output[0] = buffer[0];
+    output[n / 2] = buffer[1] * AE2FFTCOMPLEX_REAL(post, n / 2);
+
+    for (k = 1; k < n / 2; k++) {
+        const float vr = AE2FFTCOMPLEX_REAL(buffer, k), vi = AE2FFTCOMPLEX_IMAG(buffer, k);
+        const float wr = AE2FFTCOMPLEX_REAL(post, k), wi = AE2FFTCOMPLEX_IMAG(post, k);
+        output[k] = vr * wr - vi * wi;
+        output[n - k] = -(vr * wi + vi * wr);
+    }
+}
+
+/* DCT-III（DCT-IIの逆変換） AE2DCT_DCT2の手順を逆にたどる */
+static void AE2DCT_DCT3(struct AE2DCT *dct, const float *input, float *output)
+{
+    int32_t k;
+    const int32_t n = dct->size;
+    const float *post = dct->post_twiddles;
+    float *buffer = dct->buffer;
+
+    /* V[k] = conj(w[k]) * (y[k] - i * y[n-k]) */
+    buffer[0] = input[0];
+    buffer[1] = input[n / 2] / AE2FFTCOMPLEX_REAL(post, n / 2);
+    for (k = 1; k < n / 2; k++) {
+        const float ur = input[k], ui = -input[n - k];
+        const float wr = AE2FFTCOMPLEX_REAL(post, k), wi = AE2FFTCOMPLEX_IMAG(post, k);
+        AE2FFTCOMPLEX_REAL(buffer, k) = ur * wr + ui * wi;
+        AE2FFTCOMPLEX_IMAG(buffer, k) = ui * wr - ur * wi;
+    }
+
+    AE2FFTPlan_RealFFT(dct->fft_plan, 1, buffer);
+
+    for (k = 0; k < n / 2; k++) {
+        output[2 * k] = buffer[k];
+        output[2 * k + 1] = buffer[n - 1 - k];
+    }
+}
+
+/* DCT（順変換） */
+void AE2DCT_Forward(struct AE2DCT *dct, const float *input, float *output)
+{
+    assert(dct != NULL);
+    assert((input != NULL) && (output != NULL));
+
+    if (dct->type == AE2DCT_TYPE_II) {
+        AE2DCT_DCT2(dct, input, output);
+    } else {
+        AE2DCT_DCT4(dct, input, output);
+    }
+}
+
+/* DCT（逆変換） */
+void AE2DCT_Inverse(struct AE2DCT *dct, const float *input, float *output)
+{
+    assert(dct != NULL);
+    assert((input != NULL) && (output != NULL));
+
+    if (dct->type == AE2DCT_TYPE_II) {
+        AE2DCT_DCT3(dct, input, output);
+    } else {
+        AE2DCT_DCT4(dct, input, output);
+    }
+}
+
+/* MDCT作成に必要なワークサイズ計算 */
+int32_t AE2MDCT_CalculateWorkSize(const struct AE2MDCTConfig *config)
+{
+    int32_t work_size, dct_size;
+    struct AE2DCTConfig dct_config;
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* 構造体サイズ */
+    work_size = sizeof(struct AE2MDCT) + AE2DCT_ALIGNMENT;
+
+    /* DCT-IV */
+    dct_config.size = config->num_coefficients;
+    dct_config.type = AE2DCT_TYPE_IV;
+    if ((dct_size = AE2DCT_CalculateWorkSize(&dct_config)) < 0) {
+        return -1;
+    }
+    work_size += dct_size;
+
+    /* 分析窓・合成窓 */
+    work_size += 2 * (int32_t)(2 * sizeof(float) * (size_t)config->num_coefficients + AE2DCT_ALIGNMENT);
+
+    /* 直前の入力・重畳加算バッファ・折り返し用バッファ */
+    work_size += 3 * (int32_t)(sizeof(float) * (size_t)config->num_coefficients + AE2DCT_ALIGNMENT);
+
+    return work_size;
+}
+
+/* MDCT作成 */
+struct AE2MDCT *AE2MDCT_Create(const struct AE2MDCTConfig *config, void *work, int32_t work_size)
+{
+    struct AE2MDCT *mdct;
+    uint8_t *work_ptr;
+    int32_t i, n, dct_size;
+    float scale;
+    struct AE2DCTConfig dct_config;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL) || (work_size < 0)) {
+        return NULL;
+    }
+
+    if (work_size < AE2MDCT_CalculateWorkSize(config)) {
+        return NULL;
+    }
+
+    /* ハンドル領域割当 */
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work, AE2DCT_ALIGNMENT);
+    mdct = (struct AE2MDCT *)work_ptr;
+    mdct->num_coefficients = n = config->num_coefficients;
+    work_ptr += sizeof(struct AE2MDCT);
+
+    /* DCT-IV */
+    dct_config.size = n;
+    dct_config.type = AE2DCT_TYPE_IV;
+    dct_size = AE2DCT_CalculateWorkSize(&dct_config);
+    mdct->dct = AE2DCT_Create(&dct_config, work_ptr, dct_size);
+    if (mdct->dct == NULL) {
+        return NULL;
+    }
+    work_ptr += dct_size;
+
+    /* 分析窓・合成窓 */
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work_ptr, AE2DCT_ALIGNMENT);
+    mdct->analysis_window = (float *)work_ptr;
+    work_ptr += 2 * sizeof(float) * (size_t)n;
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work_ptr, AE2DCT_ALIGNMENT);
+    mdct->synthesis_window = (float *)work_ptr;
+    work_ptr += 2 * sizeof(float) * (size_t)n;
+    if (config->window != NULL) {
+        memcpy(mdct->analysis_window, config->window, 2 * sizeof(float) * (size_t)n);
+    } else {
+        /* サイン窓 */
+        for (i = 0; i < 2 * n; i++) {
+            mdct->analysis_window[i] = (float)sin(AE2_PI * (i + 0.5) / (2.0 * n));
+        }
+    }
+    /* 合成窓にはIMDCTの正規化定数2/N（DCT-IVの逆変換の正規化定数）を含めておく */
+    scale = 2.0f / (float)n;
+    for (i = 0; i < 2 * n; i++) {
+        mdct->synthesis_window[i] = scale * mdct->analysis_window[i];
+    }
+
+    /* 直前の入力・重畳加算バッファ・折り返し用バッファ */
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work_ptr, AE2DCT_ALIGNMENT);
+    mdct->history = (float *)work_ptr;
+    work_ptr += sizeof(float) * (size_t)n;
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work_ptr, AE2DCT_ALIGNMENT);
+    mdct->overlap = (float *)work_ptr;
+    work_ptr += sizeof(float) * (size_t)n;
+    work_ptr = (uint8_t *)AE2DCT_ROUNDUP((uintptr_t)work_ptr, AE2DCT_ALIGNMENT);
+    mdct->buffer = (float *)work_ptr;
+    work_ptr += sizeof(float) * (size_t)n;
+
+    AE2MDCT_Reset(mdct);
+
+    return mdct;
+}
+
+/* MDCT破棄 */
+void AE2MDCT_Destroy(struct AE2MDCT *mdct)
+{
+    if (mdct != NULL) {
+        AE2DCT_Destroy(mdct->dct);
+    }
+}
+
+/* 内部状態のリセット */
+void AE2MDCT_Reset(struct AE2MDCT *mdct)
+{
+    assert(mdct != NULL);
+
+    memset(mdct->history, 0, sizeof(float) * (size_t)mdct->num_coefficients);
+    memset(mdct->overlap, 0, sizeof(float) * (size_t)mdct->num_coefficients);
+}
+
+/* 係数の数の取得 */
+int32_t AE2MDCT_GetNumCoefficients(const struct AE2MDCT *mdct)
+{
+    assert(mdct != NULL);
+    return mdct->num_coefficients;
+}
+
+/* MDCT分析
+* 窓かけ後のフレームを4分割した[a, b, c, d]を[-c_r - d, a - b_r]（_rは逆順）に折り返してDCT-IV */
+void AE2MDCT_Analyze(struct AE2MDCT *mdct, const float *input, float *coefficients)
+{
+    int32_t i, n, h;
+    const float *w, *z;
+    float *fold;
+
+    assert(mdct != NULL);
+    assert((input != NULL) && (coefficients != NULL));
+
+    n = mdct->num_coefficients;
+    h = n / 2;
+    w = mdct->analysis_window;
+    z = mdct->history; /* フレーム前半 */
+    fold = mdct->buffer;
+
+    for (i = 0; i < h; i++) {
+        const float a = w[i] * z[i];
+        const float b = w[n - 1 - i] * z[n - 1 - i];
+        const float c = w[n + h - 1 - i] * input[h - 1 - i];
+        const float d = w[n + h + i] * input[h + i];
+        fold[i] = -c - d;
+        fold[h + i] = a - b;
+    }
+
+    /* 次のフレームのために入力を保存 */
+    memcpy(mdct->history, input, sizeof(float) * (size_t)n);
+
+    AE2DCT_Forward(mdct->dct, fold, coefficients);
+}
+
+/* MDCT合成
+* DCT-IVの結果[u1, u2]を[u2, -u2_r, -u1_r, -u1]に展開して窓をかけ、重畳加算する */
+void AE2MDCT_Synthesize(struct AE2MDCT *mdct, const float *coefficients, float *output)
+{
+    int32_t i, n, h;
+    const float *w;
+    float *u, *overlap;
+
+    assert(mdct != NULL);
+    assert((coefficients != NULL) && (output != NULL));
+
+    n = mdct->num_coefficients;
+    h = n / 2;
+    w = mdct->synthesis_window;
+    u = mdct->buffer;
+    overlap = mdct->overlap;
+
+    AE2DCT_Forward(mdct->dct, coefficients, u);
+
+    for (i = 0; i < h; i++) {
+        /* フレーム前半は直前のフレームの後半と加算して出力 */
+        output[i] = overlap[i] + w[i] * u[h + i];
+        output[h + i] = overlap[h + i] - w[h + i] * u[n - 1 - i];
+        /* フレーム後半は次回まで保持 */
+        overlap[i] = -w[n + i] * u[h - 1 - i];
+        overlap[h + i] = -w[n + h + i] * u[i];
+    }
+}
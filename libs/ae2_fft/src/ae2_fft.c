@@ -4,23 +4,53 @@
 #include <math.h>
 #include <assert.h>
 
-/* インラインキーワードを定義 */
-#if defined(_MSC_VER)
-#define AE2FFT_INLINE inline
-#elif defined(__GNUC__)
-#define AE2FFT_INLINE __inline__
-#else
-#define AE2FFT_INLINE
+#include "ae2_fft_kernel.h"
+
+#if defined(AE2FFT_USE_X86_SIMD) && defined(_MSC_VER)
+#include <intrin.h>
 #endif
 
 /* 円周率 */
 #define AE2_PI 3.14159265358979323846
+/* メモリアラインメント */
+#define AE2FFT_ALIGNMENT 16
+/* nの倍数への切り上げ */
+#define AE2FFT_ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
+/* ある整数が2の冪乗か判定. 0:2の冪乗ではない, それ以外:2の冪乗 */
+#define AE2FFT_IS_POWER_OF_2(x) (!((x) & ((x) - 1)))
+/* 変換方向(flag)から回転因子テーブルのインデックスを取得 -1(FFT):0, 1(IFFT):1 */
+#define AE2FFTPLAN_DIRECTION_INDEX(flag) (((flag) + 1) >> 1)
+/* プランの最大段数（2^31未満の点数を3基底で分解しても収まる数） */
+#define AE2FFTPLAN_MAX_NUM_STAGES 32
+/* 作業領域の複素数の個数 */
+#define AE2FFTPLAN_NUM_SCRATCH_COMPLEX(type, complex_size) (((type) == AE2FFTPLAN_TYPE_REAL) ? (2 * (complex_size)) : (complex_size))
+/* ビット反転テーブルの要素数（点数の対数の半分（切り上げ）ビット分） */
+#define AE2FFTPLAN_NUM_BITREV_TABLE(log2_size) (1 << (((log2_size) + 1) >> 1))
 
-/* 複素数型 */
-typedef struct AE2FFTComplex {
-    float real; /* 実部 */
-    float imag; /* 虚部 */
-} AE2FFTComplex;
+/* 倍精度複素数型 */
+typedef struct AE2FFTDoubleComplex {
+    double real; /* 実部 */
+    double imag; /* 虚部 */
+} AE2FFTDoubleComplex;
+
+/* FFTプラン */
+struct AE2FFTPlan {
+    AE2FFTPlanType type; /* 変換タイプ */
+    int32_t fft_size; /* FFT点数 */
+    int32_t complex_size; /* 内部で実行する複素FFTの点数 */
+    const struct AE2FFTKernel *kernel; /* バタフライ演算カーネル */
+    AE2FFTCodeletFunction codelet; /* 小点数FFTコードレット（対応する点数でない場合はNULL） */
+    int32_t num_stages; /* 段数 */
+    int32_t radices[AE2FFTPLAN_MAX_NUM_STAGES]; /* 各段の基底 */
+    AE2FFTComplex *stage_twiddles[2]; /* 段毎の回転因子 [0]:FFT, [1]:IFFT */
+    AE2FFTComplex *real_twiddles[2]; /* 実数FFT後処理の回転因子 [0]:FFT, [1]:IFFT */
+    AE2FFTDoubleComplex *double_stage_twiddles[2]; /* 倍精度の段毎の回転因子（倍精度変換を使用しない場合はNULL） */
+    AE2FFTDoubleComplex *double_real_twiddles[2]; /* 倍精度の実数FFT後処理の回転因子（倍精度変換を使用しない場合はNULL） */
+    AE2FFTComplex *scratch; /* 作業領域 実数FFTの場合は後半complex_size個を入力コピー領域として使用 インプレース変換の場合はNULL */
+    int32_t in_place; /* インプレース変換か 0:Stockham（作業領域を使用）, 1:インプレース */
+    int32_t log2_size; /* 複素FFT点数の2を底とする対数（インプレース変換のみ使用） */
+    int32_t *bitrev_table; /* ビット反転テーブル（インプレース変換のみ使用） */
+};
 
 /* FFT 正規化は行いません
 * n 系列長
@@ -34,6 +64,7 @@ static void AE2FFT_ComplexFFT(int n, int flag, AE2FFTComplex *x, AE2FFTComplex *
 * 構造体にパディングなどが入ってしまうとサイズが合わなくなる
 * 合わない場合は#pragmaで構造体をパックする */
 extern char AE2FFT_checksize[(sizeof(AE2FFTComplex) == (sizeof(float) * 2)) ? 1 : -1];
+extern char AE2FFT_checkdoublesize[(sizeof(AE2FFTDoubleComplex) == (sizeof(double) * 2)) ? 1 : -1];
 
 /* 複素数加算 */
 static AE2FFT_INLINE AE2FFTComplex AE2FFTComplex_Add(AE2FFTComplex a, AE2FFTComplex b)
@@ -196,3 +227,1522 @@ void AE2FFT_RealFFT(int n, const int flag, float *x, float *y)
         }
     }
 }
+
+/* スカラー実装の4基底パス */
+void AE2FFT_Radix4PassScalar(
+        int32_t n1, int32_t s, const AE2FFTComplex *twiddles, int flag, const AE2FFTComplex *x, AE2FFTComplex *y)
+{
+    int32_t p, q;
+    const int32_t n2 = (n1 << 1);
+    const int32_t n3 = n1 + n2;
+    const float fflag = (float)flag;
+    const AE2FFTComplex *w1 = &twiddles[0];
+    const AE2FFTComplex *w2 = &twiddles[n1];
+    const AE2FFTComplex *w3 = &twiddles[n2];
+
+    for (p = 0; p < n1; p++) {
+        const AE2FFTComplex w1p = w1[p];
+        const AE2FFTComplex w2p = w2[p];
+        const AE2FFTComplex w3p = w3[p];
+        for (q = 0; q < s; q++) {
+            const AE2FFTComplex    a = x[q + s * (p +  0)];
+            const AE2FFTComplex    b = x[q + s * (p + n1)];
+            const AE2FFTComplex    c = x[q + s * (p + n2)];
+            const AE2FFTComplex    d = x[q + s * (p + n3)];
+            const AE2FFTComplex  apc = AE2FFTComplex_Add(a, c);
+            const AE2FFTComplex  amc = AE2FFTComplex_Sub(a, c);
+            const AE2FFTComplex  bpd = AE2FFTComplex_Add(b, d);
+            const AE2FFTComplex  bmd = AE2FFTComplex_Sub(b, d);
+            AE2FFTComplex jbmd;
+            /* j = -flag * i との乗算 */
+            jbmd.real =  fflag * bmd.imag;
+            jbmd.imag = -fflag * bmd.real;
+            y[q + s * ((p << 2) + 0)] = AE2FFTComplex_Add(apc, bpd);
+            y[q + s * ((p << 2) + 1)] = AE2FFTComplex_Mul(w1p, AE2FFTComplex_Sub(amc, jbmd));
+            y[q + s * ((p << 2) + 2)] = AE2FFTComplex_Mul(w2p, AE2FFTComplex_Sub(apc,  bpd));
+            y[q + s * ((p << 2) + 3)] = AE2FFTComplex_Mul(w3p, AE2FFTComplex_Add(amc, jbmd));
+        }
+    }
+}
+
+/* スカラー実装の2基底パス */
+void AE2FFT_Radix2PassScalar(int32_t s, const AE2FFTComplex *x, AE2FFTComplex *y)
+{
+    int32_t q;
+
+    for (q = 0; q < s; q++) {
+        const AE2FFTComplex a = x[q + 0];
+        const AE2FFTComplex b = x[q + s];
+        y[q + 0] = AE2FFTComplex_Add(a, b);
+        y[q + s] = AE2FFTComplex_Sub(a, b);
+    }
+}
+
+/* スカラー実装のスペクトルの一括乗算加算 */
+void AE2FFT_SpectrumMulAddScalar(int32_t num_bins, int32_t num_spectra,
+        const float *const *a, const float *const *b, float *y_real, float *y_imag)
+{
+    int32_t i, k;
+
+    for (i = 0; i < num_bins; i++) {
+        float yr = y_real[i], yi = y_imag[i];
+        for (k = 0; k < num_spectra; k++) {
+            const float ar = a[k][i], ai = a[k][num_bins + i];
+            const float br = b[k][i], bi = b[k][num_bins + i];
+            yr += ar * br - ai * bi;
+            yi += ar * bi + ai * br;
+        }
+        y_real[i] = yr;
+        y_imag[i] = yi;
+    }
+}
+
+/* スカラーカーネル */
+static const struct AE2FFTKernel st_scalar_kernel = {
+    "scalar",
+    AE2FFT_Radix4PassScalar,
+    AE2FFT_Radix2PassScalar,
+    AE2FFT_SpectrumMulAddScalar,
+};
+
+/* スカラーカーネルの取得 */
+const struct AE2FFTKernel *AE2FFTKernel_GetScalar(void)
+{
+    return &st_scalar_kernel;
+}
+
+/* CPUがAVX2とFMAをサポートしているか（OSによるYMMレジスタの退避も確認） */
+static int AE2FFT_CPUSupportsAVX2FMA(void)
+{
+#if defined(AE2FFT_USE_X86_SIMD) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return 0;
+    }
+    /* OSXSAVE, AVX, FMA */
+    __cpuid(info, 1);
+    if (((info[2] >> 27) & 1) == 0 || ((info[2] >> 28) & 1) == 0 || ((info[2] >> 12) & 1) == 0) {
+        return 0;
+    }
+    /* OSがXMM/YMMの状態を保存するか */
+    if ((_xgetbv(0) & 0x6) != 0x6) {
+        return 0;
+    }
+    /* AVX2 */
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+#elif defined(AE2FFT_USE_X86_SIMD) && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#else
+    return 0;
+#endif
+}
+
+/* CPUがSSE2をサポートしているか */
+static int AE2FFT_CPUSupportsSSE2(void)
+{
+#if defined(AE2FFT_USE_X86_SIMD) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] >> 26) & 1;
+#elif defined(AE2FFT_USE_X86_SIMD) && defined(__GNUC__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+#else
+    return 0;
+#endif
+}
+
+/* 実行環境で使用可能な最速のカーネルを選択 */
+static const struct AE2FFTKernel *AE2FFT_SelectKernel(void)
+{
+    const struct AE2FFTKernel *kernel;
+
+    if (AE2FFT_CPUSupportsAVX2FMA() && ((kernel = AE2FFTKernel_GetAVX2()) != NULL)) {
+        return kernel;
+    }
+
+    if (AE2FFT_CPUSupportsSSE2() && ((kernel = AE2FFTKernel_GetSSE2()) != NULL)) {
+        return kernel;
+    }
+
+    return AE2FFTKernel_GetScalar();
+}
+
+/* 点数を段毎の基底に分解
+* 4基底を先に並べてSIMDカーネルが連続アクセスできるストライドで動くようにし、
+* 3, 5基底を続け、2基底が残る場合は最終段（回転因子不要）に置く
+* 2, 3, 5の積で表せない場合は-1を返す（1点の場合は段数0） */
+static int32_t AE2FFTPlan_Factorize(int32_t n, int32_t *radices)
+{
+    int32_t num_stages = 0;
+    int32_t num_radix2 = 0;
+
+    if (n < 1) {
+        return -1;
+    }
+
+    while ((n % 4) == 0) {
+        radices[num_stages++] = 4;
+        n /= 4;
+    }
+    if ((n % 2) == 0) {
+        num_radix2 = 1;
+        n /= 2;
+    }
+    while ((n % 3) == 0) {
+        radices[num_stages++] = 3;
+        n /= 3;
+    }
+    while ((n % 5) == 0) {
+        radices[num_stages++] = 5;
+        n /= 5;
+    }
+    if (num_radix2 > 0) {
+        radices[num_stages++] = 2;
+    }
+
+    return (n == 1) ? num_stages : -1;
+}
+
+/* 2の冪乗の点数の2を底とする対数 */
+static int32_t AE2FFTPlan_Log2(int32_t n)
+{
+    int32_t log2_n = 0;
+
+    assert(AE2FFT_IS_POWER_OF_2(n));
+
+    while ((1 << log2_n) < n) {
+        log2_n++;
+    }
+
+    return log2_n;
+}
+
+/* ビット反転テーブルを作成
+* table[k]はkを点数の対数の半分（切り上げ）ビットで反転した値
+* 残り半分のビットの反転も右シフトで得られるため、点数の平方根程度の大きさで済む */
+static void AE2FFTPlan_MakeBitReverseTable(int32_t *table, int32_t log2_size)
+{
+    int32_t k, b;
+    const int32_t num_bits = (log2_size + 1) >> 1;
+
+    for (k = 0; k < (1 << num_bits); k++) {
+        int32_t rev = 0;
+        for (b = 0; b < num_bits; b++) {
+            rev |= ((k >> b) & 1) << (num_bits - 1 - b);
+        }
+        table[k] = rev;
+    }
+}
+
+/* 段毎の回転因子テーブルのサイズ（複素数の個数）を計算 */
+static int32_t AE2FFTPlan_CalculateNumStageTwiddles(int32_t n, const int32_t *radices, int32_t num_stages)
+{
+    int32_t stage;
+    int32_t num_twiddles = 0;
+
+    /* 基底rの段でw^p, w^2p, ..., w^(r-1)pをn/r個ずつ使用 */
+    for (stage = 0; stage < num_stages; stage++) {
+        n /= radices[stage];
+        num_twiddles += (radices[stage] - 1) * n;
+    }
+
+    return num_twiddles;
+}
+
+/* 段毎の回転因子テーブルを作成
+* 基底rの段のテーブルはw^p, w^2p, ..., w^(r-1)p(0 <= p < n/r)の順に並ぶ
+* 精度を確保するため倍精度で計算してから丸める double_tableがNULLでなければ倍精度の値も格納 */
+static void AE2FFTPlan_MakeStageTwiddles(
+        AE2FFTComplex *table, AE2FFTDoubleComplex *double_table,
+        int32_t n, const int32_t *radices, int32_t num_stages, int flag)
+{
+    int32_t stage, p, k;
+
+    for (stage = 0; stage < num_stages; stage++) {
+        const int32_t radix = radices[stage];
+        const int32_t n1 = n / radix;
+        for (k = 1; k < radix; k++) {
+            for (p = 0; p < n1; p++) {
+                const double theta = (2.0 * AE2_PI * k * p) / n;
+                const double wr = cos(theta), wi = flag * sin(theta);
+                table[(k - 1) * n1 + p].real = (float)wr;
+                table[(k - 1) * n1 + p].imag = (float)wi;
+                if (double_table != NULL) {
+                    double_table[(k - 1) * n1 + p].real = wr;
+                    double_table[(k - 1) * n1 + p].imag = wi;
+                }
+            }
+        }
+        table += (radix - 1) * n1;
+        if (double_table != NULL) {
+            double_table += (radix - 1) * n1;
+        }
+        n = n1;
+    }
+}
+
+/* 実数FFT後処理の回転因子テーブルを作成
+* i番目(0 <= i < n/4)にw^(i+1)を格納 */
+static void AE2FFTPlan_MakeRealTwiddles(AE2FFTComplex *table, AE2FFTDoubleComplex *double_table, int32_t n, int flag)
+{
+    int32_t i;
+
+    for (i = 0; i < (n >> 2); i++) {
+        const double theta = (2.0 * AE2_PI * (i + 1)) / n;
+        const double wr = cos(theta), wi = flag * sin(theta);
+        table[i].real = (float)wr;
+        table[i].imag = (float)wi;
+        if (double_table != NULL) {
+            double_table[i].real = wr;
+            double_table[i].imag = wi;
+        }
+    }
+}
+
+/* FFTプラン作成に必要なワークサイズ計算 */
+int32_t AE2FFTPlan_CalculateWorkSize(const struct AE2FFTPlanConfig *config)
+{
+    int32_t work_size, complex_size, num_stages;
+    int32_t radices[AE2FFTPLAN_MAX_NUM_STAGES];
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* FFT点数は2以上 */
+    if (config->fft_size < 2) {
+        return -1;
+    }
+
+    /* 実数FFTの場合は半分の点数の複素FFTを実行 */
+    switch (config->type) {
+    case AE2FFTPLAN_TYPE_COMPLEX:
+        complex_size = config->fft_size;
+        break;
+    case AE2FFTPLAN_TYPE_REAL:
+        /* 実数FFTは偶数点のみ */
+        if ((config->fft_size % 2) != 0) {
+            return -1;
+        }
+        complex_size = config->fft_size >> 1;
+        break;
+    default: return -1;
+    }
+
+    /* 複素FFTの点数は2, 3, 5の積で表せる必要がある */
+    if ((num_stages = AE2FFTPlan_Factorize(complex_size, radices)) < 0) {
+        return -1;
+    }
+
+    /* インプレース変換は2の冪乗のみ */
+    if (config->in_place && !AE2FFT_IS_POWER_OF_2(complex_size)) {
+        return -1;
+    }
+
+    /* 構造体サイズ */
+    work_size = sizeof(struct AE2FFTPlan) + AE2FFT_ALIGNMENT;
+
+    /* 段毎の回転因子（FFT/IFFT） */
+    work_size += 2 * (int32_t)(sizeof(AE2FFTComplex)
+            * (size_t)AE2FFTPlan_CalculateNumStageTwiddles(complex_size, radices, num_stages) + AE2FFT_ALIGNMENT);
+
+    /* 実数FFT後処理の回転因子（FFT/IFFT） */
+    if (config->type == AE2FFTPLAN_TYPE_REAL) {
+        work_size += 2 * (int32_t)(sizeof(AE2FFTComplex) * (size_t)(config->fft_size >> 2) + AE2FFT_ALIGNMENT);
+    }
+
+    /* 倍精度の回転因子（FFT/IFFT） */
+    if (config->double_precision) {
+        work_size += 2 * (int32_t)(sizeof(AE2FFTDoubleComplex)
+                * (size_t)AE2FFTPlan_CalculateNumStageTwiddles(complex_size, radices, num_stages) + AE2FFT_ALIGNMENT);
+        if (config->type == AE2FFTPLAN_TYPE_REAL) {
+            work_size += 2 * (int32_t)(sizeof(AE2FFTDoubleComplex) * (size_t)(config->fft_size >> 2) + AE2FFT_ALIGNMENT);
+        }
+    }
+
+    if (config->in_place) {
+        /* ビット反転テーブル */
+        work_size += (int32_t)(sizeof(int32_t) * (size_t)AE2FFTPLAN_NUM_BITREV_TABLE(AE2FFTPlan_Log2(complex_size)) + AE2FFT_ALIGNMENT);
+    } else {
+        /* 作業領域（実数FFTは分離形式の変換で入力コピー領域も使うため2倍） */
+        work_size += (int32_t)(sizeof(AE2FFTComplex) * (size_t)AE2FFTPLAN_NUM_SCRATCH_COMPLEX(config->type, complex_size) + AE2FFT_ALIGNMENT);
+    }
+
+    return work_size;
+}
+
+/* FFTプラン作成 */
+struct AE2FFTPlan *AE2FFTPlan_Create(const struct AE2FFTPlanConfig *config, void *work, int32_t work_size)
+{
+    struct AE2FFTPlan *plan;
+    uint8_t *work_ptr;
+    int32_t num_stage_twiddles, i;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL) || (work_size < 0)) {
+        return NULL;
+    }
+
+    if (work_size < AE2FFTPlan_CalculateWorkSize(config)) {
+        return NULL;
+    }
+
+    /* ハンドル領域割当 */
+    work_ptr = (uint8_t *)AE2FFT_ROUNDUP((uintptr_t)work, AE2FFT_ALIGNMENT);
+    plan = (struct AE2FFTPlan *)work_ptr;
+    plan->type = config->type;
+    plan->fft_size = config->fft_size;
+    plan->complex_size = (config->type == AE2FFTPLAN_TYPE_REAL) ? (config->fft_size >> 1) : config->fft_size;
+    plan->kernel = AE2FFT_SelectKernel();
+    plan->codelet = AE2FFTCodelet_Get(plan->complex_size);
+    plan->num_stages = AE2FFTPlan_Factorize(plan->complex_size, plan->radices);
+    work_ptr += sizeof(struct AE2FFTPlan);
+
+    num_stage_twiddles = AE2FFTPlan_CalculateNumStageTwiddles(plan->complex_size, plan->radices, plan->num_stages);
+
+    /* 倍精度の回転因子領域 */
+    plan->double_stage_twiddles[0] = plan->double_stage_twiddles[1] = NULL;
+    plan->double_real_twiddles[0] = plan->double_real_twiddles[1] = NULL;
+    if (config->double_precision) {
+        for (i = 0; i < 2; i++) {
+            work_ptr = (uint8_t *)AE2FFT_ROUNDUP((uintptr_t)work_ptr, AE2FFT_ALIGNMENT);
+            plan->double_stage_twiddles[i] = (AE2FFTDoubleComplex *)work_ptr;
+            work_ptr += sizeof(AE2FFTDoubleComplex) * (size_t)num_stage_twiddles;
+        }
+        if (plan->type == AE2FFTPLAN_TYPE_REAL) {
+            for (i = 0; i < 2; i++) {
+                work_ptr = (uint8_t *)AE2FFT_ROUNDUP((uintptr_t)work_ptr, AE2FFT_ALIGNMENT);
+                plan->double_real_twiddles[i] = (AE2FFTDoubleComplex *)work_ptr;
+                work_ptr += sizeof(AE2FFTDoubleComplex) * (size_t)(plan->fft_size >> 2);
+            }
+        }
+    }
+
+    /* 段毎の回転因子 */
+    for (i = 0; i < 2; i++) {
+        work_ptr = (uint8_t *)AE2FFT_ROUNDUP((uintptr_t)work_ptr, AE2FFT_ALIGNMENT);
+        plan->stage_twiddles[i] = (AE2FFTComplex *)work_ptr;
+        AE2FFTPlan_MakeStageTwiddles(plan->stage_twiddles[i], plan->double_stage_twiddles[i],
+                plan->complex_size, plan->radices, plan->num_stages, (i == 0) ? -1 : 1);
+        work_ptr += sizeof(AE2FFTComplex) * (size_t)num_stage_twiddles;
+    }
+
+    /* 実数FFT後処理の回転因子 */
+    plan->real_twiddles[0] = plan->real_twiddles[1] = NULL;
+    if (plan->type == AE2FFTPLAN_TYPE_REAL) {
+        for (i = 0; i < 2; i++) {
+            work_ptr = (uint8_t *)AE2FFT_ROUNDUP((uintptr_t)work_ptr, AE2FFT_ALIGNMENT);
+            plan->real_twiddles[i] = (AE2FFTComplex *)work_ptr;
+            AE2FFTPlan_MakeRealTwiddles(plan->real_twiddles[i], plan->double_real_twiddles[i],
+                    plan->fft_size, (i == 0) ? -1 : 1);
+            work_ptr += sizeof(AE2FFTComplex) * (size_t)(plan->fft_size >> 2);
+        }
+    }
+
+    plan->in_place = (config->in_place) ? 1 : 0;
+    plan->scratch = NULL;
+    plan->bitrev_table = NULL;
+    plan->log2_size = 0;
+    if (plan->in_place) {
+        /* ビット反転テーブル */
+        plan->log2_size = AE2FFTPlan_Log2(plan->complex_size);
+        work_ptr = (uint8_t *)AE2FFT_ROUNDUP((uintptr_t)work_ptr, AE2FFT_ALIGNMENT);
+        plan->bitrev_table = (int32_t *)work_ptr;
+        AE2FFTPlan_MakeBitReverseTable(plan->bitrev_table, plan->log2_size);
+        work_ptr += sizeof(int32_t) * (size_t)AE2FFTPLAN_NUM_BITREV_TABLE(plan->log2_size);
+    } else {
+        /* 作業領域 */
+        work_ptr = (uint8_t *)AE2FFT_ROUNDUP((uintptr_t)work_ptr, AE2FFT_ALIGNMENT);
+        plan->scratch = (AE2FFTComplex *)work_ptr;
+        work_ptr += sizeof(AE2FFTComplex) * (size_t)AE2FFTPLAN_NUM_SCRATCH_COMPLEX(plan->type, plan->complex_size);
+    }
+
+    return plan;
+}
+
+/* FFTプラン破棄 */
+void AE2FFTPlan_Destroy(struct AE2FFTPlan *plan)
+{
+    /* 特に何もしない */
+    assert(plan != NULL);
+    (void)plan;
+}
+
+/* FFT点数の取得 */
+int32_t AE2FFTPlan_GetFFTSize(const struct AE2FFTPlan *plan)
+{
+    assert(plan != NULL);
+    return plan->fft_size;
+}
+
+/* 3点DFT（W = exp(flag * 2πi/3)） */
+static AE2FFT_INLINE void AE2FFT_Butterfly3(const AE2FFTComplex *in, AE2FFTComplex *out, float fflag)
+{
+    const float sin60 = 0.86602540378443864676f * fflag;
+    const AE2FFTComplex t1 = AE2FFTComplex_Add(in[1], in[2]);
+    const AE2FFTComplex t2 = AE2FFTComplex_Sub(in[1], in[2]);
+    AE2FFTComplex m;
+    m.real = in[0].real - 0.5f * t1.real;
+    m.imag = in[0].imag - 0.5f * t1.imag;
+    out[0] = AE2FFTComplex_Add(in[0], t1);
+    /* m ± i * sin60 * t2 */
+    out[1].real = m.real - sin60 * t2.imag;
+    out[1].imag = m.imag + sin60 * t2.real;
+    out[2].real = m.real + sin60 * t2.imag;
+    out[2].imag = m.imag - sin60 * t2.real;
+}
+
+/* 5点DFT（W = exp(flag * 2πi/5)） */
+static AE2FFT_INLINE void AE2FFT_Butterfly5(const AE2FFTComplex *in, AE2FFTComplex *out, float fflag)
+{
+    const float c1 = 0.30901699437494742410f; /* cos(2π/5) */
+    const float c2 = -0.80901699437494742410f; /* cos(4π/5) */
+    const float s1 = 0.95105651629515357212f * fflag; /* sin(2π/5) */
+    const float s2 = 0.58778525229247312917f * fflag; /* sin(4π/5) */
+    const AE2FFTComplex t1 = AE2FFTComplex_Add(in[1], in[4]);
+    const AE2FFTComplex t2 = AE2FFTComplex_Add(in[2], in[3]);
+    const AE2FFTComplex t3 = AE2FFTComplex_Sub(in[1], in[4]);
+    const AE2FFTComplex t4 = AE2FFTComplex_Sub(in[2], in[3]);
+    AE2FFTComplex m1, m2, n1, n2;
+    m1.real = in[0].real + c1 * t1.real + c2 * t2.real;
+    m1.imag = in[0].imag + c1 * t1.imag + c2 * t2.imag;
+    m2.real = in[0].real + c2 * t1.real + c1 * t2.real;
+    m2.imag = in[0].imag + c2 * t1.imag + c1 * t2.imag;
+    n1.real = s1 * t3.real + s2 * t4.real;
+    n1.imag = s1 * t3.imag + s2 * t4.imag;
+    n2.real = s2 * t3.real - s1 * t4.real;
+    n2.imag = s2 * t3.imag - s1 * t4.imag;
+    out[0].real = in[0].real + t1.real + t2.real;
+    out[0].imag = in[0].imag + t1.imag + t2.imag;
+    /* m ± i * n */
+    out[1].real = m1.real - n1.imag; out[1].imag = m1.imag + n1.real;
+    out[4].real = m1.real + n1.imag; out[4].imag = m1.imag - n1.real;
+    out[2].real = m2.real - n2.imag; out[2].imag = m2.imag + n2.real;
+    out[3].real = m2.real + n2.imag; out[3].imag = m2.imag - n2.real;
+}
+
+/* 2, 4基底以外の段のDFT 基底は3か5（分解で他の基底は現れない） */
+static AE2FFT_INLINE void AE2FFT_ButterflyOddRadix(
+        int32_t radix, const AE2FFTComplex *in, AE2FFTComplex *out, float fflag)
+{
+    if (radix == 3) {
+        AE2FFT_Butterfly3(in, out, fflag);
+    } else {
+        assert(radix == 5);
+        AE2FFT_Butterfly5(in, out, fflag);
+    }
+}
+
+/* 3, 5基底Stockhamパス
+* y[q + s * (r * p + k)] = w^(kp) * DFT_r(x[q + s * (p + n1 * m)])[k] */
+static void AE2FFTPlan_OddRadixPass(int32_t radix, int32_t n1, int32_t s,
+        const AE2FFTComplex *twiddles, int flag, const AE2FFTComplex *x, AE2FFTComplex *y)
+{
+    int32_t p, q, k;
+    const float fflag = (float)flag;
+    AE2FFTComplex in[5], out[5];
+
+    assert(radix <= 5);
+
+    for (p = 0; p < n1; p++) {
+        for (q = 0; q < s; q++) {
+            for (k = 0; k < radix; k++) {
+                in[k] = x[q + s * (p + n1 * k)];
+            }
+            AE2FFT_ButterflyOddRadix(radix, in, out, fflag);
+            y[q + s * (radix * p)] = out[0];
+            for (k = 1; k < radix; k++) {
+                y[q + s * (radix * p + k)] = AE2FFTComplex_Mul(twiddles[(k - 1) * n1 + p], out[k]);
+            }
+        }
+    }
+}
+
+/* 回転因子テーブルを使用したバッチFFT 正規化は行いません
+* plan FFTプラン
+* flag -1:FFT, 1:IFFT
+* num_batch 同時に変換する系列数
+* x フーリエ変換する系列(入出力 plan->complex_size * num_batch点, i番目の系列のk番目の要素はx[k * num_batch + i])
+* y 作業用配列(xと同一サイズ)
+* 初段のストライドをnum_batchとしたStockham FFTは、各系列を独立に変換したものと一致する
+*/
+static void AE2FFTPlan_ComplexFFTBatch(const struct AE2FFTPlan *plan, const int flag, int32_t num_batch,
+        AE2FFTComplex *x, AE2FFTComplex *y)
+{
+    int32_t stage;
+    AE2FFTComplex *tmp, *src = x;
+    const AE2FFTComplex *twiddles = plan->stage_twiddles[AE2FFTPLAN_DIRECTION_INDEX(flag)];
+    const struct AE2FFTKernel *kernel = plan->kernel;
+    int32_t n = plan->complex_size;
+    int32_t s = num_batch; /* ストライド */
+
+    /* 混合基底 Stockham FFT */
+    for (stage = 0; stage < plan->num_stages; stage++) {
+        const int32_t radix = plan->radices[stage];
+        const int32_t n1 = n / radix;
+        switch (radix) {
+        case 4:
+            kernel->Radix4Pass(n1, s, twiddles, flag, x, y);
+            break;
+        case 2:
+            /* 2基底は必ず最終段（n1 == 1） */
+            assert(n1 == 1);
+            kernel->Radix2Pass(s, x, y);
+            break;
+        default:
+            AE2FFTPlan_OddRadixPass(radix, n1, s, twiddles, flag, x, y);
+            break;
+        }
+        twiddles += (radix - 1) * n1;
+        n = n1;
+        s *= radix;
+        tmp = x; x = y; y = tmp;
+    }
+
+    if (src != x) {
+        memcpy(y, x, sizeof(AE2FFTComplex) * (size_t)s);
+    }
+}
+
+/* 回転因子テーブルを使用したFFT 正規化は行いません
+* plan FFTプラン
+* flag -1:FFT, 1:IFFT
+* x フーリエ変換する系列(入出力 plan->complex_size点)
+* y 作業用配列(xと同一サイズ)
+*/
+static void AE2FFTPlan_ComplexFFT(const struct AE2FFTPlan *plan, const int flag, AE2FFTComplex *x, AE2FFTComplex *y)
+{
+    AE2FFTPlan_ComplexFFTBatch(plan, flag, 1, x, y);
+}
+
+/* インプレースFFT 正規化は行いません
+* plan FFTプラン
+* flag -1:FFT, 1:IFFT
+* re, im フーリエ変換する系列の実部と虚部(入出力 plan->complex_size点)
+* stride 要素の間隔（実部と虚部を交互に並べた形式なら2, 分離形式なら1）
+* 4基底の周波数間引き（DIF）を行い、最後にビット反転で並べ替える
+* バタフライの出力を(0, 2, 1, 3)の順に書き戻すことで、4基底でも出力順がビット反転順になる
+* 段の回転因子はStockham FFTと同一のテーブルを使う */
+static void AE2FFTPlan_InPlaceFFT(const struct AE2FFTPlan *plan, const int flag, float *re, float *im, int32_t stride)
+{
+    int32_t stage, b, p, i;
+    const AE2FFTComplex *twiddles = plan->stage_twiddles[AE2FFTPLAN_DIRECTION_INDEX(flag)];
+    const int32_t n = plan->complex_size;
+    const float fflag = (float)flag;
+    int32_t len = n; /* 現在のブロック長 */
+
+    assert(plan->in_place);
+
+    /* 4基底/2基底 DIF */
+    for (stage = 0; stage < plan->num_stages; stage++) {
+        const int32_t radix = plan->radices[stage];
+        const int32_t n1 = len / radix;
+        if (radix == 4) {
+            const AE2FFTComplex *w1 = &twiddles[0];
+            const AE2FFTComplex *w2 = &twiddles[n1];
+            const AE2FFTComplex *w3 = &twiddles[2 * n1];
+            for (b = 0; b < n; b += len) {
+                for (p = 0; p < n1; p++) {
+                    const int32_t i0 = stride * (b + p);
+                    const int32_t i1 = i0 + stride * n1;
+                    const int32_t i2 = i1 + stride * n1;
+                    const int32_t i3 = i2 + stride * n1;
+                    const float apcr = re[i0] + re[i2], apci = im[i0] + im[i2];
+                    const float amcr = re[i0] - re[i2], amci = im[i0] - im[i2];
+                    const float bpdr = re[i1] + re[i3], bpdi = im[i1] + im[i3];
+                    /* j = -flag * i との乗算 */
+                    const float jbmdr =  fflag * (im[i1] - im[i3]);
+                    const float jbmdi = -fflag * (re[i1] - re[i3]);
+                    const float t1r = amcr - jbmdr, t1i = amci - jbmdi;
+                    const float t2r = apcr - bpdr, t2i = apci - bpdi;
+                    const float t3r = amcr + jbmdr, t3i = amci + jbmdi;
+                    re[i0] = apcr + bpdr; im[i0] = apci + bpdi;
+                    re[i1] = w2[p].real * t2r - w2[p].imag * t2i; im[i1] = w2[p].real * t2i + w2[p].imag * t2r;
+                    re[i2] = w1[p].real * t1r - w1[p].imag * t1i; im[i2] = w1[p].real * t1i + w1[p].imag * t1r;
+                    re[i3] = w3[p].real * t3r - w3[p].imag * t3i; im[i3] = w3[p].real * t3i + w3[p].imag * t3r;
+                }
+            }
+        } else {
+            /* 2基底は必ず最終段（len == 2） */
+            assert((radix == 2) && (n1 == 1));
+            for (b = 0; b < n; b += 2) {
+                const int32_t i0 = stride * b;
+                const int32_t i1 = i0 + stride;
+                const float ar = re[i0], ai = im[i0];
+                re[i0] = ar + re[i1]; im[i0] = ai + im[i1];
+                re[i1] = ar - re[i1]; im[i1] = ai - im[i1];
+            }
+        }
+        twiddles += (radix - 1) * n1;
+        len = n1;
+    }
+
+    /* ビット反転による並べ替え */
+    {
+        const int32_t num_high_bits = (plan->log2_size + 1) >> 1;
+        const int32_t num_low_bits = plan->log2_size - num_high_bits;
+        const int32_t low_mask = (1 << num_low_bits) - 1;
+        for (i = 0; i < n; i++) {
+            const int32_t rev = ((plan->bitrev_table[i & low_mask] >> (num_high_bits - num_low_bits)) << num_high_bits)
+                | plan->bitrev_table[i >> num_low_bits];
+            if (i < rev) {
+                const int32_t ii = stride * i, ir = stride * rev;
+                float tmp;
+                tmp = re[ii]; re[ii] = re[ir]; re[ir] = tmp;
+                tmp = im[ii]; im[ii] = im[ir]; im[ir] = tmp;
+            }
+        }
+    }
+}
+
+/* プランの設定に応じたFFT 正規化は行いません
+* plan FFTプラン
+* flag -1:FFT, 1:IFFT
+* x フーリエ変換する系列(入出力 plan->complex_size点)
+*/
+static void AE2FFTPlan_ExecuteComplexFFT(const struct AE2FFTPlan *plan, const int flag, float *x)
+{
+    if (plan->codelet != NULL) {
+        /* 小点数はコードレットで直接変換（作業領域不要のためインプレース変換でも使用） */
+        plan->codelet(plan->stage_twiddles[AE2FFTPLAN_DIRECTION_INDEX(flag)], flag, (AE2FFTComplex *)x);
+    } else if (plan->in_place) {
+        AE2FFTPlan_InPlaceFFT(plan, flag, &x[0], &x[1], 2);
+    } else {
+        AE2FFTPlan_ComplexFFT(plan, flag, (AE2FFTComplex *)x, plan->scratch);
+    }
+}
+
+/* プランを使用したFFT */
+void AE2FFTPlan_FloatFFT(struct AE2FFTPlan *plan, int flag, float *x)
+{
+    assert(plan != NULL);
+    assert(x != NULL);
+    assert(plan->type == AE2FFTPLAN_TYPE_COMPLEX);
+    assert((flag == -1) || (flag == 1));
+
+    AE2FFTPlan_ExecuteComplexFFT(plan, flag, x);
+}
+
+/* プランを使用した複数系列のFFT */
+void AE2FFTPlan_FloatFFTBatch(const struct AE2FFTPlan *plan, int flag, int32_t num_batch, float *x, float *y)
+{
+    assert(plan != NULL);
+    assert((x != NULL) && (y != NULL));
+    assert(plan->type == AE2FFTPLAN_TYPE_COMPLEX);
+    assert((flag == -1) || (flag == 1));
+    assert(num_batch > 0);
+
+    AE2FFTPlan_ComplexFFTBatch(plan, flag, num_batch, (AE2FFTComplex *)x, (AE2FFTComplex *)y);
+}
+
+/* 実数列FFTの後処理（IFFTの場合は前処理）
+* スペクトルの対称性を使用し、FFTの場合は最終結果をまとめ、IFFTの場合は元に戻るよう整理 */
+static void AE2FFTPlan_RealFFTPostProcess(const struct AE2FFTPlan *plan, const int flag, float *x)
+{
+    int32_t i;
+    const int32_t n = plan->fft_size;
+    const float c2 = 0.5f * (float)flag;
+    const AE2FFTComplex *real_twiddles = plan->real_twiddles[AE2FFTPLAN_DIRECTION_INDEX(flag)];
+
+    for (i = 1; i <= (n >> 2); i++) {
+        const int32_t i1 = (i << 1);
+        const int32_t i2 = i1 + 1;
+        const int32_t i3 = n - i1;
+        const int32_t i4 = i3 + 1;
+        const float wr = real_twiddles[i - 1].real;
+        const float wi = real_twiddles[i - 1].imag;
+        const float h1r = 0.5f * (x[i1] + x[i3]);
+        const float h1i = 0.5f * (x[i2] - x[i4]);
+        const float h2r = -c2 * (x[i2] + x[i4]);
+        const float h2i =  c2 * (x[i1] - x[i3]);
+        x[i1] =  h1r + (wr * h2r) - (wi * h2i);
+        x[i2] =  h1i + (wr * h2i) + (wi * h2r);
+        x[i3] =  h1r - (wr * h2r) + (wi * h2i);
+        x[i4] = -h1i + (wr * h2i) + (wi * h2r);
+    }
+
+    /* 直流成分/最高周波数成分 */
+    {
+        const float h1r = x[0];
+        if (flag == -1) {
+            x[0] = h1r + x[1];
+            x[1] = h1r - x[1];
+        } else {
+            x[0] = 0.5f * (h1r + x[1]);
+            x[1] = 0.5f * (h1r - x[1]);
+        }
+    }
+}
+
+/* プランを使用した実数列のFFT 正規化は行いません 正規化定数は2/n */
+void AE2FFTPlan_RealFFT(struct AE2FFTPlan *plan, int flag, float *x)
+{
+    assert(plan != NULL);
+    assert(x != NULL);
+    assert(plan->type == AE2FFTPLAN_TYPE_REAL);
+    assert((flag == -1) || (flag == 1));
+
+    /* FFTの場合は先に変換 */
+    if (flag == -1) {
+        AE2FFTPlan_ExecuteComplexFFT(plan, -1, x);
+    }
+
+    AE2FFTPlan_RealFFTPostProcess(plan, flag, x);
+
+    /* IFFTの場合は後で変換 */
+    if (flag == 1) {
+        AE2FFTPlan_ExecuteComplexFFT(plan, 1, x);
+    }
+}
+
+/* プランを使用した複数チャンネルの実数列のFFT 正規化は行いません 正規化定数は2/n */
+void AE2FFTPlan_RealFFTBatch(struct AE2FFTPlan *plan, int flag, int32_t num_channels, float **x, float *work)
+{
+    int32_t ch, i;
+    AE2FFTComplex *buffer, *scratch;
+
+    assert(plan != NULL);
+    assert((x != NULL) && (work != NULL));
+    assert(plan->type == AE2FFTPLAN_TYPE_REAL);
+    assert((flag == -1) || (flag == 1));
+    assert(num_channels > 0);
+
+    /* 作業領域を前半（チャンネルインターリーブ系列）と後半（Stockhamの作業用配列）に分ける */
+    buffer = (AE2FFTComplex *)work;
+    scratch = &buffer[num_channels * plan->complex_size];
+
+    /* IFFTの場合は先に前処理 */
+    if (flag == 1) {
+        for (ch = 0; ch < num_channels; ch++) {
+            assert(x[ch] != NULL);
+            AE2FFTPlan_RealFFTPostProcess(plan, 1, x[ch]);
+        }
+    }
+
+    /* チャンネル方向にインターリーブしてまとめて変換
+    * ストライドがチャンネル数の倍数になり、小さい点数でもSIMDレーンが埋まる */
+    for (ch = 0; ch < num_channels; ch++) {
+        const AE2FFTComplex *src = (const AE2FFTComplex *)x[ch];
+        assert(x[ch] != NULL);
+        for (i = 0; i < plan->complex_size; i++) {
+            buffer[i * num_channels + ch] = src[i];
+        }
+    }
+    AE2FFTPlan_ComplexFFTBatch(plan, flag, num_channels, buffer, scratch);
+    for (ch = 0; ch < num_channels; ch++) {
+        AE2FFTComplex *dst = (AE2FFTComplex *)x[ch];
+        for (i = 0; i < plan->complex_size; i++) {
+            dst[i] = buffer[i * num_channels + ch];
+        }
+    }
+
+    /* FFTの場合は後で後処理 */
+    if (flag == -1) {
+        for (ch = 0; ch < num_channels; ch++) {
+            AE2FFTPlan_RealFFTPostProcess(plan, -1, x[ch]);
+        }
+    }
+}
+
+/* プランを使用した実数列のFFT（n/2+1点の半スペクトルを出力） 正規化は行いません */
+void AE2FFTPlan_RealFFTHalfSpectrum(struct AE2FFTPlan *plan, const float *x, float *spectrum)
+{
+    int32_t n;
+
+    assert(plan != NULL);
+    assert((x != NULL) && (spectrum != NULL));
+    assert(plan->type == AE2FFTPLAN_TYPE_REAL);
+
+    n = plan->fft_size;
+
+    /* 出力領域上で直接変換 */
+    if (spectrum != x) {
+        memcpy(spectrum, x, sizeof(float) * (size_t)n);
+    }
+    AE2FFTPlan_RealFFT(plan, -1, spectrum);
+
+    /* 最高周波数成分を末尾に移し、直流・最高周波数成分の虚部を0にする */
+    spectrum[n] = spectrum[1];
+    spectrum[1] = 0.0f;
+    spectrum[n + 1] = 0.0f;
+}
+
+/* n/2+1点の半スペクトルからの実数列IFFT 正規化定数1/nを乗じて逆変換になるようにする */
+void AE2FFTPlan_RealIFFTHalfSpectrum(struct AE2FFTPlan *plan, const float *spectrum, float *x)
+{
+    int32_t i, n;
+    float scale, nyquist;
+
+    assert(plan != NULL);
+    assert((x != NULL) && (spectrum != NULL));
+    assert(plan->type == AE2FFTPLAN_TYPE_REAL);
+
+    n = plan->fft_size;
+    /* AE2FFTPlan_RealFFTの正規化定数は2/n 入力のコピー時にまとめて乗じる */
+    scale = 2.0f / (float)n;
+    /* xとspectrumが同じ領域の場合に上書きされるため先に読み出す */
+    nyquist = spectrum[n];
+
+    /* 直流・最高周波数成分の虚部は無視し、AE2FFTPlan_RealFFTの配置に詰める */
+    x[0] = scale * spectrum[0];
+    x[1] = scale * nyquist;
+    for (i = 2; i < n; i++) {
+        x[i] = scale * spectrum[i];
+    }
+
+    AE2FFTPlan_RealFFT(plan, 1, x);
+}
+
+/* 倍精度複素数加算 */
+static AE2FFT_INLINE AE2FFTDoubleComplex AE2FFTDoubleComplex_Add(AE2FFTDoubleComplex a, AE2FFTDoubleComplex b)
+{
+    AE2FFTDoubleComplex ret;
+    ret.real = a.real + b.real;
+    ret.imag = a.imag + b.imag;
+    return ret;
+}
+
+/* 倍精度複素数減算 */
+static AE2FFT_INLINE AE2FFTDoubleComplex AE2FFTDoubleComplex_Sub(AE2FFTDoubleComplex a, AE2FFTDoubleComplex b)
+{
+    AE2FFTDoubleComplex ret;
+    ret.real = a.real - b.real;
+    ret.imag = a.imag - b.imag;
+    return ret;
+}
+
+/* 倍精度複素数乗算 */
+static AE2FFT_INLINE AE2FFTDoubleComplex AE2FFTDoubleComplex_Mul(AE2FFTDoubleComplex a, AE2FFTDoubleComplex b)
+{
+    AE2FFTDoubleComplex ret;
+    ret.real = a.real * b.real - a.imag * b.imag;
+    ret.imag = a.real * b.imag + a.imag * b.real;
+    return ret;
+}
+
+/* 倍精度の3点DFT（W = exp(flag * 2πi/3)） */
+static AE2FFT_INLINE void AE2FFTDouble_Butterfly3(const AE2FFTDoubleComplex *in, AE2FFTDoubleComplex *out, double dflag)
+{
+    const double sin60 = 0.86602540378443864676 * dflag;
+    const AE2FFTDoubleComplex t1 = AE2FFTDoubleComplex_Add(in[1], in[2]);
+    const AE2FFTDoubleComplex t2 = AE2FFTDoubleComplex_Sub(in[1], in[2]);
+    AE2FFTDoubleComplex m;
+    m.real = in[0].real - 0.5 * t1.real;
+    m.imag = in[0].imag - 0.5 * t1.imag;
+    out[0] = AE2FFTDoubleComplex_Add(in[0], t1);
+    /* m ± i * sin60 * t2 */
+    out[1].real = m.real - sin60 * t2.imag;
+    out[1].imag = m.imag + sin60 * t2.real;
+    out[2].real = m.real + sin60 * t2.imag;
+    out[2].imag = m.imag - sin60 * t2.real;
+}
+
+/* 倍精度の5点DFT（W = exp(flag * 2πi/5)） */
+static AE2FFT_INLINE void AE2FFTDouble_Butterfly5(const AE2FFTDoubleComplex *in, AE2FFTDoubleComplex *out, double dflag)
+{
+    const double c1 = 0.30901699437494742410; /* cos(2π/5) */
+    const double c2 = -0.80901699437494742410; /* cos(4π/5) */
+    const double s1 = 0.95105651629515357212 * dflag; /* sin(2π/5) */
+    const double s2 = 0.58778525229247312917 * dflag; /* sin(4π/5) */
+    const AE2FFTDoubleComplex t1 = AE2FFTDoubleComplex_Add(in[1], in[4]);
+    const AE2FFTDoubleComplex t2 = AE2FFTDoubleComplex_Add(in[2], in[3]);
+    const AE2FFTDoubleComplex t3 = AE2FFTDoubleComplex_Sub(in[1], in[4]);
+    const AE2FFTDoubleComplex t4 = AE2FFTDoubleComplex_Sub(in[2], in[3]);
+    AE2FFTDoubleComplex m1, m2, n1, n2;
+    m1.real = in[0].real + c1 * t1.real + c2 * t2.real;
+    m1.imag = in[0].imag + c1 * t1.imag + c2 * t2.imag;
+    m2.real = in[0].real + c2 * t1.real + c1 * t2.real;
+    m2.imag = in[0].imag + c2 * t1.imag + c1 * t2.imag;
+    n1.real = s1 * t3.real + s2 * t4.real;
+    n1.imag = s1 * t3.imag + s2 * t4.imag;
+    n2.real = s2 * t3.real - s1 * t4.real;
+    n2.imag = s2 * t3.imag - s1 * t4.imag;
+    out[0].real = in[0].real + t1.real + t2.real;
+    out[0].imag = in[0].imag + t1.imag + t2.imag;
+    /* m ± i * n */
+    out[1].real = m1.real - n1.imag; out[1].imag = m1.imag + n1.real;
+    out[4].real = m1.real + n1.imag; out[4].imag = m1.imag - n1.real;
+    out[2].real = m2.real - n2.imag; out[2].imag = m2.imag + n2.real;
+    out[3].real = m2.real + n2.imag; out[3].imag = m2.imag - n2.real;
+}
+
+/* 倍精度の4基底Stockhamパス */
+static void AE2FFTPlan_DoubleRadix4Pass(int32_t n1, int32_t s, const AE2FFTDoubleComplex *twiddles, int flag,
+        const AE2FFTDoubleComplex *x, AE2FFTDoubleComplex *y)
+{
+    int32_t p, q;
+    const int32_t n2 = (n1 << 1);
+    const int32_t n3 = n1 + n2;
+    const double dflag = (double)flag;
+    const AE2FFTDoubleComplex *w1 = &twiddles[0];
+    const AE2FFTDoubleComplex *w2 = &twiddles[n1];
+    const AE2FFTDoubleComplex *w3 = &twiddles[n2];
+
+    for (p = 0; p < n1; p++) {
+        const AE2FFTDoubleComplex w1p = w1[p];
+        const AE2FFTDoubleComplex w2p = w2[p];
+        const AE2FFTDoubleComplex w3p = w3[p];
+        for (q = 0; q < s; q++) {
+            const AE2FFTDoubleComplex    a = x[q + s * (p +  0)];
+            const AE2FFTDoubleComplex    b = x[q + s * (p + n1)];
+            const AE2FFTDoubleComplex    c = x[q + s * (p + n2)];
+            const AE2FFTDoubleComplex    d = x[q + s * (p + n3)];
+            const AE2FFTDoubleComplex  apc = AE2FFTDoubleComplex_Add(a, c);
+            const AE2FFTDoubleComplex  amc = AE2FFTDoubleComplex_Sub(a, c);
+            const AE2FFTDoubleComplex  bpd = AE2FFTDoubleComplex_Add(b, d);
+            const AE2FFTDoubleComplex  bmd = AE2FFTDoubleComplex_Sub(b, d);
+            AE2FFTDoubleComplex jbmd;
+            /* j = -flag * i との乗算 */
+            jbmd.real =  dflag * bmd.imag;
+            jbmd.imag = -dflag * bmd.real;
+            y[q + s * ((p << 2) + 0)] = AE2FFTDoubleComplex_Add(apc, bpd);
+            y[q + s * ((p << 2) + 1)] = AE2FFTDoubleComplex_Mul(w1p, AE2FFTDoubleComplex_Sub(amc, jbmd));
+            y[q + s * ((p << 2) + 2)] = AE2FFTDoubleComplex_Mul(w2p, AE2FFTDoubleComplex_Sub(apc,  bpd));
+            y[q + s * ((p << 2) + 3)] = AE2FFTDoubleComplex_Mul(w3p, AE2FFTDoubleComplex_Add(amc, jbmd));
+        }
+    }
+}
+
+/* 倍精度の2基底Stockhamパス（最終段） */
+static void AE2FFTPlan_DoubleRadix2Pass(int32_t s, const AE2FFTDoubleComplex *x, AE2FFTDoubleComplex *y)
+{
+    int32_t q;
+
+    for (q = 0; q < s; q++) {
+        const AE2FFTDoubleComplex a = x[q + 0];
+        const AE2FFTDoubleComplex b = x[q + s];
+        y[q + 0] = AE2FFTDoubleComplex_Add(a, b);
+        y[q + s] = AE2FFTDoubleComplex_Sub(a, b);
+    }
+}
+
+/* 倍精度の3, 5基底Stockhamパス */
+static void AE2FFTPlan_DoubleOddRadixPass(int32_t radix, int32_t n1, int32_t s,
+        const AE2FFTDoubleComplex *twiddles, int flag, const AE2FFTDoubleComplex *x, AE2FFTDoubleComplex *y)
+{
+    int32_t p, q, k;
+    const double dflag = (double)flag;
+    AE2FFTDoubleComplex in[5], out[5];
+
+    assert(radix <= 5);
+
+    for (p = 0; p < n1; p++) {
+        for (q = 0; q < s; q++) {
+            for (k = 0; k < radix; k++) {
+                in[k] = x[q + s * (p + n1 * k)];
+            }
+            switch (radix) {
+            case 3: AE2FFTDouble_Butterfly3(in, out, dflag); break;
+            case 5: AE2FFTDouble_Butterfly5(in, out, dflag); break;
+            default: assert(0);
+            }
+            y[q + s * (radix * p)] = out[0];
+            for (k = 1; k < radix; k++) {
+                y[q + s * (radix * p + k)] = AE2FFTDoubleComplex_Mul(twiddles[(k - 1) * n1 + p], out[k]);
+            }
+        }
+    }
+}
+
+/* 倍精度の回転因子テーブルを使用したFFT 正規化は行いません
+* 段の構成は単精度のAE2FFTPlan_ComplexFFTBatchと同一 */
+static void AE2FFTPlan_DoubleComplexFFT(const struct AE2FFTPlan *plan, const int flag,
+        AE2FFTDoubleComplex *x, AE2FFTDoubleComplex *y)
+{
+    int32_t stage;
+    AE2FFTDoubleComplex *tmp, *src = x;
+    const AE2FFTDoubleComplex *twiddles = plan->double_stage_twiddles[AE2FFTPLAN_DIRECTION_INDEX(flag)];
+    int32_t n = plan->complex_size;
+    int32_t s = 1; /* ストライド */
+
+    assert(twiddles != NULL);
+
+    /* 混合基底 Stockham FFT */
+    for (stage = 0; stage < plan->num_stages; stage++) {
+        const int32_t radix = plan->radices[stage];
+        const int32_t n1 = n / radix;
+        switch (radix) {
+        case 4:
+            AE2FFTPlan_DoubleRadix4Pass(n1, s, twiddles, flag, x, y);
+            break;
+        case 2:
+            assert(n1 == 1);
+            AE2FFTPlan_DoubleRadix2Pass(s, x, y);
+            break;
+        default:
+            AE2FFTPlan_DoubleOddRadixPass(radix, n1, s, twiddles, flag, x, y);
+            break;
+        }
+        twiddles += (radix - 1) * n1;
+        n = n1;
+        s *= radix;
+        tmp = x; x = y; y = tmp;
+    }
+
+    if (src != x) {
+        memcpy(y, x, sizeof(AE2FFTDoubleComplex) * (size_t)s);
+    }
+}
+
+/* 倍精度の実数列FFTの後処理（IFFTの場合は前処理） AE2FFTPlan_RealFFTPostProcessの倍精度版 */
+static void AE2FFTPlan_DoubleRealFFTPostProcess(const struct AE2FFTPlan *plan, const int flag, double *x)
+{
+    int32_t i;
+    const int32_t n = plan->fft_size;
+    const double c2 = 0.5 * (double)flag;
+    const AE2FFTDoubleComplex *real_twiddles = plan->double_real_twiddles[AE2FFTPLAN_DIRECTION_INDEX(flag)];
+
+    assert((real_twiddles != NULL) || (n < 4));
+
+    for (i = 1; i <= (n >> 2); i++) {
+        const int32_t i1 = (i << 1);
+        const int32_t i2 = i1 + 1;
+        const int32_t i3 = n - i1;
+        const int32_t i4 = i3 + 1;
+        const double wr = real_twiddles[i - 1].real;
+        const double wi = real_twiddles[i - 1].imag;
+        const double h1r = 0.5 * (x[i1] + x[i3]);
+        const double h1i = 0.5 * (x[i2] - x[i4]);
+        const double h2r = -c2 * (x[i2] + x[i4]);
+        const double h2i =  c2 * (x[i1] - x[i3]);
+        x[i1] =  h1r + (wr * h2r) - (wi * h2i);
+        x[i2] =  h1i + (wr * h2i) + (wi * h2r);
+        x[i3] =  h1r - (wr * h2r) + (wi * h2i);
+        x[i4] = -h1i + (wr * h2i) + (wi * h2r);
+    }
+
+    /* 直流成分/最高周波数成分 */
+    {
+        const double h1r = x[0];
+        if (flag == -1) {
+            x[0] = h1r + x[1];
+            x[1] = h1r - x[1];
+        } else {
+            x[0] = 0.5 * (h1r + x[1]);
+            x[1] = 0.5 * (h1r - x[1]);
+        }
+    }
+}
+
+/* プランを使用した倍精度のFFT */
+void AE2FFTPlan_DoubleFFT(const struct AE2FFTPlan *plan, int flag, double *x, double *y)
+{
+    assert(plan != NULL);
+    assert((x != NULL) && (y != NULL));
+    assert(plan->type == AE2FFTPLAN_TYPE_COMPLEX);
+    assert(plan->double_stage_twiddles[0] != NULL);
+    assert((flag == -1) || (flag == 1));
+
+    AE2FFTPlan_DoubleComplexFFT(plan, flag, (AE2FFTDoubleComplex *)x, (AE2FFTDoubleComplex *)y);
+}
+
+/* プランを使用した倍精度の実数列のFFT 正規化は行いません 正規化定数は2/n */
+void AE2FFTPlan_DoubleRealFFT(const struct AE2FFTPlan *plan, int flag, double *x, double *y)
+{
+    assert(plan != NULL);
+    assert((x != NULL) && (y != NULL));
+    assert(plan->type == AE2FFTPLAN_TYPE_REAL);
+    assert(plan->double_stage_twiddles[0] != NULL);
+    assert((flag == -1) || (flag == 1));
+
+    /* FFTの場合は先に変換 */
+    if (flag == -1) {
+        AE2FFTPlan_DoubleComplexFFT(plan, -1, (AE2FFTDoubleComplex *)x, (AE2FFTDoubleComplex *)y);
+    }
+
+    AE2FFTPlan_DoubleRealFFTPostProcess(plan, flag, x);
+
+    /* IFFTの場合は後で変換 */
+    if (flag == 1) {
+        AE2FFTPlan_DoubleComplexFFT(plan, 1, (AE2FFTDoubleComplex *)x, (AE2FFTDoubleComplex *)y);
+    }
+}
+
+/* 分離形式の4基底Stockhamパス
+* 内側ループは連続アクセスのみなのでコンパイラによるベクトル化が効く */
+static void AE2FFTPlan_SplitRadix4Pass(int32_t n1, int32_t s, const AE2FFTComplex *twiddles, int flag,
+        const float *xr, const float *xi, float *yr, float *yi)
+{
+    int32_t p, q;
+    const int32_t n2 = (n1 << 1);
+    const int32_t n3 = n1 + n2;
+    const float fflag = (float)flag;
+
+    for (p = 0; p < n1; p++) {
+        const float w1r = twiddles[p].real, w1i = twiddles[p].imag;
+        const float w2r = twiddles[p + n1].real, w2i = twiddles[p + n1].imag;
+        const float w3r = twiddles[p + n2].real, w3i = twiddles[p + n2].imag;
+        const float *ar = &xr[s * p], *ai = &xi[s * p];
+        const float *br = &xr[s * (p + n1)], *bi = &xi[s * (p + n1)];
+        const float *cr = &xr[s * (p + n2)], *ci = &xi[s * (p + n2)];
+        const float *dr = &xr[s * (p + n3)], *di = &xi[s * (p + n3)];
+        float *y0r = &yr[s * ((p << 2) + 0)], *y0i = &yi[s * ((p << 2) + 0)];
+        float *y1r = &yr[s * ((p << 2) + 1)], *y1i = &yi[s * ((p << 2) + 1)];
+        float *y2r = &yr[s * ((p << 2) + 2)], *y2i = &yi[s * ((p << 2) + 2)];
+        float *y3r = &yr[s * ((p << 2) + 3)], *y3i = &yi[s * ((p << 2) + 3)];
+        for (q = 0; q < s; q++) {
+            const float apcr = ar[q] + cr[q], apci = ai[q] + ci[q];
+            const float amcr = ar[q] - cr[q], amci = ai[q] - ci[q];
+            const float bpdr = br[q] + dr[q], bpdi = bi[q] + di[q];
+            /* j = -flag * i との乗算 */
+            const float jbmdr =  fflag * (bi[q] - di[q]);
+            const float jbmdi = -fflag * (br[q] - dr[q]);
+            const float t1r = amcr - jbmdr, t1i = amci - jbmdi;
+            const float t2r = apcr - bpdr, t2i = apci - bpdi;
+            const float t3r = amcr + jbmdr, t3i = amci + jbmdi;
+            y0r[q] = apcr + bpdr; y0i[q] = apci + bpdi;
+            y1r[q] = w1r * t1r - w1i * t1i; y1i[q] = w1r * t1i + w1i * t1r;
+            y2r[q] = w2r * t2r - w2i * t2i; y2i[q] = w2r * t2i + w2i * t2r;
+            y3r[q] = w3r * t3r - w3i * t3i; y3i[q] = w3r * t3i + w3i * t3r;
+        }
+    }
+}
+
+/* 分離形式の2基底Stockhamパス */
+static void AE2FFTPlan_SplitRadix2Pass(int32_t s, const float *xr, const float *xi, float *yr, float *yi)
+{
+    int32_t q;
+
+    for (q = 0; q < s; q++) {
+        const float ar = xr[q], ai = xi[q];
+        const float br = xr[q + s], bi = xi[q + s];
+        yr[q] = ar + br; yi[q] = ai + bi;
+        yr[q + s] = ar - br; yi[q + s] = ai - bi;
+    }
+}
+
+/* 分離形式の3, 5基底Stockhamパス */
+static void AE2FFTPlan_SplitOddRadixPass(int32_t radix, int32_t n1, int32_t s,
+        const AE2FFTComplex *twiddles, int flag, const float *xr, const float *xi, float *yr, float *yi)
+{
+    int32_t p, q, k;
+    const float fflag = (float)flag;
+    AE2FFTComplex in[5], out[5];
+
+    assert(radix <= 5);
+
+    for (p = 0; p < n1; p++) {
+        for (q = 0; q < s; q++) {
+            for (k = 0; k < radix; k++) {
+                in[k].real = xr[q + s * (p + n1 * k)];
+                in[k].imag = xi[q + s * (p + n1 * k)];
+            }
+            AE2FFT_ButterflyOddRadix(radix, in, out, fflag);
+            yr[q + s * (radix * p)] = out[0].real;
+            yi[q + s * (radix * p)] = out[0].imag;
+            for (k = 1; k < radix; k++) {
+                const AE2FFTComplex y = AE2FFTComplex_Mul(twiddles[(k - 1) * n1 + p], out[k]);
+                yr[q + s * (radix * p + k)] = y.real;
+                yi[q + s * (radix * p + k)] = y.imag;
+            }
+        }
+    }
+}
+
+/* 分離形式の複素FFT 正規化は行いません
+* plan FFTプラン
+* flag -1:FFT, 1:IFFT
+* xr, xi フーリエ変換する系列の実部と虚部(入出力 plan->complex_size点)
+* yr, yi 作業用配列(xr, xiと同一サイズ)
+*/
+static void AE2FFTPlan_SplitComplexFFT(const struct AE2FFTPlan *plan, const int flag,
+        float *xr, float *xi, float *yr, float *yi)
+{
+    int32_t stage;
+    float *tmp, *src = xr;
+    const AE2FFTComplex *twiddles = plan->stage_twiddles[AE2FFTPLAN_DIRECTION_INDEX(flag)];
+    int32_t n = plan->complex_size;
+    int32_t s = 1; /* ストライド */
+
+    /* 混合基底 Stockham FFT */
+    for (stage = 0; stage < plan->num_stages; stage++) {
+        const int32_t radix = plan->radices[stage];
+        const int32_t n1 = n / radix;
+        switch (radix) {
+        case 4:
+            AE2FFTPlan_SplitRadix4Pass(n1, s, twiddles, flag, xr, xi, yr, yi);
+            break;
+        case 2:
+            /* 2基底は必ず最終段（n1 == 1） */
+            assert(n1 == 1);
+            AE2FFTPlan_SplitRadix2Pass(s, xr, xi, yr, yi);
+            break;
+        default:
+            AE2FFTPlan_SplitOddRadixPass(radix, n1, s, twiddles, flag, xr, xi, yr, yi);
+            break;
+        }
+        twiddles += (radix - 1) * n1;
+        n = n1;
+        s *= radix;
+        tmp = xr; xr = yr; yr = tmp;
+        tmp = xi; xi = yi; yi = tmp;
+    }
+
+    if (src != xr) {
+        memcpy(yr, xr, sizeof(float) * (size_t)s);
+        memcpy(yi, xi, sizeof(float) * (size_t)s);
+    }
+}
+
+/* プランを使用した分離形式のFFT */
+void AE2FFTPlan_SplitFFT(struct AE2FFTPlan *plan, int flag, float *real, float *imag)
+{
+    float *scratch;
+
+    assert(plan != NULL);
+    assert((real != NULL) && (imag != NULL));
+    assert(plan->type == AE2FFTPLAN_TYPE_COMPLEX);
+    assert((flag == -1) || (flag == 1));
+
+    if (plan->in_place) {
+        AE2FFTPlan_InPlaceFFT(plan, flag, real, imag, 1);
+        return;
+    }
+
+    /* 作業領域を実部/虚部に分けて使う */
+    scratch = (float *)plan->scratch;
+    AE2FFTPlan_SplitComplexFFT(plan, flag, real, imag, &scratch[0], &scratch[plan->complex_size]);
+}
+
+/* インプレース変換による実数列の分離形式出力FFT 正規化は行いません
+* 偶数番目/奇数番目のサンプルを出力の実部/虚部に振り分けて変換し、出力領域の中でまとめる */
+static void AE2FFTPlan_InPlaceSplitRealFFT(const struct AE2FFTPlan *plan, const float *x, float *real, float *imag)
+{
+    int32_t i;
+    const int32_t n = plan->fft_size;
+    const int32_t half = n >> 1;
+    const float c2 = -0.5f;
+    const AE2FFTComplex *real_twiddles = plan->real_twiddles[AE2FFTPLAN_DIRECTION_INDEX(-1)];
+
+    for (i = 0; i < half; i++) {
+        real[i] = x[2 * i];
+        imag[i] = x[2 * i + 1];
+    }
+    AE2FFTPlan_InPlaceFFT(plan, -1, real, imag, 1);
+
+    /* スペクトルの対称性を使用して結果をまとめる（iとhalf - iの組を読んでから書き戻す） */
+    for (i = 1; i <= (n >> 2); i++) {
+        const float wr = real_twiddles[i - 1].real;
+        const float wi = real_twiddles[i - 1].imag;
+        const float h1r = 0.5f * (real[i] + real[half - i]);
+        const float h1i = 0.5f * (imag[i] - imag[half - i]);
+        const float h2r = -c2 * (imag[i] + imag[half - i]);
+        const float h2i =  c2 * (real[i] - real[half - i]);
+        real[i] =  h1r + (wr * h2r) - (wi * h2i);
+        imag[i] =  h1i + (wr * h2i) + (wi * h2r);
+        real[half - i] =  h1r - (wr * h2r) + (wi * h2i);
+        imag[half - i] = -h1i + (wr * h2i) + (wi * h2r);
+    }
+
+    /* 直流成分/最高周波数成分 */
+    {
+        const float h1r = real[0];
+        real[0] = h1r + imag[0];
+        imag[0] = h1r - imag[0];
+    }
+}
+
+/* プランを使用した実数列の分離形式出力FFT 正規化は行いません */
+void AE2FFTPlan_SplitRealFFT(struct AE2FFTPlan *plan, const float *x, float *real, float *imag)
+{
+    int32_t i, n;
+    float *buffer;
+    const float c2 = -0.5f;
+    const AE2FFTComplex *real_twiddles;
+
+    assert(plan != NULL);
+    assert((x != NULL) && (real != NULL) && (imag != NULL));
+    assert(plan->type == AE2FFTPLAN_TYPE_REAL);
+
+    n = plan->fft_size;
+    real_twiddles = plan->real_twiddles[AE2FFTPLAN_DIRECTION_INDEX(-1)];
+
+    if (plan->in_place) {
+        AE2FFTPlan_InPlaceSplitRealFFT(plan, x, real, imag);
+        return;
+    }
+
+    /* 入力を作業領域後半にコピーして半分の点数の複素FFT */
+    buffer = (float *)&plan->scratch[plan->complex_size];
+    memcpy(buffer, x, sizeof(float) * (size_t)n);
+    AE2FFTPlan_ComplexFFT(plan, -1, (AE2FFTComplex *)buffer, plan->scratch);
+
+    /* スペクトルの対称性を使用して結果をまとめ、実部と虚部に分けて書き出す */
+    for (i = 1; i <= (n >> 2); i++) {
+        const int32_t i1 = (i << 1);
+        const int32_t i2 = i1 + 1;
+        const int32_t i3 = n - i1;
+        const int32_t i4 = i3 + 1;
+        const float wr = real_twiddles[i - 1].real;
+        const float wi = real_twiddles[i - 1].imag;
+        const float h1r = 0.5f * (buffer[i1] + buffer[i3]);
+        const float h1i = 0.5f * (buffer[i2] - buffer[i4]);
+        const float h2r = -c2 * (buffer[i2] + buffer[i4]);
+        const float h2i =  c2 * (buffer[i1] - buffer[i3]);
+        real[i] =  h1r + (wr * h2r) - (wi * h2i);
+        imag[i] =  h1i + (wr * h2i) + (wi * h2r);
+        real[(n >> 1) - i] =  h1r - (wr * h2r) + (wi * h2i);
+        imag[(n >> 1) - i] = -h1i + (wr * h2i) + (wi * h2r);
+    }
+
+    /* 直流成分/最高周波数成分 */
+    real[0] = buffer[0] + buffer[1];
+    imag[0] = buffer[0] - buffer[1];
+}
+
+/* プランを使用した分離形式入力の実数列IFFT 正規化は行いません 正規化定数は2/n */
+void AE2FFTPlan_SplitRealIFFT(struct AE2FFTPlan *plan, const float *real, const float *imag, float *x)
+{
+    int32_t i, n;
+    const float c2 = 0.5f;
+    const AE2FFTComplex *real_twiddles;
+
+    assert(plan != NULL);
+    assert((x != NULL) && (real != NULL) && (imag != NULL));
+    assert(plan->type == AE2FFTPLAN_TYPE_REAL);
+
+    n = plan->fft_size;
+    real_twiddles = plan->real_twiddles[AE2FFTPLAN_DIRECTION_INDEX(1)];
+
+    /* スペクトルの対称性を使用し、半分の点数の複素IFFTの入力に整理 */
+    for (i = 1; i <= (n >> 2); i++) {
+        const int32_t i1 = (i << 1);
+        const int32_t i2 = i1 + 1;
+        const int32_t i3 = n - i1;
+        const int32_t i4 = i3 + 1;
+        const float wr = real_twiddles[i - 1].real;
+        const float wi = real_twiddles[i - 1].imag;
+        const float h1r = 0.5f * (real[i] + real[(n >> 1) - i]);
+        const float h1i = 0.5f * (imag[i] - imag[(n >> 1) - i]);
+        const float h2r = -c2 * (imag[i] + imag[(n >> 1) - i]);
+        const float h2i =  c2 * (real[i] - real[(n >> 1) - i]);
+        x[i1] =  h1r + (wr * h2r) - (wi * h2i);
+        x[i2] =  h1i + (wr * h2i) + (wi * h2r);
+        x[i3] =  h1r - (wr * h2r) + (wi * h2i);
+        x[i4] = -h1i + (wr * h2i) + (wi * h2r);
+    }
+
+    /* 直流成分/最高周波数成分 */
+    x[0] = 0.5f * (real[0] + imag[0]);
+    x[1] = 0.5f * (real[0] - imag[0]);
+
+    AE2FFTPlan_ExecuteComplexFFT(plan, 1, x);
+}
+
+/* 分離形式スペクトルの複素乗算 */
+void AE2FFT_SplitSpectrumMul(int32_t num_bins,
+        const float *a_real, const float *a_imag, const float *b_real, const float *b_imag,
+        float *y_real, float *y_imag)
+{
+    int32_t i;
+
+    assert((a_real != NULL) && (a_imag != NULL));
+    assert((b_real != NULL) && (b_imag != NULL));
+    assert((y_real != NULL) && (y_imag != NULL));
+
+    for (i = 0; i < num_bins; i++) {
+        const float ar = a_real[i], ai = a_imag[i];
+        const float br = b_real[i], bi = b_imag[i];
+        y_real[i] = ar * br - ai * bi;
+        y_imag[i] = ar * bi + ai * br;
+    }
+}
+
+/* 分離形式スペクトルの複素乗算結果の加算 */
+void AE2FFT_SplitSpectrumMulAdd(int32_t num_bins,
+        const float *a_real, const float *a_imag, const float *b_real, const float *b_imag,
+        float *y_real, float *y_imag)
+{
+    int32_t i;
+
+    assert((a_real != NULL) && (a_imag != NULL));
+    assert((b_real != NULL) && (b_imag != NULL));
+    assert((y_real != NULL) && (y_imag != NULL));
+
+    for (i = 0; i < num_bins; i++) {
+        const float ar = a_real[i], ai = a_imag[i];
+        const float br = b_real[i], bi = b_imag[i];
+        y_real[i] += ar * br - ai * bi;
+        y_imag[i] += ar * bi + ai * br;
+    }
+}
+
+/* 実数列の分離形式スペクトルの複素乗算 */
+void AE2FFT_SplitRealSpectrumMul(int32_t num_bins,
+        const float *a_real, const float *a_imag, const float *b_real, const float *b_imag,
+        float *y_real, float *y_imag)
+{
+    float dc, nyquist;
+
+    assert(num_bins > 0);
+    assert((a_real != NULL) && (a_imag != NULL));
+    assert((b_real != NULL) && (b_imag != NULL));
+    assert((y_real != NULL) && (y_imag != NULL));
+
+    /* 先頭は直流成分と最高周波数成分の実部 */
+    dc = a_real[0] * b_real[0];
+    nyquist = a_imag[0] * b_imag[0];
+
+    AE2FFT_SplitSpectrumMul(num_bins - 1,
+            &a_real[1], &a_imag[1], &b_real[1], &b_imag[1], &y_real[1], &y_imag[1]);
+
+    y_real[0] = dc;
+    y_imag[0] = nyquist;
+}
+
+/* プランを使用した実数列の分離形式スペクトルの複素乗算結果の一括加算 */
+void AE2FFTPlan_SplitRealSpectrumMulAddMultiple(const struct AE2FFTPlan *plan,
+        int32_t num_spectra, const float *const *a, const float *const *b, float *y)
+{
+    int32_t k;
+    float dc, nyquist;
+    int32_t num_bins;
+
+    assert(plan != NULL);
+    assert(plan->type == AE2FFTPLAN_TYPE_REAL);
+    assert((a != NULL) && (b != NULL) && (y != NULL));
+
+    num_bins = plan->fft_size / 2;
+
+    /* 先頭は直流成分と最高周波数成分の実部 */
+    dc = y[0];
+    nyquist = y[num_bins];
+    for (k = 0; k < num_spectra; k++) {
+        dc += a[k][0] * b[k][0];
+        nyquist += a[k][num_bins] * b[k][num_bins];
+    }
+
+    /* 先頭も含めて複素数として一括処理した後、先頭を上書き */
+    plan->kernel->SpectrumMulAdd(num_bins, num_spectra, a, b, &y[0], &y[num_bins]);
+
+    y[0] = dc;
+    y[num_bins] = nyquist;
+}
+
+/* 実数列の分離形式スペクトルの複素乗算結果の加算 */
+void AE2FFT_SplitRealSpectrumMulAdd(int32_t num_bins,
+        const float *a_real, const float *a_imag, const float *b_real, const float *b_imag,
+        float *y_real, float *y_imag)
+{
+    float dc, nyquist;
+
+    assert(num_bins > 0);
+    assert((a_real != NULL) && (a_imag != NULL));
+    assert((b_real != NULL) && (b_imag != NULL));
+    assert((y_real != NULL) && (y_imag != NULL));
+
+    /* 先頭は直流成分と最高周波数成分の実部 */
+    dc = a_real[0] * b_real[0];
+    nyquist = a_imag[0] * b_imag[0];
+
+    AE2FFT_SplitSpectrumMulAdd(num_bins - 1,
+            &a_real[1], &a_imag[1], &b_real[1], &b_imag[1], &y_real[1], &y_imag[1]);
+
+    y_real[0] += dc;
+    y_imag[0] += nyquist;
+}
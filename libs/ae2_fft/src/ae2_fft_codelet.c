@@ -0,0 +1,230 @@
+#include "ae2_fft_kernel.h"
+
+#include <stddef.h>
+
+/* sqrt(1/2) */
+#define AE2FFTCODELET_SQRT1_2 0.70710678118654752440f
+/* cos(π/8) */
+#define AE2FFTCODELET_COS_PI_8 0.92387953251128675613f
+/* sin(π/8) */
+#define AE2FFTCODELET_SIN_PI_8 0.38268343236508977173f
+
+/* 複素数の加算 */
+static AE2FFT_INLINE AE2FFTComplex AE2FFTCodelet_Add(AE2FFTComplex a, AE2FFTComplex b)
+{
+    AE2FFTComplex ret;
+    ret.real = a.real + b.real;
+    ret.imag = a.imag + b.imag;
+    return ret;
+}
+
+/* 複素数の減算 */
+static AE2FFT_INLINE AE2FFTComplex AE2FFTCodelet_Sub(AE2FFTComplex a, AE2FFTComplex b)
+{
+    AE2FFTComplex ret;
+    ret.real = a.real - b.real;
+    ret.imag = a.imag - b.imag;
+    return ret;
+}
+
+/* 複素数の乗算 */
+static AE2FFT_INLINE AE2FFTComplex AE2FFTCodelet_Mul(AE2FFTComplex a, AE2FFTComplex b)
+{
+    AE2FFTComplex ret;
+    ret.real = a.real * b.real - a.imag * b.imag;
+    ret.imag = a.real * b.imag + a.imag * b.real;
+    return ret;
+}
+
+/* 定数 (wr, fflag * wi) との乗算 */
+static AE2FFT_INLINE AE2FFTComplex AE2FFTCodelet_MulConst(AE2FFTComplex a, float wr, float wi, float fflag)
+{
+    AE2FFTComplex ret;
+    const float fwi = fflag * wi;
+    ret.real = a.real * wr - a.imag * fwi;
+    ret.imag = a.real * fwi + a.imag * wr;
+    return ret;
+}
+
+/* j = -flag * i との乗算 */
+static AE2FFT_INLINE AE2FFTComplex AE2FFTCodelet_MulJ(AE2FFTComplex a, float fflag)
+{
+    AE2FFTComplex ret;
+    ret.real =  fflag * a.imag;
+    ret.imag = -fflag * a.real;
+    return ret;
+}
+
+/* 4点DFT（入出力はレジスタ上の値） */
+static AE2FFT_INLINE void AE2FFTCodelet_DFT4(
+        AE2FFTComplex a, AE2FFTComplex b, AE2FFTComplex c, AE2FFTComplex d, float fflag,
+        AE2FFTComplex *y0, AE2FFTComplex *y1, AE2FFTComplex *y2, AE2FFTComplex *y3)
+{
+    const AE2FFTComplex apc = AE2FFTCodelet_Add(a, c);
+    const AE2FFTComplex amc = AE2FFTCodelet_Sub(a, c);
+    const AE2FFTComplex bpd = AE2FFTCodelet_Add(b, d);
+    const AE2FFTComplex jbmd = AE2FFTCodelet_MulJ(AE2FFTCodelet_Sub(b, d), fflag);
+    (*y0) = AE2FFTCodelet_Add(apc, bpd);
+    (*y1) = AE2FFTCodelet_Sub(amc, jbmd);
+    (*y2) = AE2FFTCodelet_Sub(apc, bpd);
+    (*y3) = AE2FFTCodelet_Add(amc, jbmd);
+}
+
+/* 8点DFT（全展開）
+* 入力を全てレジスタに読み込んでから出力するため、xとyは同一でもよい
+* x 入力系列 istride 入力の間隔
+* y 出力系列 ostride 出力の間隔
+*/
+static AE2FFT_INLINE void AE2FFTCodelet_DFT8(
+        const AE2FFTComplex *x, int32_t istride, AE2FFTComplex *y, int32_t ostride, float fflag)
+{
+    AE2FFTComplex e0, e1, e2, e3, o0, o1, o2, o3;
+
+    /* 偶数番目・奇数番目の4点DFT */
+    AE2FFTCodelet_DFT4(x[0 * istride], x[2 * istride], x[4 * istride], x[6 * istride], fflag, &e0, &e1, &e2, &e3);
+    AE2FFTCodelet_DFT4(x[1 * istride], x[3 * istride], x[5 * istride], x[7 * istride], fflag, &o0, &o1, &o2, &o3);
+
+    /* 回転因子 w8^k = exp(flag * 2πik/8) の乗算 */
+    o1 = AE2FFTCodelet_MulConst(o1, AE2FFTCODELET_SQRT1_2, AE2FFTCODELET_SQRT1_2, fflag);
+    o2 = AE2FFTCodelet_MulJ(o2, -fflag);
+    o3 = AE2FFTCodelet_MulConst(o3, -AE2FFTCODELET_SQRT1_2, AE2FFTCODELET_SQRT1_2, fflag);
+
+    y[0 * ostride] = AE2FFTCodelet_Add(e0, o0);
+    y[1 * ostride] = AE2FFTCodelet_Add(e1, o1);
+    y[2 * ostride] = AE2FFTCodelet_Add(e2, o2);
+    y[3 * ostride] = AE2FFTCodelet_Add(e3, o3);
+    y[4 * ostride] = AE2FFTCodelet_Sub(e0, o0);
+    y[5 * ostride] = AE2FFTCodelet_Sub(e1, o1);
+    y[6 * ostride] = AE2FFTCodelet_Sub(e2, o2);
+    y[7 * ostride] = AE2FFTCodelet_Sub(e3, o3);
+}
+
+/* 16点DFT（全展開）
+* 4基底の時間間引きで、4点DFTを2段重ねる
+* 入力を全てレジスタに読み込んでから出力するため、xとyは同一でもよい
+*/
+static AE2FFT_INLINE void AE2FFTCodelet_DFT16(
+        const AE2FFTComplex *x, int32_t istride, AE2FFTComplex *y, int32_t ostride, float fflag)
+{
+    const float cs1 = AE2FFTCODELET_COS_PI_8, sn1 = AE2FFTCODELET_SIN_PI_8, cs2 = AE2FFTCODELET_SQRT1_2;
+    AE2FFTComplex a0, a1, a2, a3, b0, b1, b2, b3, c0, c1, c2, c3, d0, d1, d2, d3;
+
+    /* 4つ飛ばしの4点DFT */
+    AE2FFTCodelet_DFT4(x[0 * istride], x[4 * istride], x[ 8 * istride], x[12 * istride], fflag, &a0, &a1, &a2, &a3);
+    AE2FFTCodelet_DFT4(x[1 * istride], x[5 * istride], x[ 9 * istride], x[13 * istride], fflag, &b0, &b1, &b2, &b3);
+    AE2FFTCodelet_DFT4(x[2 * istride], x[6 * istride], x[10 * istride], x[14 * istride], fflag, &c0, &c1, &c2, &c3);
+    AE2FFTCodelet_DFT4(x[3 * istride], x[7 * istride], x[11 * istride], x[15 * istride], fflag, &d0, &d1, &d2, &d3);
+
+    /* 回転因子 w16^(qk) = exp(flag * 2πiqk/16) の乗算 */
+    b1 = AE2FFTCodelet_MulConst(b1, cs1, sn1, fflag);
+    b2 = AE2FFTCodelet_MulConst(b2, cs2, cs2, fflag);
+    b3 = AE2FFTCodelet_MulConst(b3, sn1, cs1, fflag);
+    c1 = AE2FFTCodelet_MulConst(c1, cs2, cs2, fflag);
+    c2 = AE2FFTCodelet_MulJ(c2, -fflag);
+    c3 = AE2FFTCodelet_MulConst(c3, -cs2, cs2, fflag);
+    d1 = AE2FFTCodelet_MulConst(d1, sn1, cs1, fflag);
+    d2 = AE2FFTCodelet_MulConst(d2, -cs2, cs2, fflag);
+    d3 = AE2FFTCodelet_MulConst(d3, -cs1, -sn1, fflag);
+
+    /* 2段目の4点DFT */
+    AE2FFTCodelet_DFT4(a0, b0, c0, d0, fflag, &y[0 * ostride], &y[4 * ostride], &y[ 8 * ostride], &y[12 * ostride]);
+    AE2FFTCodelet_DFT4(a1, b1, c1, d1, fflag, &y[1 * ostride], &y[5 * ostride], &y[ 9 * ostride], &y[13 * ostride]);
+    AE2FFTCodelet_DFT4(a2, b2, c2, d2, fflag, &y[2 * ostride], &y[6 * ostride], &y[10 * ostride], &y[14 * ostride]);
+    AE2FFTCodelet_DFT4(a3, b3, c3, d3, fflag, &y[3 * ostride], &y[7 * ostride], &y[11 * ostride], &y[15 * ostride]);
+}
+
+/* 4基底の周波数間引き1段（ループ長は定数で呼び出し、展開はコンパイラに任せる）
+* n1 系列長/4
+* twiddles 段の回転因子テーブル（w^p, w^2p, w^3pがn1個ずつ並ぶ）
+* x 入力系列 t 出力系列（xと重複不可）
+* tのr番目のブロック（n1点）のDFTが、出力の4k+r番目に対応する
+*/
+static AE2FFT_INLINE void AE2FFTCodelet_Radix4Step(
+        int32_t n1, const AE2FFTComplex *twiddles, float fflag, const AE2FFTComplex *x, AE2FFTComplex *t)
+{
+    int32_t p;
+    const AE2FFTComplex *w1 = &twiddles[0];
+    const AE2FFTComplex *w2 = &twiddles[n1];
+    const AE2FFTComplex *w3 = &twiddles[2 * n1];
+
+    for (p = 0; p < n1; p++) {
+        AE2FFTComplex y0, y1, y2, y3;
+        AE2FFTCodelet_DFT4(x[p], x[p + n1], x[p + 2 * n1], x[p + 3 * n1], fflag, &y0, &y1, &y2, &y3);
+        t[p] = y0;
+        t[p + 1 * n1] = AE2FFTCodelet_Mul(y1, w1[p]);
+        t[p + 2 * n1] = AE2FFTCodelet_Mul(y2, w2[p]);
+        t[p + 3 * n1] = AE2FFTCodelet_Mul(y3, w3[p]);
+    }
+}
+
+/* 32点DFT 入力は連続, 出力はostride間隔 xとyは同一でもよい */
+static AE2FFT_INLINE void AE2FFTCodelet_DFT32(
+        const AE2FFTComplex *twiddles, float fflag, const AE2FFTComplex *x, AE2FFTComplex *y, int32_t ostride)
+{
+    AE2FFTComplex t[32];
+    AE2FFTCodelet_Radix4Step(8, twiddles, fflag, x, t);
+    AE2FFTCodelet_DFT8(&t[ 0], 1, &y[0 * ostride], 4 * ostride, fflag);
+    AE2FFTCodelet_DFT8(&t[ 8], 1, &y[1 * ostride], 4 * ostride, fflag);
+    AE2FFTCodelet_DFT8(&t[16], 1, &y[2 * ostride], 4 * ostride, fflag);
+    AE2FFTCodelet_DFT8(&t[24], 1, &y[3 * ostride], 4 * ostride, fflag);
+}
+
+/* 8点FFTコードレット */
+static void AE2FFTCodelet_8(const AE2FFTComplex *twiddles, int flag, AE2FFTComplex *x)
+{
+    (void)twiddles;
+    AE2FFTCodelet_DFT8(x, 1, x, 1, (float)flag);
+}
+
+/* 16点FFTコードレット */
+static void AE2FFTCodelet_16(const AE2FFTComplex *twiddles, int flag, AE2FFTComplex *x)
+{
+    (void)twiddles;
+    AE2FFTCodelet_DFT16(x, 1, x, 1, (float)flag);
+}
+
+/* 32点FFTコードレット 32 = 4 * 8 */
+static void AE2FFTCodelet_32(const AE2FFTComplex *twiddles, int flag, AE2FFTComplex *x)
+{
+    AE2FFTCodelet_DFT32(twiddles, (float)flag, x, x, 1);
+}
+
+/* 64点FFTコードレット 64 = 4 * 16 */
+static void AE2FFTCodelet_64(const AE2FFTComplex *twiddles, int flag, AE2FFTComplex *x)
+{
+    const float fflag = (float)flag;
+    AE2FFTComplex t[64];
+    AE2FFTCodelet_Radix4Step(16, twiddles, fflag, x, t);
+    AE2FFTCodelet_DFT16(&t[ 0], 1, &x[0], 4, fflag);
+    AE2FFTCodelet_DFT16(&t[16], 1, &x[1], 4, fflag);
+    AE2FFTCodelet_DFT16(&t[32], 1, &x[2], 4, fflag);
+    AE2FFTCodelet_DFT16(&t[48], 1, &x[3], 4, fflag);
+}
+
+/* 128点FFTコードレット 128 = 4 * 32 */
+static void AE2FFTCodelet_128(const AE2FFTComplex *twiddles, int flag, AE2FFTComplex *x)
+{
+    const float fflag = (float)flag;
+    const AE2FFTComplex *twiddles32 = &twiddles[3 * 32]; /* 2段目（32点）の回転因子 */
+    AE2FFTComplex t[128];
+    AE2FFTCodelet_Radix4Step(32, twiddles, fflag, x, t);
+    AE2FFTCodelet_DFT32(twiddles32, fflag, &t[ 0], &x[0], 4);
+    AE2FFTCodelet_DFT32(twiddles32, fflag, &t[32], &x[1], 4);
+    AE2FFTCodelet_DFT32(twiddles32, fflag, &t[64], &x[2], 4);
+    AE2FFTCodelet_DFT32(twiddles32, fflag, &t[96], &x[3], 4);
+}
+
+/* 点数に対応するコードレットの取得 */
+AE2FFTCodeletFunction AE2FFTCodelet_Get(int32_t n)
+{
+    switch (n) {
+    case 8:     return AE2FFTCodelet_8;
+    case 16:    return AE2FFTCodelet_16;
+    case 32:    return AE2FFTCodelet_32;
+    case 64:    return AE2FFTCodelet_64;
+    case 128:   return AE2FFTCodelet_128;
+    default:    break;
+    }
+
+    return NULL;
+}
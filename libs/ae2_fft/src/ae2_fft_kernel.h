@@ -0,0 +1,103 @@
+/*!
+* @file ae2_fft_kernel.h
+* @brief FFTバタフライ演算カーネル（ライブラリ内部用）
+*/
+#ifndef AE2FFTKERNEL_H_INCLUDED
+#define AE2FFTKERNEL_H_INCLUDED
+
+#include <stdint.h>
+
+/* インラインキーワードを定義 */
+#if defined(_MSC_VER)
+#define AE2FFT_INLINE inline
+#elif defined(__GNUC__)
+#define AE2FFT_INLINE __inline__
+#else
+#define AE2FFT_INLINE
+#endif
+
+/* x86/x64向けのSIMDカーネルを使用するか */
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define AE2FFT_USE_X86_SIMD
+#endif
+
+/* 複素数型 */
+typedef struct AE2FFTComplex {
+    float real; /* 実部 */
+    float imag; /* 虚部 */
+} AE2FFTComplex;
+
+/* 4基底Stockhamパス
+* n1 現在の系列長/4
+* s ストライド
+* twiddles 段の回転因子テーブル（w^p, w^2p, w^3pがn1個ずつ並ぶ）
+* flag -1:FFT, 1:IFFT
+* x 入力系列
+* y 出力系列
+*/
+typedef void (*AE2FFTRadix4PassFunction)(
+        int32_t n1, int32_t s, const AE2FFTComplex *twiddles, int flag, const AE2FFTComplex *x, AE2FFTComplex *y);
+
+/* 2基底Stockhamパス（最終段）
+* s ストライド
+* x 入力系列
+* y 出力系列
+*/
+typedef void (*AE2FFTRadix2PassFunction)(int32_t s, const AE2FFTComplex *x, AE2FFTComplex *y);
+
+/* 分離形式スペクトルの複素乗算結果の一括加算 y += sum_k a[k] * b[k]
+* num_bins 周波数ビン数
+* num_spectra 乗算するスペクトルの組数
+* a, b 乗算するスペクトルの配列（各スペクトルは実部num_bins個、虚部num_bins個の順に並ぶ）
+* y_real, y_imag 加算先の実部と虚部
+*/
+typedef void (*AE2FFTSpectrumMulAddFunction)(int32_t num_bins, int32_t num_spectra,
+        const float *const *a, const float *const *b, float *y_real, float *y_imag);
+
+/* 小点数FFTコードレット（全展開した固定点数のFFT）
+* twiddles プランの段毎の回転因子テーブル（4基底を先に並べた分解のもの）
+* flag -1:FFT, 1:IFFT
+* x フーリエ変換する系列(入出力)
+*/
+typedef void (*AE2FFTCodeletFunction)(const AE2FFTComplex *twiddles, int flag, AE2FFTComplex *x);
+
+/* FFTカーネル */
+struct AE2FFTKernel {
+    const char *name; /* カーネル名 */
+    AE2FFTRadix4PassFunction Radix4Pass; /* 4基底パス */
+    AE2FFTRadix2PassFunction Radix2Pass; /* 2基底パス */
+    AE2FFTSpectrumMulAddFunction SpectrumMulAdd; /* スペクトルの一括乗算加算 */
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* スカラー実装の4基底パス SIMDカーネルの端数処理でも使用 */
+void AE2FFT_Radix4PassScalar(
+        int32_t n1, int32_t s, const AE2FFTComplex *twiddles, int flag, const AE2FFTComplex *x, AE2FFTComplex *y);
+
+/* スカラー実装の2基底パス SIMDカーネルの端数処理でも使用 */
+void AE2FFT_Radix2PassScalar(int32_t s, const AE2FFTComplex *x, AE2FFTComplex *y);
+
+/* スカラー実装のスペクトルの一括乗算加算 SIMDカーネルの端数処理でも使用 */
+void AE2FFT_SpectrumMulAddScalar(int32_t num_bins, int32_t num_spectra,
+        const float *const *a, const float *const *b, float *y_real, float *y_imag);
+
+/* スカラーカーネルの取得 */
+const struct AE2FFTKernel *AE2FFTKernel_GetScalar(void);
+
+/* SSE2カーネルの取得 ビルド対象外の環境ではNULLを返す */
+const struct AE2FFTKernel *AE2FFTKernel_GetSSE2(void);
+
+/* AVX2/FMAカーネルの取得 ビルド対象外の環境ではNULLを返す */
+const struct AE2FFTKernel *AE2FFTKernel_GetAVX2(void);
+
+/* 点数に対応するコードレットの取得 対応するものがない場合はNULLを返す */
+AE2FFTCodeletFunction AE2FFTCodelet_Get(int32_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AE2FFTKERNEL_H_INCLUDED */
@@ -0,0 +1,186 @@
+#include "ae2_fft_kernel.h"
+
+#include <stddef.h>
+
+/* AVX2/FMAを有効にしてコンパイルされた場合のみカーネルを提供 */
+#if defined(AE2FFT_USE_X86_SIMD) && defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+#include <immintrin.h>
+
+/* 4要素の複素数を読み込み */
+#define AE2FFTAVX2_LOAD(ptr) _mm256_loadu_ps((const float *)(ptr))
+/* 4要素の複素数を書き込み */
+#define AE2FFTAVX2_STORE(ptr, v) _mm256_storeu_ps((float *)(ptr), (v))
+/* 実部と虚部の入れ替え */
+#define AE2FFTAVX2_SWAP(v) _mm256_permute_ps((v), 0xB1)
+
+/* 1要素の複素数を4要素に複製して読み込み */
+static AE2FFT_INLINE __m256 AE2FFTAVX2_Broadcast(const AE2FFTComplex *ptr)
+{
+    return _mm256_castpd_ps(_mm256_broadcast_sd((const double *)ptr));
+}
+
+/* 複素数の乗算 */
+static AE2FFT_INLINE __m256 AE2FFTAVX2_Mul(__m256 z, __m256 w)
+{
+    const __m256 wre = _mm256_moveldup_ps(w);
+    const __m256 wim = _mm256_movehdup_ps(w);
+    return _mm256_fmaddsub_ps(z, wre, _mm256_mul_ps(AE2FFTAVX2_SWAP(z), wim));
+}
+
+/* 4点バタフライ
+* jsign は j = -flag * i の乗算に使う符号 (flag, -flag, ...) */
+static AE2FFT_INLINE void AE2FFTAVX2_Butterfly(
+        __m256 a, __m256 b, __m256 c, __m256 d, __m256 jsign,
+        __m256 *y0, __m256 *y1, __m256 *y2, __m256 *y3)
+{
+    const __m256 apc = _mm256_add_ps(a, c);
+    const __m256 amc = _mm256_sub_ps(a, c);
+    const __m256 bpd = _mm256_add_ps(b, d);
+    const __m256 bmd = _mm256_sub_ps(b, d);
+    const __m256 jbmd = _mm256_mul_ps(AE2FFTAVX2_SWAP(bmd), jsign);
+    (*y0) = _mm256_add_ps(apc, bpd);
+    (*y1) = _mm256_sub_ps(amc, jbmd);
+    (*y2) = _mm256_sub_ps(apc, bpd);
+    (*y3) = _mm256_add_ps(amc, jbmd);
+}
+
+/* AVX2実装の4基底パス */
+static void AE2FFT_Radix4PassAVX2(
+        int32_t n1, int32_t s, const AE2FFTComplex *twiddles, int flag, const AE2FFTComplex *x, AE2FFTComplex *y)
+{
+    int32_t p, q;
+    const int32_t n2 = (n1 << 1);
+    const int32_t n3 = n1 + n2;
+    const float fflag = (float)flag;
+    const __m256 jsign = _mm256_setr_ps(fflag, -fflag, fflag, -fflag, fflag, -fflag, fflag, -fflag);
+    const AE2FFTComplex *w1 = &twiddles[0];
+    const AE2FFTComplex *w2 = &twiddles[n1];
+    const AE2FFTComplex *w3 = &twiddles[n2];
+
+    if ((s % 4) == 0) {
+        /* ストライド方向にベクトル化 */
+        for (p = 0; p < n1; p++) {
+            const __m256 w1p = AE2FFTAVX2_Broadcast(&w1[p]);
+            const __m256 w2p = AE2FFTAVX2_Broadcast(&w2[p]);
+            const __m256 w3p = AE2FFTAVX2_Broadcast(&w3[p]);
+            const AE2FFTComplex *xp = &x[s * p];
+            AE2FFTComplex *yp = &y[s * (p << 2)];
+            for (q = 0; q < s; q += 4) {
+                __m256 y0, y1, y2, y3;
+                AE2FFTAVX2_Butterfly(
+                        AE2FFTAVX2_LOAD(&xp[q + s * 0]), AE2FFTAVX2_LOAD(&xp[q + s * n1]),
+                        AE2FFTAVX2_LOAD(&xp[q + s * n2]), AE2FFTAVX2_LOAD(&xp[q + s * n3]),
+                        jsign, &y0, &y1, &y2, &y3);
+                AE2FFTAVX2_STORE(&yp[q + s * 0], y0);
+                AE2FFTAVX2_STORE(&yp[q + s * 1], AE2FFTAVX2_Mul(y1, w1p));
+                AE2FFTAVX2_STORE(&yp[q + s * 2], AE2FFTAVX2_Mul(y2, w2p));
+                AE2FFTAVX2_STORE(&yp[q + s * 3], AE2FFTAVX2_Mul(y3, w3p));
+            }
+        }
+    } else if ((s == 1) && ((n1 % 4) == 0)) {
+        /* 初段（s == 1）は系列方向にベクトル化し、出力を4x4転置して書き込む */
+        for (p = 0; p < n1; p += 4) {
+            __m256 y0, y1, y2, y3;
+            __m256d t0, t1, t2, t3;
+            AE2FFTAVX2_Butterfly(
+                    AE2FFTAVX2_LOAD(&x[p]), AE2FFTAVX2_LOAD(&x[p + n1]),
+                    AE2FFTAVX2_LOAD(&x[p + n2]), AE2FFTAVX2_LOAD(&x[p + n3]),
+                    jsign, &y0, &y1, &y2, &y3);
+            y1 = AE2FFTAVX2_Mul(y1, AE2FFTAVX2_LOAD(&w1[p]));
+            y2 = AE2FFTAVX2_Mul(y2, AE2FFTAVX2_LOAD(&w2[p]));
+            y3 = AE2FFTAVX2_Mul(y3, AE2FFTAVX2_LOAD(&w3[p]));
+            /* 複素数1要素を64bit要素とみなして転置 */
+            t0 = _mm256_unpacklo_pd(_mm256_castps_pd(y0), _mm256_castps_pd(y1));
+            t1 = _mm256_unpackhi_pd(_mm256_castps_pd(y0), _mm256_castps_pd(y1));
+            t2 = _mm256_unpacklo_pd(_mm256_castps_pd(y2), _mm256_castps_pd(y3));
+            t3 = _mm256_unpackhi_pd(_mm256_castps_pd(y2), _mm256_castps_pd(y3));
+            AE2FFTAVX2_STORE(&y[(p << 2) +  0], _mm256_castpd_ps(_mm256_permute2f128_pd(t0, t2, 0x20)));
+            AE2FFTAVX2_STORE(&y[(p << 2) +  4], _mm256_castpd_ps(_mm256_permute2f128_pd(t1, t3, 0x20)));
+            AE2FFTAVX2_STORE(&y[(p << 2) +  8], _mm256_castpd_ps(_mm256_permute2f128_pd(t0, t2, 0x31)));
+            AE2FFTAVX2_STORE(&y[(p << 2) + 12], _mm256_castpd_ps(_mm256_permute2f128_pd(t1, t3, 0x31)));
+        }
+    } else {
+        AE2FFT_Radix4PassScalar(n1, s, twiddles, flag, x, y);
+    }
+}
+
+/* AVX2実装の2基底パス */
+static void AE2FFT_Radix2PassAVX2(int32_t s, const AE2FFTComplex *x, AE2FFTComplex *y)
+{
+    int32_t q;
+
+    if ((s % 4) != 0) {
+        AE2FFT_Radix2PassScalar(s, x, y);
+        return;
+    }
+
+    for (q = 0; q < s; q += 4) {
+        const __m256 a = AE2FFTAVX2_LOAD(&x[q + 0]);
+        const __m256 b = AE2FFTAVX2_LOAD(&x[q + s]);
+        AE2FFTAVX2_STORE(&y[q + 0], _mm256_add_ps(a, b));
+        AE2FFTAVX2_STORE(&y[q + s], _mm256_sub_ps(a, b));
+    }
+}
+
+/* AVX2/FMA実装のスペクトルの一括乗算加算
+* 8ビンずつ、全ての組の積をレジスタ上で累積してから書き出す */
+static void AE2FFT_SpectrumMulAddAVX2(int32_t num_bins, int32_t num_spectra,
+        const float *const *a, const float *const *b, float *y_real, float *y_imag)
+{
+    int32_t i, k;
+
+    for (i = 0; i + 8 <= num_bins; i += 8) {
+        __m256 yr = _mm256_loadu_ps(&y_real[i]);
+        __m256 yi = _mm256_loadu_ps(&y_imag[i]);
+        for (k = 0; k < num_spectra; k++) {
+            const __m256 ar = _mm256_loadu_ps(&a[k][i]);
+            const __m256 ai = _mm256_loadu_ps(&a[k][num_bins + i]);
+            const __m256 br = _mm256_loadu_ps(&b[k][i]);
+            const __m256 bi = _mm256_loadu_ps(&b[k][num_bins + i]);
+            yr = _mm256_fmadd_ps(ar, br, yr);
+            yr = _mm256_fnmadd_ps(ai, bi, yr);
+            yi = _mm256_fmadd_ps(ar, bi, yi);
+            yi = _mm256_fmadd_ps(ai, br, yi);
+        }
+        _mm256_storeu_ps(&y_real[i], yr);
+        _mm256_storeu_ps(&y_imag[i], yi);
+    }
+
+    /* 端数 */
+    for (; i < num_bins; i++) {
+        float yr = y_real[i], yi = y_imag[i];
+        for (k = 0; k < num_spectra; k++) {
+            const float ar = a[k][i], ai = a[k][num_bins + i];
+            const float br = b[k][i], bi = b[k][num_bins + i];
+            yr += ar * br - ai * bi;
+            yi += ar * bi + ai * br;
+        }
+        y_real[i] = yr;
+        y_imag[i] = yi;
+    }
+}
+
+/* AVX2カーネル */
+static const struct AE2FFTKernel st_avx2_kernel = {
+    "avx2",
+    AE2FFT_Radix4PassAVX2,
+    AE2FFT_Radix2PassAVX2,
+    AE2FFT_SpectrumMulAddAVX2,
+};
+
+/* AVX2カーネルの取得 */
+const struct AE2FFTKernel *AE2FFTKernel_GetAVX2(void)
+{
+    return &st_avx2_kernel;
+}
+
+#else
+
+/* AVX2カーネルの取得 */
+const struct AE2FFTKernel *AE2FFTKernel_GetAVX2(void)
+{
+    return NULL;
+}
+
+#endif /* AE2FFT_USE_X86_SIMD && __AVX2__ */
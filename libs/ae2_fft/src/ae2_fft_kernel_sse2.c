@@ -0,0 +1,180 @@
+#include "ae2_fft_kernel.h"
+
+#include <stddef.h>
+
+/* SSE2を有効にしてコンパイルされた場合のみカーネルを提供 */
+#if defined(AE2FFT_USE_X86_SIMD) \
+    && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+
+#include <emmintrin.h>
+
+/* 2要素の複素数を読み込み */
+#define AE2FFTSSE2_LOAD(ptr) _mm_loadu_ps((const float *)(ptr))
+/* 2要素の複素数を書き込み */
+#define AE2FFTSSE2_STORE(ptr, v) _mm_storeu_ps((float *)(ptr), (v))
+/* 実部と虚部の入れ替え */
+#define AE2FFTSSE2_SWAP(v) _mm_shuffle_ps((v), (v), _MM_SHUFFLE(2, 3, 0, 1))
+
+/* 1要素の複素数を2要素に複製して読み込み */
+static AE2FFT_INLINE __m128 AE2FFTSSE2_Broadcast(const AE2FFTComplex *ptr)
+{
+    return _mm_castpd_ps(_mm_load1_pd((const double *)ptr));
+}
+
+/* 複素数の乗算 */
+static AE2FFT_INLINE __m128 AE2FFTSSE2_Mul(__m128 z, __m128 w)
+{
+    const __m128 sign = _mm_set_ps(1.0f, -1.0f, 1.0f, -1.0f);
+    const __m128 wre = _mm_shuffle_ps(w, w, _MM_SHUFFLE(2, 2, 0, 0));
+    const __m128 wim = _mm_shuffle_ps(w, w, _MM_SHUFFLE(3, 3, 1, 1));
+    return _mm_add_ps(_mm_mul_ps(z, wre), _mm_mul_ps(_mm_mul_ps(AE2FFTSSE2_SWAP(z), wim), sign));
+}
+
+/* 4点バタフライ
+* jsign は j = -flag * i の乗算に使う符号 (flag, -flag, flag, -flag) */
+static AE2FFT_INLINE void AE2FFTSSE2_Butterfly(
+        __m128 a, __m128 b, __m128 c, __m128 d, __m128 jsign,
+        __m128 *y0, __m128 *y1, __m128 *y2, __m128 *y3)
+{
+    const __m128 apc = _mm_add_ps(a, c);
+    const __m128 amc = _mm_sub_ps(a, c);
+    const __m128 bpd = _mm_add_ps(b, d);
+    const __m128 bmd = _mm_sub_ps(b, d);
+    const __m128 jbmd = _mm_mul_ps(AE2FFTSSE2_SWAP(bmd), jsign);
+    (*y0) = _mm_add_ps(apc, bpd);
+    (*y1) = _mm_sub_ps(amc, jbmd);
+    (*y2) = _mm_sub_ps(apc, bpd);
+    (*y3) = _mm_add_ps(amc, jbmd);
+}
+
+/* SSE2実装の4基底パス */
+static void AE2FFT_Radix4PassSSE2(
+        int32_t n1, int32_t s, const AE2FFTComplex *twiddles, int flag, const AE2FFTComplex *x, AE2FFTComplex *y)
+{
+    int32_t p, q;
+    const int32_t n2 = (n1 << 1);
+    const int32_t n3 = n1 + n2;
+    const float fflag = (float)flag;
+    const __m128 jsign = _mm_set_ps(-fflag, fflag, -fflag, fflag);
+    const AE2FFTComplex *w1 = &twiddles[0];
+    const AE2FFTComplex *w2 = &twiddles[n1];
+    const AE2FFTComplex *w3 = &twiddles[n2];
+
+    if ((s % 2) == 0) {
+        /* ストライド方向にベクトル化 */
+        for (p = 0; p < n1; p++) {
+            const __m128 w1p = AE2FFTSSE2_Broadcast(&w1[p]);
+            const __m128 w2p = AE2FFTSSE2_Broadcast(&w2[p]);
+            const __m128 w3p = AE2FFTSSE2_Broadcast(&w3[p]);
+            const AE2FFTComplex *xp = &x[s * p];
+            AE2FFTComplex *yp = &y[s * (p << 2)];
+            for (q = 0; q < s; q += 2) {
+                __m128 y0, y1, y2, y3;
+                AE2FFTSSE2_Butterfly(
+                        AE2FFTSSE2_LOAD(&xp[q + s * 0]), AE2FFTSSE2_LOAD(&xp[q + s * n1]),
+                        AE2FFTSSE2_LOAD(&xp[q + s * n2]), AE2FFTSSE2_LOAD(&xp[q + s * n3]),
+                        jsign, &y0, &y1, &y2, &y3);
+                AE2FFTSSE2_STORE(&yp[q + s * 0], y0);
+                AE2FFTSSE2_STORE(&yp[q + s * 1], AE2FFTSSE2_Mul(y1, w1p));
+                AE2FFTSSE2_STORE(&yp[q + s * 2], AE2FFTSSE2_Mul(y2, w2p));
+                AE2FFTSSE2_STORE(&yp[q + s * 3], AE2FFTSSE2_Mul(y3, w3p));
+            }
+        }
+    } else if ((s == 1) && ((n1 % 2) == 0)) {
+        /* 初段（s == 1）は系列方向にベクトル化し、出力を転置して書き込む */
+        for (p = 0; p < n1; p += 2) {
+            __m128 y0, y1, y2, y3;
+            AE2FFTSSE2_Butterfly(
+                    AE2FFTSSE2_LOAD(&x[p]), AE2FFTSSE2_LOAD(&x[p + n1]),
+                    AE2FFTSSE2_LOAD(&x[p + n2]), AE2FFTSSE2_LOAD(&x[p + n3]),
+                    jsign, &y0, &y1, &y2, &y3);
+            y1 = AE2FFTSSE2_Mul(y1, AE2FFTSSE2_LOAD(&w1[p]));
+            y2 = AE2FFTSSE2_Mul(y2, AE2FFTSSE2_LOAD(&w2[p]));
+            y3 = AE2FFTSSE2_Mul(y3, AE2FFTSSE2_LOAD(&w3[p]));
+            AE2FFTSSE2_STORE(&y[(p << 2) + 0], _mm_movelh_ps(y0, y1));
+            AE2FFTSSE2_STORE(&y[(p << 2) + 2], _mm_movelh_ps(y2, y3));
+            AE2FFTSSE2_STORE(&y[(p << 2) + 4], _mm_movehl_ps(y1, y0));
+            AE2FFTSSE2_STORE(&y[(p << 2) + 6], _mm_movehl_ps(y3, y2));
+        }
+    } else {
+        AE2FFT_Radix4PassScalar(n1, s, twiddles, flag, x, y);
+    }
+}
+
+/* SSE2実装の2基底パス */
+static void AE2FFT_Radix2PassSSE2(int32_t s, const AE2FFTComplex *x, AE2FFTComplex *y)
+{
+    int32_t q;
+
+    if ((s % 2) != 0) {
+        AE2FFT_Radix2PassScalar(s, x, y);
+        return;
+    }
+
+    for (q = 0; q < s; q += 2) {
+        const __m128 a = AE2FFTSSE2_LOAD(&x[q + 0]);
+        const __m128 b = AE2FFTSSE2_LOAD(&x[q + s]);
+        AE2FFTSSE2_STORE(&y[q + 0], _mm_add_ps(a, b));
+        AE2FFTSSE2_STORE(&y[q + s], _mm_sub_ps(a, b));
+    }
+}
+
+/* SSE2実装のスペクトルの一括乗算加算
+* 4ビンずつ、全ての組の積をレジスタ上で累積してから書き出す */
+static void AE2FFT_SpectrumMulAddSSE2(int32_t num_bins, int32_t num_spectra,
+        const float *const *a, const float *const *b, float *y_real, float *y_imag)
+{
+    int32_t i, k;
+
+    for (i = 0; i + 4 <= num_bins; i += 4) {
+        __m128 yr = _mm_loadu_ps(&y_real[i]);
+        __m128 yi = _mm_loadu_ps(&y_imag[i]);
+        for (k = 0; k < num_spectra; k++) {
+            const __m128 ar = _mm_loadu_ps(&a[k][i]);
+            const __m128 ai = _mm_loadu_ps(&a[k][num_bins + i]);
+            const __m128 br = _mm_loadu_ps(&b[k][i]);
+            const __m128 bi = _mm_loadu_ps(&b[k][num_bins + i]);
+            yr = _mm_add_ps(yr, _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi)));
+            yi = _mm_add_ps(yi, _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br)));
+        }
+        _mm_storeu_ps(&y_real[i], yr);
+        _mm_storeu_ps(&y_imag[i], yi);
+    }
+
+    /* 端数 */
+    for (; i < num_bins; i++) {
+        float yr = y_real[i], yi = y_imag[i];
+        for (k = 0; k < num_spectra; k++) {
+            const float ar = a[k][i], ai = a[k][num_bins + i];
+            const float br = b[k][i], bi = b[k][num_bins + i];
+            yr += ar * br - ai * bi;
+            yi += ar * bi + ai * br;
+        }
+        y_real[i] = yr;
+        y_imag[i] = yi;
+    }
+}
+
+/* SSE2カーネル */
+static const struct AE2FFTKernel st_sse2_kernel = {
+    "sse2",
+    AE2FFT_Radix4PassSSE2,
+    AE2FFT_Radix2PassSSE2,
+    AE2FFT_SpectrumMulAddSSE2,
+};
+
+/* SSE2カーネルの取得 */
+const struct AE2FFTKernel *AE2FFTKernel_GetSSE2(void)
+{
+    return &st_sse2_kernel;
+}
+
+#else
+
+/* SSE2カーネルの取得 */
+const struct AE2FFTKernel *AE2FFTKernel_GetSSE2(void)
+{
+    return NULL;
+}
+
+#endif /* AE2FFT_USE_X86_SIMD && __SSE2__ */
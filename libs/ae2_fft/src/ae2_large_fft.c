@@ -0,0 +1,388 @@
+#include "ae2_large_fft.h"
+
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+#include "ae2_fft.h"
+
+/* 円周率 */
+#define AE2_PI 3.14159265358979323846
+/* メモリアラインメント */
+#define AE2LARGEFFT_ALIGNMENT 16
+/* ワーカー毎の作業領域の境界（キャッシュラインを共有しないよう64バイト単位） */
+#define AE2LARGEFFT_WORKER_BUFFER_ALIGNMENT 64
+/* 列方向FFTでまとめて処理する列数（複素数8個 = 64バイト） */
+#define AE2LARGEFFT_COLUMN_BLOCK_SIZE 8
+/* 転置のタイルサイズ */
+#define AE2LARGEFFT_TRANSPOSE_TILE_SIZE 16
+/* nの倍数への切り上げ */
+#define AE2LARGEFFT_ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
+/* 変換方向(flag)からテーブルのインデックスを取得 -1:0, 1:1 */
+#define AE2LARGEFFT_DIRECTION_INDEX(flag) (((flag) + 1) >> 1)
+/* 最大値を取得 */
+#define AE2LARGEFFT_MAX(a, b) (((a) > (b)) ? (a) : (b))
+/* 最小値を取得 */
+#define AE2LARGEFFT_MIN(a, b) (((a) < (b)) ? (a) : (b))
+
+/* 大規模FFT */
+struct AE2LargeFFT {
+    int32_t fft_size; /* FFT点数 */
+    int32_t n1; /* 列方向FFTの点数（行数） */
+    int32_t n2; /* 行方向FFTの点数（列数） */
+    int32_t num_workers; /* 並列に処理するタスク数 */
+    AE2LargeFFTRunnerFunction runner; /* タスクの並列実行関数 */
+    void *runner_arg; /* タスクの並列実行関数に渡す引数 */
+    struct AE2FFTPlan *column_plan; /* 列方向FFTのプラン */
+    struct AE2FFTPlan *row_plan; /* 行方向FFTのプラン */
+    int32_t twiddle_split; /* 回転因子テーブルの分割点 */
+    float *fine_twiddles[2]; /* w^m(0 <= m < twiddle_split) [0]:FFT, [1]:IFFT */
+    float *coarse_twiddles[2]; /* w^(m * twiddle_split)(0 <= m < fft_size / twiddle_split) [0]:FFT, [1]:IFFT */
+    float *worker_buffers; /* ワーカー毎の作業領域 */
+    int32_t worker_buffer_size; /* ワーカー1つあたりの作業領域サイズ(float個数) */
+    /* 実行中の変換の引数 */
+    int flag; /* -1:FFT, 1:IFFT */
+    float *x; /* 入出力系列 */
+    float *y; /* 作業用配列 */
+};
+
+/* 点数を行数と列数に分解
+* 列方向FFTの点数は平方根以下の約数のうち最大のものとし、
+* どちらもFFTプランが扱える点数（2, 3, 5の積で表せる2以上の値）になるようにする */
+static int32_t AE2LargeFFT_Factorize(int32_t fft_size, int32_t *n1, int32_t *n2)
+{
+    int32_t d;
+    struct AE2FFTPlanConfig fft_config;
+
+    fft_config.type = AE2FFTPLAN_TYPE_COMPLEX;
+    fft_config.in_place = 0;
+    fft_config.double_precision = 0;
+    for (d = (int32_t)sqrt((double)fft_size) + 1; d >= 2; d--) {
+        if (((fft_size % d) != 0) || (d > (fft_size / d))) {
+            continue;
+        }
+        fft_config.fft_size = d;
+        if (AE2FFTPlan_CalculateWorkSize(&fft_config) < 0) {
+            continue;
+        }
+        fft_config.fft_size = fft_size / d;
+        if (AE2FFTPlan_CalculateWorkSize(&fft_config) < 0) {
+            continue;
+        }
+        (*n1) = d;
+        (*n2) = fft_size / d;
+        return 0;
+    }
+
+    return -1;
+}
+
+/* 回転因子テーブルの分割点を計算 */
+static int32_t AE2LargeFFT_CalculateTwiddleSplit(int32_t fft_size)
+{
+    return (int32_t)ceil(sqrt((double)fft_size));
+}
+
+/* ワーカー1つあたりの作業領域サイズ(float個数)を計算
+* 列方向FFTでは列ブロックとその作業用配列を、行方向FFTでは行1本分の作業用配列を使う */
+static int32_t AE2LargeFFT_CalculateWorkerBufferSize(int32_t n1, int32_t n2)
+{
+    const int32_t column_size = 2 * (2 * n1 * AE2LARGEFFT_COLUMN_BLOCK_SIZE);
+    const int32_t row_size = 2 * n2;
+    return AE2LARGEFFT_ROUNDUP(AE2LARGEFFT_MAX(column_size, row_size),
+            (int32_t)(AE2LARGEFFT_WORKER_BUFFER_ALIGNMENT / sizeof(float)));
+}
+
+/* 大規模FFT作成に必要なワークサイズ計算 */
+int32_t AE2LargeFFT_CalculateWorkSize(const struct AE2LargeFFTConfig *config)
+{
+    int32_t work_size, n1, n2, split, plan_size;
+    struct AE2FFTPlanConfig fft_config;
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* コンフィグチェック */
+    if ((config->fft_size < 4) || (config->num_workers <= 0)) {
+        return -1;
+    }
+    if (AE2LargeFFT_Factorize(config->fft_size, &n1, &n2) < 0) {
+        return -1;
+    }
+
+    /* 構造体サイズ */
+    work_size = sizeof(struct AE2LargeFFT) + AE2LARGEFFT_ALIGNMENT;
+
+    /* 列方向/行方向FFTのプラン */
+    fft_config.type = AE2FFTPLAN_TYPE_COMPLEX;
+    fft_config.in_place = 0;
+    fft_config.double_precision = 0;
+    fft_config.fft_size = n1;
+    if ((plan_size = AE2FFTPlan_CalculateWorkSize(&fft_config)) < 0) {
+        return -1;
+    }
+    work_size += plan_size;
+    fft_config.fft_size = n2;
+    if ((plan_size = AE2FFTPlan_CalculateWorkSize(&fft_config)) < 0) {
+        return -1;
+    }
+    work_size += plan_size;
+
+    /* 回転因子テーブル（FFT/IFFT） */
+    split = AE2LargeFFT_CalculateTwiddleSplit(config->fft_size);
+    work_size += 2 * (int32_t)(2 * sizeof(float) * (size_t)split + AE2LARGEFFT_ALIGNMENT);
+    work_size += 2 * (int32_t)(2 * sizeof(float) * (size_t)((config->fft_size + split - 1) / split) + AE2LARGEFFT_ALIGNMENT);
+
+    /* ワーカー毎の作業領域 */
+    work_size += (int32_t)(sizeof(float) * (size_t)config->num_workers
+            * (size_t)AE2LargeFFT_CalculateWorkerBufferSize(n1, n2) + AE2LARGEFFT_WORKER_BUFFER_ALIGNMENT);
+
+    return work_size;
+}
+
+/* 回転因子テーブルを作成 table[i] = w^(i * step) */
+static void AE2LargeFFT_MakeTwiddles(float *table, int32_t num_twiddles, int32_t step, int32_t fft_size, int flag)
+{
+    int32_t i;
+
+    for (i = 0; i < num_twiddles; i++) {
+        const double theta = (2.0 * AE2_PI * (double)(((int64_t)i * step) % fft_size)) / fft_size;
+        AE2FFTCOMPLEX_REAL(table, i) = (float)cos(theta);
+        AE2FFTCOMPLEX_IMAG(table, i) = (float)(flag * sin(theta));
+    }
+}
+
+/* 大規模FFT作成 */
+struct AE2LargeFFT *AE2LargeFFT_Create(const struct AE2LargeFFTConfig *config, void *work, int32_t work_size)
+{
+    struct AE2LargeFFT *fft;
+    uint8_t *work_ptr;
+    int32_t i, plan_size, num_coarse;
+    struct AE2FFTPlanConfig fft_config;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL) || (work_size < 0)) {
+        return NULL;
+    }
+
+    if (work_size < AE2LargeFFT_CalculateWorkSize(config)) {
+        return NULL;
+    }
+
+    /* ハンドル領域割当 */
+    work_ptr = (uint8_t *)AE2LARGEFFT_ROUNDUP((uintptr_t)work, AE2LARGEFFT_ALIGNMENT);
+    fft = (struct AE2LargeFFT *)work_ptr;
+    fft->fft_size = config->fft_size;
+    fft->num_workers = config->num_workers;
+    fft->runner = config->runner;
+    fft->runner_arg = config->runner_arg;
+    if (AE2LargeFFT_Factorize(fft->fft_size, &fft->n1, &fft->n2) < 0) {
+        return NULL;
+    }
+    fft->flag = -1;
+    fft->x = fft->y = NULL;
+    work_ptr += sizeof(struct AE2LargeFFT);
+
+    /* 列方向/行方向FFTのプラン */
+    fft_config.type = AE2FFTPLAN_TYPE_COMPLEX;
+    fft_config.in_place = 0;
+    fft_config.double_precision = 0;
+    fft_config.fft_size = fft->n1;
+    plan_size = AE2FFTPlan_CalculateWorkSize(&fft_config);
+    if ((fft->column_plan = AE2FFTPlan_Create(&fft_config, work_ptr, plan_size)) == NULL) {
+        return NULL;
+    }
+    work_ptr += plan_size;
+    fft_config.fft_size = fft->n2;
+    plan_size = AE2FFTPlan_CalculateWorkSize(&fft_config);
+    if ((fft->row_plan = AE2FFTPlan_Create(&fft_config, work_ptr, plan_size)) == NULL) {
+        return NULL;
+    }
+    work_ptr += plan_size;
+
+    /* 回転因子テーブル w^m = w^(m % split) * w^((m / split) * split) として2つに分ける
+    * 点数分のテーブルを持たずに、倍精度で計算した値2つの積で精度を確保する */
+    fft->twiddle_split = AE2LargeFFT_CalculateTwiddleSplit(fft->fft_size);
+    num_coarse = (fft->fft_size + fft->twiddle_split - 1) / fft->twiddle_split;
+    for (i = 0; i < 2; i++) {
+        const int flag = (i == 0) ? -1 : 1;
+        work_ptr = (uint8_t *)AE2LARGEFFT_ROUNDUP((uintptr_t)work_ptr, AE2LARGEFFT_ALIGNMENT);
+        fft->fine_twiddles[i] = (float *)work_ptr;
+        AE2LargeFFT_MakeTwiddles(fft->fine_twiddles[i], fft->twiddle_split, 1, fft->fft_size, flag);
+        work_ptr += 2 * sizeof(float) * (size_t)fft->twiddle_split;
+        work_ptr = (uint8_t *)AE2LARGEFFT_ROUNDUP((uintptr_t)work_ptr, AE2LARGEFFT_ALIGNMENT);
+        fft->coarse_twiddles[i] = (float *)work_ptr;
+        AE2LargeFFT_MakeTwiddles(fft->coarse_twiddles[i], num_coarse, fft->twiddle_split, fft->fft_size, flag);
+        work_ptr += 2 * sizeof(float) * (size_t)num_coarse;
+    }
+
+    /* ワーカー毎の作業領域 */
+    fft->worker_buffer_size = AE2LargeFFT_CalculateWorkerBufferSize(fft->n1, fft->n2);
+    work_ptr = (uint8_t *)AE2LARGEFFT_ROUNDUP((uintptr_t)work_ptr, AE2LARGEFFT_WORKER_BUFFER_ALIGNMENT);
+    fft->worker_buffers = (float *)work_ptr;
+    work_ptr += sizeof(float) * (size_t)fft->num_workers * (size_t)fft->worker_buffer_size;
+
+    return fft;
+}
+
+/* 大規模FFT破棄 */
+void AE2LargeFFT_Destroy(struct AE2LargeFFT *fft)
+{
+    if (fft != NULL) {
+        AE2FFTPlan_Destroy(fft->column_plan);
+        AE2FFTPlan_Destroy(fft->row_plan);
+    }
+}
+
+/* FFT点数の取得 */
+int32_t AE2LargeFFT_GetFFTSize(const struct AE2LargeFFT *fft)
+{
+    assert(fft != NULL);
+    return fft->fft_size;
+}
+
+/* タスクが担当する範囲[begin, end)を計算 */
+static void AE2LargeFFT_GetTaskRange(
+        int32_t num_items, int32_t num_tasks, int32_t task_index, int32_t *begin, int32_t *end)
+{
+    (*begin) = (int32_t)(((int64_t)num_items * task_index) / num_tasks);
+    (*end) = (int32_t)(((int64_t)num_items * (task_index + 1)) / num_tasks);
+}
+
+/* 列方向FFTタスク
+* 列ブロックを作業領域に集めてまとめて変換し、回転因子を乗じて作業用配列yに書き出す */
+static void AE2LargeFFT_ColumnTask(void *task_arg, int32_t task_index)
+{
+    struct AE2LargeFFT *fft = (struct AE2LargeFFT *)task_arg;
+    const int32_t n = fft->fft_size;
+    const int32_t n1 = fft->n1;
+    const int32_t n2 = fft->n2;
+    const int32_t split = fft->twiddle_split;
+    const float *fine = fft->fine_twiddles[AE2LARGEFFT_DIRECTION_INDEX(fft->flag)];
+    const float *coarse = fft->coarse_twiddles[AE2LARGEFFT_DIRECTION_INDEX(fft->flag)];
+    const int32_t num_blocks = (n2 + AE2LARGEFFT_COLUMN_BLOCK_SIZE - 1) / AE2LARGEFFT_COLUMN_BLOCK_SIZE;
+    const float *x = fft->x;
+    float *y = fft->y;
+    float *block = &fft->worker_buffers[task_index * fft->worker_buffer_size];
+    float *block_work = &block[2 * n1 * AE2LARGEFFT_COLUMN_BLOCK_SIZE];
+    int32_t blk, begin, end, k1, b;
+
+    AE2LargeFFT_GetTaskRange(num_blocks, fft->num_workers, task_index, &begin, &end);
+
+    for (blk = begin; blk < end; blk++) {
+        const int32_t c0 = blk * AE2LARGEFFT_COLUMN_BLOCK_SIZE;
+        const int32_t nb = AE2LARGEFFT_MIN(AE2LARGEFFT_COLUMN_BLOCK_SIZE, n2 - c0);
+
+        /* 列ブロックを集める（各行からnb個の連続した複素数をコピー） */
+        for (k1 = 0; k1 < n1; k1++) {
+            memcpy(&block[2 * k1 * nb], &x[2 * ((int64_t)k1 * n2 + c0)], 2 * sizeof(float) * (size_t)nb);
+        }
+
+        /* 列方向FFT */
+        AE2FFTPlan_FloatFFTBatch(fft->column_plan, fft->flag, nb, block, block_work);
+
+        /* 回転因子w^((c0 + b) * k1)を乗じて書き出す */
+        for (k1 = 0; k1 < n1; k1++) {
+            int32_t m = (int32_t)(((int64_t)c0 * k1) % n);
+            const float *src = &block[2 * k1 * nb];
+            float *dst = &y[2 * ((int64_t)k1 * n2 + c0)];
+            for (b = 0; b < nb; b++) {
+                const float fr = AE2FFTCOMPLEX_REAL(fine, m % split), fi = AE2FFTCOMPLEX_IMAG(fine, m % split);
+                const float cr = AE2FFTCOMPLEX_REAL(coarse, m / split), ci = AE2FFTCOMPLEX_IMAG(coarse, m / split);
+                const float wr = fr * cr - fi * ci, wi = fr * ci + fi * cr;
+                const float sr = AE2FFTCOMPLEX_REAL(src, b), si = AE2FFTCOMPLEX_IMAG(src, b);
+                AE2FFTCOMPLEX_REAL(dst, b) = sr * wr - si * wi;
+                AE2FFTCOMPLEX_IMAG(dst, b) = sr * wi + si * wr;
+                /* k1 < nなので1回の減算で[0, n)に戻る */
+                m += k1;
+                if (m >= n) {
+                    m -= n;
+                }
+            }
+        }
+    }
+}
+
+/* 行方向FFTタスク */
+static void AE2LargeFFT_RowTask(void *task_arg, int32_t task_index)
+{
+    struct AE2LargeFFT *fft = (struct AE2LargeFFT *)task_arg;
+    float *work = &fft->worker_buffers[task_index * fft->worker_buffer_size];
+    int32_t k1, begin, end;
+
+    AE2LargeFFT_GetTaskRange(fft->n1, fft->num_workers, task_index, &begin, &end);
+
+    for (k1 = begin; k1 < end; k1++) {
+        AE2FFTPlan_FloatFFTBatch(fft->row_plan, fft->flag, 1, &fft->y[2 * (int64_t)k1 * fft->n2], work);
+    }
+}
+
+/* 転置タスク x[k2 * n1 + k1] = y[k1 * n2 + k2]
+* タイル単位で転置し、読み書き双方のキャッシュミスを抑える */
+static void AE2LargeFFT_TransposeTask(void *task_arg, int32_t task_index)
+{
+    struct AE2LargeFFT *fft = (struct AE2LargeFFT *)task_arg;
+    const int32_t n1 = fft->n1;
+    const int32_t n2 = fft->n2;
+    const int32_t num_tiles = (n1 + AE2LARGEFFT_TRANSPOSE_TILE_SIZE - 1) / AE2LARGEFFT_TRANSPOSE_TILE_SIZE;
+    const float *y = fft->y;
+    float *x = fft->x;
+    int32_t tile, begin, end, k1, k2, j;
+
+    AE2LargeFFT_GetTaskRange(num_tiles, fft->num_workers, task_index, &begin, &end);
+
+    for (tile = begin; tile < end; tile++) {
+        const int32_t k1_begin = tile * AE2LARGEFFT_TRANSPOSE_TILE_SIZE;
+        const int32_t k1_end = AE2LARGEFFT_MIN(k1_begin + AE2LARGEFFT_TRANSPOSE_TILE_SIZE, n1);
+        for (j = 0; j < n2; j += AE2LARGEFFT_TRANSPOSE_TILE_SIZE) {
+            const int32_t k2_end = AE2LARGEFFT_MIN(j + AE2LARGEFFT_TRANSPOSE_TILE_SIZE, n2);
+            for (k2 = j; k2 < k2_end; k2++) {
+                for (k1 = k1_begin; k1 < k1_end; k1++) {
+                    const int64_t src = (int64_t)k1 * n2 + k2;
+                    const int64_t dst = (int64_t)k2 * n1 + k1;
+                    AE2FFTCOMPLEX_REAL(x, dst) = AE2FFTCOMPLEX_REAL(y, src);
+                    AE2FFTCOMPLEX_IMAG(x, dst) = AE2FFTCOMPLEX_IMAG(y, src);
+                }
+            }
+        }
+    }
+}
+
+/* タスクを実行 */
+static void AE2LargeFFT_RunTasks(struct AE2LargeFFT *fft, AE2LargeFFTTaskFunction task)
+{
+    int32_t i;
+
+    if (fft->runner != NULL) {
+        fft->runner(fft->runner_arg, fft->num_workers, task, fft);
+        return;
+    }
+
+    /* 実行関数が無い場合は呼び出しスレッドで順に実行 */
+    for (i = 0; i < fft->num_workers; i++) {
+        task(fft, i);
+    }
+}
+
+/* 大規模FFT 正規化は行いません
+* n = n2 * j1 + j2, k = k1 + n1 * k2 とおくと
+* X[k] = sum_j2 (w^(j2 * k1) * sum_j1 x[n] * w_n1^(j1 * k1)) * w_n2^(j2 * k2)
+* となるので、列方向FFT・回転因子乗算・行方向FFT・転置の順に計算する */
+void AE2LargeFFT_FloatFFT(struct AE2LargeFFT *fft, int flag, float *x, float *y)
+{
+    assert(fft != NULL);
+    assert((x != NULL) && (y != NULL));
+    assert((flag == -1) || (flag == 1));
+
+    fft->flag = flag;
+    fft->x = x;
+    fft->y = y;
+
+    AE2LargeFFT_RunTasks(fft, AE2LargeFFT_ColumnTask);
+    AE2LargeFFT_RunTasks(fft, AE2LargeFFT_RowTask);
+    AE2LargeFFT_RunTasks(fft, AE2LargeFFT_TransposeTask);
+
+    fft->x = fft->y = NULL;
+}
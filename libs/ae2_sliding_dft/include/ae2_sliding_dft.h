@@ -0,0 +1,181 @@
+/*!
+* @file ae2_sliding_dft.h
+* @brief スライディングDFT・Goertzelバンク（少数の周波数ビンのサンプル単位追跡）
+*/
+#ifndef AE2SLIDINGDFT_H_INCLUDED
+#define AE2SLIDINGDFT_H_INCLUDED
+
+#include <stdint.h>
+#include "ae2_window_function.h"
+
+/*!
+* @brief スライディングDFT生成コンフィグ
+*/
+struct AE2SlidingDFTConfig {
+    int32_t window_size; /*!< DFT点数（窓のサイズ） */
+    int32_t max_num_bins; /*!< 追跡する最大ビン数 */
+    AE2WindowFunctionType window_type; /*!< 窓関数タイプ */
+};
+
+/*!
+* @brief Goertzelバンク生成コンフィグ
+*/
+struct AE2GoertzelConfig {
+    float sampling_rate; /*!< サンプリングレート */
+    int32_t block_size; /*!< ブロックサイズ（1回の推定に使うサンプル数） */
+    int32_t max_num_frequencies; /*!< 追跡する最大周波数数 */
+    AE2WindowFunctionType window_type; /*!< 窓関数タイプ */
+};
+
+/*!
+* @brief スライディングDFT
+* @note 指定したビンのみを1サンプルごとにO(ビン数)で更新します
+*/
+struct AE2SlidingDFT;
+
+/*!
+* @brief Goertzelバンク
+* @note 任意周波数の成分をブロックごとに推定します。更新は1サンプルあたりO(周波数数)です
+*/
+struct AE2Goertzel;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*!
+* @brief スライディングDFT作成に必要なワークサイズ計算
+* @param[in] config スライディングDFT生成コンフィグ
+* @return int32_t 計算に成功した場合は0以上の値を、失敗した場合は負の値を返します
+* @sa AE2SlidingDFT_Create
+*/
+int32_t AE2SlidingDFT_CalculateWorkSize(const struct AE2SlidingDFTConfig *config);
+
+/*!
+* @brief スライディングDFT作成
+* @param[in] config スライディングDFT生成コンフィグ
+* @param[in,out] work スライディングDFT生成に使用するワーク領域
+* @param[in] work_size スライディングDFT生成に使用するワーク領域サイズ
+* @return AE2SlidingDFT 生成に成功した場合は構造体のポインタを、失敗した場合はNULLを返します
+* @note 作成直後は追跡するビンはありません
+* @sa AE2SlidingDFT_CalculateWorkSize, AE2SlidingDFT_SetBins
+*/
+struct AE2SlidingDFT *AE2SlidingDFT_Create(const struct AE2SlidingDFTConfig *config, void *work, int32_t work_size);
+
+/*!
+* @brief スライディングDFT破棄
+* @param[in,out] sdft スライディングDFT
+*/
+void AE2SlidingDFT_Destroy(struct AE2SlidingDFT *sdft);
+
+/*!
+* @brief スライディングDFTリセット
+* @param[in,out] sdft スライディングDFT
+* @note 入力履歴を0クリアします
+*/
+void AE2SlidingDFT_Reset(struct AE2SlidingDFT *sdft);
+
+/*!
+* @brief 追跡するビンの設定
+* @param[in,out] sdft スライディングDFT
+* @param[in] bins ビン番号の配列（各要素は0以上window_size未満）
+* @param[in] num_bins ビン数（max_num_bins以下）
+* @return int32_t 成功時は0、失敗時は負の値
+* @note 保持している入力履歴から各ビンを計算し直すため、O(window_size * num_bins)の計算がかかります
+*/
+int32_t AE2SlidingDFT_SetBins(struct AE2SlidingDFT *sdft, const int32_t *bins, int32_t num_bins);
+
+/*!
+* @brief 入力サンプルの処理
+* @param[in,out] sdft スライディングDFT
+* @param[in] input 入力サンプル
+* @param[in] num_samples 入力サンプル数
+*/
+void AE2SlidingDFT_Process(struct AE2SlidingDFT *sdft, const float *input, int32_t num_samples);
+
+/*!
+* @brief 現在のスペクトルの取得
+* @param[in] sdft スライディングDFT
+* @param[out] spectrum 直近window_sizeサンプルに窓をかけたDFT結果（実部と虚部を交互に格納。2 * num_binsサイズ必須）
+* @note 窓は周期窓（余弦和の分母をwindow_sizeとした窓）として周波数領域で適用します
+*/
+void AE2SlidingDFT_GetSpectrum(const struct AE2SlidingDFT *sdft, float *spectrum);
+
+/*!
+* @brief 現在のパワーの取得
+* @param[in] sdft スライディングDFT
+* @param[out] power 各ビンのパワー（num_binsサイズ必須）
+*/
+void AE2SlidingDFT_GetPower(const struct AE2SlidingDFT *sdft, float *power);
+
+/*!
+* @brief Goertzelバンク作成に必要なワークサイズ計算
+* @param[in] config Goertzelバンク生成コンフィグ
+* @return int32_t 計算に成功した場合は0以上の値を、失敗した場合は負の値を返します
+* @sa AE2Goertzel_Create
+*/
+int32_t AE2Goertzel_CalculateWorkSize(const struct AE2GoertzelConfig *config);
+
+/*!
+* @brief Goertzelバンク作成
+* @param[in] config Goertzelバンク生成コンフィグ
+* @param[in,out] work Goertzelバンク生成に使用するワーク領域
+* @param[in] work_size Goertzelバンク生成に使用するワーク領域サイズ
+* @return AE2Goertzel 生成に成功した場合は構造体のポインタを、失敗した場合はNULLを返します
+* @note 作成直後は追跡する周波数はありません
+* @sa AE2Goertzel_CalculateWorkSize, AE2Goertzel_SetFrequencies
+*/
+struct AE2Goertzel *AE2Goertzel_Create(const struct AE2GoertzelConfig *config, void *work, int32_t work_size);
+
+/*!
+* @brief Goertzelバンク破棄
+* @param[in,out] goertzel Goertzelバンク
+*/
+void AE2Goertzel_Destroy(struct AE2Goertzel *goertzel);
+
+/*!
+* @brief Goertzelバンクリセット
+* @param[in,out] goertzel Goertzelバンク
+* @note 途中のブロックを破棄し、推定結果を0クリアします
+*/
+void AE2Goertzel_Reset(struct AE2Goertzel *goertzel);
+
+/*!
+* @brief 追跡する周波数の設定
+* @param[in,out] goertzel Goertzelバンク
+* @param[in] frequencies 周波数[Hz]の配列（各要素は0以上ナイキスト周波数以下）
+* @param[in] num_frequencies 周波数数（max_num_frequencies以下）
+* @return int32_t 成功時は0、失敗時は負の値
+* @note 係数はここで全て計算します。内部状態はリセットされます
+*/
+int32_t AE2Goertzel_SetFrequencies(struct AE2Goertzel *goertzel, const float *frequencies, int32_t num_frequencies);
+
+/*!
+* @brief 入力サンプルの処理
+* @param[in,out] goertzel Goertzelバンク
+* @param[in] input 入力サンプル
+* @param[in] num_samples 入力サンプル数
+* @return int32_t この呼び出しで完了したブロック数
+* @note ブロックが完了するたびに推定結果を更新します
+*/
+int32_t AE2Goertzel_Process(struct AE2Goertzel *goertzel, const float *input, int32_t num_samples);
+
+/*!
+* @brief 直近のブロックのスペクトルの取得
+* @param[in] goertzel Goertzelバンク
+* @param[out] spectrum ブロックの先頭を時刻0として窓をかけたDTFT値（実部と虚部を交互に格納。2 * num_frequenciesサイズ必須）
+*/
+void AE2Goertzel_GetSpectrum(const struct AE2Goertzel *goertzel, float *spectrum);
+
+/*!
+* @brief 直近のブロックのパワーの取得
+* @param[in] goertzel Goertzelバンク
+* @param[out] power 各周波数のパワー（num_frequenciesサイズ必須）
+*/
+void AE2Goertzel_GetPower(const struct AE2Goertzel *goertzel, float *power);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* AE2SLIDINGDFT_H_INCLUDED */
@@ -0,0 +1,531 @@
+#include "ae2_sliding_dft.h"
+
+#include <math.h>
+#include <string.h>
+#include <assert.h>
+#include <stddef.h>
+
+/* 円周率 */
+#define AE2_PI 3.14159265358979323846
+/* メモリアラインメント */
+#define AE2SLIDINGDFT_ALIGNMENT 16
+/* nの倍数への切り上げ */
+#define AE2SLIDINGDFT_ROUNDUP(val, n) ((((val) + ((n) - 1)) / (n)) * (n))
+/* 1ビンあたりの最大共振器数（窓の余弦和の項数から決まる） */
+#define AE2SLIDINGDFT_MAX_NUM_TAPS (2 * AE2WINDOWFUNCTION_MAX_NUM_COSINE_TERMS - 1)
+
+/* スライディングDFT */
+struct AE2SlidingDFT {
+    int32_t window_size; /* DFT点数 */
+    int32_t max_num_bins; /* 最大ビン数 */
+    int32_t num_bins; /* 追跡中のビン数 */
+    int32_t num_taps; /* 1ビンあたりの共振器数 */
+    float kernel[AE2SLIDINGDFT_MAX_NUM_TAPS]; /* 周波数領域で適用する窓のカーネル */
+    int32_t position; /* 次に書き込む入力履歴の位置 */
+    float *history; /* 入力履歴 */
+    double *cos_table; /* cos(2πm/N)のテーブル */
+    double *sin_table; /* sin(2πm/N)のテーブル */
+    int32_t *resonator_bins; /* 各共振器のビン番号 */
+    int32_t *resonator_phases; /* 各共振器の次サンプルの回転因子インデックス */
+    double *accumulators; /* 各共振器の累積値（実部と虚部を交互に格納） */
+};
+
+/* Goertzelバンク */
+struct AE2Goertzel {
+    float sampling_rate; /* サンプリングレート */
+    int32_t block_size; /* ブロックサイズ */
+    int32_t max_num_frequencies; /* 最大周波数数 */
+    int32_t num_frequencies; /* 追跡中の周波数数 */
+    int32_t count; /* 現在のブロック内の処理済みサンプル数 */
+    float *window; /* 窓 */
+    double *coefficients; /* 2cos(ω) */
+    double *twiddles; /* exp(-iω)（実部と虚部を交互に格納） */
+    double *phase_twiddles; /* ブロック先頭を時刻0に戻すための回転exp(-iω(N-1))（実部と虚部を交互に格納） */
+    double *states; /* 状態s[n-1], s[n-2]（交互に格納） */
+    float *results; /* 直近ブロックの推定結果（実部と虚部を交互に格納） */
+};
+
+/* スライディングDFT作成に必要なワークサイズ計算 */
+int32_t AE2SlidingDFT_CalculateWorkSize(const struct AE2SlidingDFTConfig *config)
+{
+    int32_t work_size, num_resonators;
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* コンフィグチェック */
+    if ((config->window_size < AE2SLIDINGDFT_MAX_NUM_TAPS) || (config->max_num_bins <= 0)) {
+        return -1;
+    }
+    switch (config->window_type) {
+    case AE2WINDOWFUNCTION_RECTANGULAR:
+    case AE2WINDOWFUNCTION_HANN:
+    case AE2WINDOWFUNCTION_HAMMING:
+    case AE2WINDOWFUNCTION_BLACKMAN:
+        break;
+    default:
+        return -1;
+    }
+
+    num_resonators = config->max_num_bins * AE2SLIDINGDFT_MAX_NUM_TAPS;
+
+    work_size = sizeof(struct AE2SlidingDFT) + AE2SLIDINGDFT_ALIGNMENT;
+    work_size += (int32_t)sizeof(float) * config->window_size + AE2SLIDINGDFT_ALIGNMENT;
+    work_size += 2 * ((int32_t)sizeof(double) * config->window_size + AE2SLIDINGDFT_ALIGNMENT);
+    work_size += 2 * ((int32_t)sizeof(int32_t) * num_resonators + AE2SLIDINGDFT_ALIGNMENT);
+    work_size += (int32_t)sizeof(double) * 2 * num_resonators + AE2SLIDINGDFT_ALIGNMENT;
+
+    return work_size;
+}
+
+/* スライディングDFT作成 */
+struct AE2SlidingDFT *AE2SlidingDFT_Create(const struct AE2SlidingDFTConfig *config, void *work, int32_t work_size)
+{
+    int32_t i, num_resonators, num_terms;
+    float terms[AE2WINDOWFUNCTION_MAX_NUM_COSINE_TERMS];
+    struct AE2SlidingDFT *sdft;
+    uint8_t *work_ptr;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL) || (work_size < 0)) {
+        return NULL;
+    }
+
+    if (work_size < AE2SlidingDFT_CalculateWorkSize(config)) {
+        return NULL;
+    }
+
+    num_resonators = config->max_num_bins * AE2SLIDINGDFT_MAX_NUM_TAPS;
+
+    /* ハンドル領域割当 */
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work, AE2SLIDINGDFT_ALIGNMENT);
+    sdft = (struct AE2SlidingDFT *)work_ptr;
+    sdft->window_size = config->window_size;
+    sdft->max_num_bins = config->max_num_bins;
+    sdft->num_bins = 0;
+    work_ptr += sizeof(struct AE2SlidingDFT);
+
+    /* 各種バッファの領域割当 */
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    sdft->history = (float *)work_ptr;
+    work_ptr += sizeof(float) * (size_t)config->window_size;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    sdft->cos_table = (double *)work_ptr;
+    work_ptr += sizeof(double) * (size_t)config->window_size;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    sdft->sin_table = (double *)work_ptr;
+    work_ptr += sizeof(double) * (size_t)config->window_size;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    sdft->resonator_bins = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * (size_t)num_resonators;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    sdft->resonator_phases = (int32_t *)work_ptr;
+    work_ptr += sizeof(int32_t) * (size_t)num_resonators;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    sdft->accumulators = (double *)work_ptr;
+    work_ptr += sizeof(double) * 2 * (size_t)num_resonators;
+
+    /* 回転因子テーブル */
+    for (i = 0; i < config->window_size; i++) {
+        sdft->cos_table[i] = cos((2.0 * AE2_PI * i) / config->window_size);
+        sdft->sin_table[i] = sin((2.0 * AE2_PI * i) / config->window_size);
+    }
+
+    /* 窓の余弦和を周波数領域の畳み込みカーネルに変換 */
+    /* w[m] = sum_t (-1)^t a[t] cos(2πtm/N) より、X_w[k] = a[0] X[k] + sum_t (-1)^t a[t] / 2 (X[k - t] + X[k + t]) */
+    num_terms = AE2WindowFunction_GetCosineSumCoefficients(config->window_type, terms);
+    sdft->num_taps = 2 * num_terms - 1;
+    sdft->kernel[num_terms - 1] = terms[0];
+    for (i = 1; i < num_terms; i++) {
+        const float coef = ((i % 2) ? -0.5f : 0.5f) * terms[i];
+        sdft->kernel[num_terms - 1 - i] = coef;
+        sdft->kernel[num_terms - 1 + i] = coef;
+    }
+
+    /* 内部状態のリセット */
+    AE2SlidingDFT_Reset(sdft);
+
+    return sdft;
+}
+
+/* スライディングDFT破棄 */
+void AE2SlidingDFT_Destroy(struct AE2SlidingDFT *sdft)
+{
+    if (sdft != NULL) {
+        /* 不定領域アクセス防止のため内容はクリア */
+        AE2SlidingDFT_Reset(sdft);
+    }
+}
+
+/* スライディングDFTリセット */
+void AE2SlidingDFT_Reset(struct AE2SlidingDFT *sdft)
+{
+    assert(sdft != NULL);
+
+    sdft->position = 0;
+    memset(sdft->history, 0, sizeof(float) * (size_t)sdft->window_size);
+    memset(sdft->resonator_phases, 0, sizeof(int32_t) * (size_t)(sdft->max_num_bins * AE2SLIDINGDFT_MAX_NUM_TAPS));
+    memset(sdft->accumulators, 0, sizeof(double) * 2 * (size_t)(sdft->max_num_bins * AE2SLIDINGDFT_MAX_NUM_TAPS));
+}
+
+/* 追跡するビンの設定 */
+int32_t AE2SlidingDFT_SetBins(struct AE2SlidingDFT *sdft, const int32_t *bins, int32_t num_bins)
+{
+    int32_t i, t, m, n, center;
+
+    assert(sdft != NULL);
+
+    n = sdft->window_size;
+    center = sdft->num_taps / 2;
+
+    /* 引数チェック */
+    if ((bins == NULL) || (num_bins < 0) || (num_bins > sdft->max_num_bins)) {
+        return -1;
+    }
+    for (i = 0; i < num_bins; i++) {
+        if ((bins[i] < 0) || (bins[i] >= n)) {
+            return -1;
+        }
+    }
+
+    sdft->num_bins = num_bins;
+
+    for (i = 0; i < num_bins; i++) {
+        for (t = 0; t < sdft->num_taps; t++) {
+            const int32_t r = i * sdft->num_taps + t;
+            const int32_t bin = (bins[i] + t - center + n) % n;
+            double re = 0.0, im = 0.0;
+            int32_t phase = 0;
+            /* 入力履歴から累積値を計算し直す */
+            /* history[m]には時刻がmod Nでmとなるサンプルが入っているため、回転因子はbin * m (mod N)で引ける */
+            for (m = 0; m < n; m++) {
+                re += sdft->history[m] * sdft->cos_table[phase];
+                im -= sdft->history[m] * sdft->sin_table[phase];
+                if (m == sdft->position) {
+                    sdft->resonator_phases[r] = phase;
+                }
+                phase += bin;
+                if (phase >= n) {
+                    phase -= n;
+                }
+            }
+            sdft->resonator_bins[r] = bin;
+            sdft->accumulators[2 * r + 0] = re;
+            sdft->accumulators[2 * r + 1] = im;
+        }
+    }
+
+    return 0;
+}
+
+/* 入力サンプルの処理 */
+void AE2SlidingDFT_Process(struct AE2SlidingDFT *sdft, const float *input, int32_t num_samples)
+{
+    int32_t smpl, r, n, num_resonators;
+    const double *cos_table, *sin_table;
+    const int32_t *resonator_bins;
+    int32_t *resonator_phases;
+    double *accumulators;
+
+    assert(sdft != NULL);
+    assert(input != NULL);
+    assert(num_samples >= 0);
+
+    n = sdft->window_size;
+    num_resonators = sdft->num_bins * sdft->num_taps;
+    cos_table = sdft->cos_table;
+    sin_table = sdft->sin_table;
+    resonator_bins = sdft->resonator_bins;
+    resonator_phases = sdft->resonator_phases;
+    accumulators = sdft->accumulators;
+
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        /* 窓から外れるサンプルとの差分のみを加える */
+        const double diff = (double)input[smpl] - sdft->history[sdft->position];
+        sdft->history[sdft->position] = input[smpl];
+        sdft->position++;
+        if (sdft->position >= n) {
+            sdft->position = 0;
+        }
+
+        /* 回転因子は時刻で変調したものをテーブルから引く（mSDFT） */
+        /* 累積値に回転因子を乗算し続けないため、丸め誤差による極の単位円外への移動が起こらない */
+        for (r = 0; r < num_resonators; r++) {
+            int32_t phase = resonator_phases[r];
+            accumulators[2 * r + 0] += diff * cos_table[phase];
+            accumulators[2 * r + 1] -= diff * sin_table[phase];
+            phase += resonator_bins[r];
+            if (phase >= n) {
+                phase -= n;
+            }
+            resonator_phases[r] = phase;
+        }
+    }
+}
+
+/* 窓をかけたビンの値を計算 */
+static void AE2SlidingDFT_CalculateBin(const struct AE2SlidingDFT *sdft, int32_t bin_index, double *real, double *imag)
+{
+    int32_t t;
+    double re = 0.0, im = 0.0;
+
+    assert(sdft != NULL);
+    assert((real != NULL) && (imag != NULL));
+
+    for (t = 0; t < sdft->num_taps; t++) {
+        const int32_t r = bin_index * sdft->num_taps + t;
+        const int32_t phase = sdft->resonator_phases[r];
+        const double a_re = sdft->accumulators[2 * r + 0];
+        const double a_im = sdft->accumulators[2 * r + 1];
+        /* 最古のサンプルを時刻0とするよう復調してから窓のカーネルを畳み込む */
+        re += sdft->kernel[t] * (a_re * sdft->cos_table[phase] - a_im * sdft->sin_table[phase]);
+        im += sdft->kernel[t] * (a_re * sdft->sin_table[phase] + a_im * sdft->cos_table[phase]);
+    }
+
+    (*real) = re;
+    (*imag) = im;
+}
+
+/* 現在のスペクトルの取得 */
+void AE2SlidingDFT_GetSpectrum(const struct AE2SlidingDFT *sdft, float *spectrum)
+{
+    int32_t i;
+
+    assert(sdft != NULL);
+    assert(spectrum != NULL);
+
+    for (i = 0; i < sdft->num_bins; i++) {
+        double re, im;
+        AE2SlidingDFT_CalculateBin(sdft, i, &re, &im);
+        spectrum[2 * i + 0] = (float)re;
+        spectrum[2 * i + 1] = (float)im;
+    }
+}
+
+/* 現在のパワーの取得 */
+void AE2SlidingDFT_GetPower(const struct AE2SlidingDFT *sdft, float *power)
+{
+    int32_t i;
+
+    assert(sdft != NULL);
+    assert(power != NULL);
+
+    for (i = 0; i < sdft->num_bins; i++) {
+        double re, im;
+        AE2SlidingDFT_CalculateBin(sdft, i, &re, &im);
+        power[i] = (float)(re * re + im * im);
+    }
+}
+
+/* Goertzelバンク作成に必要なワークサイズ計算 */
+int32_t AE2Goertzel_CalculateWorkSize(const struct AE2GoertzelConfig *config)
+{
+    int32_t work_size;
+
+    /* 引数チェック */
+    if (config == NULL) {
+        return -1;
+    }
+
+    /* コンフィグチェック */
+    if ((config->sampling_rate <= 0.0f) || (config->block_size < 2) || (config->max_num_frequencies <= 0)) {
+        return -1;
+    }
+    switch (config->window_type) {
+    case AE2WINDOWFUNCTION_RECTANGULAR:
+    case AE2WINDOWFUNCTION_HANN:
+    case AE2WINDOWFUNCTION_HAMMING:
+    case AE2WINDOWFUNCTION_BLACKMAN:
+        break;
+    default:
+        return -1;
+    }
+
+    work_size = sizeof(struct AE2Goertzel) + AE2SLIDINGDFT_ALIGNMENT;
+    work_size += (int32_t)sizeof(float) * config->block_size + AE2SLIDINGDFT_ALIGNMENT;
+    work_size += (int32_t)sizeof(double) * config->max_num_frequencies + AE2SLIDINGDFT_ALIGNMENT;
+    work_size += 3 * ((int32_t)sizeof(double) * 2 * config->max_num_frequencies + AE2SLIDINGDFT_ALIGNMENT);
+    work_size += (int32_t)sizeof(float) * 2 * config->max_num_frequencies + AE2SLIDINGDFT_ALIGNMENT;
+
+    return work_size;
+}
+
+/* Goertzelバンク作成 */
+struct AE2Goertzel *AE2Goertzel_Create(const struct AE2GoertzelConfig *config, void *work, int32_t work_size)
+{
+    struct AE2Goertzel *goertzel;
+    uint8_t *work_ptr;
+
+    /* 引数チェック */
+    if ((config == NULL) || (work == NULL) || (work_size < 0)) {
+        return NULL;
+    }
+
+    if (work_size < AE2Goertzel_CalculateWorkSize(config)) {
+        return NULL;
+    }
+
+    /* ハンドル領域割当 */
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work, AE2SLIDINGDFT_ALIGNMENT);
+    goertzel = (struct AE2Goertzel *)work_ptr;
+    goertzel->sampling_rate = config->sampling_rate;
+    goertzel->block_size = config->block_size;
+    goertzel->max_num_frequencies = config->max_num_frequencies;
+    goertzel->num_frequencies = 0;
+    work_ptr += sizeof(struct AE2Goertzel);
+
+    /* 各種バッファの領域割当 */
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    goertzel->window = (float *)work_ptr;
+    work_ptr += sizeof(float) * (size_t)config->block_size;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    goertzel->coefficients = (double *)work_ptr;
+    work_ptr += sizeof(double) * (size_t)config->max_num_frequencies;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    goertzel->twiddles = (double *)work_ptr;
+    work_ptr += sizeof(double) * 2 * (size_t)config->max_num_frequencies;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    goertzel->phase_twiddles = (double *)work_ptr;
+    work_ptr += sizeof(double) * 2 * (size_t)config->max_num_frequencies;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    goertzel->states = (double *)work_ptr;
+    work_ptr += sizeof(double) * 2 * (size_t)config->max_num_frequencies;
+    work_ptr = (uint8_t *)AE2SLIDINGDFT_ROUNDUP((uintptr_t)work_ptr, AE2SLIDINGDFT_ALIGNMENT);
+    goertzel->results = (float *)work_ptr;
+    work_ptr += sizeof(float) * 2 * (size_t)config->max_num_frequencies;
+
+    /* 窓の作成 */
+    AE2WindowFunction_MakeWindow(config->window_type, goertzel->window, (uint32_t)config->block_size);
+
+    /* 内部状態のリセット */
+    AE2Goertzel_Reset(goertzel);
+
+    return goertzel;
+}
+
+/* Goertzelバンク破棄 */
+void AE2Goertzel_Destroy(struct AE2Goertzel *goertzel)
+{
+    if (goertzel != NULL) {
+        /* 不定領域アクセス防止のため内容はクリア */
+        AE2Goertzel_Reset(goertzel);
+    }
+}
+
+/* Goertzelバンクリセット */
+void AE2Goertzel_Reset(struct AE2Goertzel *goertzel)
+{
+    assert(goertzel != NULL);
+
+    goertzel->count = 0;
+    memset(goertzel->states, 0, sizeof(double) * 2 * (size_t)goertzel->max_num_frequencies);
+    memset(goertzel->results, 0, sizeof(float) * 2 * (size_t)goertzel->max_num_frequencies);
+}
+
+/* 追跡する周波数の設定 */
+int32_t AE2Goertzel_SetFrequencies(struct AE2Goertzel *goertzel, const float *frequencies, int32_t num_frequencies)
+{
+    int32_t i;
+
+    assert(goertzel != NULL);
+
+    /* 引数チェック */
+    if ((frequencies == NULL) || (num_frequencies < 0) || (num_frequencies > goertzel->max_num_frequencies)) {
+        return -1;
+    }
+    for (i = 0; i < num_frequencies; i++) {
+        if ((frequencies[i] < 0.0f) || (frequencies[i] > 0.5f * goertzel->sampling_rate)) {
+            return -1;
+        }
+    }
+
+    goertzel->num_frequencies = num_frequencies;
+
+    for (i = 0; i < num_frequencies; i++) {
+        const double omega = (2.0 * AE2_PI * frequencies[i]) / goertzel->sampling_rate;
+        goertzel->coefficients[i] = 2.0 * cos(omega);
+        goertzel->twiddles[2 * i + 0] = cos(omega);
+        goertzel->twiddles[2 * i + 1] = -sin(omega);
+        goertzel->phase_twiddles[2 * i + 0] = cos(omega * (goertzel->block_size - 1));
+        goertzel->phase_twiddles[2 * i + 1] = -sin(omega * (goertzel->block_size - 1));
+    }
+
+    AE2Goertzel_Reset(goertzel);
+
+    return 0;
+}
+
+/* 入力サンプルの処理 */
+int32_t AE2Goertzel_Process(struct AE2Goertzel *goertzel, const float *input, int32_t num_samples)
+{
+    int32_t smpl, i, num_frequencies, num_blocks = 0;
+    const double *coefficients;
+    double *states;
+
+    assert(goertzel != NULL);
+    assert(input != NULL);
+    assert(num_samples >= 0);
+
+    num_frequencies = goertzel->num_frequencies;
+    coefficients = goertzel->coefficients;
+    states = goertzel->states;
+
+    for (smpl = 0; smpl < num_samples; smpl++) {
+        const double x = (double)input[smpl] * goertzel->window[goertzel->count];
+
+        /* 状態は倍精度で保持（低い周波数では係数が2に近く、単精度では桁落ちが大きい） */
+        for (i = 0; i < num_frequencies; i++) {
+            const double s0 = x + coefficients[i] * states[2 * i + 0] - states[2 * i + 1];
+            states[2 * i + 1] = states[2 * i + 0];
+            states[2 * i + 0] = s0;
+        }
+
+        goertzel->count++;
+        if (goertzel->count < goertzel->block_size) {
+            continue;
+        }
+
+        /* ブロック完了: y = s[N-1] - exp(-iω) s[N-2] にexp(-iω(N-1))を掛けてブロック先頭基準の値にする */
+        for (i = 0; i < num_frequencies; i++) {
+            const double s1 = states[2 * i + 0], s2 = states[2 * i + 1];
+            const double y_re = s1 - goertzel->twiddles[2 * i + 0] * s2;
+            const double y_im = -goertzel->twiddles[2 * i + 1] * s2;
+            const double p_re = goertzel->phase_twiddles[2 * i + 0];
+            const double p_im = goertzel->phase_twiddles[2 * i + 1];
+            goertzel->results[2 * i + 0] = (float)(y_re * p_re - y_im * p_im);
+            goertzel->results[2 * i + 1] = (float)(y_re * p_im + y_im * p_re);
+            /* ブロックごとに状態をクリアするため誤差は蓄積しない */
+            states[2 * i + 0] = states[2 * i + 1] = 0.0;
+        }
+        goertzel->count = 0;
+        num_blocks++;
+    }
+
+    return num_blocks;
+}
+
+/* 直近のブロックのスペクトルの取得 */
+void AE2Goertzel_GetSpectrum(const struct AE2Goertzel *goertzel, float *spectrum)
+{
+    assert(goertzel != NULL);
+    assert(spectrum != NULL);
+
+    memcpy(spectrum, goertzel->results, sizeof(float) * 2 * (size_t)goertzel->num_frequencies);
+}
+
+/* 直近のブロックのパワーの取得 */
+void AE2Goertzel_GetPower(const struct AE2Goertzel *goertzel, float *power)
+{
+    int32_t i;
+
+    assert(goertzel != NULL);
+    assert(power != NULL);
+
+    for (i = 0; i < goertzel->num_frequencies; i++) {
+        const float re = goertzel->results[2 * i + 0];
+        const float im = goertzel->results[2 * i + 1];
+        power[i] = re * re + im * im;
+    }
+}
@@ -17,6 +17,9 @@ typedef enum {
     AE2WINDOWFUNCTION_BLACKMAN, /*!< ブラックマン窓 */
 } AE2WindowFunctionType;
 
+/*! 余弦和で表される窓の最大項数 */
+#define AE2WINDOWFUNCTION_MAX_NUM_COSINE_TERMS 3
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -40,6 +43,16 @@ void AE2WindowFunction_MakeWindow(AE2WindowFunctionType type, float *window, uin
 */
 void AE2WindowFunction_ApplyWindow(AE2WindowFunctionType type, float *data, uint32_t num_samples);
 
+/*!
+* @brief 余弦和係数の取得
+* @param[in] type 窓関数タイプ
+* @param[out] coefficients 係数a[m]を受け取る領域(AE2WINDOWFUNCTION_MAX_NUM_COSINE_TERMSサイズ必須)
+* @return int32_t 項数
+* @note 窓はサイズLに対して w[x] = sum_m (-1)^m a[m] cos(2πmx / L) と表せます
+* @note AE2WindowFunction_MakeWindowはL = window_size - 1とした対称窓を作成します
+*/
+int32_t AE2WindowFunction_GetCosineSumCoefficients(AE2WindowFunctionType type, float *coefficients);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
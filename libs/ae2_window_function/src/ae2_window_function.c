@@ -143,3 +143,32 @@ void AE2WindowFunction_ApplyWindow(AE2WindowFunctionType type, float *data, uint
         assert(0);
     }
 }
+
+/* 余弦和係数の取得 */
+int32_t AE2WindowFunction_GetCosineSumCoefficients(AE2WindowFunctionType type, float *coefficients)
+{
+    assert(coefficients != NULL);
+
+    switch (type) {
+    case AE2WINDOWFUNCTION_RECTANGULAR:
+        coefficients[0] = 1.0f;
+        return 1;
+    case AE2WINDOWFUNCTION_HANN:
+        coefficients[0] = 0.5f;
+        coefficients[1] = 0.5f;
+        return 2;
+    case AE2WINDOWFUNCTION_HAMMING:
+        coefficients[0] = 0.54f;
+        coefficients[1] = 0.46f;
+        return 2;
+    case AE2WINDOWFUNCTION_BLACKMAN:
+        coefficients[0] = 0.42f;
+        coefficients[1] = 0.5f;
+        coefficients[2] = 0.08f;
+        return 3;
+    default:
+        assert(0);
+    }
+
+    return 0;
+}
@@ -8,11 +8,15 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
-#include "ae2_zerolatency_fft_convolve.h"
 
 #include <cstring>
 
 namespace {
+    // 周波数領域畳み込みの分割サイズ
+    // ブロックサイズに依存させないことで、ブロックサイズが変わっても変換済みの係数を再利用できる
+    const uint32_t convPartitionSize = 512;
+    // ブロックサイズ毎に再利用のため保持する処理状態の最大数
+    const size_t maxNumPooledStates = 4;
     // デフォルトのインパルス
     const float defaultImpulse[] = { 1.0f, 0.0f, 0.0f, 0.0f };
     const float *pdefaultImpulse[] = { defaultImpulse, defaultImpulse };
@@ -33,56 +37,39 @@ AE2AudioProcessor::AE2AudioProcessor()
 {
     const uint32_t defaultNumChannels = sizeof(pdefaultImpulse) / sizeof(pdefaultImpulse[0]);
     const uint32_t defaultImpulseLength = sizeof(defaultImpulse) / sizeof(defaultImpulse[0]);
+    struct AE2ConvolveConfig convConfig;
 
     // インターフェース取得
     convInterface = AE2ZeroLatencyFFTConvolve_GetInterface();
+    maxNumInputSamples = 512; // PrepareToPlayが実行されるまでの仮値
 
-    // 畳み込みオブジェクト作成
-    {
-        convConfig.max_num_input_samples = 512; // PrepareToPlayが実行されるまでの仮値
-        convConfig.max_num_coefficients = defaultImpulseLength;
-        convWorkSize = convInterface->CalculateWorkSize(&convConfig);
-        convWork = new uint8_t*[defaultNumChannels];
-        conv = new void*[defaultNumChannels];
-        for (uint32_t channel = 0; channel < defaultNumChannels; channel++) {
-            convWork[channel] = new uint8_t[static_cast<size_t>(convWorkSize)];
-            conv[channel] = convInterface->Create(&convConfig, convWork[channel], convWorkSize);
-        }
-    }
+    // 仮のインパルスを変換
+    convConfig.max_num_input_samples = maxNumInputSamples;
+    convConfig.partition_size = convPartitionSize;
+    convConfig.max_num_coefficients = defaultImpulseLength;
+    spectra = std::make_shared<ImpulseSpectra>(convConfig, pdefaultImpulse, defaultNumChannels, defaultImpulseLength);
+    spectra->build();
 
-    // 信号処理バッファ
-    pcm_buffer = new float[convConfig.max_num_input_samples];
-
-    // インパルス信号記録領域
-    impulse = new float*[defaultNumChannels];
-    for (uint32_t channel = 0; channel < defaultNumChannels; channel++) {
-        impulse[channel] = new float[defaultImpulseLength];
-    }
+    // 最初の処理状態はこの場で作成して適用
+    activeState = new ConvolverState(convInterface, maxNumInputSamples, spectra);
+    activeState->build();
 
-    // 仮のインパルスを設定
-    channelCounts = defaultNumChannels;
-    impulseLength = defaultImpulseLength;
-    setImpulse(pdefaultImpulse, channelCounts, impulseLength);
+    // 使用を終えた処理状態の回収
+    startTimer(100);
 }
 
 AE2AudioProcessor::~AE2AudioProcessor()
 {
-    // インパルスの破棄
-    for (uint32_t channel = 0; channel < channelCounts; channel++) {
-        delete[] impulse[channel];
-    }
-    delete[] impulse;
+    // 作成中の処理状態を待ってから全て破棄
+    stopTimer();
+    stateBuilder.removeAllJobs(true, -1);
+    delete activeState;
+    delete nextState.exchange(nullptr);
+    delete retiredState.exchange(nullptr);
+    statePool.clear();
 
-    // 信号処理バッファの破棄
-    delete[] pcm_buffer;
-
-    // 畳み込みオブジェクトの破棄
-    for (uint32_t channel = 0; channel < channelCounts; channel++) {
-        convInterface->Destroy(conv[channel]);
-        delete[] convWork[channel];
-    }
-    delete[] convWork;
-    delete[] conv;
+    // インパルスの破棄（処理状態から参照されなくなった時点で解放される）
+    spectra.reset();
 
     convInterface = nullptr;
 }
@@ -158,31 +145,29 @@ void AE2AudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 {
     ignoreUnused (sampleRate);
 
-    // 入力サンプル数が変わった場合はインスタンスを作り直す
-    if (convConfig.max_num_input_samples != static_cast<uint32_t>(samplesPerBlock))
+    // 入力サンプル数が変わった場合は処理状態を切り替える
+    // 切り替えが済むまでは前の状態で、ブロックを分割して処理する
+    if (maxNumInputSamples != static_cast<uint32_t>(samplesPerBlock))
     {
-        convLock.enter();
+        maxNumInputSamples = static_cast<uint32_t>(samplesPerBlock);
 
-        convConfig.max_num_input_samples = static_cast<uint32_t>(samplesPerBlock);
-        convWorkSize = convInterface->CalculateWorkSize(&convConfig);
-        for (uint32_t channel = 0; channel < channelCounts; channel++)
+        // 以前に使った入力サンプル数であれば、保持していた状態をリセットしてそのまま使う（確保も変換も行わない）
+        auto pooled = statePool.find(maxNumInputSamples);
+        if (pooled != statePool.end())
         {
-            convInterface->Destroy(conv[channel]);
-            delete[] convWork[channel];
-            convWork[channel] = new uint8_t[static_cast<size_t>(convWorkSize)];
-            conv[channel] = convInterface->Create(&convConfig, convWork[channel], convWorkSize);
+            auto* state = pooled->second.release();
+            statePool.erase(pooled);
+            state->reset();
+            // 作成中の古い要求より優先させる
+            stateBuilder.removeAllJobs(false, 0);
+            publishConvolverState(state, ++latestRequestId);
+        }
+        else
+        {
+            // 変換済みの係数を参照するインスタンスのみ作成する
+            requestConvolverState();
         }
-
-        // 信号処理バッファ再度割当
-        delete[] pcm_buffer;
-        pcm_buffer = new float[convConfig.max_num_input_samples];
-
-        convLock.exit();
-
-        // インパルスも再設定
-        setImpulse((const float **)impulse, channelCounts, impulseLength);
     }
-
 }
 
 void AE2AudioProcessor::releaseResources()
@@ -220,7 +205,6 @@ void AE2AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::Mi
     ScopedNoDenormals noDenormals;
     int totalNumInputChannels = getTotalNumInputChannels();
     int totalNumOutputChannels = getTotalNumOutputChannels();
-    int processChannels = jmin(static_cast<int>(channelCounts), totalNumInputChannels);
     int processSamples = buffer.getNumSamples();
 
     ignoreUnused (midiMessages);
@@ -228,16 +212,34 @@ void AE2AudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::Mi
     for (int i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, processSamples);
 
-    convLock.enter();
+    // 新しい処理状態が公開されていれば切り替える
+    // 前の状態の回収が済むまでは切り替えない（回収待ちの状態は1つのみ）
+    if (retiredState.load(std::memory_order_acquire) == nullptr)
+    {
+        if (auto* state = nextState.exchange(nullptr, std::memory_order_acq_rel))
+        {
+            retiredState.store(activeState, std::memory_order_release);
+            activeState = state;
+        }
+    }
+
+    auto* state = activeState;
+    int processChannels = jmin(static_cast<int>(state->channelCounts), totalNumInputChannels);
+    int maxBlockSamples = static_cast<int>(state->convConfig.max_num_input_samples);
+
     for (int channel = 0; channel < processChannels; ++channel)
     {
         auto* input = buffer.getReadPointer (channel);
         auto* output = buffer.getWritePointer (channel);
-        // inputとoutputが同じ領域を指している場合があるのでバッファにコピー
-        memcpy(pcm_buffer, input, sizeof(float) * static_cast<size_t>(processSamples));
-        convInterface->Convolve(conv[channel], pcm_buffer, output, static_cast<uint32_t>(processSamples));
+        // 状態の作成時よりブロックが大きい場合は分割して処理
+        for (int offset = 0; offset < processSamples; offset += maxBlockSamples)
+        {
+            int blockSamples = jmin(maxBlockSamples, processSamples - offset);
+            // inputとoutputが同じ領域を指している場合があるのでバッファにコピー
+            memcpy(state->pcm_buffer, input + offset, sizeof(float) * static_cast<size_t>(blockSamples));
+            state->convInterface->Convolve(state->conv[channel], state->pcm_buffer, output + offset, static_cast<uint32_t>(blockSamples));
+        }
     }
-    convLock.exit();
 }
 
 //==============================================================================
@@ -266,54 +268,210 @@ void AE2AudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 // インパルスの設定
 void AE2AudioProcessor::setImpulse (const float* const* impulse, uint32_t channelCounts, uint32_t impulseLength)
 {
-    convLock.enter();
+    struct AE2ConvolveConfig convConfig;
+
+    // インパルスのコピーのみここで行い、変換はバックグラウンドで行う
+    convConfig.max_num_input_samples = maxNumInputSamples;
+    convConfig.partition_size = convPartitionSize;
+    convConfig.max_num_coefficients = impulseLength;
+    spectra = std::make_shared<ImpulseSpectra>(convConfig, impulse, channelCounts, impulseLength);
+
+    // 保持していた状態は古いインパルスを参照しているので破棄
+    statePool.clear();
+
+    requestConvolverState();
+}
+
+// 現在のインパルスと設定で処理状態の作成を要求
+void AE2AudioProcessor::requestConvolverState()
+{
+    // 処理状態の作成ジョブ
+    class BuildJob : public juce::ThreadPoolJob
+    {
+    public:
+        BuildJob (AE2AudioProcessor& owner, ConvolverState *state, uint32_t requestId)
+            : juce::ThreadPoolJob ("AE2SimpleConvolver state builder"), owner (owner), state (state), requestId (requestId)
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            // インパルスが未変換であれば変換（同じインパルスの要求が続いた場合は最初の1回のみ）
+            if (state->spectra->sharedImpulse == nullptr) {
+                state->spectra->build();
+            }
+            state->build();
+            owner.publishConvolverState(state.release(), requestId);
+            return jobHasFinished;
+        }
+
+    private:
+        AE2AudioProcessor& owner;
+        std::unique_ptr<ConvolverState> state; // 実行されずに破棄された場合も解放される
+        uint32_t requestId;
+    };
+
+    // 作成前の古い要求は不要なので取り消す（作成中のものは待たない）
+    stateBuilder.removeAllJobs(false, 0);
+
+    stateBuilder.addJob(new BuildJob(*this,
+        new ConvolverState(convInterface, maxNumInputSamples, spectra), ++latestRequestId), true);
+}
+
+// 作成した処理状態の公開
+void AE2AudioProcessor::publishConvolverState (ConvolverState *state, uint32_t requestId)
+{
+    const juce::ScopedLock lock (publishLock);
 
-    // インスタンスを破棄
-    for (uint32_t channel = 0; channel < this->channelCounts; channel++) {
-        convInterface->Destroy(conv[channel]);
-        delete[] convWork[channel];
+    // 作成中に新しい要求があった場合は公開しない
+    if (requestId != latestRequestId.load())
+    {
+        delete state;
+        return;
     }
-    delete[] convWork;
-    delete[] conv;
 
-    // 記録してあったインパルスを破棄
-    if (impulse != this->impulse) {
-        for (uint32_t channel = 0; channel < this->channelCounts; channel++) {
-            delete[] this->impulse[channel];
+    // 置き換えた未適用の状態はオーディオスレッドが一度も参照していないので、その場で破棄できる
+    delete nextState.exchange(state, std::memory_order_acq_rel);
+}
+
+// 使用を終えた処理状態の回収
+void AE2AudioProcessor::timerCallback()
+{
+    auto* state = retiredState.exchange(nullptr, std::memory_order_acq_rel);
+
+    if (state == nullptr)
+        return;
+
+    // 現在のインパルスを参照していれば、入力サンプル数が戻ったときのために保持
+    const uint32_t key = state->convConfig.max_num_input_samples;
+    if ((state->spectra == spectra) && (key != maxNumInputSamples)
+        && (statePool.size() < maxNumPooledStates) && (statePool.count(key) == 0))
+    {
+        statePool[key].reset(state);
+    }
+    else
+    {
+        delete state;
+    }
+}
+
+// インパルスの記録（コピーのみ）
+AE2AudioProcessor::ImpulseSpectra::ImpulseSpectra (const AE2ConvolveConfig& convConfig,
+    const float* const* impulse, uint32_t channelCounts, uint32_t impulseLength)
+    : convConfig (convConfig), sharedImpulse (nullptr), sharedImpulseWork (nullptr), sharedImpulseWorkSize (0),
+      channelCounts (channelCounts), impulseLength (impulseLength)
+{
+    this->impulse = new float*[channelCounts];
+    for (uint32_t channel = 0; channel < channelCounts; channel++) {
+        this->impulse[channel] = new float[impulseLength];
+        memcpy(this->impulse[channel], impulse[channel], sizeof(float) * impulseLength);
+    }
+}
+
+// インパルスの変換
+void AE2AudioProcessor::ImpulseSpectra::build()
+{
+    jassert(sharedImpulse == nullptr);
+
+    // 同じインパルスのチャンネル間ではフーリエ変換済みの係数を共有し、変換も1回で済ませる
+    sharedImpulseWorkSize = AE2ZeroLatencyFFTConvolve_CalculateSharedCoefficientsWorkSize(&convConfig);
+    auto **shared = new AE2ZeroLatencyFFTConvolveSharedCoefficients*[channelCounts];
+    sharedImpulseWork = new uint8_t*[channelCounts];
+    for (uint32_t channel = 0; channel < channelCounts; channel++) {
+        shared[channel] = nullptr;
+        sharedImpulseWork[channel] = nullptr;
+        for (uint32_t prev = 0; prev < channel; prev++) {
+            if (memcmp(impulse[prev], impulse[channel], sizeof(float) * impulseLength) == 0) {
+                shared[channel] = shared[prev];
+                break;
+            }
+        }
+        if (shared[channel] == nullptr) {
+            sharedImpulseWork[channel] = new uint8_t[static_cast<size_t>(sharedImpulseWorkSize)];
+            shared[channel] = AE2ZeroLatencyFFTConvolve_CreateSharedCoefficients(&convConfig,
+                impulse[channel], impulseLength, sharedImpulseWork[channel], sharedImpulseWorkSize);
+            jassert(shared[channel] != nullptr);
         }
-        delete[] this->impulse;
     }
 
-    // 現在のインパルス情報を記録
-    this->channelCounts = channelCounts;
-    this->impulseLength = impulseLength;
+    // 変換済みの印として最後にセット
+    sharedImpulse = shared;
+}
 
-    // インスタンスを再度作成
-    convConfig.max_num_coefficients = impulseLength;
-    convWorkSize = convInterface->CalculateWorkSize(&convConfig);
+// インパルスの破棄
+AE2AudioProcessor::ImpulseSpectra::~ImpulseSpectra()
+{
+    // 参照していた処理状態は全て破棄済み
+    if (sharedImpulse != nullptr) {
+        for (uint32_t channel = 0; channel < channelCounts; channel++) {
+            if (sharedImpulseWork[channel] != nullptr) {
+                AE2ZeroLatencyFFTConvolve_DestroySharedCoefficients(sharedImpulse[channel]);
+                delete[] sharedImpulseWork[channel];
+            }
+        }
+    }
+    delete[] sharedImpulseWork;
+    delete[] sharedImpulse;
+
+    for (uint32_t channel = 0; channel < channelCounts; channel++) {
+        delete[] impulse[channel];
+    }
+    delete[] impulse;
+}
+
+// 処理状態の作成（確保はbuildで行う）
+AE2AudioProcessor::ConvolverState::ConvolverState (const AE2ConvolveInterface *convInterface,
+    uint32_t maxNumInputSamples, std::shared_ptr<ImpulseSpectra> spectra)
+    : convInterface (convInterface), convConfig (spectra->convConfig), spectra (spectra),
+      conv (nullptr), convWork (nullptr), convWorkSize (0),
+      pcm_buffer (nullptr), channelCounts (spectra->channelCounts)
+{
+    // 分割サイズと係数長は変換済みの係数に合わせ、入力サンプル数のみ変える
+    convConfig.max_num_input_samples = maxNumInputSamples;
+}
+
+// 畳み込みインスタンスの作成
+void AE2AudioProcessor::ConvolverState::build()
+{
+    jassert((conv == nullptr) && (spectra->sharedImpulse != nullptr));
+
+    // 信号処理バッファ
+    pcm_buffer = new float[convConfig.max_num_input_samples];
+
+    // 変換済みの係数を参照するインスタンスを作成
+    convWorkSize = AE2ZeroLatencyFFTConvolve_CalculateSharedWorkSize(&convConfig);
     convWork = new uint8_t*[channelCounts];
     conv = new void*[channelCounts];
+    const juce::ScopedLock referenceLock (spectra->referenceLock);
     for (uint32_t channel = 0; channel < channelCounts; channel++) {
         convWork[channel] = new uint8_t[static_cast<size_t>(convWorkSize)];
-        conv[channel] = convInterface->Create(&convConfig, convWork[channel], convWorkSize);
+        conv[channel] = AE2ZeroLatencyFFTConvolve_CreateShared(&convConfig, spectra->sharedImpulse[channel], convWork[channel], convWorkSize);
         jassert(conv[channel] != NULL);
     }
+}
 
-    // インパルスを記録
-    if (impulse != this->impulse) {
-        this->impulse = new float*[channelCounts];
-        for (uint32_t channel = 0; channel < channelCounts; channel++) {
-            this->impulse[channel] = new float[impulseLength];
-            memcpy(this->impulse[channel], impulse[channel], sizeof(float) * impulseLength);
-        }
-    }
-
-    // インパルス設定
+// 内部状態のリセット
+void AE2AudioProcessor::ConvolverState::reset()
+{
     for (uint32_t channel = 0; channel < channelCounts; channel++) {
-        convInterface->SetCoefficients(conv[channel], impulse[channel], impulseLength);
+        convInterface->Reset(conv[channel]);
     }
+}
 
-    convLock.exit();
+// 処理状態の破棄
+AE2AudioProcessor::ConvolverState::~ConvolverState()
+{
+    // 共有係数の参照数は複数のスレッドから操作されるため、ロックして破棄
+    if (conv != nullptr) {
+        const juce::ScopedLock referenceLock (spectra->referenceLock);
+        for (uint32_t channel = 0; channel < channelCounts; channel++) {
+            convInterface->Destroy(conv[channel]);
+            delete[] convWork[channel];
+        }
+    }
+    delete[] convWork;
+    delete[] conv;
+    delete[] pcm_buffer;
 }
 
 //==============================================================================
@@ -9,12 +9,17 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <atomic>
+#include <map>
+#include <memory>
 #include "ae2_convolve.h"
+#include "ae2_zerolatency_fft_convolve.h"
 
 //==============================================================================
 /**
 */
-class AE2AudioProcessor  : public juce::AudioProcessor
+class AE2AudioProcessor  : public juce::AudioProcessor,
+                           private juce::Timer
 {
 public:
     //==============================================================================
@@ -61,13 +66,72 @@ private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AE2AudioProcessor)
 
-    void **conv;
-    uint8_t **convWork;
-    int32_t convWorkSize;
+    // インパルスとフーリエ変換済みの係数
+    // 分割サイズをブロックサイズから切り離しているため、ブロックサイズが変わっても変換し直さずに共有できる
+    class ImpulseSpectra
+    {
+    public:
+        // インパルスのコピーのみ行う（呼び出し元スレッドで実行）
+        ImpulseSpectra (const AE2ConvolveConfig& convConfig, const float* const* impulse, uint32_t channelCounts, uint32_t impulseLength);
+        ~ImpulseSpectra();
+
+        // インパルスの変換（バックグラウンドスレッドで実行）
+        void build();
+
+        struct AE2ConvolveConfig convConfig; // 変換に使用した設定（partition_sizeとmax_num_coefficientsはインスタンスと一致させる）
+        AE2ZeroLatencyFFTConvolveSharedCoefficients **sharedImpulse; // チャンネル毎の参照先（同じインパルスのチャンネル間で共有）
+        uint8_t **sharedImpulseWork; // 共有係数の領域（他チャンネルの係数を参照する場合はnullptr）
+        int32_t sharedImpulseWorkSize;
+        float **impulse;
+        uint32_t channelCounts, impulseLength;
+        juce::CriticalSection referenceLock; // 共有係数の参照数を操作する（インスタンスを作成・破棄する）間のロック
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (ImpulseSpectra)
+    };
+
+    // 畳み込み処理状態
+    // バックグラウンドスレッドで作成し、オーディオスレッドへはポインタの交換で渡す
+    class ConvolverState
+    {
+    public:
+        ConvolverState (const AE2ConvolveInterface *convInterface, uint32_t maxNumInputSamples, std::shared_ptr<ImpulseSpectra> spectra);
+        ~ConvolverState();
+
+        // 畳み込みインスタンスの作成（バックグラウンドスレッドで実行）
+        void build();
+        // 内部状態のリセット（再利用時）
+        void reset();
+
+        const AE2ConvolveInterface *convInterface;
+        struct AE2ConvolveConfig convConfig;
+        std::shared_ptr<ImpulseSpectra> spectra;
+        void **conv;
+        uint8_t **convWork;
+        int32_t convWorkSize;
+        float *pcm_buffer;
+        uint32_t channelCounts;
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (ConvolverState)
+    };
+
+    // 現在のインパルスと設定で処理状態の作成を要求
+    void requestConvolverState();
+    // 作成した処理状態の公開（要求が古くなっていれば破棄する）
+    void publishConvolverState (ConvolverState *state, uint32_t requestId);
+    // 使用を終えた処理状態の回収（メッセージスレッド）
+    void timerCallback() override;
+
     const AE2ConvolveInterface *convInterface;
-    struct AE2ConvolveConfig convConfig;
-    CriticalSection convLock;
-    float *pcm_buffer;
-    float **impulse;
-    uint32_t channelCounts, impulseLength;
+    uint32_t maxNumInputSamples; // 次に作成する処理状態の最大入力サンプル数（メッセージスレッドのみ操作）
+    std::shared_ptr<ImpulseSpectra> spectra; // 最後に設定されたインパルス（メッセージスレッドのみ操作）
+    std::map<uint32_t, std::unique_ptr<ConvolverState>> statePool; // 最大入力サンプル数毎に再利用を待つ状態（メッセージスレッドのみ操作）
+
+    juce::ThreadPool stateBuilder { 1 }; // 処理状態を作成するスレッド
+    std::atomic<uint32_t> latestRequestId { 0 }; // 最後に要求した処理状態の番号
+    juce::CriticalSection publishLock; // 要求番号の確認と公開の間のロック（オーディオスレッドは取らない）
+    ConvolverState *activeState; // 処理中の状態（オーディオスレッドのみ操作）
+    std::atomic<ConvolverState*> nextState { nullptr }; // 公開済みで未適用の状態
+    std::atomic<ConvolverState*> retiredState { nullptr }; // 使用を終え回収を待つ状態
 };
@@ -63,6 +63,22 @@ AE2SpectrumAnalyzerAudioProcessor::AE2SpectrumAnalyzerAudioProcessor()
     // いったん矩形窓を作成
     AE2WindowFunction_MakeWindow(AE2WINDOWFUNCTION_RECTANGULAR, window, maxFFTSize);
     windowFunctionType = Rectangular;
+
+    // 選択可能な全FFTサイズのプランを作成
+    // 補足）回転因子の計算はここで済ませ、processBlockでは三角関数を呼ばない
+    // 補足）FFTサイズは全て2の冪乗なので、作業領域を持たないインプレース変換のプランにする
+    for (int i = 0; i < numFFTSizes; i++) {
+        AE2FFTPlanConfig config;
+        config.fft_size = 256 * (1 << i);
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        config.in_place = 1;
+        config.double_precision = 0;
+        const int32_t workSize = AE2FFTPlan_CalculateWorkSize(&config);
+        jassert(workSize >= 0);
+        fftPlanWorks[i] = new uint8_t[workSize];
+        fftPlans[i] = AE2FFTPlan_Create(&config, fftPlanWorks[i], workSize);
+        jassert(fftPlans[i] != NULL);
+    }
 }
 
 AE2SpectrumAnalyzerAudioProcessor::~AE2SpectrumAnalyzerAudioProcessor()
@@ -71,6 +87,11 @@ AE2SpectrumAnalyzerAudioProcessor::~AE2SpectrumAnalyzerAudioProcessor()
         AE2RingBuffer_Destroy(ringBuffer);
         delete[] ringBufferWork;
     }
+
+    for (int i = 0; i < numFFTSizes; i++) {
+        AE2FFTPlan_Destroy(fftPlans[i]);
+        delete[] fftPlanWorks[i];
+    }
 }
 
 //==============================================================================
@@ -214,6 +235,8 @@ void AE2SpectrumAnalyzerAudioProcessor::processBlock (juce::AudioBuffer<float>&
         || (windowFunctionType != static_cast<int>(*windowFunction))
         || (currentSlideSamples != getNumSlideSamples())) {
         currentFFTSize = getFFTSizeParameterInt();
+        currentFFTPlan = fftPlans[static_cast<int>(*fftSize)];
+        jassert(AE2FFTPlan_GetFFTSize(currentFFTPlan) == currentFFTSize);
         windowFunctionType = static_cast<int>(*windowFunction);
         currentSlideSamples = getNumSlideSamples();
 
@@ -268,17 +291,14 @@ void AE2SpectrumAnalyzerAudioProcessor::processBlock (juce::AudioBuffer<float>&
             for (int smpl = 0; smpl < currentFFTSize; smpl++) {
                 analyzedSpectrum[smpl] *= (regularization_factor * window[smpl]);
             }
-            // FFT
-            AE2FFT_RealFFT(currentFFTSize, -1, analyzedSpectrum, fftWork);
+            // FFT（直流からナイキスト周波数までのn/2+1点の半スペクトルを出力）
+            AE2FFTPlan_RealFFTHalfSpectrum(currentFFTPlan, analyzedSpectrum, analyzedSpectrum);
             // パワーを計算
-            analyzedSpectrum[0] = analyzedSpectrum[0] * analyzedSpectrum[0]; // 直流成分
-            const float nypuistPower = analyzedSpectrum[1] * analyzedSpectrum[1]; // ナイキスト周波数成分
-            for (int bin = 1; bin < currentFFTSize / 2; bin++) {
+            for (int bin = 0; bin <= currentFFTSize / 2; bin++) {
                 analyzedSpectrum[bin]
                     = AE2FFTCOMPLEX_REAL(analyzedSpectrum, bin) * AE2FFTCOMPLEX_REAL(analyzedSpectrum, bin)
                     + AE2FFTCOMPLEX_IMAG(analyzedSpectrum, bin) * AE2FFTCOMPLEX_IMAG(analyzedSpectrum, bin);
             }
-            analyzedSpectrum[currentFFTSize / 2] = nypuistPower;
             // dBに変換
             // TODO: 外観に関する部分なのでEditorがやるべき
             for (int bin = 0; bin <= currentFFTSize / 2; bin++) {
@@ -11,6 +11,7 @@
 #include <JuceHeader.h>
 
 #include "ae2_ring_buffer.h"
+#include "ae2_fft.h"
 
 //==============================================================================
 /**
@@ -60,12 +61,13 @@ public:
 
     int currentAnalyzeChannel = 0; //! 解析対象のチャンネル
     static const int maxFFTSize = 1 << 14; //! 最大のFFTサイズ
+    static const int numFFTSizes = 7; //! 選択可能なFFTサイズの数
 
     double sampleRate = 0.0; //! サンプリングレート
 
     ReadWriteLock analyzeLock; //! 解析データの排他制御
     float analyzedWave[maxFFTSize]; //! 解析対象の波形
-    float analyzedSpectrum[maxFFTSize]; //! スペクトラム
+    float analyzedSpectrum[maxFFTSize + 2]; //! スペクトラム（FFT時はn/2+1点の複素数を格納）
     float peakSpectrum[(maxFFTSize / 2) + 1]; //! スペクトラムピーク
     bool peakHoldEnable = false; //! ピークホールド有効？
 
@@ -96,7 +98,9 @@ private:
 
     std::atomic<AE2RingBuffer *> ringBuffer = NULL; //! 音声データのリングバッファ
     uint8_t *ringBufferWork = nullptr; //! リングバッファのワーク領域
-    float fftWork[maxFFTSize]; //! FFT実行用のワーク領域
+    AE2FFTPlan *fftPlans[numFFTSizes]; //! FFTサイズ毎のFFTプラン
+    uint8_t *fftPlanWorks[numFFTSizes]; //! FFTプランのワーク領域
+    AE2FFTPlan *currentFFTPlan = nullptr; //! 現在のFFTサイズに対応するFFTプラン
     int currentFFTSize = 0; //! 現在のFFTサイズ
     int currentSlideSamples = 0; //! スライド幅
     float window[maxFFTSize]; //! 窓
@@ -11,8 +11,11 @@
 #endif
 
 /* テスト対象のモジュール */
+#include "../../libs/ae2_convolve/include/ae2_crossfade_convolve.h"
 #include "../../libs/ae2_convolve/include/ae2_karatsuba.h"
+#include "../../libs/ae2_convolve/include/ae2_mimo_fft_convolve.h"
 #include "../../libs/ae2_convolve/include/ae2_fft_convolve.h"
+#include "../../libs/ae2_convolve/include/ae2_nonuniform_fft_convolve.h"
 #include "../../libs/ae2_convolve/include/ae2_zerolatency_fft_convolve.h"
 
 /* 直接畳み込み（リファレンス） */
@@ -250,6 +253,7 @@ TEST(AE2ConvolveTest, ConvolveTest)
 
     config.max_num_coefficients = 200;
     config.max_num_input_samples = 256;
+    config.partition_size = 0;
     ConvolveCheck(AE2Karatsuba_GetInterface(), &config);
     ConvolveCheck(AE2FFTConvolve_GetInterface(), &config);
     ConvolveCheck(AE2ZeroLatencyFFTConvolve_GetInterface(), &config);
@@ -258,6 +262,503 @@ TEST(AE2ConvolveTest, ConvolveTest)
     config.max_num_input_samples = 512;
     ConvolveCheck(AE2FFTConvolve_GetInterface(), &config);
     ConvolveCheck(AE2ZeroLatencyFFTConvolve_GetInterface(), &config);
+
+    /* 分割サイズを明示的に指定 */
+    config.max_num_coefficients = 3000;
+    config.max_num_input_samples = 480;
+    config.partition_size = 480;
+    ConvolveCheck(AE2FFTConvolve_GetInterface(), &config);
+    ConvolveCheck(AE2ZeroLatencyFFTConvolve_GetInterface(), &config);
+    config.max_num_input_samples = 32;
+    config.partition_size = 0;
+    ConvolveCheck(AE2FFTConvolve_GetInterface(), &config);
+    ConvolveCheck(AE2ZeroLatencyFFTConvolve_GetInterface(), &config);
+    config.max_num_input_samples = 4096;
+    ConvolveCheck(AE2FFTConvolve_GetInterface(), &config);
+    ConvolveCheck(AE2ZeroLatencyFFTConvolve_GetInterface(), &config);
+}
+
+/* 非一様分割畳み込みの一致確認テスト */
+TEST(AE2ConvolveTest, NonUniformConvolveTest)
+{
+    struct AE2ConvolveConfig config;
+
+    /* 分割FFT畳み込みを使わない短い係数 */
+    config.max_num_coefficients = 200;
+    config.max_num_input_samples = 256;
+    config.partition_size = 0;
+    ConvolveCheck(AE2NonUniformFFTConvolve_GetInterface(), &config);
+
+    /* 64, 256, 1024, 4096の4段 */
+    config.max_num_coefficients = 6000;
+    config.max_num_input_samples = 64;
+    ConvolveCheck(AE2NonUniformFFTConvolve_GetInterface(), &config);
+
+    /* 最小分割サイズを明示し、入力サンプル数を分割サイズより大きくする */
+    config.max_num_coefficients = 3000;
+    config.max_num_input_samples = 512;
+    config.partition_size = 16;
+    ConvolveCheck(AE2NonUniformFFTConvolve_GetInterface(), &config);
+}
+
+TEST(AE2ConvolveTest, NonUniformAsyncConvolveTest)
+{
+    const struct AE2ConvolveInterface *convif = AE2NonUniformFFTConvolve_GetAsyncInterface();
+    struct AE2ConvolveConfig config;
+    int32_t work_size;
+    void *work, *conv;
+    float *input, *coef, *answer, *test;
+    uint32_t smpl;
+    const uint32_t NUM_COEFS = 12000;
+    const uint32_t NUM_SAMPLES = 30000;
+
+    /* 64, 256, 1024の段に続いて4096の段をバックグラウンドで処理する */
+    config.max_num_coefficients = NUM_COEFS;
+    config.max_num_input_samples = 100;
+    config.partition_size = 64;
+
+    work_size = convif->CalculateWorkSize(&config);
+    ASSERT_TRUE(work_size >= 0);
+    work = malloc((size_t)work_size);
+    conv = convif->Create(&config, work, work_size);
+    ASSERT_TRUE(conv != NULL);
+
+    input = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    coef = (float *)malloc(sizeof(float) * NUM_COEFS);
+    answer = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    test = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+
+    srand(0);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[smpl] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    for (smpl = 0; smpl < NUM_COEFS; smpl++) {
+        coef[smpl] = 0.01f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    DirectConvolve(coef, NUM_COEFS, input, answer, NUM_SAMPLES);
+
+    convif->SetCoefficients(conv, coef, NUM_COEFS);
+
+    /* 毎回バックグラウンド処理を呼べば締め切りに間に合い、直接畳み込みと一致する */
+    smpl = 0;
+    while (smpl < NUM_SAMPLES) {
+        const uint32_t num_block_samples = MIN((uint32_t)rand() % (config.max_num_input_samples + 1), NUM_SAMPLES - smpl);
+        convif->Convolve(conv, &input[smpl], &test[smpl], num_block_samples);
+        AE2NonUniformFFTConvolve_ProcessBackground(conv);
+        smpl += num_block_samples;
+    }
+    EXPECT_EQ(0U, AE2NonUniformFFTConvolve_GetNumMissedDeadlines(conv));
+    EXPECT_EQ(0, convif->GetLatencyNumSamples(conv));
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        if (fabs(answer[smpl] - test[smpl]) > FLOAT_EPSILON) {
+            printf("test failed. %d answer:%f actual:%f diff:%e \n", smpl, answer[smpl], test[smpl], fabs(answer[smpl] - test[smpl]));
+            FAIL();
+        }
+    }
+
+    /* バックグラウンド処理を呼ばなければ締め切りに間に合わない */
+    convif->Reset(conv);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl += config.max_num_input_samples) {
+        convif->Convolve(conv, &input[smpl], &test[smpl], MIN(config.max_num_input_samples, NUM_SAMPLES - smpl));
+    }
+    EXPECT_GT(AE2NonUniformFFTConvolve_GetNumMissedDeadlines(conv), 0U);
+
+    /* リセットで締め切り超過数も戻る */
+    convif->Reset(conv);
+    EXPECT_EQ(0U, AE2NonUniformFFTConvolve_GetNumMissedDeadlines(conv));
+
+    convif->Destroy(conv);
+    free(work);
+    free(input);
+    free(coef);
+    free(answer);
+    free(test);
 }
 
 
+
+TEST(AE2ConvolveTest, FFTSharedCoefficientsConvolveTest)
+{
+    const struct AE2ConvolveInterface *convif = AE2FFTConvolve_GetInterface();
+    struct AE2ConvolveConfig config;
+    struct AE2FFTConvolveSharedCoefficients *shared;
+    int32_t work_size, shared_work_size, coef_work_size;
+    void *work, *coef_work, *conv, *shared_conv[2], *shared_work[2];
+    float *input, *coef, *answer, *test;
+    uint32_t smpl, i;
+    const uint32_t NUM_COEFS = 3000;
+    const uint32_t NUM_SAMPLES = 10000;
+
+    config.max_num_coefficients = NUM_COEFS;
+    config.max_num_input_samples = 256;
+    config.partition_size = 0;
+
+    /* 係数を持たない分だけワークサイズが小さい */
+    work_size = convif->CalculateWorkSize(&config);
+    shared_work_size = AE2FFTConvolve_CalculateSharedWorkSize(&config);
+    ASSERT_TRUE(shared_work_size >= 0);
+    EXPECT_LT(shared_work_size, work_size);
+
+    input = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    coef = (float *)malloc(sizeof(float) * NUM_COEFS);
+    answer = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    test = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    srand(0);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[smpl] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    for (smpl = 0; smpl < NUM_COEFS; smpl++) {
+        coef[smpl] = 0.05f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+
+    /* 係数を自身で保持するインスタンスの結果を正解とする */
+    work = malloc((size_t)work_size);
+    conv = convif->Create(&config, work, work_size);
+    ASSERT_TRUE(conv != NULL);
+    convif->SetCoefficients(conv, coef, NUM_COEFS);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl += config.max_num_input_samples) {
+        convif->Convolve(conv, &input[smpl], &answer[smpl], MIN(config.max_num_input_samples, NUM_SAMPLES - smpl));
+    }
+
+    /* 共有係数作成 */
+    coef_work_size = AE2FFTConvolve_CalculateSharedCoefficientsWorkSize(&config);
+    ASSERT_TRUE(coef_work_size >= 0);
+    coef_work = malloc((size_t)coef_work_size);
+    shared = AE2FFTConvolve_CreateSharedCoefficients(&config, coef, NUM_COEFS, coef_work, coef_work_size);
+    ASSERT_TRUE(shared != NULL);
+    EXPECT_EQ(0U, AE2FFTConvolve_GetSharedCoefficientsNumReferences(shared));
+
+    /* 共有係数を参照するインスタンスを複数作成 */
+    for (i = 0; i < 2; i++) {
+        shared_work[i] = malloc((size_t)shared_work_size);
+        shared_conv[i] = AE2FFTConvolve_CreateShared(&config, shared, shared_work[i], shared_work_size);
+        ASSERT_TRUE(shared_conv[i] != NULL);
+        EXPECT_EQ(i + 1, AE2FFTConvolve_GetSharedCoefficientsNumReferences(shared));
+    }
+
+    /* どのインスタンスも係数を保持するインスタンスと一致 */
+    for (i = 0; i < 2; i++) {
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl += config.max_num_input_samples) {
+            convif->Convolve(shared_conv[i], &input[smpl], &test[smpl], MIN(config.max_num_input_samples, NUM_SAMPLES - smpl));
+        }
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+            if (fabs(answer[smpl] - test[smpl]) > FLOAT_EPSILON) {
+                printf("test failed. %d answer:%f actual:%f diff:%e \n", smpl, answer[smpl], test[smpl], fabs(answer[smpl] - test[smpl]));
+                FAIL();
+            }
+        }
+    }
+
+    /* 分割サイズが異なるコンフィグでは参照できない */
+    config.partition_size = 64;
+    work_size = AE2FFTConvolve_CalculateSharedWorkSize(&config);
+    EXPECT_TRUE(AE2FFTConvolve_CreateShared(&config, shared, work, work_size) == NULL);
+    EXPECT_EQ(2U, AE2FFTConvolve_GetSharedCoefficientsNumReferences(shared));
+
+    /* 破棄で参照数が減る */
+    for (i = 0; i < 2; i++) {
+        convif->Destroy(shared_conv[i]);
+        EXPECT_EQ(1 - i, AE2FFTConvolve_GetSharedCoefficientsNumReferences(shared));
+        free(shared_work[i]);
+    }
+    AE2FFTConvolve_DestroySharedCoefficients(shared);
+
+    convif->Destroy(conv);
+    free(work);
+    free(coef_work);
+    free(input);
+    free(coef);
+    free(answer);
+    free(test);
+}
+
+TEST(AE2ConvolveTest, ZeroLatencySharedCoefficientsConvolveTest)
+{
+    const struct AE2ConvolveInterface *convif = AE2ZeroLatencyFFTConvolve_GetInterface();
+    struct AE2ConvolveConfig config;
+    struct AE2ZeroLatencyFFTConvolveSharedCoefficients *shared;
+    int32_t shared_work_size, coef_work_size;
+    void *coef_work, *shared_conv[2], *shared_work[2];
+    float *input, *coef, *answer, *test;
+    uint32_t smpl, i, c;
+    const uint32_t NUM_SAMPLES = 8000;
+    /* 時間領域畳み込みのみで済む長さと、周波数領域畳み込みも使う長さ */
+    const uint32_t num_coefs_list[] = { 500, 5000 };
+
+    config.max_num_coefficients = 5000;
+    config.max_num_input_samples = 128;
+    config.partition_size = 0;
+
+    shared_work_size = AE2ZeroLatencyFFTConvolve_CalculateSharedWorkSize(&config);
+    ASSERT_TRUE(shared_work_size >= 0);
+    EXPECT_LT(shared_work_size, convif->CalculateWorkSize(&config));
+    coef_work_size = AE2ZeroLatencyFFTConvolve_CalculateSharedCoefficientsWorkSize(&config);
+    ASSERT_TRUE(coef_work_size >= 0);
+
+    input = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    coef = (float *)malloc(sizeof(float) * config.max_num_coefficients);
+    answer = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    test = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    coef_work = malloc((size_t)coef_work_size);
+    for (i = 0; i < 2; i++) {
+        shared_work[i] = malloc((size_t)shared_work_size);
+    }
+    srand(0);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[smpl] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    for (smpl = 0; smpl < config.max_num_coefficients; smpl++) {
+        coef[smpl] = 0.02f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+
+    for (c = 0; c < sizeof(num_coefs_list) / sizeof(num_coefs_list[0]); c++) {
+        const uint32_t num_coefs = num_coefs_list[c];
+
+        DirectConvolve(coef, num_coefs, input, answer, NUM_SAMPLES);
+
+        shared = AE2ZeroLatencyFFTConvolve_CreateSharedCoefficients(&config, coef, num_coefs, coef_work, coef_work_size);
+        ASSERT_TRUE(shared != NULL);
+
+        for (i = 0; i < 2; i++) {
+            shared_conv[i] = AE2ZeroLatencyFFTConvolve_CreateShared(&config, shared, shared_work[i], shared_work_size);
+            ASSERT_TRUE(shared_conv[i] != NULL);
+        }
+        EXPECT_EQ(2U, AE2ZeroLatencyFFTConvolve_GetSharedCoefficientsNumReferences(shared));
+
+        for (i = 0; i < 2; i++) {
+            EXPECT_EQ(0, convif->GetLatencyNumSamples(shared_conv[i]));
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl += config.max_num_input_samples) {
+                convif->Convolve(shared_conv[i], &input[smpl], &test[smpl], MIN(config.max_num_input_samples, NUM_SAMPLES - smpl));
+            }
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                if (fabs(answer[smpl] - test[smpl]) > FLOAT_EPSILON) {
+                    printf("test failed. %d answer:%f actual:%f diff:%e \n", smpl, answer[smpl], test[smpl], fabs(answer[smpl] - test[smpl]));
+                    FAIL();
+                }
+            }
+        }
+
+        for (i = 0; i < 2; i++) {
+            convif->Destroy(shared_conv[i]);
+        }
+        EXPECT_EQ(0U, AE2ZeroLatencyFFTConvolve_GetSharedCoefficientsNumReferences(shared));
+        AE2ZeroLatencyFFTConvolve_DestroySharedCoefficients(shared);
+    }
+
+    for (i = 0; i < 2; i++) {
+        free(shared_work[i]);
+    }
+    free(coef_work);
+    free(input);
+    free(coef);
+    free(answer);
+    free(test);
+}
+
+TEST(AE2ConvolveTest, MIMOConvolveTest)
+{
+    struct AE2MIMOFFTConvolveConfig config;
+    struct AE2MIMOFFTConvolve *conv;
+    int32_t work_size, latency;
+    void *work;
+    float *input[2], *output[3], *coef[2][3], *answer, *tmp;
+    uint32_t smpl, in, out;
+    const uint32_t NUM_INPUTS = 2;
+    const uint32_t NUM_OUTPUTS = 3;
+    const uint32_t NUM_SAMPLES = 10000;
+    /* 組毎に異なる係数長（0は寄与なし） */
+    const uint32_t num_coefs[2][3] = { { 1000, 0, 37 }, { 2500, 300, 0 } };
+
+    config.num_inputs = NUM_INPUTS;
+    config.num_outputs = NUM_OUTPUTS;
+    config.max_num_coefficients = 2500;
+    config.max_num_input_samples = 200;
+    config.partition_size = 128;
+
+    work_size = AE2MIMOFFTConvolve_CalculateWorkSize(&config);
+    ASSERT_TRUE(work_size >= 0);
+    work = malloc((size_t)work_size);
+    conv = AE2MIMOFFTConvolve_Create(&config, work, work_size);
+    ASSERT_TRUE(conv != NULL);
+    latency = AE2MIMOFFTConvolve_GetLatencyNumSamples(conv);
+    EXPECT_EQ(128, latency);
+
+    srand(0);
+    for (in = 0; in < NUM_INPUTS; in++) {
+        input[in] = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+        for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+            input[in][smpl] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+        }
+        for (out = 0; out < NUM_OUTPUTS; out++) {
+            coef[in][out] = (float *)malloc(sizeof(float) * config.max_num_coefficients);
+            for (smpl = 0; smpl < num_coefs[in][out]; smpl++) {
+                coef[in][out][smpl] = 0.02f * ((float)rand() / RAND_MAX - 0.5f);
+            }
+            AE2MIMOFFTConvolve_SetCoefficients(conv, in, out, coef[in][out], num_coefs[in][out]);
+        }
+    }
+    for (out = 0; out < NUM_OUTPUTS; out++) {
+        output[out] = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    }
+    answer = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    tmp = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+
+    /* 不定長のブロックで処理 */
+    smpl = 0;
+    while (smpl < NUM_SAMPLES) {
+        const uint32_t num_block_samples = MIN((uint32_t)rand() % (config.max_num_input_samples + 1), NUM_SAMPLES - smpl);
+        const float *in_ptr[2];
+        float *out_ptr[3];
+        for (in = 0; in < NUM_INPUTS; in++) {
+            in_ptr[in] = &input[in][smpl];
+        }
+        for (out = 0; out < NUM_OUTPUTS; out++) {
+            out_ptr[out] = &output[out][smpl];
+        }
+        AE2MIMOFFTConvolve_Convolve(conv, in_ptr, out_ptr, num_block_samples);
+        smpl += num_block_samples;
+    }
+
+    /* 各出力は全入力の直接畳み込みの和をレイテンシ分遅らせたもの */
+    for (out = 0; out < NUM_OUTPUTS; out++) {
+        memset(answer, 0, sizeof(float) * NUM_SAMPLES);
+        for (in = 0; in < NUM_INPUTS; in++) {
+            DirectConvolve(coef[in][out], num_coefs[in][out], input[in], tmp, NUM_SAMPLES);
+            for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+                answer[smpl] += tmp[smpl];
+            }
+        }
+        for (smpl = 0; smpl < (uint32_t)latency; smpl++) {
+            EXPECT_FLOAT_EQ(0.0f, output[out][smpl]);
+        }
+        for (smpl = (uint32_t)latency; smpl < NUM_SAMPLES; smpl++) {
+            if (fabs(answer[smpl - latency] - output[out][smpl]) > FLOAT_EPSILON) {
+                printf("test failed. out:%d %d answer:%f actual:%f \n", out, smpl, answer[smpl - latency], output[out][smpl]);
+                FAIL();
+            }
+        }
+    }
+
+    AE2MIMOFFTConvolve_Destroy(conv);
+    free(work);
+    for (in = 0; in < NUM_INPUTS; in++) {
+        free(input[in]);
+        for (out = 0; out < NUM_OUTPUTS; out++) {
+            free(coef[in][out]);
+        }
+    }
+    for (out = 0; out < NUM_OUTPUTS; out++) {
+        free(output[out]);
+    }
+    free(answer);
+    free(tmp);
+}
+
+TEST(AE2ConvolveTest, CrossfadeSwapConvolveTest)
+{
+    struct AE2CrossfadeConvolveConfig config;
+    struct AE2CrossfadeConvolve *conv;
+    int32_t work_size;
+    void *work;
+    float *input, *coef[2], *answer, *test, *split_input[2], *split;
+    uint32_t smpl, i;
+    const uint32_t NUM_COEFS = 3000;
+    const uint32_t NUM_SAMPLES = 20000;
+    const uint32_t BLOCK_SIZE = 100;
+    const uint32_t SWAP_POS = 8000; /* BLOCK_SIZEの倍数 */
+    const uint32_t NUM_CROSSFADE_SAMPLES = 1050;
+
+    config.conv_if = AE2ZeroLatencyFFTConvolve_GetInterface();
+    config.conv_config.max_num_coefficients = NUM_COEFS;
+    config.conv_config.max_num_input_samples = BLOCK_SIZE;
+    config.conv_config.partition_size = 0;
+
+    work_size = AE2CrossfadeConvolve_CalculateWorkSize(&config);
+    ASSERT_TRUE(work_size >= 0);
+    work = malloc((size_t)work_size);
+    conv = AE2CrossfadeConvolve_Create(&config, work, work_size);
+    ASSERT_TRUE(conv != NULL);
+    EXPECT_EQ(0, AE2CrossfadeConvolve_GetLatencyNumSamples(conv));
+
+    input = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    answer = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    test = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    split_input[0] = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    split_input[1] = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    split = (float *)malloc(sizeof(float) * NUM_SAMPLES);
+    srand(0);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[smpl] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    for (i = 0; i < 2; i++) {
+        coef[i] = (float *)malloc(sizeof(float) * NUM_COEFS);
+        for (smpl = 0; smpl < NUM_COEFS; smpl++) {
+            coef[i][smpl] = 0.02f * ((float)rand() / RAND_MAX - 0.5f);
+        }
+    }
+
+    AE2CrossfadeConvolve_SetCoefficients(conv, coef[0], NUM_COEFS);
+    EXPECT_EQ(1, AE2CrossfadeConvolve_IsSwapCompleted(conv));
+
+    /* 差し替え位置まで */
+    for (smpl = 0; smpl < SWAP_POS; smpl += BLOCK_SIZE) {
+        AE2CrossfadeConvolve_Convolve(conv, &input[smpl], &test[smpl], BLOCK_SIZE);
+    }
+
+    /* 差し替え要求。完了するまで次の差し替えは受け付けない */
+    EXPECT_EQ(0, AE2CrossfadeConvolve_SwapCoefficients(conv, coef[1], NUM_COEFS, NUM_CROSSFADE_SAMPLES));
+    EXPECT_EQ(0, AE2CrossfadeConvolve_IsSwapCompleted(conv));
+    EXPECT_TRUE(AE2CrossfadeConvolve_SwapCoefficients(conv, coef[0], NUM_COEFS, NUM_CROSSFADE_SAMPLES) < 0);
+
+    for (smpl = SWAP_POS; smpl < SWAP_POS + NUM_CROSSFADE_SAMPLES + NUM_COEFS - BLOCK_SIZE; smpl += BLOCK_SIZE) {
+        AE2CrossfadeConvolve_Convolve(conv, &input[smpl], &test[smpl], BLOCK_SIZE);
+    }
+    /* フェード後も古い係数の残響が鳴り終わるまでは完了しない */
+    EXPECT_EQ(0, AE2CrossfadeConvolve_IsSwapCompleted(conv));
+    for (; smpl < NUM_SAMPLES; smpl += BLOCK_SIZE) {
+        AE2CrossfadeConvolve_Convolve(conv, &input[smpl], &test[smpl], BLOCK_SIZE);
+    }
+    EXPECT_EQ(1, AE2CrossfadeConvolve_IsSwapCompleted(conv));
+
+    /* 差し替え前は古い係数の畳み込み（リセットによる途切れはない） */
+    DirectConvolve(coef[0], NUM_COEFS, input, answer, NUM_SAMPLES);
+    for (smpl = 0; smpl < SWAP_POS; smpl++) {
+        if (fabs(answer[smpl] - test[smpl]) > FLOAT_EPSILON) {
+            printf("test failed. %d answer:%f actual:%f \n", smpl, answer[smpl], test[smpl]);
+            FAIL();
+        }
+    }
+
+    /* 差し替え以降は入力を新旧に振り分けてそれぞれの係数で畳み込んだものの和 */
+    /* 差し替え前の入力による古い係数の残響は途切れない */
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        float gain = 0.0f;
+        if (smpl >= SWAP_POS + NUM_CROSSFADE_SAMPLES) {
+            gain = 1.0f;
+        } else if (smpl >= SWAP_POS) {
+            gain = (float)(smpl - SWAP_POS + 1) / NUM_CROSSFADE_SAMPLES;
+        }
+        split_input[1][smpl] = gain * input[smpl];
+        split_input[0][smpl] = input[smpl] - split_input[1][smpl];
+    }
+    DirectConvolve(coef[0], NUM_COEFS, split_input[0], answer, NUM_SAMPLES);
+    DirectConvolve(coef[1], NUM_COEFS, split_input[1], split, NUM_SAMPLES);
+    for (smpl = SWAP_POS; smpl < NUM_SAMPLES; smpl++) {
+        const float expected = answer[smpl] + split[smpl];
+        if (fabs(expected - test[smpl]) > FLOAT_EPSILON) {
+            printf("test failed. %d answer:%f actual:%f \n", smpl, expected, test[smpl]);
+            FAIL();
+        }
+    }
+
+    AE2CrossfadeConvolve_Destroy(conv);
+    free(work);
+    free(input);
+    free(answer);
+    free(test);
+    free(split_input[0]);
+    free(split_input[1]);
+    free(split);
+    free(coef[0]);
+    free(coef[1]);
+}
@@ -0,0 +1,148 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+
+/* FFT畳み込みのベンチマーク */
+/* 公開インターフェースのみを使うため、変更前のツリーに対しても同じ条件で計測できる */
+/* BUILD_AE2_BENCHMARKSを有効にした場合のみビルドされ、ctestでは実行されない */
+#include "../../libs/ae2_convolve/include/ae2_fft_convolve.h"
+
+#define NUM_BLOCK_SAMPLES 256 /* 1ブロックのサンプル数 */
+#define NUM_BLOCKS 2000 /* 計測するブロック数 */
+#define NUM_TRIALS 3 /* 試行回数（最良値を採用） */
+
+/* 経過時間[us] */
+static double ElapsedMicroseconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+/* 1ブロックあたりの畳み込み時間[us]を計測 */
+static double MeasureConvolve(uint32_t num_coefficients, const float *input)
+{
+    const struct AE2ConvolveInterface *convif = AE2FFTConvolve_GetInterface();
+    struct AE2ConvolveConfig config;
+    int32_t work_size;
+    void *work, *conv;
+    float *coef, output[NUM_BLOCK_SAMPLES];
+    uint32_t i, trial;
+    double best = 0.0;
+
+    config.max_num_coefficients = num_coefficients;
+    config.max_num_input_samples = NUM_BLOCK_SAMPLES;
+    config.partition_size = 0;
+    if ((work_size = convif->CalculateWorkSize(&config)) < 0) {
+        return -1.0;
+    }
+    work = malloc((size_t)work_size);
+    conv = convif->Create(&config, work, work_size);
+
+    coef = (float *)malloc(sizeof(float) * num_coefficients);
+    srand(0);
+    for (i = 0; i < num_coefficients; i++) {
+        coef[i] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+    convif->SetCoefficients(conv, coef, num_coefficients);
+
+    for (trial = 0; trial < NUM_TRIALS; trial++) {
+        std::chrono::steady_clock::time_point start;
+        double elapsed;
+        convif->Reset(conv);
+        start = std::chrono::steady_clock::now();
+        for (i = 0; i < NUM_BLOCKS; i++) {
+            convif->Convolve(conv, &input[i * NUM_BLOCK_SAMPLES], output, NUM_BLOCK_SAMPLES);
+        }
+        elapsed = ElapsedMicroseconds(start) / NUM_BLOCKS;
+        if ((trial == 0) || (elapsed < best)) {
+            best = elapsed;
+        }
+    }
+
+    convif->Destroy(conv);
+    free(coef);
+    free(work);
+
+    return best;
+}
+
+/* 遅延線の回転（分割毎のGet/Putと新しいスペクトルのコピー）に相当するコピーの1ブロックあたりの時間[us]を計測 */
+static double MeasureRotationCopy(uint32_t num_partitions, uint32_t fft_size, uint32_t num_hops)
+{
+    float *spectra, *spectrum;
+    uint32_t i, hop, part, trial;
+    double best = 0.0;
+
+    spectra = (float *)calloc((size_t)num_partitions * fft_size, sizeof(float));
+    spectrum = (float *)calloc(fft_size, sizeof(float));
+
+    for (trial = 0; trial < NUM_TRIALS; trial++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        double elapsed;
+        for (i = 0; i < NUM_BLOCKS; i++) {
+            for (hop = 0; hop < num_hops; hop++) {
+                /* 古い分割を1つずつずらす */
+                for (part = num_partitions - 1; part > 0; part--) {
+                    memcpy(&spectra[part * fft_size], &spectra[(part - 1) * fft_size], sizeof(float) * fft_size);
+                }
+                /* 新しいスペクトルを先頭に書き込む */
+                spectrum[i % fft_size] += 1.0f;
+                memcpy(spectra, spectrum, sizeof(float) * fft_size);
+            }
+        }
+        elapsed = ElapsedMicroseconds(start) / NUM_BLOCKS;
+        if ((trial == 0) || (elapsed < best)) {
+            best = elapsed;
+        }
+    }
+
+    /* 最適化でコピーが消えないよう結果を参照 */
+    if (spectra[(num_partitions - 1) * fft_size] < 0.0f) {
+        printf("unexpected\n");
+    }
+
+    free(spectrum);
+    free(spectra);
+
+    return best;
+}
+
+int main(void)
+{
+    const uint32_t num_coefficients[] = { 48000, 96000, 192000 };
+    float *input;
+    uint32_t i;
+
+    input = (float *)malloc(sizeof(float) * NUM_BLOCK_SAMPLES * NUM_BLOCKS);
+    srand(1);
+    for (i = 0; i < NUM_BLOCK_SAMPLES * NUM_BLOCKS; i++) {
+        input[i] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+
+    printf("AE2FFTConvolve: %d blocks of %d samples, best of %d trials\n", NUM_BLOCKS, NUM_BLOCK_SAMPLES, NUM_TRIALS);
+    printf("%8s %6s %12s %14s %14s %14s\n",
+            "taps", "parts", "convolve[us]", "rotation[us]", "saved[MB/blk]", "muladd[MB/blk]");
+
+    for (i = 0; i < sizeof(num_coefficients) / sizeof(num_coefficients[0]); i++) {
+        /* 分割サイズは入力サンプル数と同じ（partition_size = 0）。FFT点数とスペクトルのfloat数は分割サイズの2倍 */
+        const uint32_t partition_size = NUM_BLOCK_SAMPLES;
+        const uint32_t fft_size = 2 * partition_size;
+        const uint32_t num_partitions = (num_coefficients[i] + partition_size - 1) / partition_size;
+        const uint32_t num_hops = NUM_BLOCK_SAMPLES / partition_size;
+        /* 回転で不要になった読み書き: (N - 1)分割のコピーと新しいスペクトルのコピー */
+        const double saved_bytes = (double)num_hops * 2.0 * ((num_partitions - 1) + 1) * fft_size * sizeof(float);
+        /* 複素乗算/加算が読むバイト数: 入力スペクトルと係数スペクトル */
+        const double muladd_bytes = (double)num_hops * 2.0 * num_partitions * fft_size * sizeof(float);
+        const double convolve_us = MeasureConvolve(num_coefficients[i], input);
+        const double rotation_us = MeasureRotationCopy(num_partitions, fft_size, num_hops);
+
+        printf("%8u %6u %12.1f %14.1f %14.2f %14.2f\n",
+                num_coefficients[i], num_partitions, convolve_us, rotation_us,
+                saved_bytes / (1024.0 * 1024.0), muladd_bytes / (1024.0 * 1024.0));
+    }
+
+    free(input);
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+
+/* カラツバ法の分岐点（基底サイズ）のキャリブレーション */
+/* 各カーネルの基底サイズを変えて畳み込み時間を計測し、サイズ毎に最速の基底サイズを表示する */
+/* 結果はae2_karatsuba.c, ae2_karatsuba_kernel_*.cのカーネル定義（base_size）に反映する */
+/* BUILD_AE2_BENCHMARKSを有効にした場合のみビルドされ、ctestでは実行されない */
+extern "C" {
+#include "../../libs/ae2_convolve/src/ae2_karatsuba.c"
+}
+
+#define MIN_N 64 /* 計測する最小サイズ */
+#define MAX_N 1024 /* 計測する最大サイズ */
+#define MIN_BASE_SIZE 4 /* 計測する最小の基底サイズ */
+#define NUM_REPEATS 200 /* 1回の計測での畳み込み回数 */
+#define NUM_TRIALS 5 /* 試行回数（最良値を採用） */
+
+/* 1回の畳み込み時間[us]を計測 */
+static double MeasureKaratsuba(const struct AE2KaratsubaKernel *kernel, const float *a, const float *b, float *z, uint32_t n)
+{
+    uint32_t i, trial;
+    double best = 0.0;
+
+    for (trial = 0; trial < NUM_TRIALS; trial++) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        double elapsed;
+        for (i = 0; i < NUM_REPEATS; i++) {
+            AE2Karatsuba_ConvolveKaratsuba(kernel, a, b, z, n);
+        }
+        elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / NUM_REPEATS;
+        if ((trial == 0) || (elapsed < best)) {
+            best = elapsed;
+        }
+    }
+
+    /* 最適化で計算が消えないよう結果を参照 */
+    if (z[0] != z[0]) {
+        printf("unexpected\n");
+    }
+
+    return best;
+}
+
+int main(void)
+{
+    const struct AE2KaratsubaKernel *kernels[3];
+    static float a[MAX_N], b[MAX_N], z[6 * MAX_N];
+    uint32_t i, k, n, base_size;
+
+    srand(0);
+    for (i = 0; i < MAX_N; i++) {
+        a[i] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+        b[i] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+
+    kernels[0] = AE2KaratsubaKernel_GetScalar();
+    kernels[1] = AE2Karatsuba_CPUSupportsSSE2() ? AE2KaratsubaKernel_GetSSE2() : NULL;
+    kernels[2] = AE2Karatsuba_CPUSupportsAVX2FMA() ? AE2KaratsubaKernel_GetAVX2() : NULL;
+
+    printf("AE2Karatsuba: time per convolution [us], best of %d trials of %d runs\n", NUM_TRIALS, NUM_REPEATS);
+
+    for (k = 0; k < 3; k++) {
+        if (kernels[k] == NULL) {
+            continue;
+        }
+
+        printf("\nkernel: %s (current base size: %u)\n", kernels[k]->name, kernels[k]->base_size);
+        printf("%6s", "n");
+        for (base_size = MIN_BASE_SIZE; base_size <= AE2KARATSUBA_MAX_BASE_SIZE; base_size <<= 1) {
+            printf(" %8u", base_size);
+        }
+        printf(" %6s\n", "best");
+
+        for (n = MIN_N; n <= MAX_N; n <<= 1) {
+            uint32_t best_base_size = 0;
+            double best = 0.0;
+            printf("%6u", n);
+            for (base_size = MIN_BASE_SIZE; base_size <= AE2KARATSUBA_MAX_BASE_SIZE; base_size <<= 1) {
+                struct AE2KaratsubaKernel kernel = *kernels[k];
+                double elapsed;
+                kernel.base_size = base_size;
+                elapsed = MeasureKaratsuba(&kernel, a, b, z, n);
+                printf(" %8.2f", elapsed);
+                if ((best_base_size == 0) || (elapsed < best)) {
+                    best = elapsed;
+                    best_base_size = base_size;
+                }
+            }
+            printf(" %6u\n", best_base_size);
+        }
+    }
+
+    return 0;
+}
@@ -7,3 +7,62 @@
 extern "C" {
 #include "../../libs/ae2_convolve/src/ae2_karatsuba.c"
 }
+
+#include <math.h>
+
+/* 全カーネル・基底サイズでの畳み込み一致確認テスト */
+TEST(AE2KaratsubaTest, KernelConsistencyTest)
+{
+#define MAX_N 1024
+#define KARATSUBA_FLOAT_EPSILON 1e-3
+    uint32_t n, i, j, k, base_size;
+    const struct AE2KaratsubaKernel *kernels[3];
+    static float a[MAX_N], b[MAX_N], z[6 * MAX_N];
+    static double ref[2 * MAX_N];
+
+    srand(0);
+    for (i = 0; i < MAX_N; i++) {
+        a[i] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+        b[i] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+
+    kernels[0] = AE2KaratsubaKernel_GetScalar();
+    kernels[1] = AE2Karatsuba_CPUSupportsSSE2() ? AE2KaratsubaKernel_GetSSE2() : NULL;
+    kernels[2] = AE2Karatsuba_CPUSupportsAVX2FMA() ? AE2KaratsubaKernel_GetAVX2() : NULL;
+
+    for (n = 1; n <= MAX_N; n <<= 1) {
+        /* 正解は倍精度の直接畳み込み */
+        for (i = 0; i < 2 * n; i++) {
+            ref[i] = 0.0;
+        }
+        for (j = 0; j < n; j++) {
+            for (i = 0; i < n; i++) {
+                ref[i + j] += (double)a[i] * b[j];
+            }
+        }
+
+        for (k = 0; k < 3; k++) {
+            if (kernels[k] == NULL) {
+                continue;
+            }
+            /* 分岐点を変えても結果が変わらない（SIMDカーネルの小サイズ処理も含む） */
+            for (base_size = 1; base_size <= AE2KARATSUBA_MAX_BASE_SIZE; base_size <<= 1) {
+                struct AE2KaratsubaKernel kernel = *kernels[k];
+                int32_t is_ok = 1;
+                kernel.base_size = base_size;
+                AE2Karatsuba_ConvolveKaratsuba(&kernel, a, b, z, n);
+                for (i = 0; i < 2 * n; i++) {
+                    if (fabs(ref[i] - z[i]) > KARATSUBA_FLOAT_EPSILON) {
+                        printf("test failed. kernel:%s base:%d n:%d %d answer:%f actual:%f \n",
+                                kernel.name, base_size, n, i, ref[i], z[i]);
+                        is_ok = 0;
+                        break;
+                    }
+                }
+                EXPECT_EQ(1, is_ok);
+            }
+        }
+    }
+#undef MAX_N
+#undef KARATSUBA_FLOAT_EPSILON
+}
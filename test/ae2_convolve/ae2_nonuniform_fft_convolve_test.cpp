@@ -0,0 +1,9 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+/* テスト対象のモジュール */
+extern "C" {
+#include "../../libs/ae2_convolve/src/ae2_nonuniform_fft_convolve.c"
+}
@@ -7,3 +7,41 @@
 extern "C" {
 #include "../../libs/ae2_convolve/src/ae2_zerolatency_fft_convolve.c"
 }
+
+/* 既定の分割サイズが入力サンプル数に依存しないことの確認 */
+TEST(AE2ZeroLatencyFFTConvolveTest, DefaultPartitionSizeTest)
+{
+    uint32_t i;
+    struct AE2ConvolveConfig config;
+    const uint32_t num_input_samples[] = { 1, 32, 64, 480, 1024, 4096 };
+
+    config.max_num_coefficients = 8192;
+    config.partition_size = 0;
+    for (i = 0; i < sizeof(num_input_samples) / sizeof(num_input_samples[0]); i++) {
+        int32_t work_size;
+        void *work;
+        struct AE2ZeroLatencyFFTConvolve *conv;
+
+        config.max_num_input_samples = num_input_samples[i];
+        EXPECT_EQ((uint32_t)AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS,
+                AE2ZeroLatencyFFTConvolve_CalculatePartitionSize(&config));
+
+        /* 後半の周波数領域畳み込みも同じ分割サイズで作られる */
+        work_size = AE2ZeroLatencyFFTConvolve_GetInterface()->CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+        conv = (struct AE2ZeroLatencyFFTConvolve *)AE2ZeroLatencyFFTConvolve_GetInterface()->Create(&config, work, work_size);
+        ASSERT_TRUE(conv != NULL);
+        EXPECT_EQ(AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS,
+                conv->freq_conv_if->GetLatencyNumSamples(conv->freq_conv_obj));
+        AE2ZeroLatencyFFTConvolve_GetInterface()->Destroy(conv);
+        free(work);
+    }
+
+    /* 明示的に指定した場合はそれに従う */
+    config.max_num_input_samples = 32;
+    config.partition_size = 256;
+    EXPECT_EQ(256u, AE2ZeroLatencyFFTConvolve_CalculatePartitionSize(&config));
+    config.partition_size = 4096;
+    EXPECT_EQ((uint32_t)AE2BARACONVOLVE_NUM_TIMEDOMAIN_COEFFICIENTS, AE2ZeroLatencyFFTConvolve_CalculatePartitionSize(&config));
+}
@@ -1,6 +1,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 /* テスト対象のモジュール */
@@ -8,6 +11,11 @@ extern "C" {
 #include "../../libs/ae2_fft/src/ae2_fft.c"
 }
 
+#include "ae2_czt.h"
+#include "ae2_dct.h"
+#include "ae2_large_fft.h"
+#include "ae2_fft.hpp"
+
 /*!
 * @brief DFT
 * @param[in] n DFT点数
@@ -37,6 +45,35 @@ static void AE2FFTTest_FloatDFT(int n, int flag, const float *input, float *outp
     }
 }
 
+/*!
+* @brief 倍精度で計算するDFT
+* @param[in] n DFT点数
+* @param[in] flag -1:順方向変換, 1:逆方向変換
+* @param[in] input フーリエ変換する系列(入出力 2nサイズ必須, 偶数番目に実数部, 奇数番目に虚数部)
+* @param[out] output 出力配列(xと同一サイズ)
+* @note 正規化は行いません。点数が大きい場合の参照値として使用
+*/
+static void AE2FFTTest_PreciseDFT(int n, int flag, const float *input, float *output)
+{
+    int32_t i, k;
+
+    assert(input != NULL);
+    assert(output != NULL);
+    assert((flag == 1) || (flag == -1));
+
+    for (k = 0; k < n; k++) {
+        double re = 0.0, im = 0.0;
+        for (i = 0; i < n; i++) {
+            const double theta = 2.0 * AE2_PI * (double)((int64_t)i * k % n) / n;
+            const double wr = cos(theta), wi = flag * sin(theta);
+            re += input[2 * i] * wr - input[2 * i + 1] * wi;
+            im += input[2 * i] * wi + input[2 * i + 1] * wr;
+        }
+        output[2 * k] = (float)re;
+        output[2 * k + 1] = (float)im;
+    }
+}
+
 /* Fastルーチンの結果一致テスト */
 TEST(AE2FFTTest, CheckWithDFTTest)
 {
@@ -369,8 +406,1927 @@ TEST(AE2FFTTest, CheckWithDFTTest)
     }
 }
 
+/* プラン作成破棄テスト */
+TEST(AE2FFTTest, PlanCreateDestroyTest)
+{
+    /* ワークサイズ計算テスト */
+    {
+        int32_t work_size;
+        struct AE2FFTPlanConfig config;
+
+        /* 簡単な成功例 */
+        config.fft_size = 16;
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        config.in_place = 0;
+        config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size >= (int32_t)sizeof(struct AE2FFTPlan));
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size >= (int32_t)sizeof(struct AE2FFTPlan));
+
+        /* 不正な引数 */
+        work_size = AE2FFTPlan_CalculateWorkSize(NULL);
+        EXPECT_TRUE(work_size < 0);
+
+        /* 混合基底で表せるFFT点数 */
+        config.fft_size = 480;
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size >= (int32_t)sizeof(struct AE2FFTPlan));
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size >= (int32_t)sizeof(struct AE2FFTPlan));
+
+        /* 2, 3, 5の積で表せないFFT点数 */
+        config.fft_size = 14;
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+        config.fft_size = 1;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+
+        /* 奇数点の実数FFT */
+        config.fft_size = 15;
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        config.fft_size = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+        /* インプレース変換は2の冪乗のみ */
+        config.fft_size = 16;
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        config.in_place = 1;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size >= (int32_t)sizeof(struct AE2FFTPlan));
+        config.fft_size = 480;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        config.fft_size = 960;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+    }
+
+    /* ワーク領域渡しによるプラン作成（成功例） */
+    {
+        void *work;
+        int32_t work_size;
+        struct AE2FFTPlanConfig config;
+        struct AE2FFTPlan *plan;
+
+        config.fft_size = 16;
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        config.in_place = 0;
+        config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+
+        plan = AE2FFTPlan_Create(&config, work, work_size);
+        EXPECT_TRUE(plan != NULL);
+        EXPECT_EQ(16, AE2FFTPlan_GetFFTSize(plan));
+
+        AE2FFTPlan_Destroy(plan);
+        free(work);
+    }
+
+    /* ワーク領域渡しによるプラン作成（失敗ケース） */
+    {
+        void *work;
+        int32_t work_size;
+        struct AE2FFTPlanConfig config;
+        struct AE2FFTPlan *plan;
+
+        config.fft_size = 16;
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        config.in_place = 0;
+        config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+
+        /* 引数が不正 */
+        plan = AE2FFTPlan_Create(NULL, work, work_size);
+        EXPECT_TRUE(plan == NULL);
+        plan = AE2FFTPlan_Create(&config, NULL, work_size);
+        EXPECT_TRUE(plan == NULL);
+        plan = AE2FFTPlan_Create(&config, work, 0);
+        EXPECT_TRUE(plan == NULL);
+
+        /* ワークサイズ不足 */
+        plan = AE2FFTPlan_Create(&config, work, work_size - 1);
+        EXPECT_TRUE(plan == NULL);
+
+        free(work);
+    }
+}
+
+/* プランを使用したFFTの結果一致テスト */
+TEST(AE2FFTTest, PlanCheckWithDFTTest)
+{
+#define MAX_NUM_SAMPLES 1024
+#define PLAN_FLOAT_EPSILON 1e-3
+    static const int32_t test_sizes[] = { 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024 };
+    const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    int32_t t, i, is_ok;
+    static float input[2 * MAX_NUM_SAMPLES], ref_output[2 * MAX_NUM_SAMPLES];
+    static float output[2 * MAX_NUM_SAMPLES], work[2 * MAX_NUM_SAMPLES];
+
+    for (t = 0; t < num_test_sizes; t++) {
+        const int32_t n = test_sizes[t];
+        void *plan_work;
+        int32_t work_size;
+        struct AE2FFTPlanConfig config;
+        struct AE2FFTPlan *plan;
+
+        /* 複素FFT/IFFT: DFTと比較 */
+        config.fft_size = n;
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        config.in_place = 0;
+        config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        srand(0);
+        for (i = 0; i < 2 * n; i++) {
+            input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        }
+
+        AE2FFTTest_PreciseDFT(n, -1, input, ref_output);
+        memcpy(output, input, sizeof(float) * 2 * n);
+        AE2FFTPlan_FloatFFT(plan, -1, output);
+        is_ok = 1;
+        for (i = 0; i < 2 * n; i++) {
+            if (fabs(ref_output[i] - output[i]) > PLAN_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2FFTTest_PreciseDFT(n, 1, input, ref_output);
+        memcpy(output, input, sizeof(float) * 2 * n);
+        AE2FFTPlan_FloatFFT(plan, 1, output);
+        is_ok = 1;
+        for (i = 0; i < 2 * n; i++) {
+            if (fabs(ref_output[i] - output[i]) > PLAN_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+
+        /* 実数FFT/IFFT: 従来の実数FFTと比較 */
+        config.fft_size = n;
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        config.in_place = 0;
+        config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        srand(0);
+        for (i = 0; i < n; i++) {
+            input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        }
+
+        memcpy(ref_output, input, sizeof(float) * n);
+        AE2FFT_RealFFT(n, -1, ref_output, work);
+        memcpy(output, input, sizeof(float) * n);
+        AE2FFTPlan_RealFFT(plan, -1, output);
+        is_ok = 1;
+        for (i = 0; i < n; i++) {
+            if (fabs(ref_output[i] - output[i]) > PLAN_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        /* IFFTして元に戻るか */
+        AE2FFTPlan_RealFFT(plan, 1, output);
+        is_ok = 1;
+        for (i = 0; i < n; i++) {
+            if (fabs(input[i] - output[i] * 2.0 / n) > PLAN_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+    }
+#undef MAX_NUM_SAMPLES
+#undef PLAN_FLOAT_EPSILON
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
 }
+
+/* SIMDカーネルとスカラーカーネルの結果一致テスト */
+TEST(AE2FFTTest, PlanKernelConsistencyTest)
+{
+#define MAX_NUM_SAMPLES 4096
+#define KERNEL_FLOAT_EPSILON 1e-5
+    static const int32_t test_sizes[] = { 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    const struct AE2FFTKernel *kernels[2];
+    int32_t t, k, i, is_ok;
+    static float input[2 * MAX_NUM_SAMPLES], ref_output[2 * MAX_NUM_SAMPLES], output[2 * MAX_NUM_SAMPLES];
+
+    /* ビルド環境・実行環境で使用できるカーネルのみテスト */
+    kernels[0] = AE2FFT_CPUSupportsSSE2() ? AE2FFTKernel_GetSSE2() : NULL;
+    kernels[1] = AE2FFT_CPUSupportsAVX2FMA() ? AE2FFTKernel_GetAVX2() : NULL;
+
+    for (t = 0; t < num_test_sizes; t++) {
+        const int32_t n = test_sizes[t];
+        void *plan_work;
+        int32_t work_size;
+        struct AE2FFTPlanConfig config;
+        struct AE2FFTPlan *plan;
+
+        srand(0);
+        for (i = 0; i < 2 * n; i++) {
+            input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        }
+
+        for (k = 0; k < (int32_t)(sizeof(kernels) / sizeof(kernels[0])); k++) {
+            int flag;
+            if (kernels[k] == NULL) {
+                continue;
+            }
+            for (flag = -1; flag <= 1; flag += 2) {
+                /* 複素FFT */
+                config.fft_size = n;
+                config.type = AE2FFTPLAN_TYPE_COMPLEX;
+                config.in_place = 0;
+                config.double_precision = 0;
+                work_size = AE2FFTPlan_CalculateWorkSize(&config);
+                ASSERT_TRUE(work_size >= 0);
+                plan_work = malloc((size_t)work_size);
+                plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+                ASSERT_TRUE(plan != NULL);
+
+                plan->kernel = AE2FFTKernel_GetScalar();
+                memcpy(ref_output, input, sizeof(float) * 2 * n);
+                AE2FFTPlan_FloatFFT(plan, flag, ref_output);
+                plan->kernel = kernels[k];
+                memcpy(output, input, sizeof(float) * 2 * n);
+                AE2FFTPlan_FloatFFT(plan, flag, output);
+                is_ok = 1;
+                for (i = 0; i < 2 * n; i++) {
+                    if (fabs(ref_output[i] - output[i]) > KERNEL_FLOAT_EPSILON * n) {
+                        is_ok = 0;
+                        break;
+                    }
+                }
+                EXPECT_EQ(1, is_ok);
+
+                AE2FFTPlan_Destroy(plan);
+                free(plan_work);
+
+                /* 実数FFT */
+                config.type = AE2FFTPLAN_TYPE_REAL;
+                work_size = AE2FFTPlan_CalculateWorkSize(&config);
+                ASSERT_TRUE(work_size >= 0);
+                plan_work = malloc((size_t)work_size);
+                plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+                ASSERT_TRUE(plan != NULL);
+
+                plan->kernel = AE2FFTKernel_GetScalar();
+                memcpy(ref_output, input, sizeof(float) * n);
+                AE2FFTPlan_RealFFT(plan, flag, ref_output);
+                plan->kernel = kernels[k];
+                memcpy(output, input, sizeof(float) * n);
+                AE2FFTPlan_RealFFT(plan, flag, output);
+                is_ok = 1;
+                for (i = 0; i < n; i++) {
+                    if (fabs(ref_output[i] - output[i]) > KERNEL_FLOAT_EPSILON * n) {
+                        is_ok = 0;
+                        break;
+                    }
+                }
+                EXPECT_EQ(1, is_ok);
+
+                AE2FFTPlan_Destroy(plan);
+                free(plan_work);
+            }
+        }
+    }
+#undef MAX_NUM_SAMPLES
+#undef KERNEL_FLOAT_EPSILON
+}
+
+/* 分離形式のFFTと従来形式のFFTの結果一致テスト */
+TEST(AE2FFTTest, PlanSplitFFTTest)
+{
+#define MAX_NUM_SAMPLES 2048
+#define SPLIT_FLOAT_EPSILON 1e-4
+    static const int32_t test_sizes[] = { 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048 };
+    const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    int32_t t, i, is_ok;
+    static float input[2 * MAX_NUM_SAMPLES], ref_output[2 * MAX_NUM_SAMPLES];
+    static float real[MAX_NUM_SAMPLES], imag[MAX_NUM_SAMPLES], output[MAX_NUM_SAMPLES];
+
+    for (t = 0; t < num_test_sizes; t++) {
+        const int32_t n = test_sizes[t];
+        void *plan_work;
+        int32_t work_size;
+        int flag;
+        struct AE2FFTPlanConfig config;
+        struct AE2FFTPlan *plan;
+
+        srand(0);
+        for (i = 0; i < 2 * n; i++) {
+            input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        }
+
+        /* 複素FFT: 従来形式の結果と比較 */
+        config.fft_size = n;
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        config.in_place = 0;
+        config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        for (flag = -1; flag <= 1; flag += 2) {
+            memcpy(ref_output, input, sizeof(float) * 2 * n);
+            AE2FFTPlan_FloatFFT(plan, flag, ref_output);
+            for (i = 0; i < n; i++) {
+                real[i] = AE2FFTCOMPLEX_REAL(input, i);
+                imag[i] = AE2FFTCOMPLEX_IMAG(input, i);
+            }
+            AE2FFTPlan_SplitFFT(plan, flag, real, imag);
+            is_ok = 1;
+            for (i = 0; i < n; i++) {
+                if ((fabs(AE2FFTCOMPLEX_REAL(ref_output, i) - real[i]) > SPLIT_FLOAT_EPSILON)
+                        || (fabs(AE2FFTCOMPLEX_IMAG(ref_output, i) - imag[i]) > SPLIT_FLOAT_EPSILON)) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+        }
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+
+        /* 実数FFT: 従来形式の結果と比較し、逆変換で元に戻るか確認 */
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        memcpy(ref_output, input, sizeof(float) * n);
+        AE2FFTPlan_RealFFT(plan, -1, ref_output);
+        AE2FFTPlan_SplitRealFFT(plan, input, real, imag);
+        is_ok = 1;
+        for (i = 0; i < n / 2; i++) {
+            if ((fabs(AE2FFTCOMPLEX_REAL(ref_output, i) - real[i]) > SPLIT_FLOAT_EPSILON)
+                    || (fabs(AE2FFTCOMPLEX_IMAG(ref_output, i) - imag[i]) > SPLIT_FLOAT_EPSILON)) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2FFTPlan_SplitRealIFFT(plan, real, imag, output);
+        is_ok = 1;
+        for (i = 0; i < n; i++) {
+            if (fabs(input[i] - output[i] * 2.0f / n) > SPLIT_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+    }
+#undef MAX_NUM_SAMPLES
+#undef SPLIT_FLOAT_EPSILON
+}
+
+/* 分離形式スペクトルの乗算テスト */
+TEST(AE2FFTTest, SplitSpectrumMulTest)
+{
+#define NUM_BINS 64
+#define MUL_FLOAT_EPSILON 1e-6
+    int32_t i, is_ok;
+    float a_re[NUM_BINS], a_im[NUM_BINS], b_re[NUM_BINS], b_im[NUM_BINS];
+    float y_re[NUM_BINS], y_im[NUM_BINS];
+
+    srand(0);
+    for (i = 0; i < NUM_BINS; i++) {
+        a_re[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        a_im[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        b_re[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        b_im[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+    }
+
+    /* 複素乗算 */
+    AE2FFT_SplitSpectrumMul(NUM_BINS, a_re, a_im, b_re, b_im, y_re, y_im);
+    is_ok = 1;
+    for (i = 0; i < NUM_BINS; i++) {
+        if ((fabs(y_re[i] - (a_re[i] * b_re[i] - a_im[i] * b_im[i])) > MUL_FLOAT_EPSILON)
+                || (fabs(y_im[i] - (a_re[i] * b_im[i] + a_im[i] * b_re[i])) > MUL_FLOAT_EPSILON)) {
+            is_ok = 0;
+            break;
+        }
+    }
+    EXPECT_EQ(1, is_ok);
+
+    /* 複素乗算結果の加算: 乗算結果に再度加算すると2倍になる */
+    AE2FFT_SplitSpectrumMulAdd(NUM_BINS, a_re, a_im, b_re, b_im, y_re, y_im);
+    is_ok = 1;
+    for (i = 0; i < NUM_BINS; i++) {
+        if ((fabs(y_re[i] - 2.0f * (a_re[i] * b_re[i] - a_im[i] * b_im[i])) > MUL_FLOAT_EPSILON)
+                || (fabs(y_im[i] - 2.0f * (a_re[i] * b_im[i] + a_im[i] * b_re[i])) > MUL_FLOAT_EPSILON)) {
+            is_ok = 0;
+            break;
+        }
+    }
+    EXPECT_EQ(1, is_ok);
+
+    /* 実数列のスペクトル: 先頭は直流成分と最高周波数成分の実数同士の積 */
+    AE2FFT_SplitRealSpectrumMul(NUM_BINS, a_re, a_im, b_re, b_im, y_re, y_im);
+    EXPECT_FLOAT_EQ(a_re[0] * b_re[0], y_re[0]);
+    EXPECT_FLOAT_EQ(a_im[0] * b_im[0], y_im[0]);
+    is_ok = 1;
+    for (i = 1; i < NUM_BINS; i++) {
+        if ((fabs(y_re[i] - (a_re[i] * b_re[i] - a_im[i] * b_im[i])) > MUL_FLOAT_EPSILON)
+                || (fabs(y_im[i] - (a_re[i] * b_im[i] + a_im[i] * b_re[i])) > MUL_FLOAT_EPSILON)) {
+            is_ok = 0;
+            break;
+        }
+    }
+    EXPECT_EQ(1, is_ok);
+
+    AE2FFT_SplitRealSpectrumMulAdd(NUM_BINS, a_re, a_im, b_re, b_im, y_re, y_im);
+    EXPECT_FLOAT_EQ(2.0f * a_re[0] * b_re[0], y_re[0]);
+    EXPECT_FLOAT_EQ(2.0f * a_im[0] * b_im[0], y_im[0]);
+#undef NUM_BINS
+#undef MUL_FLOAT_EPSILON
+}
+
+/* スペクトルの一括乗算加算テスト */
+TEST(AE2FFTTest, PlanSpectrumMulAddMultipleTest)
+{
+#define FFT_SIZE 54
+#define NUM_BINS (FFT_SIZE / 2)
+#define NUM_SPECTRA 5
+#define MUL_FLOAT_EPSILON 1e-5
+    int32_t i, k, is_ok;
+    void *plan_work;
+    int32_t work_size;
+    struct AE2FFTPlanConfig config;
+    struct AE2FFTPlan *plan;
+    const struct AE2FFTKernel *kernels[3];
+    static float a[NUM_SPECTRA][FFT_SIZE], b[NUM_SPECTRA][FFT_SIZE];
+    static float ref[FFT_SIZE], y[FFT_SIZE];
+    const float *pa[NUM_SPECTRA], *pb[NUM_SPECTRA];
+
+    srand(0);
+    for (k = 0; k < NUM_SPECTRA; k++) {
+        for (i = 0; i < FFT_SIZE; i++) {
+            a[k][i] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+            b[k][i] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+        }
+        pa[k] = a[k];
+        pb[k] = b[k];
+    }
+
+    /* 1組ずつの乗算加算を正解とする */
+    for (i = 0; i < FFT_SIZE; i++) {
+        ref[i] = 0.1f * (float)i;
+    }
+    memcpy(y, ref, sizeof(y));
+    for (k = 0; k < NUM_SPECTRA; k++) {
+        AE2FFT_SplitRealSpectrumMulAdd(NUM_BINS, a[k], &a[k][NUM_BINS], b[k], &b[k][NUM_BINS], ref, &ref[NUM_BINS]);
+    }
+
+    config.fft_size = FFT_SIZE;
+    config.type = AE2FFTPLAN_TYPE_REAL;
+    config.in_place = 0;
+    config.double_precision = 0;
+    work_size = AE2FFTPlan_CalculateWorkSize(&config);
+    ASSERT_TRUE(work_size >= 0);
+    plan_work = malloc((size_t)work_size);
+    plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+    ASSERT_TRUE(plan != NULL);
+
+    /* 使用できる全てのカーネルで端数を含めて一致 */
+    kernels[0] = AE2FFTKernel_GetScalar();
+    kernels[1] = AE2FFT_CPUSupportsSSE2() ? AE2FFTKernel_GetSSE2() : NULL;
+    kernels[2] = AE2FFT_CPUSupportsAVX2FMA() ? AE2FFTKernel_GetAVX2() : NULL;
+    for (k = 0; k < 3; k++) {
+        float test[FFT_SIZE];
+        if (kernels[k] == NULL) {
+            continue;
+        }
+        plan->kernel = kernels[k];
+        memcpy(test, y, sizeof(y));
+        AE2FFTPlan_SplitRealSpectrumMulAddMultiple(plan, NUM_SPECTRA, pa, pb, test);
+        is_ok = 1;
+        for (i = 0; i < FFT_SIZE; i++) {
+            if (fabs(ref[i] - test[i]) > MUL_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+    }
+
+    AE2FFTPlan_Destroy(plan);
+    free(plan_work);
+#undef FFT_SIZE
+#undef NUM_BINS
+#undef NUM_SPECTRA
+#undef MUL_FLOAT_EPSILON
+}
+
+/* 混合基底FFTの結果一致テスト */
+TEST(AE2FFTTest, PlanMixedRadixTest)
+{
+#define MAX_NUM_SAMPLES 1920
+#define MIXED_FLOAT_EPSILON 1e-3
+    static const int32_t test_sizes[] = {
+        3, 5, 6, 9, 10, 12, 15, 20, 24, 25, 30, 36, 45, 48, 60, 75, 80, 90, 96, 100, 120,
+        240, 360, 480, 720, 960, 1440, 1920 };
+    const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    int32_t t, i, is_ok;
+    static float input[2 * MAX_NUM_SAMPLES], ref_output[2 * MAX_NUM_SAMPLES], output[2 * MAX_NUM_SAMPLES];
+    static float real[MAX_NUM_SAMPLES], imag[MAX_NUM_SAMPLES];
+
+    for (t = 0; t < num_test_sizes; t++) {
+        const int32_t n = test_sizes[t];
+        void *plan_work;
+        int32_t work_size;
+        int flag;
+        struct AE2FFTPlanConfig config;
+        struct AE2FFTPlan *plan;
+
+        srand(0);
+        for (i = 0; i < 2 * n; i++) {
+            input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        }
+
+        /* 複素FFT/IFFT: DFTと比較 */
+        config.fft_size = n;
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        config.in_place = 0;
+        config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size > 0);
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        for (flag = -1; flag <= 1; flag += 2) {
+            AE2FFTTest_PreciseDFT(n, flag, input, ref_output);
+            memcpy(output, input, sizeof(float) * 2 * n);
+            AE2FFTPlan_FloatFFT(plan, flag, output);
+            is_ok = 1;
+            for (i = 0; i < 2 * n; i++) {
+                if (fabs(ref_output[i] - output[i]) > MIXED_FLOAT_EPSILON) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+
+            /* 分離形式 */
+            for (i = 0; i < n; i++) {
+                real[i] = AE2FFTCOMPLEX_REAL(input, i);
+                imag[i] = AE2FFTCOMPLEX_IMAG(input, i);
+            }
+            AE2FFTPlan_SplitFFT(plan, flag, real, imag);
+            is_ok = 1;
+            for (i = 0; i < n; i++) {
+                if ((fabs(AE2FFTCOMPLEX_REAL(ref_output, i) - real[i]) > MIXED_FLOAT_EPSILON)
+                        || (fabs(AE2FFTCOMPLEX_IMAG(ref_output, i) - imag[i]) > MIXED_FLOAT_EPSILON)) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+        }
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+
+        /* 実数FFT: 虚部0の複素DFTと比較し、逆変換で元に戻るか確認 */
+        if ((n % 2) != 0) {
+            continue;
+        }
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        if (work_size < 0) {
+            continue;
+        }
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        for (i = 0; i < n; i++) {
+            AE2FFTCOMPLEX_REAL(ref_output, i) = input[i];
+            AE2FFTCOMPLEX_IMAG(ref_output, i) = 0.0f;
+        }
+        memcpy(output, ref_output, sizeof(float) * 2 * n);
+        AE2FFTTest_PreciseDFT(n, -1, output, ref_output);
+        memcpy(output, input, sizeof(float) * n);
+        AE2FFTPlan_RealFFT(plan, -1, output);
+        is_ok = 1;
+        /* 先頭は直流成分と最高周波数成分の実部 */
+        if ((fabs(AE2FFTCOMPLEX_REAL(ref_output, 0) - output[0]) > MIXED_FLOAT_EPSILON)
+                || (fabs(AE2FFTCOMPLEX_REAL(ref_output, n / 2) - output[1]) > MIXED_FLOAT_EPSILON)) {
+            is_ok = 0;
+        }
+        for (i = 2; i < n; i++) {
+            if (fabs(ref_output[i] - output[i]) > MIXED_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2FFTPlan_RealFFT(plan, 1, output);
+        is_ok = 1;
+        for (i = 0; i < n; i++) {
+            if (fabs(input[i] - output[i] * 2.0f / n) > MIXED_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+    }
+#undef MAX_NUM_SAMPLES
+#undef MIXED_FLOAT_EPSILON
+}
+
+/* CZT作成破棄テスト */
+TEST(AE2FFTTest, CZTCreateDestroyTest)
+{
+    /* ワークサイズ計算テスト */
+    {
+        int32_t work_size;
+        struct AE2CZTConfig config;
+
+        /* 簡単な成功例 */
+        config.num_input_samples = 17;
+        config.num_output_bins = 17;
+        config.start_frequency = 0.0;
+        config.frequency_step = 1.0 / 17;
+        work_size = AE2CZT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size >= 0);
+
+        /* 不正な引数 */
+        work_size = AE2CZT_CalculateWorkSize(NULL);
+        EXPECT_TRUE(work_size < 0);
+
+        /* 不正なコンフィグ */
+        config.num_input_samples = 0;
+        work_size = AE2CZT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+        config.num_input_samples = 17;
+        config.num_output_bins = 0;
+        work_size = AE2CZT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+
+        /* 点数の和が大きすぎる */
+        config.num_input_samples = INT32_MAX / 2;
+        config.num_output_bins = 1;
+        work_size = AE2CZT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+        config.num_input_samples = INT32_MAX;
+        config.num_output_bins = INT32_MAX;
+        work_size = AE2CZT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+    }
+
+    /* FFT点数は入出力数の和-1以上で最小の2, 3, 5の積 */
+    {
+        int32_t num_samples, expected;
+        int32_t radices[AE2FFTPLAN_MAX_NUM_STAGES];
+
+        for (num_samples = 1; num_samples <= 1000; num_samples++) {
+            void *work;
+            int32_t work_size;
+            struct AE2CZTConfig config;
+            struct AE2CZT *czt;
+
+            config.num_input_samples = num_samples;
+            config.num_output_bins = 1;
+            config.start_frequency = 0.0;
+            config.frequency_step = 0.0;
+            work_size = AE2CZT_CalculateWorkSize(&config);
+            ASSERT_TRUE(work_size >= 0);
+            work = malloc((size_t)work_size);
+            czt = AE2CZT_Create(&config, work, work_size);
+            ASSERT_TRUE(czt != NULL);
+
+            /* 1点ずつ探索した結果と一致 */
+            expected = (num_samples < 2) ? 2 : num_samples;
+            while (AE2FFTPlan_Factorize(expected, radices) < 0) {
+                expected++;
+            }
+            EXPECT_EQ(expected, AE2CZT_GetFFTSize(czt));
+
+            AE2CZT_Destroy(czt);
+            free(work);
+        }
+    }
+
+    /* ワーク領域渡しによる作成（成功例） */
+    {
+        void *work;
+        int32_t work_size;
+        struct AE2CZTConfig config;
+        struct AE2CZT *czt;
+
+        config.num_input_samples = 17;
+        config.num_output_bins = 5;
+        config.start_frequency = 0.0;
+        config.frequency_step = 1.0 / 17;
+        work_size = AE2CZT_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+
+        czt = AE2CZT_Create(&config, work, work_size);
+        EXPECT_TRUE(czt != NULL);
+        EXPECT_TRUE(AE2CZT_GetFFTSize(czt) >= (17 + 5 - 1));
+
+        AE2CZT_Destroy(czt);
+        free(work);
+    }
+
+    /* ワーク領域渡しによる作成（失敗ケース） */
+    {
+        void *work;
+        int32_t work_size;
+        struct AE2CZTConfig config;
+        struct AE2CZT *czt;
+
+        config.num_input_samples = 17;
+        config.num_output_bins = 17;
+        config.start_frequency = 0.0;
+        config.frequency_step = 1.0 / 17;
+        work_size = AE2CZT_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+
+        /* 引数が不正 */
+        czt = AE2CZT_Create(NULL, work, work_size);
+        EXPECT_TRUE(czt == NULL);
+        czt = AE2CZT_Create(&config, NULL, work_size);
+        EXPECT_TRUE(czt == NULL);
+        czt = AE2CZT_Create(&config, work, 0);
+        EXPECT_TRUE(czt == NULL);
+
+        /* ワークサイズ不足 */
+        czt = AE2CZT_Create(&config, work, work_size - 1);
+        EXPECT_TRUE(czt == NULL);
+
+        free(work);
+    }
+}
+
+/* CZTの結果一致テスト */
+TEST(AE2FFTTest, CZTCheckWithDFTTest)
+{
+#define MAX_NUM_SAMPLES 1024
+#define CZT_FLOAT_EPSILON 2e-3
+
+    /* 任意長のDFTと一致するか */
+    {
+        static const int32_t test_sizes[] = { 1, 2, 7, 13, 97, 100, 257, 1000, 1009 };
+        const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+        int32_t t, i, is_ok;
+        static float input[2 * MAX_NUM_SAMPLES + 2], ref_output[2 * MAX_NUM_SAMPLES + 2], output[2 * MAX_NUM_SAMPLES + 2];
+
+        for (t = 0; t < num_test_sizes; t++) {
+            const int32_t n = test_sizes[t];
+            void *work;
+            int32_t work_size;
+            int flag;
+            struct AE2CZTConfig config;
+            struct AE2CZT *czt;
+
+            srand(0);
+            for (i = 0; i < 2 * n; i++) {
+                input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+            }
+
+            config.num_input_samples = n;
+            config.num_output_bins = n;
+            config.start_frequency = 0.0;
+            config.frequency_step = 1.0 / n;
+            work_size = AE2CZT_CalculateWorkSize(&config);
+            ASSERT_TRUE(work_size > 0);
+            ASSERT_TRUE(work_size >= 0);
+            work = malloc((size_t)work_size);
+            czt = AE2CZT_Create(&config, work, work_size);
+            ASSERT_TRUE(czt != NULL);
+
+            for (flag = -1; flag <= 1; flag += 2) {
+                AE2FFTTest_PreciseDFT(n, flag, input, ref_output);
+                AE2CZT_Transform(czt, flag, input, output);
+                is_ok = 1;
+                for (i = 0; i < 2 * n; i++) {
+                    if (fabs(ref_output[i] - output[i]) > CZT_FLOAT_EPSILON) {
+                        is_ok = 0;
+                        break;
+                    }
+                }
+                EXPECT_EQ(1, is_ok);
+            }
+
+            AE2CZT_Destroy(czt);
+            free(work);
+        }
+    }
+
+    /* 部分帯域の評価（ズームFFT）が直接計算と一致するか */
+    {
+        const int32_t num_samples = 300;
+        const int32_t num_bins = 64;
+        const double start_frequency = 0.1;
+        const double frequency_step = 0.05 / num_bins;
+        int32_t i, k, is_ok;
+        void *work;
+        int32_t work_size;
+        struct AE2CZTConfig config;
+        struct AE2CZT *czt;
+        static float input[2 * MAX_NUM_SAMPLES], ref_output[2 * MAX_NUM_SAMPLES], output[2 * MAX_NUM_SAMPLES];
+
+        srand(0);
+        for (i = 0; i < 2 * num_samples; i++) {
+            input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        }
+
+        for (k = 0; k < num_bins; k++) {
+            double re = 0.0, im = 0.0;
+            for (i = 0; i < num_samples; i++) {
+                const double theta = -2.0 * AE2_PI * (start_frequency + k * frequency_step) * i;
+                re += input[2 * i] * cos(theta) - input[2 * i + 1] * sin(theta);
+                im += input[2 * i] * sin(theta) + input[2 * i + 1] * cos(theta);
+            }
+            ref_output[2 * k] = (float)re;
+            ref_output[2 * k + 1] = (float)im;
+        }
+
+        config.num_input_samples = num_samples;
+        config.num_output_bins = num_bins;
+        config.start_frequency = start_frequency;
+        config.frequency_step = frequency_step;
+        work_size = AE2CZT_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size > 0);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+        czt = AE2CZT_Create(&config, work, work_size);
+        ASSERT_TRUE(czt != NULL);
+
+        AE2CZT_Transform(czt, -1, input, output);
+        is_ok = 1;
+        for (i = 0; i < 2 * num_bins; i++) {
+            if (fabs(ref_output[i] - output[i]) > CZT_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2CZT_Destroy(czt);
+        free(work);
+    }
+
+#undef MAX_NUM_SAMPLES
+#undef CZT_FLOAT_EPSILON
+}
+
+/* 複数チャンネルの実数FFTの結果一致テスト */
+TEST(AE2FFTTest, PlanRealFFTBatchTest)
+{
+#define MAX_NUM_SAMPLES 512
+#define MAX_NUM_CHANNELS 16
+#define BATCH_FLOAT_EPSILON 1e-4
+    static const int32_t test_sizes[] = { 2, 16, 64, 128, 256, 480, 512 };
+    static const int32_t test_num_channels[] = { 1, 2, 3, 8, 12, 16 };
+    const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    const int32_t num_test_channels = sizeof(test_num_channels) / sizeof(test_num_channels[0]);
+    int32_t t, c, ch, i, is_ok;
+    static float input[MAX_NUM_CHANNELS][MAX_NUM_SAMPLES];
+    static float ref_output[MAX_NUM_CHANNELS][MAX_NUM_SAMPLES];
+    static float output[MAX_NUM_CHANNELS][MAX_NUM_SAMPLES];
+    static float work[2 * MAX_NUM_CHANNELS * MAX_NUM_SAMPLES];
+    float *outputs[MAX_NUM_CHANNELS];
+
+    for (ch = 0; ch < MAX_NUM_CHANNELS; ch++) {
+        outputs[ch] = output[ch];
+    }
+
+    for (t = 0; t < num_test_sizes; t++) {
+        const int32_t n = test_sizes[t];
+        void *plan_work;
+        int32_t work_size;
+        struct AE2FFTPlanConfig config;
+        struct AE2FFTPlan *plan;
+
+        config.fft_size = n;
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        config.in_place = 0;
+        config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size > 0);
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        for (c = 0; c < num_test_channels; c++) {
+            const int32_t num_channels = test_num_channels[c];
+            int flag;
+
+            srand(0);
+            for (ch = 0; ch < num_channels; ch++) {
+                for (i = 0; i < n; i++) {
+                    input[ch][i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+                }
+            }
+
+            /* FFT/IFFTそれぞれで1チャンネルずつの変換と比較 */
+            for (flag = -1; flag <= 1; flag += 2) {
+                for (ch = 0; ch < num_channels; ch++) {
+                    memcpy(ref_output[ch], input[ch], sizeof(float) * n);
+                    AE2FFTPlan_RealFFT(plan, flag, ref_output[ch]);
+                    memcpy(output[ch], input[ch], sizeof(float) * n);
+                }
+                AE2FFTPlan_RealFFTBatch(plan, flag, num_channels, outputs, work);
+                is_ok = 1;
+                for (ch = 0; ch < num_channels; ch++) {
+                    for (i = 0; i < n; i++) {
+                        if (fabs(ref_output[ch][i] - output[ch][i]) > BATCH_FLOAT_EPSILON) {
+                            is_ok = 0;
+                            break;
+                        }
+                    }
+                }
+                EXPECT_EQ(1, is_ok);
+            }
+        }
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+    }
+#undef MAX_NUM_SAMPLES
+#undef MAX_NUM_CHANNELS
+#undef BATCH_FLOAT_EPSILON
+}
+
+/* 大規模FFTのタスクをスレッドで並列実行 */
+static void AE2FFTTest_ThreadRunner(void *runner_arg, int32_t num_tasks, AE2LargeFFTTaskFunction task, void *task_arg)
+{
+    int32_t i;
+    std::vector<std::thread> threads;
+
+    (void)runner_arg;
+
+    for (i = 0; i < num_tasks; i++) {
+        threads.push_back(std::thread(task, task_arg, i));
+    }
+    for (i = 0; i < num_tasks; i++) {
+        threads[i].join();
+    }
+}
+
+/* 大規模FFT作成破棄テスト */
+TEST(AE2FFTTest, LargeFFTCreateDestroyTest)
+{
+    /* ワークサイズ計算テスト */
+    {
+        int32_t work_size;
+        struct AE2LargeFFTConfig config;
+
+        /* 簡単な成功例 */
+        config.fft_size = 1 << 12;
+        config.num_workers = 4;
+        config.runner = NULL;
+        config.runner_arg = NULL;
+        work_size = AE2LargeFFT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size >= 0);
+
+        /* 不正な引数 */
+        work_size = AE2LargeFFT_CalculateWorkSize(NULL);
+        EXPECT_TRUE(work_size < 0);
+
+        /* 不正なコンフィグ */
+        config.fft_size = 2;
+        work_size = AE2LargeFFT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+        config.fft_size = 7 * 64;
+        work_size = AE2LargeFFT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+        config.fft_size = 1 << 12;
+        config.num_workers = 0;
+        work_size = AE2LargeFFT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size < 0);
+    }
+
+    /* ワーク領域渡しによる作成 */
+    {
+        void *work;
+        int32_t work_size;
+        struct AE2LargeFFTConfig config;
+        struct AE2LargeFFT *fft;
+
+        config.fft_size = 1 << 12;
+        config.num_workers = 4;
+        config.runner = NULL;
+        config.runner_arg = NULL;
+        work_size = AE2LargeFFT_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+
+        /* 成功例 */
+        fft = AE2LargeFFT_Create(&config, work, work_size);
+        EXPECT_TRUE(fft != NULL);
+        EXPECT_EQ(1 << 12, AE2LargeFFT_GetFFTSize(fft));
+        AE2LargeFFT_Destroy(fft);
+
+        /* 引数が不正 */
+        fft = AE2LargeFFT_Create(NULL, work, work_size);
+        EXPECT_TRUE(fft == NULL);
+        fft = AE2LargeFFT_Create(&config, NULL, work_size);
+        EXPECT_TRUE(fft == NULL);
+
+        /* ワークサイズ不足 */
+        fft = AE2LargeFFT_Create(&config, work, work_size - 1);
+        EXPECT_TRUE(fft == NULL);
+
+        free(work);
+    }
+}
+
+/* 大規模FFTの結果一致テスト */
+TEST(AE2FFTTest, LargeFFTCheckWithPlanTest)
+{
+#define LARGE_FLOAT_RELATIVE_EPSILON 1e-5
+    static const int32_t test_sizes[] = { 4, 60, 1000, 1 << 10, 1920, 1 << 16, 3 * (1 << 16) };
+    static const int32_t test_num_workers[] = { 1, 3, 8 };
+    const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    const int32_t num_test_workers = sizeof(test_num_workers) / sizeof(test_num_workers[0]);
+    int32_t t, w, i;
+
+    for (t = 0; t < num_test_sizes; t++) {
+        const int32_t n = test_sizes[t];
+        std::vector<float> input(2 * n), ref_output(2 * n), output(2 * n), work(2 * n);
+        void *plan_work;
+        int32_t work_size;
+        int flag;
+        struct AE2FFTPlanConfig plan_config;
+        struct AE2FFTPlan *plan;
+
+        srand(0);
+        for (i = 0; i < 2 * n; i++) {
+            input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        }
+
+        plan_config.fft_size = n;
+        plan_config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        plan_config.in_place = 0;
+        plan_config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&plan_config);
+        ASSERT_TRUE(work_size > 0);
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&plan_config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        for (w = 0; w < num_test_workers; w++) {
+            void *fft_work;
+            struct AE2LargeFFTConfig config;
+            struct AE2LargeFFT *fft;
+
+            config.fft_size = n;
+            config.num_workers = test_num_workers[w];
+            config.runner = (test_num_workers[w] > 1) ? AE2FFTTest_ThreadRunner : NULL;
+            config.runner_arg = NULL;
+            work_size = AE2LargeFFT_CalculateWorkSize(&config);
+            ASSERT_TRUE(work_size > 0);
+            ASSERT_TRUE(work_size >= 0);
+            fft_work = malloc((size_t)work_size);
+            fft = AE2LargeFFT_Create(&config, fft_work, work_size);
+            ASSERT_TRUE(fft != NULL);
+
+            for (flag = -1; flag <= 1; flag += 2) {
+                double max_error = 0.0, max_abs = 0.0;
+                memcpy(&ref_output[0], &input[0], sizeof(float) * 2 * n);
+                AE2FFTPlan_FloatFFT(plan, flag, &ref_output[0]);
+                memcpy(&output[0], &input[0], sizeof(float) * 2 * n);
+                AE2LargeFFT_FloatFFT(fft, flag, &output[0], &work[0]);
+                for (i = 0; i < 2 * n; i++) {
+                    max_error = std::max(max_error, (double)fabs(ref_output[i] - output[i]));
+                    max_abs = std::max(max_abs, (double)fabs(ref_output[i]));
+                }
+                EXPECT_LT(max_error, LARGE_FLOAT_RELATIVE_EPSILON * max_abs);
+            }
+
+            AE2LargeFFT_Destroy(fft);
+            free(fft_work);
+        }
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+    }
+#undef LARGE_FLOAT_RELATIVE_EPSILON
+}
+
+/* インプレース変換プランの結果一致テスト */
+TEST(AE2FFTTest, PlanInPlaceTest)
+{
+#define MAX_NUM_SAMPLES 4096
+#define INPLACE_FLOAT_EPSILON 1e-3
+    int32_t n, i, is_ok;
+    static float input[2 * MAX_NUM_SAMPLES], ref_output[2 * MAX_NUM_SAMPLES], output[2 * MAX_NUM_SAMPLES];
+    static float ref_real[MAX_NUM_SAMPLES], ref_imag[MAX_NUM_SAMPLES], real[MAX_NUM_SAMPLES], imag[MAX_NUM_SAMPLES];
+
+    for (n = 2; n <= MAX_NUM_SAMPLES; n *= 2) {
+        int32_t t;
+        for (t = 0; t < 2; t++) {
+            const AE2FFTPlanType type = (t == 0) ? AE2FFTPLAN_TYPE_COMPLEX : AE2FFTPLAN_TYPE_REAL;
+            void *ref_work, *work;
+            int32_t ref_work_size, work_size;
+            int flag;
+            struct AE2FFTPlanConfig config;
+            struct AE2FFTPlan *ref_plan, *plan;
+
+            config.fft_size = n;
+            config.type = type;
+            config.in_place = 0;
+            config.double_precision = 0;
+            ref_work_size = AE2FFTPlan_CalculateWorkSize(&config);
+            ASSERT_TRUE(ref_work_size > 0);
+            ASSERT_TRUE(ref_work_size >= 0);
+            ref_work = malloc((size_t)ref_work_size);
+            ref_plan = AE2FFTPlan_Create(&config, ref_work, ref_work_size);
+            ASSERT_TRUE(ref_plan != NULL);
+            config.in_place = 1;
+            work_size = AE2FFTPlan_CalculateWorkSize(&config);
+            ASSERT_TRUE(work_size > 0);
+            ASSERT_TRUE(work_size >= 0);
+            work = malloc((size_t)work_size);
+            plan = AE2FFTPlan_Create(&config, work, work_size);
+            ASSERT_TRUE(plan != NULL);
+
+            /* 点数分の作業領域を持たない */
+            EXPECT_TRUE(work_size < ref_work_size);
+
+            srand(0);
+            for (i = 0; i < 2 * n; i++) {
+                input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+            }
+
+            if (type == AE2FFTPLAN_TYPE_COMPLEX) {
+                for (flag = -1; flag <= 1; flag += 2) {
+                    memcpy(ref_output, input, sizeof(float) * 2 * n);
+                    AE2FFTPlan_FloatFFT(ref_plan, flag, ref_output);
+                    memcpy(output, input, sizeof(float) * 2 * n);
+                    AE2FFTPlan_FloatFFT(plan, flag, output);
+                    is_ok = 1;
+                    for (i = 0; i < 2 * n; i++) {
+                        if (fabs(ref_output[i] - output[i]) > INPLACE_FLOAT_EPSILON) {
+                            is_ok = 0;
+                            break;
+                        }
+                    }
+                    EXPECT_EQ(1, is_ok);
+
+                    /* 分離形式 */
+                    memcpy(ref_real, input, sizeof(float) * n);
+                    memcpy(ref_imag, &input[n], sizeof(float) * n);
+                    AE2FFTPlan_SplitFFT(ref_plan, flag, ref_real, ref_imag);
+                    memcpy(real, input, sizeof(float) * n);
+                    memcpy(imag, &input[n], sizeof(float) * n);
+                    AE2FFTPlan_SplitFFT(plan, flag, real, imag);
+                    is_ok = 1;
+                    for (i = 0; i < n; i++) {
+                        if ((fabs(ref_real[i] - real[i]) > INPLACE_FLOAT_EPSILON)
+                                || (fabs(ref_imag[i] - imag[i]) > INPLACE_FLOAT_EPSILON)) {
+                            is_ok = 0;
+                            break;
+                        }
+                    }
+                    EXPECT_EQ(1, is_ok);
+                }
+            } else {
+                for (flag = -1; flag <= 1; flag += 2) {
+                    memcpy(ref_output, input, sizeof(float) * n);
+                    AE2FFTPlan_RealFFT(ref_plan, flag, ref_output);
+                    memcpy(output, input, sizeof(float) * n);
+                    AE2FFTPlan_RealFFT(plan, flag, output);
+                    is_ok = 1;
+                    for (i = 0; i < n; i++) {
+                        if (fabs(ref_output[i] - output[i]) > INPLACE_FLOAT_EPSILON) {
+                            is_ok = 0;
+                            break;
+                        }
+                    }
+                    EXPECT_EQ(1, is_ok);
+                }
+
+                /* 分離形式 */
+                AE2FFTPlan_SplitRealFFT(ref_plan, input, ref_real, ref_imag);
+                AE2FFTPlan_SplitRealFFT(plan, input, real, imag);
+                is_ok = 1;
+                for (i = 0; i < n / 2; i++) {
+                    if ((fabs(ref_real[i] - real[i]) > INPLACE_FLOAT_EPSILON)
+                            || (fabs(ref_imag[i] - imag[i]) > INPLACE_FLOAT_EPSILON)) {
+                        is_ok = 0;
+                        break;
+                    }
+                }
+                EXPECT_EQ(1, is_ok);
+                AE2FFTPlan_SplitRealIFFT(plan, real, imag, output);
+                is_ok = 1;
+                for (i = 0; i < n; i++) {
+                    if (fabs(input[i] - output[i] * 2.0f / n) > INPLACE_FLOAT_EPSILON) {
+                        is_ok = 0;
+                        break;
+                    }
+                }
+                EXPECT_EQ(1, is_ok);
+            }
+
+            AE2FFTPlan_Destroy(plan);
+            AE2FFTPlan_Destroy(ref_plan);
+            free(work);
+            free(ref_work);
+        }
+    }
+#undef MAX_NUM_SAMPLES
+#undef INPLACE_FLOAT_EPSILON
+}
+
+/* 小点数コードレットの結果一致テスト */
+TEST(AE2FFTTest, PlanCodeletTest)
+{
+#define MAX_NUM_SAMPLES 256
+#define CODELET_FLOAT_EPSILON 1e-4
+    int32_t n, i, is_ok;
+    static float input[2 * MAX_NUM_SAMPLES], ref_output[2 * MAX_NUM_SAMPLES], output[2 * MAX_NUM_SAMPLES];
+    static float work[2 * MAX_NUM_SAMPLES];
+
+    for (n = 2; n <= MAX_NUM_SAMPLES; n *= 2) {
+        int flag;
+        void *plan_work;
+        int32_t work_size;
+        struct AE2FFTPlanConfig config;
+        struct AE2FFTPlan *plan;
+
+        config.fft_size = n;
+        config.type = AE2FFTPLAN_TYPE_COMPLEX;
+        config.in_place = 0;
+        config.double_precision = 0;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        /* 8点から128点まではコードレットが選択される */
+        if ((n >= 8) && (n <= 128)) {
+            EXPECT_TRUE(plan->codelet != NULL);
+        } else {
+            EXPECT_TRUE(plan->codelet == NULL);
+        }
+
+        srand(0);
+        for (i = 0; i < 2 * n; i++) {
+            input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        }
+
+        for (flag = -1; flag <= 1; flag += 2) {
+            /* Stockham FFTとの比較 */
+            memcpy(ref_output, input, sizeof(float) * 2 * n);
+            AE2FFTPlan_ComplexFFT(plan, flag, (AE2FFTComplex *)ref_output, (AE2FFTComplex *)work);
+            memcpy(output, input, sizeof(float) * 2 * n);
+            AE2FFTPlan_FloatFFT(plan, flag, output);
+            is_ok = 1;
+            for (i = 0; i < 2 * n; i++) {
+                if (fabs(ref_output[i] - output[i]) > CODELET_FLOAT_EPSILON) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+
+            /* 倍精度DFTとの比較 */
+            AE2FFTTest_PreciseDFT(n, flag, input, ref_output);
+            is_ok = 1;
+            for (i = 0; i < 2 * n; i++) {
+                if (fabs(ref_output[i] - output[i]) > CODELET_FLOAT_EPSILON) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+        }
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+    }
+#undef MAX_NUM_SAMPLES
+#undef CODELET_FLOAT_EPSILON
+}
+
+/* 半スペクトル形式の実数FFTテスト */
+TEST(AE2FFTTest, PlanRealFFTHalfSpectrumTest)
+{
+#define MAX_NUM_SAMPLES 2048
+#define HALFSPEC_FLOAT_EPSILON 1e-3
+    int32_t t, i, is_ok;
+    static const int32_t test_sizes[] = { 2, 4, 16, 64, 256, 480, 1024, 1920, 2048 };
+    const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    static float input[2 * MAX_NUM_SAMPLES], ref_output[2 * MAX_NUM_SAMPLES];
+    static float spectrum[MAX_NUM_SAMPLES + 2], output[MAX_NUM_SAMPLES + 2];
+
+    for (t = 0; t < num_test_sizes; t++) {
+        const int32_t n = test_sizes[t];
+        void *plan_work;
+        int32_t work_size, in_place;
+
+        for (in_place = 0; in_place <= 1; in_place++) {
+            struct AE2FFTPlanConfig config;
+            struct AE2FFTPlan *plan;
+
+            config.fft_size = n;
+            config.type = AE2FFTPLAN_TYPE_REAL;
+            config.in_place = in_place;
+            config.double_precision = 0;
+            work_size = AE2FFTPlan_CalculateWorkSize(&config);
+            if (work_size < 0) {
+                /* インプレース変換は2の冪乗のみ */
+                continue;
+            }
+            ASSERT_TRUE(work_size >= 0);
+            plan_work = malloc((size_t)work_size);
+            plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+            ASSERT_TRUE(plan != NULL);
+
+            /* 虚部0の複素系列として倍精度DFTを計算 */
+            srand(0);
+            for (i = 0; i < n; i++) {
+                input[2 * i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+                input[2 * i + 1] = 0.0f;
+            }
+            AE2FFTTest_PreciseDFT(n, -1, input, ref_output);
+            for (i = 0; i < n; i++) {
+                input[i] = input[2 * i];
+            }
+
+            /* 直流からナイキスト周波数までの全ビンが通常の複素数で並ぶ */
+            AE2FFTPlan_RealFFTHalfSpectrum(plan, input, spectrum);
+            is_ok = 1;
+            for (i = 0; i < n + 2; i++) {
+                if (fabs(ref_output[i] - spectrum[i]) > HALFSPEC_FLOAT_EPSILON) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+            EXPECT_FLOAT_EQ(0.0f, spectrum[1]);
+            EXPECT_FLOAT_EQ(0.0f, spectrum[n + 1]);
+
+            /* 入出力同一領域での変換 */
+            memcpy(output, input, sizeof(float) * n);
+            AE2FFTPlan_RealFFTHalfSpectrum(plan, output, output);
+            EXPECT_EQ(0, memcmp(output, spectrum, sizeof(float) * (n + 2)));
+
+            /* 逆変換で元に戻る */
+            AE2FFTPlan_RealIFFTHalfSpectrum(plan, spectrum, output);
+            is_ok = 1;
+            for (i = 0; i < n; i++) {
+                if (fabs(input[i] - output[i]) > HALFSPEC_FLOAT_EPSILON) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+            AE2FFTPlan_RealIFFTHalfSpectrum(plan, spectrum, spectrum);
+            EXPECT_EQ(0, memcmp(output, spectrum, sizeof(float) * n));
+
+            AE2FFTPlan_Destroy(plan);
+            free(plan_work);
+        }
+    }
+#undef MAX_NUM_SAMPLES
+#undef HALFSPEC_FLOAT_EPSILON
+}
+
+/* 倍精度FFTのテスト */
+TEST(AE2FFTTest, PlanDoubleFFTTest)
+{
+#define MAX_NUM_SAMPLES 2048
+#define DOUBLE_EPSILON 1e-9
+    int32_t t, i, k, is_ok;
+    static const int32_t test_sizes[] = { 2, 4, 8, 60, 128, 480, 1024, 1920, 2048 };
+    const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    static double input[2 * MAX_NUM_SAMPLES], ref_output[2 * MAX_NUM_SAMPLES];
+    static double output[2 * MAX_NUM_SAMPLES], work[2 * MAX_NUM_SAMPLES];
+
+    for (t = 0; t < num_test_sizes; t++) {
+        const int32_t n = test_sizes[t];
+        int flag;
+        void *plan_work;
+        int32_t work_size, ref_work_size;
+        struct AE2FFTPlanConfig config;
+        struct AE2FFTPlan *plan;
+
+        srand(0);
+        for (i = 0; i < 2 * n; i++) {
+            input[i] = 2.0 * ((double)rand() / RAND_MAX - 0.5);
+        }
+
+        for (flag = -1; flag <= 1; flag += 2) {
+            /* 倍精度DFT */
+            for (k = 0; k < n; k++) {
+                double re = 0.0, im = 0.0;
+                for (i = 0; i < n; i++) {
+                    const double theta = 2.0 * AE2_PI * (double)((int64_t)i * k % n) / n;
+                    const double wr = cos(theta), wi = flag * sin(theta);
+                    re += input[2 * i] * wr - input[2 * i + 1] * wi;
+                    im += input[2 * i] * wi + input[2 * i + 1] * wr;
+                }
+                ref_output[2 * k] = re;
+                ref_output[2 * k + 1] = im;
+            }
+
+            /* 複素FFT */
+            config.fft_size = n;
+            config.type = AE2FFTPLAN_TYPE_COMPLEX;
+            config.in_place = 0;
+            config.double_precision = 0;
+            ref_work_size = AE2FFTPlan_CalculateWorkSize(&config);
+            config.double_precision = 1;
+            work_size = AE2FFTPlan_CalculateWorkSize(&config);
+            ASSERT_TRUE(work_size > ref_work_size);
+            ASSERT_TRUE(work_size >= 0);
+            plan_work = malloc((size_t)work_size);
+            plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+            ASSERT_TRUE(plan != NULL);
+
+            memcpy(output, input, sizeof(double) * 2 * n);
+            AE2FFTPlan_DoubleFFT(plan, flag, output, work);
+            is_ok = 1;
+            for (i = 0; i < 2 * n; i++) {
+                if (fabs(ref_output[i] - output[i]) > DOUBLE_EPSILON) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+
+            AE2FFTPlan_Destroy(plan);
+            free(plan_work);
+        }
+
+        /* 実数FFT: 実部のみの入力を複素DFTと比較 */
+        for (i = 0; i < n; i++) {
+            input[2 * i + 1] = 0.0;
+        }
+        for (k = 0; k <= n / 2; k++) {
+            double re = 0.0, im = 0.0;
+            for (i = 0; i < n; i++) {
+                const double theta = 2.0 * AE2_PI * (double)((int64_t)i * k % n) / n;
+                re += input[2 * i] * cos(theta);
+                im -= input[2 * i] * sin(theta);
+            }
+            ref_output[2 * k] = re;
+            ref_output[2 * k + 1] = im;
+        }
+        for (i = 0; i < n; i++) {
+            input[i] = input[2 * i];
+        }
+
+        config.fft_size = n;
+        config.type = AE2FFTPLAN_TYPE_REAL;
+        config.in_place = 0;
+        config.double_precision = 1;
+        work_size = AE2FFTPlan_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        plan_work = malloc((size_t)work_size);
+        plan = AE2FFTPlan_Create(&config, plan_work, work_size);
+        ASSERT_TRUE(plan != NULL);
+
+        memcpy(output, input, sizeof(double) * n);
+        AE2FFTPlan_DoubleRealFFT(plan, -1, output, work);
+        /* 先頭は直流成分とナイキスト周波数成分の実部 */
+        is_ok = 1;
+        if ((fabs(ref_output[0] - output[0]) > DOUBLE_EPSILON)
+                || (fabs(ref_output[n] - output[1]) > DOUBLE_EPSILON)) {
+            is_ok = 0;
+        }
+        for (i = 2; i < n; i++) {
+            if (fabs(ref_output[i] - output[i]) > DOUBLE_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        /* 逆変換で元に戻る */
+        AE2FFTPlan_DoubleRealFFT(plan, 1, output, work);
+        is_ok = 1;
+        for (i = 0; i < n; i++) {
+            if (fabs(input[i] - output[i] * 2.0 / n) > DOUBLE_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2FFTPlan_Destroy(plan);
+        free(plan_work);
+    }
+#undef MAX_NUM_SAMPLES
+#undef DOUBLE_EPSILON
+}
+
+/* 点数固定テンプレートFFTとプランの結果比較 */
+template <int N>
+static void AE2FFTTest_CheckTemplateFFT(void)
+{
+#define TEMPLATE_FLOAT_EPSILON 1e-5
+    int32_t i, is_ok;
+    int flag;
+    static float input[2 * N], ref_output[2 * N], output[2 * N];
+    static float fft_work[ae2::FFT<N>::workSize], real_fft_work[ae2::RealFFT<2 * N>::workSize];
+    ae2::FFT<N> fft(fft_work);
+    ae2::RealFFT<2 * N> real_fft(real_fft_work);
+    struct AE2FFTPlanConfig config;
+    struct AE2FFTPlan *plan, *real_plan;
+    void *work, *real_work;
+    int32_t work_size, real_work_size;
+
+    config.fft_size = N;
+    config.type = AE2FFTPLAN_TYPE_COMPLEX;
+    config.in_place = 0;
+    config.double_precision = 0;
+    work_size = AE2FFTPlan_CalculateWorkSize(&config);
+    ASSERT_TRUE(work_size >= 0);
+    work = malloc((size_t)work_size);
+    plan = AE2FFTPlan_Create(&config, work, work_size);
+    ASSERT_TRUE(plan != NULL);
+    config.fft_size = 2 * N;
+    config.type = AE2FFTPLAN_TYPE_REAL;
+    real_work_size = AE2FFTPlan_CalculateWorkSize(&config);
+    ASSERT_TRUE(real_work_size >= 0);
+    real_work = malloc((size_t)real_work_size);
+    real_plan = AE2FFTPlan_Create(&config, real_work, real_work_size);
+    ASSERT_TRUE(real_plan != NULL);
+
+    srand(0);
+    for (i = 0; i < 2 * N; i++) {
+        input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+    }
+
+    for (flag = -1; flag <= 1; flag += 2) {
+        /* 複素FFT */
+        memcpy(ref_output, input, sizeof(float) * 2 * N);
+        AE2FFTPlan_FloatFFT(plan, flag, ref_output);
+        memcpy(output, input, sizeof(float) * 2 * N);
+        fft.transform(flag, output);
+        is_ok = 1;
+        for (i = 0; i < 2 * N; i++) {
+            if (fabs(ref_output[i] - output[i]) > TEMPLATE_FLOAT_EPSILON * N) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        /* 実数FFT */
+        memcpy(ref_output, input, sizeof(float) * 2 * N);
+        AE2FFTPlan_RealFFT(real_plan, flag, ref_output);
+        memcpy(output, input, sizeof(float) * 2 * N);
+        real_fft.transform(flag, output);
+        is_ok = 1;
+        for (i = 0; i < 2 * N; i++) {
+            if (fabs(ref_output[i] - output[i]) > TEMPLATE_FLOAT_EPSILON * N) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+    }
+
+    AE2FFTPlan_Destroy(plan);
+    AE2FFTPlan_Destroy(real_plan);
+    free(work);
+    free(real_work);
+#undef TEMPLATE_FLOAT_EPSILON
+}
+
+/* 点数固定テンプレートFFTのテスト */
+TEST(AE2FFTTest, TemplateFFTTest)
+{
+    /* コンパイル時に計算した回転因子 */
+    static_assert(ae2::detail::cosTurn(0, 8) == 1.0, "cos(0) must be exact");
+    static_assert(ae2::detail::sinTurn(2, 8) == 1.0, "sin(π/2) must be exact");
+    {
+        int32_t m;
+        for (m = 0; m < 1024; m++) {
+            EXPECT_NEAR(cos(2.0 * AE2_PI * m / 1024), ae2::detail::TwiddleTable<1024>::cosTable[m], 1e-7);
+            EXPECT_NEAR(sin(2.0 * AE2_PI * m / 1024), ae2::detail::TwiddleTable<1024>::sinTable[m], 1e-7);
+        }
+    }
+
+    AE2FFTTest_CheckTemplateFFT<2>();
+    AE2FFTTest_CheckTemplateFFT<4>();
+    AE2FFTTest_CheckTemplateFFT<8>();
+    AE2FFTTest_CheckTemplateFFT<16>();
+    AE2FFTTest_CheckTemplateFFT<32>();
+    AE2FFTTest_CheckTemplateFFT<64>();
+    AE2FFTTest_CheckTemplateFFT<128>();
+    AE2FFTTest_CheckTemplateFFT<256>();
+    AE2FFTTest_CheckTemplateFFT<512>();
+    AE2FFTTest_CheckTemplateFFT<1024>();
+    AE2FFTTest_CheckTemplateFFT<2048>();
+    AE2FFTTest_CheckTemplateFFT<4096>();
+}
+
+/* DCT・MDCT作成破棄テスト */
+TEST(AE2FFTTest, DCTCreateDestroyTest)
+{
+    /* ワークサイズ計算テスト */
+    {
+        int32_t work_size;
+        struct AE2DCTConfig config;
+        struct AE2MDCTConfig mdct_config;
+
+        /* 簡単な成功例 */
+        config.size = 16;
+        config.type = AE2DCT_TYPE_II;
+        work_size = AE2DCT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size >= 0);
+        config.type = AE2DCT_TYPE_IV;
+        work_size = AE2DCT_CalculateWorkSize(&config);
+        EXPECT_TRUE(work_size >= 0);
+        mdct_config.num_coefficients = 16;
+        mdct_config.window = NULL;
+        work_size = AE2MDCT_CalculateWorkSize(&mdct_config);
+        EXPECT_TRUE(work_size >= 0);
+
+        /* 不正な引数 */
+        EXPECT_TRUE(AE2DCT_CalculateWorkSize(NULL) < 0);
+        EXPECT_TRUE(AE2MDCT_CalculateWorkSize(NULL) < 0);
+
+        /* 不正なコンフィグ */
+        config.size = 2;
+        EXPECT_TRUE(AE2DCT_CalculateWorkSize(&config) < 0);
+        config.size = 15;
+        EXPECT_TRUE(AE2DCT_CalculateWorkSize(&config) < 0);
+        config.size = 14;
+        EXPECT_TRUE(AE2DCT_CalculateWorkSize(&config) < 0);
+        mdct_config.num_coefficients = 14;
+        EXPECT_TRUE(AE2MDCT_CalculateWorkSize(&mdct_config) < 0);
+    }
+
+    /* ワーク領域渡しによる作成 */
+    {
+        void *work;
+        int32_t work_size;
+        struct AE2DCTConfig config;
+        struct AE2DCT *dct;
+        struct AE2MDCTConfig mdct_config;
+        struct AE2MDCT *mdct;
+
+        config.size = 480;
+        config.type = AE2DCT_TYPE_II;
+        work_size = AE2DCT_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+        EXPECT_TRUE(AE2DCT_Create(NULL, work, work_size) == NULL);
+        EXPECT_TRUE(AE2DCT_Create(&config, NULL, work_size) == NULL);
+        EXPECT_TRUE(AE2DCT_Create(&config, work, work_size - 1) == NULL);
+        dct = AE2DCT_Create(&config, work, work_size);
+        EXPECT_TRUE(dct != NULL);
+        EXPECT_EQ(480, AE2DCT_GetSize(dct));
+        AE2DCT_Destroy(dct);
+        free(work);
+
+        mdct_config.num_coefficients = 256;
+        mdct_config.window = NULL;
+        work_size = AE2MDCT_CalculateWorkSize(&mdct_config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+        EXPECT_TRUE(AE2MDCT_Create(NULL, work, work_size) == NULL);
+        EXPECT_TRUE(AE2MDCT_Create(&mdct_config, NULL, work_size) == NULL);
+        EXPECT_TRUE(AE2MDCT_Create(&mdct_config, work, work_size - 1) == NULL);
+        mdct = AE2MDCT_Create(&mdct_config, work, work_size);
+        EXPECT_TRUE(mdct != NULL);
+        EXPECT_EQ(256, AE2MDCT_GetNumCoefficients(mdct));
+        AE2MDCT_Destroy(mdct);
+        free(work);
+    }
+}
+
+/* DCT・MDCTの定義式との比較テスト */
+TEST(AE2FFTTest, DCTCheckWithDefinitionTest)
+{
+#define MAX_NUM_SAMPLES 1024
+#define DCT_FLOAT_EPSILON 1e-5
+    static const int32_t test_sizes[] = { 4, 8, 12, 16, 60, 256, 480, 1024 };
+    const int32_t num_test_sizes = sizeof(test_sizes) / sizeof(test_sizes[0]);
+    static float input[2 * MAX_NUM_SAMPLES], output[2 * MAX_NUM_SAMPLES], inverse[2 * MAX_NUM_SAMPLES];
+    static double ref_output[2 * MAX_NUM_SAMPLES];
+    int32_t t, i, k, type, is_ok;
+
+    for (t = 0; t < num_test_sizes; t++) {
+        const int32_t n = test_sizes[t];
+
+        srand(0);
+        for (i = 0; i < 2 * n; i++) {
+            input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+        }
+
+        /* DCT-II, DCT-IV */
+        for (type = 0; type < 2; type++) {
+            void *work;
+            int32_t work_size;
+            struct AE2DCTConfig config;
+            struct AE2DCT *dct;
+            const double offset = (type == 0) ? 0.0 : 0.5;
+
+            config.size = n;
+            config.type = (type == 0) ? AE2DCT_TYPE_II : AE2DCT_TYPE_IV;
+            work_size = AE2DCT_CalculateWorkSize(&config);
+            ASSERT_TRUE(work_size >= 0);
+            work = malloc((size_t)work_size);
+            dct = AE2DCT_Create(&config, work, work_size);
+            ASSERT_TRUE(dct != NULL);
+
+            for (k = 0; k < n; k++) {
+                ref_output[k] = 0.0;
+                for (i = 0; i < n; i++) {
+                    ref_output[k] += input[i] * cos(AE2_PI / n * (i + 0.5) * (k + offset));
+                }
+            }
+            AE2DCT_Forward(dct, input, output);
+            is_ok = 1;
+            for (k = 0; k < n; k++) {
+                if (fabs(ref_output[k] - output[k]) > DCT_FLOAT_EPSILON * n) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+
+            /* 逆変換で元に戻る（同一領域を指定） */
+            memcpy(inverse, output, sizeof(float) * n);
+            AE2DCT_Inverse(dct, inverse, inverse);
+            is_ok = 1;
+            for (i = 0; i < n; i++) {
+                if (fabs(input[i] - inverse[i] * 2.0f / n) > DCT_FLOAT_EPSILON * 10) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+
+            AE2DCT_Destroy(dct);
+            free(work);
+        }
+
+        /* MDCT（直前の入力が0の状態からの1フレーム） */
+        {
+            void *work;
+            int32_t work_size;
+            struct AE2MDCTConfig config;
+            struct AE2MDCT *mdct;
+
+            config.num_coefficients = n;
+            config.window = NULL;
+            work_size = AE2MDCT_CalculateWorkSize(&config);
+            ASSERT_TRUE(work_size >= 0);
+            work = malloc((size_t)work_size);
+            mdct = AE2MDCT_Create(&config, work, work_size);
+            ASSERT_TRUE(mdct != NULL);
+
+            AE2MDCT_Analyze(mdct, input, output);
+            AE2MDCT_Analyze(mdct, &input[n], output);
+            for (k = 0; k < n; k++) {
+                ref_output[k] = 0.0;
+                for (i = 0; i < 2 * n; i++) {
+                    const double w = sin(AE2_PI * (i + 0.5) / (2.0 * n));
+                    ref_output[k] += w * input[i] * cos(AE2_PI / n * (i + 0.5 + n / 2.0) * (k + 0.5));
+                }
+            }
+            is_ok = 1;
+            for (k = 0; k < n; k++) {
+                if (fabs(ref_output[k] - output[k]) > DCT_FLOAT_EPSILON * n) {
+                    is_ok = 0;
+                    break;
+                }
+            }
+            EXPECT_EQ(1, is_ok);
+
+            AE2MDCT_Destroy(mdct);
+            free(work);
+        }
+    }
+#undef MAX_NUM_SAMPLES
+#undef DCT_FLOAT_EPSILON
+}
+
+/* MDCT分析・合成による完全再構成テスト */
+TEST(AE2FFTTest, MDCTPerfectReconstructionTest)
+{
+#define NUM_COEFFICIENTS 64
+#define NUM_FRAMES 32
+#define MDCT_FLOAT_EPSILON 1e-5
+    static float input[NUM_COEFFICIENTS * NUM_FRAMES], output[NUM_COEFFICIENTS * NUM_FRAMES];
+    static float coefficients[NUM_COEFFICIENTS], window[2 * NUM_COEFFICIENTS];
+    int32_t i, f, w, is_ok;
+
+    srand(0);
+    for (i = 0; i < NUM_COEFFICIENTS * NUM_FRAMES; i++) {
+        input[i] = 2.0 * ((float)rand() / RAND_MAX - 0.5);
+    }
+
+    /* サイン窓と、Princen-Bradley条件を満たすVorbis窓 */
+    for (i = 0; i < 2 * NUM_COEFFICIENTS; i++) {
+        const double s = sin(AE2_PI * (i + 0.5) / (2.0 * NUM_COEFFICIENTS));
+        window[i] = (float)sin(0.5 * AE2_PI * s * s);
+    }
+
+    for (w = 0; w < 2; w++) {
+        void *work;
+        int32_t work_size;
+        struct AE2MDCTConfig config;
+        struct AE2MDCT *mdct;
+
+        config.num_coefficients = NUM_COEFFICIENTS;
+        config.window = (w == 0) ? NULL : window;
+        work_size = AE2MDCT_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+        mdct = AE2MDCT_Create(&config, work, work_size);
+        ASSERT_TRUE(mdct != NULL);
+
+        for (f = 0; f < NUM_FRAMES; f++) {
+            AE2MDCT_Analyze(mdct, &input[f * NUM_COEFFICIENTS], coefficients);
+            AE2MDCT_Synthesize(mdct, coefficients, &output[f * NUM_COEFFICIENTS]);
+        }
+
+        /* 1フレーム遅れて元に戻る */
+        is_ok = 1;
+        for (i = 0; i < NUM_COEFFICIENTS * (NUM_FRAMES - 1); i++) {
+            if (fabs(input[i] - output[i + NUM_COEFFICIENTS]) > MDCT_FLOAT_EPSILON) {
+                is_ok = 0;
+                break;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        /* リセット後は無音から再開 */
+        AE2MDCT_Reset(mdct);
+        memset(coefficients, 0, sizeof(coefficients));
+        AE2MDCT_Synthesize(mdct, coefficients, output);
+        for (i = 0; i < NUM_COEFFICIENTS; i++) {
+            EXPECT_FLOAT_EQ(0.0f, output[i]);
+        }
+
+        AE2MDCT_Destroy(mdct);
+        free(work);
+    }
+#undef NUM_COEFFICIENTS
+#undef NUM_FRAMES
+#undef MDCT_FLOAT_EPSILON
+}
@@ -0,0 +1,351 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <gtest/gtest.h>
+
+/* テスト対象のモジュール */
+extern "C" {
+#include "../../libs/ae2_sliding_dft/src/ae2_sliding_dft.c"
+}
+
+/* 直近window_sizeサンプルに周期窓をかけたDFTを定義通りに計算 */
+static void AE2SlidingDFTTest_WindowedDFT(
+    AE2WindowFunctionType type, const float *input, int32_t window_size, int32_t bin, double *real, double *imag)
+{
+    int32_t m, t, num_terms;
+    float terms[AE2WINDOWFUNCTION_MAX_NUM_COSINE_TERMS];
+
+    num_terms = AE2WindowFunction_GetCosineSumCoefficients(type, terms);
+
+    (*real) = (*imag) = 0.0;
+    for (m = 0; m < window_size; m++) {
+        double w = 0.0;
+        for (t = 0; t < num_terms; t++) {
+            w += ((t % 2) ? -1.0 : 1.0) * terms[t] * cos((2.0 * AE2_PI * t * m) / window_size);
+        }
+        (*real) += w * input[m] * cos((2.0 * AE2_PI * bin * m) / window_size);
+        (*imag) -= w * input[m] * sin((2.0 * AE2_PI * bin * m) / window_size);
+    }
+}
+
+/* 作成破棄テスト */
+TEST(AE2SlidingDFTTest, CreateDestroyTest)
+{
+    /* ワークサイズ計算テスト */
+    {
+        struct AE2SlidingDFTConfig config;
+        struct AE2GoertzelConfig goertzel_config;
+
+        /* 簡単な成功例 */
+        config.window_size = 1024;
+        config.max_num_bins = 4;
+        config.window_type = AE2WINDOWFUNCTION_HANN;
+        EXPECT_TRUE(AE2SlidingDFT_CalculateWorkSize(&config) >= 0);
+        goertzel_config.sampling_rate = 48000.0f;
+        goertzel_config.block_size = 1024;
+        goertzel_config.max_num_frequencies = 4;
+        goertzel_config.window_type = AE2WINDOWFUNCTION_BLACKMAN;
+        EXPECT_TRUE(AE2Goertzel_CalculateWorkSize(&goertzel_config) >= 0);
+
+        /* 不正な引数 */
+        EXPECT_TRUE(AE2SlidingDFT_CalculateWorkSize(NULL) < 0);
+        EXPECT_TRUE(AE2Goertzel_CalculateWorkSize(NULL) < 0);
+
+        /* 不正なコンフィグ */
+        config.window_size = 0;
+        EXPECT_TRUE(AE2SlidingDFT_CalculateWorkSize(&config) < 0);
+        config.window_size = 1024;
+        config.max_num_bins = 0;
+        EXPECT_TRUE(AE2SlidingDFT_CalculateWorkSize(&config) < 0);
+        config.max_num_bins = 4;
+        config.window_type = (AE2WindowFunctionType)-1;
+        EXPECT_TRUE(AE2SlidingDFT_CalculateWorkSize(&config) < 0);
+
+        goertzel_config.sampling_rate = 0.0f;
+        EXPECT_TRUE(AE2Goertzel_CalculateWorkSize(&goertzel_config) < 0);
+        goertzel_config.sampling_rate = 48000.0f;
+        goertzel_config.block_size = 1;
+        EXPECT_TRUE(AE2Goertzel_CalculateWorkSize(&goertzel_config) < 0);
+        goertzel_config.block_size = 1024;
+        goertzel_config.max_num_frequencies = 0;
+        EXPECT_TRUE(AE2Goertzel_CalculateWorkSize(&goertzel_config) < 0);
+    }
+
+    /* ワーク領域渡しによる作成 */
+    {
+        void *work;
+        int32_t work_size;
+        struct AE2SlidingDFTConfig config;
+        struct AE2SlidingDFT *sdft;
+        int32_t bins[4] = { 0, 1, 10, 512 };
+
+        config.window_size = 1024;
+        config.max_num_bins = 4;
+        config.window_type = AE2WINDOWFUNCTION_HANN;
+        work_size = AE2SlidingDFT_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+
+        EXPECT_TRUE(AE2SlidingDFT_Create(NULL, work, work_size) == NULL);
+        EXPECT_TRUE(AE2SlidingDFT_Create(&config, NULL, work_size) == NULL);
+        EXPECT_TRUE(AE2SlidingDFT_Create(&config, work, work_size - 1) == NULL);
+        sdft = AE2SlidingDFT_Create(&config, work, work_size);
+        ASSERT_TRUE(sdft != NULL);
+
+        /* ビン設定 */
+        EXPECT_EQ(0, AE2SlidingDFT_SetBins(sdft, bins, 4));
+        EXPECT_TRUE(AE2SlidingDFT_SetBins(sdft, NULL, 4) < 0);
+        EXPECT_TRUE(AE2SlidingDFT_SetBins(sdft, bins, 5) < 0);
+        bins[0] = 1024;
+        EXPECT_TRUE(AE2SlidingDFT_SetBins(sdft, bins, 4) < 0);
+        bins[0] = -1;
+        EXPECT_TRUE(AE2SlidingDFT_SetBins(sdft, bins, 4) < 0);
+
+        AE2SlidingDFT_Destroy(sdft);
+        free(work);
+    }
+
+    /* ワーク領域渡しによる作成（Goertzel） */
+    {
+        void *work;
+        int32_t work_size;
+        struct AE2GoertzelConfig config;
+        struct AE2Goertzel *goertzel;
+        float frequencies[2] = { 440.0f, 24000.0f };
+
+        config.sampling_rate = 48000.0f;
+        config.block_size = 1024;
+        config.max_num_frequencies = 2;
+        config.window_type = AE2WINDOWFUNCTION_HAMMING;
+        work_size = AE2Goertzel_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+
+        EXPECT_TRUE(AE2Goertzel_Create(NULL, work, work_size) == NULL);
+        EXPECT_TRUE(AE2Goertzel_Create(&config, NULL, work_size) == NULL);
+        EXPECT_TRUE(AE2Goertzel_Create(&config, work, work_size - 1) == NULL);
+        goertzel = AE2Goertzel_Create(&config, work, work_size);
+        ASSERT_TRUE(goertzel != NULL);
+
+        /* 周波数設定 */
+        EXPECT_EQ(0, AE2Goertzel_SetFrequencies(goertzel, frequencies, 2));
+        EXPECT_TRUE(AE2Goertzel_SetFrequencies(goertzel, NULL, 2) < 0);
+        EXPECT_TRUE(AE2Goertzel_SetFrequencies(goertzel, frequencies, 3) < 0);
+        frequencies[1] = 24001.0f;
+        EXPECT_TRUE(AE2Goertzel_SetFrequencies(goertzel, frequencies, 2) < 0);
+
+        AE2Goertzel_Destroy(goertzel);
+        free(work);
+    }
+
+    /* NULLの破棄は何もしない */
+    AE2SlidingDFT_Destroy(NULL);
+    AE2Goertzel_Destroy(NULL);
+}
+
+/* スライディングDFTの定義式との比較テスト */
+TEST(AE2SlidingDFTTest, SlidingDFTCheckTest)
+{
+#define WINDOW_SIZE 256
+#define NUM_BINS 5
+#define NUM_SAMPLES (WINDOW_SIZE * 20 + 37)
+#define SDFT_EPSILON 1e-3
+    static const AE2WindowFunctionType types[] = {
+        AE2WINDOWFUNCTION_RECTANGULAR, AE2WINDOWFUNCTION_HANN, AE2WINDOWFUNCTION_HAMMING, AE2WINDOWFUNCTION_BLACKMAN
+    };
+    static float input[NUM_SAMPLES];
+    const int32_t bins[NUM_BINS] = { 0, 1, 17, WINDOW_SIZE / 2, WINDOW_SIZE - 1 };
+    int32_t i, t, smpl, is_ok;
+
+    srand(0);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        input[smpl] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+
+    for (t = 0; t < (int32_t)(sizeof(types) / sizeof(types[0])); t++) {
+        void *work;
+        int32_t work_size;
+        struct AE2SlidingDFTConfig config;
+        struct AE2SlidingDFT *sdft;
+        float spectrum[2 * NUM_BINS], power[NUM_BINS];
+
+        config.window_size = WINDOW_SIZE;
+        config.max_num_bins = NUM_BINS;
+        config.window_type = types[t];
+        work_size = AE2SlidingDFT_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+        sdft = AE2SlidingDFT_Create(&config, work, work_size);
+        ASSERT_TRUE(sdft != NULL);
+
+        /* 途中でビンを設定しても履歴から正しく計算し直す */
+        AE2SlidingDFT_Process(sdft, input, WINDOW_SIZE / 3);
+        ASSERT_EQ(0, AE2SlidingDFT_SetBins(sdft, bins, NUM_BINS));
+
+        is_ok = 1;
+        for (smpl = WINDOW_SIZE / 3; smpl < NUM_SAMPLES; smpl++) {
+            AE2SlidingDFT_Process(sdft, &input[smpl], 1);
+            /* 1サンプルごとの結果を間引いて確認 */
+            if ((smpl >= WINDOW_SIZE - 1) && ((smpl % 97) == 0)) {
+                AE2SlidingDFT_GetSpectrum(sdft, spectrum);
+                AE2SlidingDFT_GetPower(sdft, power);
+                for (i = 0; i < NUM_BINS; i++) {
+                    double re, im;
+                    AE2SlidingDFTTest_WindowedDFT(types[t], &input[smpl - WINDOW_SIZE + 1], WINDOW_SIZE, bins[i], &re, &im);
+                    if ((fabs(re - spectrum[2 * i + 0]) > SDFT_EPSILON)
+                        || (fabs(im - spectrum[2 * i + 1]) > SDFT_EPSILON)
+                        || (fabs((re * re + im * im) - power[i]) > SDFT_EPSILON * (1.0 + re * re + im * im))) {
+                        is_ok = 0;
+                    }
+                }
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        /* リセット後は0 */
+        AE2SlidingDFT_Reset(sdft);
+        AE2SlidingDFT_GetPower(sdft, power);
+        for (i = 0; i < NUM_BINS; i++) {
+            EXPECT_FLOAT_EQ(0.0f, power[i]);
+        }
+
+        AE2SlidingDFT_Destroy(sdft);
+        free(work);
+    }
+#undef WINDOW_SIZE
+#undef NUM_BINS
+#undef NUM_SAMPLES
+#undef SDFT_EPSILON
+}
+
+/* スライディングDFTの長時間動作での安定性テスト */
+TEST(AE2SlidingDFTTest, SlidingDFTStabilityTest)
+{
+#define WINDOW_SIZE 100
+#define NUM_SAMPLES (48000 * 60)
+#define SDFT_EPSILON 1e-4
+    void *work;
+    int32_t work_size, smpl, is_ok, i;
+    struct AE2SlidingDFTConfig config;
+    struct AE2SlidingDFT *sdft;
+    const int32_t bins[3] = { 1, 5, 49 };
+    float power[3];
+    static float input[WINDOW_SIZE];
+
+    config.window_size = WINDOW_SIZE;
+    config.max_num_bins = 3;
+    config.window_type = AE2WINDOWFUNCTION_HANN;
+    work_size = AE2SlidingDFT_CalculateWorkSize(&config);
+    ASSERT_TRUE(work_size >= 0);
+    work = malloc((size_t)work_size);
+    sdft = AE2SlidingDFT_Create(&config, work, work_size);
+    ASSERT_TRUE(sdft != NULL);
+    ASSERT_EQ(0, AE2SlidingDFT_SetBins(sdft, bins, 3));
+
+    /* 1分間分の雑音を入力 */
+    srand(0);
+    for (smpl = 0; smpl < NUM_SAMPLES; smpl++) {
+        const float x = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+        AE2SlidingDFT_Process(sdft, &x, 1);
+    }
+
+    /* 無音を入力すれば誤差の蓄積分のみが残る */
+    memset(input, 0, sizeof(input));
+    AE2SlidingDFT_Process(sdft, input, WINDOW_SIZE);
+    AE2SlidingDFT_GetPower(sdft, power);
+    is_ok = 1;
+    for (i = 0; i < 3; i++) {
+        if (power[i] > SDFT_EPSILON) {
+            is_ok = 0;
+        }
+    }
+    EXPECT_EQ(1, is_ok);
+
+    AE2SlidingDFT_Destroy(sdft);
+    free(work);
+#undef WINDOW_SIZE
+#undef NUM_SAMPLES
+#undef SDFT_EPSILON
+}
+
+/* Goertzelバンクの定義式との比較テスト */
+TEST(AE2SlidingDFTTest, GoertzelCheckTest)
+{
+#define BLOCK_SIZE 480
+#define NUM_BLOCKS 5
+#define NUM_FREQUENCIES 4
+#define GOERTZEL_EPSILON 1e-3
+    static const AE2WindowFunctionType types[] = {
+        AE2WINDOWFUNCTION_RECTANGULAR, AE2WINDOWFUNCTION_HANN, AE2WINDOWFUNCTION_HAMMING, AE2WINDOWFUNCTION_BLACKMAN
+    };
+    static float input[BLOCK_SIZE * NUM_BLOCKS], window[BLOCK_SIZE];
+    const float sampling_rate = 48000.0f;
+    const float frequencies[NUM_FREQUENCIES] = { 0.0f, 27.5f, 440.0f, 24000.0f };
+    int32_t t, i, b, smpl, is_ok;
+
+    srand(0);
+    for (smpl = 0; smpl < BLOCK_SIZE * NUM_BLOCKS; smpl++) {
+        input[smpl] = 2.0f * ((float)rand() / RAND_MAX - 0.5f);
+    }
+
+    for (t = 0; t < (int32_t)(sizeof(types) / sizeof(types[0])); t++) {
+        void *work;
+        int32_t work_size;
+        struct AE2GoertzelConfig config;
+        struct AE2Goertzel *goertzel;
+        float spectrum[2 * NUM_FREQUENCIES], power[NUM_FREQUENCIES];
+
+        config.sampling_rate = sampling_rate;
+        config.block_size = BLOCK_SIZE;
+        config.max_num_frequencies = NUM_FREQUENCIES;
+        config.window_type = types[t];
+        work_size = AE2Goertzel_CalculateWorkSize(&config);
+        ASSERT_TRUE(work_size >= 0);
+        work = malloc((size_t)work_size);
+        goertzel = AE2Goertzel_Create(&config, work, work_size);
+        ASSERT_TRUE(goertzel != NULL);
+        ASSERT_EQ(0, AE2Goertzel_SetFrequencies(goertzel, frequencies, NUM_FREQUENCIES));
+
+        AE2WindowFunction_MakeWindow(types[t], window, BLOCK_SIZE);
+
+        /* ブロック境界をまたぐ長さで入力 */
+        EXPECT_EQ(0, AE2Goertzel_Process(goertzel, input, BLOCK_SIZE - 1));
+        EXPECT_EQ(1, AE2Goertzel_Process(goertzel, &input[BLOCK_SIZE - 1], 2));
+        EXPECT_EQ(NUM_BLOCKS - 1, AE2Goertzel_Process(goertzel, &input[BLOCK_SIZE + 1], BLOCK_SIZE * (NUM_BLOCKS - 1) - 1));
+        AE2Goertzel_GetSpectrum(goertzel, spectrum);
+        AE2Goertzel_GetPower(goertzel, power);
+
+        /* 最後のブロックと比較 */
+        b = NUM_BLOCKS - 1;
+        is_ok = 1;
+        for (i = 0; i < NUM_FREQUENCIES; i++) {
+            double re = 0.0, im = 0.0;
+            const double omega = (2.0 * AE2_PI * frequencies[i]) / sampling_rate;
+            for (smpl = 0; smpl < BLOCK_SIZE; smpl++) {
+                const double x = window[smpl] * input[b * BLOCK_SIZE + smpl];
+                re += x * cos(omega * smpl);
+                im -= x * sin(omega * smpl);
+            }
+            if ((fabs(re - spectrum[2 * i + 0]) > GOERTZEL_EPSILON)
+                || (fabs(im - spectrum[2 * i + 1]) > GOERTZEL_EPSILON)
+                || (fabs((re * re + im * im) - power[i]) > GOERTZEL_EPSILON * (1.0 + re * re + im * im))) {
+                is_ok = 0;
+            }
+        }
+        EXPECT_EQ(1, is_ok);
+
+        AE2Goertzel_Destroy(goertzel);
+        free(work);
+    }
+#undef BLOCK_SIZE
+#undef NUM_BLOCKS
+#undef NUM_FREQUENCIES
+#undef GOERTZEL_EPSILON
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -3,11 +3,55 @@
 
 #include <gtest/gtest.h>
 
+#include <math.h>
+
 /* テスト対象のモジュール */
 extern "C" {
 #include "../../libs/ae2_window_function/src/ae2_window_function.c"
 }
 
+/* 余弦和係数の取得テスト */
+TEST(AE2WindowFunctionTest, GetCosineSumCoefficientsTest)
+{
+#define WINDOW_SIZE 64
+#define WINDOW_FLOAT_EPSILON 1e-6
+    uint32_t i, x;
+    int32_t m, num_terms;
+    float coefficients[AE2WINDOWFUNCTION_MAX_NUM_COSINE_TERMS];
+    float window[WINDOW_SIZE];
+    const struct {
+        AE2WindowFunctionType type;
+        int32_t num_terms;
+        float coefficients[AE2WINDOWFUNCTION_MAX_NUM_COSINE_TERMS];
+    } test_cases[] = {
+        { AE2WINDOWFUNCTION_RECTANGULAR, 1, { 1.0f, 0.0f, 0.0f } },
+        { AE2WINDOWFUNCTION_HANN, 2, { 0.5f, 0.5f, 0.0f } },
+        { AE2WINDOWFUNCTION_HAMMING, 2, { 0.54f, 0.46f, 0.0f } },
+        { AE2WINDOWFUNCTION_BLACKMAN, 3, { 0.42f, 0.5f, 0.08f } },
+    };
+
+    for (i = 0; i < sizeof(test_cases) / sizeof(test_cases[0]); i++) {
+        /* 既知の係数と一致 */
+        num_terms = AE2WindowFunction_GetCosineSumCoefficients(test_cases[i].type, coefficients);
+        ASSERT_EQ(test_cases[i].num_terms, num_terms);
+        for (m = 0; m < num_terms; m++) {
+            EXPECT_FLOAT_EQ(test_cases[i].coefficients[m], coefficients[m]);
+        }
+
+        /* 係数から合成した窓はMakeWindowの窓（L = WINDOW_SIZE - 1）と一致 */
+        AE2WindowFunction_MakeWindow(test_cases[i].type, window, WINDOW_SIZE);
+        for (x = 0; x < WINDOW_SIZE; x++) {
+            double w = 0.0;
+            for (m = 0; m < num_terms; m++) {
+                w += ((m % 2 == 0) ? 1.0 : -1.0) * coefficients[m] * cos((2.0 * AE2_PI * m * x) / (WINDOW_SIZE - 1));
+            }
+            EXPECT_NEAR(w, window[x], WINDOW_FLOAT_EPSILON);
+        }
+    }
+#undef WINDOW_SIZE
+#undef WINDOW_FLOAT_EPSILON
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);